@@ -25,6 +25,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
 #ifdef OUTPUT_PAGE_ID_FOR_DEBUG
   cout << "BufferPoolManager::FetchPage " << page_id << endl;
 #endif
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
 
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
@@ -33,6 +34,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
     frame_id = page_table_[page_id];
     replacer_->Pin(frame_id);
     ++pages_[frame_id].pin_count_;
+    hit_count_++;
     return &pages_[frame_id];
   }
   // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
@@ -41,7 +43,10 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
   if (!free_list_.empty()) {
     frame_id = free_list_.back();
     free_list_.pop_back();
-  } else replacer_->Victim(&frame_id);
+  } else if (!replacer_->Victim(&frame_id)) {
+    // every frame is pinned
+    return nullptr;
+  }
   
   // 2.     If R is dirty, write it back to the disk.
   if (pages_[frame_id].IsDirty()) {
@@ -56,25 +61,30 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
   pages_[frame_id].pin_count_ = 1;
   pages_[frame_id].ResetMemory();
   disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
+  miss_count_++;
   return &pages_[frame_id];
 }
 
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 0.   Make sure you call AllocatePage!
   frame_id_t frame_id;
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
-  if (free_list_.empty() && !replacer_->Victim(&frame_id)) {
+  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+  if (!free_list_.empty()) {
+    frame_id = free_list_.back();
+    free_list_.pop_back();
+  } else if (!replacer_->Victim(&frame_id)) {
     return nullptr;
   }
-  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
-  else {
-    page_id = AllocatePage();
-    if (!free_list_.empty()) {
-      frame_id = free_list_.back();
-      free_list_.pop_back();
-    } else {
-      replacer_->Victim(&frame_id);
+  page_id = AllocatePage();
+  // 2.1  If P is dirty, write it back to the disk, and drop it from the page table.
+  if (pages_[frame_id].page_id_ != INVALID_PAGE_ID) {
+    if (pages_[frame_id].IsDirty()) {
+      FlushPage(pages_[frame_id].page_id_);
+      pages_[frame_id].is_dirty_ = false;
     }
+    page_table_.erase(pages_[frame_id].page_id_);
   }
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   page_table_[page_id] = frame_id;
@@ -95,6 +105,7 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
 #ifdef OUTPUT_PAGE_ID_FOR_DEBUG
   cout << "BufferPoolManager::Delete " << page_id << endl;
 #endif
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
 
   // 0.   Make sure you call DeallocatePage!
   DeallocatePage(page_id);
@@ -121,6 +132,7 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
 #ifdef OUTPUT_PAGE_ID_FOR_DEBUG
   cout << "BufferPoolManager::UnpinPage " << page_id << endl;
 #endif
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
 
   //  找不到page，return false
   if (page_table_.find(page_id) == page_table_.end()) {
@@ -150,6 +162,7 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   //  找不到page，return false
   if (page_table_.find(page_id) == page_table_.end()) {
     return false;
@@ -189,6 +202,7 @@ bool BufferPoolManager::IsPageFree(page_id_t page_id) {
 
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   bool res = true;
   for (size_t i = 0; i < pool_size_; i++) {
     if (pages_[i].pin_count_ != 0) {
@@ -90,11 +90,18 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
   }
 }
 
-CatalogManager::~CatalogManager() { delete heap_; }
+CatalogManager::~CatalogManager() {
+  // indexes write back what they keep in memory, eg: their Bloom filters
+  for (auto &index : indexes_) {
+    delete index.second->GetIndex();
+  }
+  delete heap_;
+}
 
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Transaction *txn,
-                                    IndexInfo *&index_info) {
+                                    IndexInfo *&index_info, bool unique, IndexMethod method,
+                                    const std::vector<std::string> &include_keys, bool bloom_filter) {
   // what we need?
   // indexes_ needs index_id,index_info
   // index_info needs index_meta, table_info
@@ -128,7 +135,25 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
     }
   }
 
-  IndexMetadata *indexMetadata = IndexMetadata::Create(index_id, index_name, tableId, key_map, heap_);
+  // included columns are only stored in B+ tree leaves
+  std::vector<uint32_t> include_map;
+  if (!include_keys.empty() && method != kIndexBPlusTree) return DB_FAILED;
+  for (const auto &include_key : include_keys) {
+    uint32_t column_index;
+    if (tableInfo->GetSchema()->GetColumnIndex(include_key, column_index) != DB_SUCCESS) {
+      return DB_COLUMN_NAME_NOT_EXIST;
+    }
+    include_map.push_back(column_index);
+  }
+
+  // the narrowest precompiled key layout, fixed for the life of the index
+  IndexKeyType key_type;
+  uint32_t key_size;
+  IndexMetadata::SelectKeyType(tableInfo->GetSchema(), key_map, unique, key_type, key_size, method, include_map);
+  // hash indexes already answer a lookup from one bucket, only B+ trees keep a filter
+  IndexMetadata *indexMetadata = IndexMetadata::Create(index_id, index_name, tableId, key_map, heap_, unique, key_type,
+                                                       key_size, method, include_map,
+                                                       bloom_filter && method == kIndexBPlusTree);
   page_id_t pageId;
   Page *index_meta_page = buffer_pool_manager_->NewPage(pageId);
   indexMetadata->SerializeTo(index_meta_page->GetData());
@@ -173,6 +198,7 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
   index_id_t indexId=index_map[index_name];
   page_id_t pageId=(catalog_meta_->index_meta_pages_)[indexId];
 
+  indexes_[indexId]->GetIndex()->Destroy();
   buffer_pool_manager_->DeletePage(pageId);
   (catalog_meta_->index_meta_pages_).erase((catalog_meta_->index_meta_pages_).find(indexId));
   indexes_.erase(indexes_.find(indexId));
@@ -200,6 +226,13 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
       TableHeap::Create(buffer_pool_manager_, page_id, tableMetadata->GetSchema(), log_manager_, lock_manager_, heap_);
   TableInfo *tableInfo = TableInfo::Create(heap_);
   tableInfo->Init(tableMetadata, tableHeap);
+  if (tableMetadata->GetStatisticsPageId() != INVALID_PAGE_ID) {
+    auto statistics_page = buffer_pool_manager_->FetchPage(tableMetadata->GetStatisticsPageId());
+    TableStatistics *statistics;
+    TableStatistics::DeserializeFrom(statistics_page->GetData(), statistics, heap_);
+    tableInfo->SetStatistics(statistics);
+    buffer_pool_manager_->UnpinPage(tableMetadata->GetStatisticsPageId(), false);
+  }
   table_names_[tableMetadata->GetTableName()] = table_id;
   tables_[table_id] = tableInfo;
   buffer_pool_manager_->UnpinPage(page_id, false);
@@ -215,6 +248,9 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   TableInfo *tableInfo = tables_[tableId];
 
   buffer_pool_manager_->DeletePage(pageId);
+  if (tableInfo->GetTableMeta()->GetStatisticsPageId() != INVALID_PAGE_ID) {
+    buffer_pool_manager_->DeletePage(tableInfo->GetTableMeta()->GetStatisticsPageId());
+  }
   table_names_.erase(table_names_iter);
   tables_.erase(tables_.find(tableId));
   (catalog_meta_->GetTableMetaPages())->erase(table_meta_pages_iter);
@@ -255,6 +291,37 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::AnalyzeTable(const std::string &table_name, Transaction *txn, TableStatistics *&statistics) {
+  TableInfo *tableInfo;
+  if (GetTable(table_name, tableInfo) != DB_SUCCESS) return DB_TABLE_NOT_EXIST;
+  statistics = TableStatistics::Collect(tableInfo->GetTableHeap(), tableInfo->GetSchema(), heap_);
+  // the first analyze gives the table its statistics page
+  TableMetadata *tableMetadata = tableInfo->GetTableMeta();
+  page_id_t statisticsPageId = tableMetadata->GetStatisticsPageId();
+  Page *statistics_page;
+  if (statisticsPageId == INVALID_PAGE_ID) {
+    statistics_page = buffer_pool_manager_->NewPage(statisticsPageId);
+    if (statistics_page == nullptr) return DB_FAILED;
+    tableMetadata->SetStatisticsPageId(statisticsPageId);
+    page_id_t metaPageId = catalog_meta_->table_meta_pages_[tableInfo->GetTableId()];
+    Page *table_meta_page = buffer_pool_manager_->FetchPage(metaPageId);
+    tableMetadata->SerializeTo(table_meta_page->GetData());
+    buffer_pool_manager_->UnpinPage(metaPageId, true);
+  } else {
+    statistics_page = buffer_pool_manager_->FetchPage(statisticsPageId);
+  }
+  statistics->SerializeTo(statistics_page->GetData());
+  buffer_pool_manager_->UnpinPage(statisticsPageId, true);
+  // earlier statistics are replaced in place, their memory stays with the catalog heap
+  if (tableInfo->GetStatistics() != nullptr) {
+    *tableInfo->GetStatistics() = std::move(*statistics);
+    statistics = tableInfo->GetStatistics();
+  } else {
+    tableInfo->SetStatistics(statistics);
+  }
+  return DB_SUCCESS;
+}
+
 dberr_t CatalogManager::GetIndex(const std::string &table_name, const std::string &index_name,
                                  IndexInfo *&index_info) const {
   auto out_index_names_iter = index_names_.find(table_name);
@@ -1,15 +1,54 @@
+#include <algorithm>
 #include "catalog/indexes.h"
 
 IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &index_name, const table_id_t table_id,
-                                     const vector<uint32_t> &key_map, MemHeap *heap) {
+                                     const vector<uint32_t> &key_map, MemHeap *heap, bool unique,
+                                     IndexKeyType key_type, uint32_t key_size, IndexMethod method,
+                                     const vector<uint32_t> &include_map, bool bloom_filter) {
   void *buf = heap->Allocate(sizeof(IndexMetadata));
-  return new (buf) IndexMetadata(index_id, index_name, table_id, key_map);
+  return new (buf) IndexMetadata(index_id, index_name, table_id, key_map, unique, key_type, key_size, method,
+                                 include_map, bloom_filter);
+}
+
+void IndexMetadata::SelectKeyType(const Schema *table_schema, const vector<uint32_t> &key_map, bool unique,
+                                  IndexKeyType &key_type, uint32_t &key_size, IndexMethod method,
+                                  const vector<uint32_t> &include_map) {
+  // covering entries always end with the row id, uniqueness is checked on the key columns
+  uint32_t row_id_size = unique && include_map.empty() ? 0 : sizeof(int64_t);
+  if (method == kIndexBPlusTree && include_map.empty() && key_map.size() == 1 && table_schema->GetColumn(key_map[0])->GetType() != TypeId::kTypeChar) {
+    key_type = table_schema->GetColumn(key_map[0])->GetType() == TypeId::kTypeInt ? kKeyInt : kKeyFloat;
+    key_size = unique ? 8 : 16;
+    return;
+  }
+  // widest encoded key: a null flag per column, char columns at their full length
+  uint32_t size = 0;
+  std::vector<uint32_t> column_map(key_map);
+  column_map.insert(column_map.end(), include_map.begin(), include_map.end());
+  for (auto i : column_map) {
+    const Column *column = table_schema->GetColumn(i);
+    size += PackedKeyCodec::FLAG_SIZE;
+    if (column->GetType() == TypeId::kTypeChar) {
+      size += column->GetLength() + PackedKeyCodec::TERMINATOR_SIZE;
+    } else {
+      size += Type::GetTypeSize(column->GetType());
+    }
+  }
+  key_type = kKeyPacked;
+  if (method == kIndexHash) {
+    // buckets keep the row id beside the key
+    key_size = std::min(size, MAX_PACKED_KEY_SIZE);
+    return;
+  }
+  key_size = 32;
+  while (key_size < size + row_id_size && key_size < MAX_PACKED_KEY_SIZE) {
+    key_size *= 2;
+  }
 }
 
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
   char *temp = buf;
   size_t i;
-  MACH_WRITE_UINT32(temp, INDEX_METADATA_MAGIC_NUM);
+  MACH_WRITE_UINT32(temp, INDEX_METADATA_V4_MAGIC_NUM);
   temp += sizeof(uint32_t);
   MACH_WRITE_UINT32(temp, index_id_);
   temp += sizeof(uint32_t);
@@ -25,14 +64,28 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
     MACH_WRITE_TO(uint32_t, temp, key_map_.at(i));
     temp += sizeof(uint32_t);
   }
+  MACH_WRITE_UINT32(temp, (unique_ ? INDEX_FLAG_UNIQUE : 0) | (method_ == kIndexHash ? INDEX_FLAG_HASH : 0) |
+                              (bloom_filter_ ? INDEX_FLAG_BLOOM : 0));
+  temp += sizeof(uint32_t);
+  MACH_WRITE_UINT32(temp, key_type_);
+  temp += sizeof(uint32_t);
+  MACH_WRITE_UINT32(temp, key_size_);
+  temp += sizeof(uint32_t);
+  MACH_WRITE_UINT32(temp, include_map_.size());
+  temp += sizeof(uint32_t);
+  for (i = 0; i < include_map_.size(); i++) {
+    MACH_WRITE_TO(uint32_t, temp, include_map_.at(i));
+    temp += sizeof(uint32_t);
+  }
   return temp - buf;
 }
 
 uint32_t IndexMetadata::GetSerializedSize() const {
   uint32_t re = 0;
-  re += sizeof(uint32_t) * 5;
+  re += sizeof(uint32_t) * 9;
   re += index_name_.size() * sizeof(char);
   re += key_map_.size() * sizeof(uint32_t);
+  re += include_map_.size() * sizeof(uint32_t);
   return re;
 }
 
@@ -42,8 +95,11 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, M
   table_id_t table_id;
   size_t map_size, name_size, i;
   std::string index_name;
-  std::vector<uint32_t> key_map;
-  if (MACH_READ_UINT32(temp) != INDEX_METADATA_MAGIC_NUM) std::cerr << "Magic Num vertification failed" << std::endl;
+  std::vector<uint32_t> key_map, include_map;
+  uint32_t magic_num = MACH_READ_UINT32(temp);
+  if (magic_num != INDEX_METADATA_MAGIC_NUM && magic_num != INDEX_METADATA_V2_MAGIC_NUM &&
+      magic_num != INDEX_METADATA_V3_MAGIC_NUM && magic_num != INDEX_METADATA_V4_MAGIC_NUM)
+    std::cerr << "Magic Num vertification failed" << std::endl;
   temp += sizeof(uint32_t);
   index_id = MACH_READ_UINT32(temp);
   temp += sizeof(uint32_t);
@@ -61,6 +117,88 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, M
     key_map.push_back(MACH_READ_UINT32(temp));
     temp += sizeof(uint32_t);
   }
-  index_meta = ALLOC_P(heap, IndexMetadata)(index_id, index_name, table_id, key_map);
+  bool unique = true;
+  IndexKeyType key_type = kKeyGeneric;
+  uint32_t key_size = DEFAULT_KEY_SIZE;
+  IndexMethod method = kIndexBPlusTree;
+  bool bloom_filter = false;
+  if (magic_num != INDEX_METADATA_MAGIC_NUM) {
+    uint32_t flags = MACH_READ_UINT32(temp);
+    unique = flags & INDEX_FLAG_UNIQUE;
+    method = (flags & INDEX_FLAG_HASH) ? kIndexHash : kIndexBPlusTree;
+    bloom_filter = flags & INDEX_FLAG_BLOOM;
+    temp += sizeof(uint32_t);
+  }
+  if (magic_num == INDEX_METADATA_V3_MAGIC_NUM || magic_num == INDEX_METADATA_V4_MAGIC_NUM) {
+    key_type = static_cast<IndexKeyType>(MACH_READ_UINT32(temp));
+    temp += sizeof(uint32_t);
+    key_size = MACH_READ_UINT32(temp);
+    temp += sizeof(uint32_t);
+  }
+  if (magic_num == INDEX_METADATA_V4_MAGIC_NUM) {
+    map_size = MACH_READ_UINT32(temp);
+    temp += sizeof(uint32_t);
+    for (i = 0; i < map_size; i++) {
+      include_map.push_back(MACH_READ_UINT32(temp));
+      temp += sizeof(uint32_t);
+    }
+  }
+  index_meta = ALLOC_P(heap, IndexMetadata)(index_id, index_name, table_id, key_map, unique, key_type, key_size,
+                                            method, include_map, bloom_filter);
   return temp - buf;
-}
\ No newline at end of file
+}
+Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager) {
+  if (meta_data_->GetIndexMethod() == kIndexHash) {
+    return new ExtendibleHashIndex(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager, meta_data_->IsUnique(),
+                                   meta_data_->GetKeySize());
+  }
+  if (meta_data_->IsCovering()) {
+    switch (meta_data_->GetKeySize()) {
+      case 32:
+        return NewCoveringIndex<32>(buffer_pool_manager);
+      case 64:
+        return NewCoveringIndex<64>(buffer_pool_manager);
+      case 128:
+        return NewCoveringIndex<128>(buffer_pool_manager);
+      default:
+        return NewCoveringIndex<256>(buffer_pool_manager);
+    }
+  }
+  switch (meta_data_->GetKeyType()) {
+    case kKeyInt:
+      if (meta_data_->GetKeySize() == 8) {
+        return NewBPlusTreeIndex<NativeKey<int32_t, 8>, NativeComparator<int32_t, 8>>(buffer_pool_manager);
+      }
+      return NewBPlusTreeIndex<NativeKey<int32_t, 16>, NativeComparator<int32_t, 16>>(buffer_pool_manager);
+    case kKeyFloat:
+      if (meta_data_->GetKeySize() == 8) {
+        return NewBPlusTreeIndex<NativeKey<float, 8>, NativeComparator<float, 8>>(buffer_pool_manager);
+      }
+      return NewBPlusTreeIndex<NativeKey<float, 16>, NativeComparator<float, 16>>(buffer_pool_manager);
+    case kKeyPacked:
+      switch (meta_data_->GetKeySize()) {
+        case 32:
+          return NewBPlusTreeIndex<PackedKey<32>, PackedComparator<32>>(buffer_pool_manager);
+        case 64:
+          return NewBPlusTreeIndex<PackedKey<64>, PackedComparator<64>>(buffer_pool_manager);
+        case 128:
+          return NewBPlusTreeIndex<PackedKey<128>, PackedComparator<128>>(buffer_pool_manager);
+        default:
+          return NewBPlusTreeIndex<PackedKey<256>, PackedComparator<256>>(buffer_pool_manager);
+      }
+    default:
+      break;
+  }
+  switch (meta_data_->GetKeySize()) {
+    case 8:
+      return NewBPlusTreeIndex<GenericKey<8>, GenericComparator<8>>(buffer_pool_manager);
+    case 16:
+      return NewBPlusTreeIndex<GenericKey<16>, GenericComparator<16>>(buffer_pool_manager);
+    case 32:
+      return NewBPlusTreeIndex<GenericKey<32>, GenericComparator<32>>(buffer_pool_manager);
+    case 64:
+      return NewBPlusTreeIndex<GenericKey<64>, GenericComparator<64>>(buffer_pool_manager);
+    default:
+      return NewBPlusTreeIndex<GenericKey<128>, GenericComparator<128>>(buffer_pool_manager);
+  }
+}
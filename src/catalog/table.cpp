@@ -2,7 +2,7 @@
 
 uint32_t TableMetadata::SerializeTo(char *buf) const {
   char *temp = buf;
-  MACH_WRITE_UINT32(temp, TABLE_METADATA_MAGIC_NUM);
+  MACH_WRITE_UINT32(temp, TABLE_METADATA_V2_MAGIC_NUM);
   temp += sizeof(uint32_t);
   MACH_WRITE_UINT32(temp, table_id_);
   temp += sizeof(uint32_t);
@@ -14,12 +14,14 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
   temp += sizeof(int32_t);
   schema_->SerializeTo(temp);
   temp += schema_->GetSerializedSize();
+  MACH_WRITE_INT32(temp, statistics_page_id_);
+  temp += sizeof(int32_t);
   return temp - buf;
 }
 
 uint32_t TableMetadata::GetSerializedSize() const {
   uint32_t re = 0;
-  re += sizeof(uint32_t) * 3 + sizeof(int32_t);
+  re += sizeof(uint32_t) * 3 + sizeof(int32_t) * 2;
   re += sizeof(char) * table_name_.size();
   re += schema_->GetSerializedSize();
   return re;
@@ -35,7 +37,9 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
   std::string table_name;
   page_id_t root_page_id;
   Schema *schema;
-  if (MACH_READ_UINT32(temp) != TABLE_METADATA_MAGIC_NUM) std::cerr << "Magic Num vertification failed" << std::endl;
+  uint32_t magic_num = MACH_READ_UINT32(temp);
+  if (magic_num != TABLE_METADATA_MAGIC_NUM && magic_num != TABLE_METADATA_V2_MAGIC_NUM)
+    std::cerr << "Magic Num vertification failed" << std::endl;
   temp += sizeof(uint32_t);
   table_id = MACH_READ_UINT32(temp);
   temp += sizeof(uint32_t);
@@ -49,6 +53,11 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
   temp += sizeof(int32_t);
   temp += Schema::DeserializeFrom(temp, schema, heap);
   table_meta = ALLOC_P(heap, TableMetadata)(table_id, table_name, root_page_id, schema);
+  // tables written before statistics existed were never analyzed
+  if (magic_num == TABLE_METADATA_V2_MAGIC_NUM) {
+    table_meta->statistics_page_id_ = MACH_READ_INT32(temp);
+    temp += sizeof(int32_t);
+  }
   return temp - buf;
 }
 
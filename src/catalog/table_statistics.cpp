@@ -0,0 +1,195 @@
+#include "catalog/table_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "record/type_kernel.h"
+
+double TableStatistics::ToScalar(const Field &field) {
+  switch (field.GetTypeId()) {
+    case kTypeInt:
+      return TypeKernel<kTypeInt>::Get(field);
+    case kTypeFloat:
+      return TypeKernel<kTypeFloat>::Get(field);
+    default: {
+      // the first bytes as a base 256 fraction, ties beyond them compare equal
+      double scalar = 0, scale = 1;
+      const char *data = field.GetData();
+      for (uint32_t i = 0; i < std::min<uint32_t>(field.GetLength(), 6); i++) {
+        scale /= 256;
+        scalar += static_cast<unsigned char>(data[i]) * scale;
+      }
+      return scalar;
+    }
+  }
+}
+
+TableStatistics *TableStatistics::Collect(TableHeap *table_heap, Schema *schema, MemHeap *heap) {
+  auto *statistics = ALLOC_P(heap, TableStatistics)();
+  uint32_t column_count = schema->GetColumnCount();
+  std::vector<std::vector<double>> values(column_count);
+  std::vector<std::unordered_map<uint64_t, uint32_t>> frequencies(column_count);
+  std::vector<uint32_t> nulls(column_count, 0);
+  auto visit = [&](const RowView &view) {
+    statistics->sample_rows_++;
+    for (uint32_t i = 0; i < column_count; i++) {
+      if (view.IsNull(i)) {
+        nulls[i]++;
+        continue;
+      }
+      Field field = view.GetField(i);
+      values[i].push_back(ToScalar(field));
+      frequencies[i][HashField(field)]++;
+    }
+  };
+  uint32_t sampled = table_heap->SamplePages(SAMPLE_PAGES, visit, statistics->page_count_);
+  if (sampled > 0) {
+    statistics->row_count_ = static_cast<uint64_t>(statistics->sample_rows_) * statistics->page_count_ / sampled;
+  }
+  double scale = statistics->sample_rows_ == 0 ? 0 : double(statistics->row_count_) / statistics->sample_rows_;
+  // every column and its bounds fit into one page
+  const int column_size = (PAGE_SIZE - 5 * static_cast<int>(sizeof(uint32_t))) / std::max<int>(column_count, 1);
+  const int bucket_limit = (column_size - 3 * static_cast<int>(sizeof(uint32_t))) / static_cast<int>(sizeof(double)) - 1;
+  uint32_t buckets = std::max(1, std::min<int>(HISTOGRAM_BUCKETS, bucket_limit));
+  statistics->columns_.resize(column_count);
+  for (uint32_t i = 0; i < column_count; i++) {
+    ColumnStatistics &column = statistics->columns_[i];
+    column.null_count_ = std::lround(nulls[i] * scale);
+    // values seen once stand for the unseen ones, scaled by the sampling
+    // rate (the GEE estimator); a full scan counts exactly
+    uint32_t singles = 0, seen = frequencies[i].size();
+    for (auto &frequency : frequencies[i]) {
+      singles += frequency.second == 1;
+    }
+    double distinct = seen;
+    if (sampled < statistics->page_count_) {
+      distinct = std::sqrt(scale) * singles + (seen - singles);
+    }
+    uint32_t non_null = statistics->row_count_ - std::min(statistics->row_count_, column.null_count_);
+    column.distinct_count_ = std::max<uint32_t>(seen, std::min<double>(std::lround(distinct), non_null));
+    std::vector<double> &sample = values[i];
+    if (sample.empty()) continue;
+    std::sort(sample.begin(), sample.end());
+    uint32_t count = std::min<uint32_t>(buckets, sample.size());
+    for (uint32_t j = 0; j <= count; j++) {
+      column.bounds_.push_back(sample[static_cast<uint64_t>(j) * (sample.size() - 1) / count]);
+    }
+  }
+  return statistics;
+}
+
+uint32_t TableStatistics::SerializeTo(char *buf) const {
+  char *temp = buf;
+  MACH_WRITE_UINT32(temp, TABLE_STATISTICS_MAGIC_NUM);
+  temp += sizeof(uint32_t);
+  MACH_WRITE_UINT32(temp, row_count_);
+  temp += sizeof(uint32_t);
+  MACH_WRITE_UINT32(temp, page_count_);
+  temp += sizeof(uint32_t);
+  MACH_WRITE_UINT32(temp, sample_rows_);
+  temp += sizeof(uint32_t);
+  MACH_WRITE_UINT32(temp, columns_.size());
+  temp += sizeof(uint32_t);
+  for (const auto &column : columns_) {
+    MACH_WRITE_UINT32(temp, column.null_count_);
+    temp += sizeof(uint32_t);
+    MACH_WRITE_UINT32(temp, column.distinct_count_);
+    temp += sizeof(uint32_t);
+    MACH_WRITE_UINT32(temp, column.bounds_.size());
+    temp += sizeof(uint32_t);
+    for (double bound : column.bounds_) {
+      MACH_WRITE_TO(double, temp, bound);
+      temp += sizeof(double);
+    }
+  }
+  return temp - buf;
+}
+
+uint32_t TableStatistics::GetSerializedSize() const {
+  uint32_t re = sizeof(uint32_t) * 5;
+  for (const auto &column : columns_) {
+    re += sizeof(uint32_t) * 3 + sizeof(double) * column.bounds_.size();
+  }
+  return re;
+}
+
+uint32_t TableStatistics::DeserializeFrom(char *buf, TableStatistics *&statistics, MemHeap *heap) {
+  char *temp = buf;
+  if (MACH_READ_UINT32(temp) != TABLE_STATISTICS_MAGIC_NUM) std::cerr << "Magic Num vertification failed" << std::endl;
+  temp += sizeof(uint32_t);
+  statistics = ALLOC_P(heap, TableStatistics)();
+  statistics->row_count_ = MACH_READ_UINT32(temp);
+  temp += sizeof(uint32_t);
+  statistics->page_count_ = MACH_READ_UINT32(temp);
+  temp += sizeof(uint32_t);
+  statistics->sample_rows_ = MACH_READ_UINT32(temp);
+  temp += sizeof(uint32_t);
+  uint32_t column_count = MACH_READ_UINT32(temp);
+  temp += sizeof(uint32_t);
+  statistics->columns_.resize(column_count);
+  for (auto &column : statistics->columns_) {
+    column.null_count_ = MACH_READ_UINT32(temp);
+    temp += sizeof(uint32_t);
+    column.distinct_count_ = MACH_READ_UINT32(temp);
+    temp += sizeof(uint32_t);
+    uint32_t bound_count = MACH_READ_UINT32(temp);
+    temp += sizeof(uint32_t);
+    for (uint32_t i = 0; i < bound_count; i++) {
+      column.bounds_.push_back(MACH_READ_FROM(double, temp));
+      temp += sizeof(double);
+    }
+  }
+  return temp - buf;
+}
+
+double TableStatistics::NullSelectivity(uint32_t column) const {
+  if (row_count_ == 0) return 0;
+  return std::min(1.0, double(columns_[column].null_count_) / row_count_);
+}
+
+double TableStatistics::EqualSelectivity(uint32_t column, const Field &value) const {
+  const std::vector<double> &bounds = columns_[column].bounds_;
+  if (row_count_ == 0 || bounds.empty()) return 0;
+  double x = ToScalar(value);
+  if (x < bounds.front() || x > bounds.back()) return 0;
+  double selectivity = 1.0 / std::max<uint32_t>(columns_[column].distinct_count_, 1);
+  // a value filling whole buckets is more frequent than the average one
+  uint32_t buckets = bounds.size() - 1, spanned = 0;
+  for (uint32_t i = 0; i < buckets; i++) {
+    spanned += bounds[i] == x && bounds[i + 1] == x;
+  }
+  if (buckets > 0) {
+    selectivity = std::max(selectivity, double(spanned) / buckets);
+  }
+  return (1 - NullSelectivity(column)) * std::min(1.0, selectivity);
+}
+
+double TableStatistics::Below(uint32_t column, double value) const {
+  const std::vector<double> &bounds = columns_[column].bounds_;
+  if (bounds.empty() || value <= bounds.front()) return 0;
+  if (value > bounds.back()) return 1;
+  // last bucket starting below value, interpolated inside
+  uint32_t i = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin() - 1;
+  double width = bounds[i + 1] - bounds[i];
+  double inside = width > 0 ? std::min(1.0, (value - bounds[i]) / width) : 1;
+  return (i + inside) / (bounds.size() - 1);
+}
+
+double TableStatistics::RangeSelectivity(uint32_t column, const Field *low, bool low_inclusive, const Field *high,
+                                         bool high_inclusive) const {
+  if (row_count_ == 0 || columns_[column].bounds_.empty()) return 0;
+  double non_null = 1 - NullSelectivity(column);
+  if (non_null <= 0) return 0;
+  // shares of the non-null values cut off below low and kept up to high
+  double from = 0, to = 1;
+  if (low != nullptr) {
+    from = Below(column, ToScalar(*low));
+    if (!low_inclusive) from += EqualSelectivity(column, *low) / non_null;
+  }
+  if (high != nullptr) {
+    to = Below(column, ToScalar(*high));
+    if (high_inclusive) to += EqualSelectivity(column, *high) / non_null;
+  }
+  return non_null * std::max(0.0, std::min(1.0, to - from));
+}
@@ -1,8 +1,22 @@
 #include "executor/execute_engine.h"
+#include "executor/external_sort.h"
+#include "executor/hash_aggregate.h"
+#include "executor/hash_join.h"
+#include "executor/index_join.h"
+#include "executor/parallel_scan.h"
+#include "executor/predicate.h"
+#include "executor/vector_filter.h"
 #include "glog/logging.h"
+#include "record/type_kernel.h"
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <unordered_set>
+#include <cmath>
+#include <iterator>
+#include <functional>
+#include <memory>
+#include <thread>
 ExecuteEngine::ExecuteEngine() {
 
 }
@@ -11,6 +25,19 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
   if (ast == nullptr) {
     return DB_FAILED;
   }
+  switch (ast->type_) {
+    case kNodeDropDB:
+    case kNodeUseDB:
+    case kNodeCreateTable:
+    case kNodeDropTable:
+    case kNodeCreateIndex:
+    case kNodeDropIndex:
+      // what cached statements resolved may be gone
+      catalog_version_++;
+      break;
+    default:
+      break;
+  }
   switch (ast->type_) {
     case kNodeCreateDB:
       return ExecuteCreateDatabase(ast, context);
@@ -50,12 +77,86 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
       return ExecuteExecfile(ast, context);
     case kNodeQuit:
       return ExecuteQuit(ast, context);
+    case kNodeAnalyze:
+      return ExecuteAnalyze(ast, context);
+    case kNodePrepare:
+      return ExecutePrepare(ast, context);
+    case kNodeExecute:
+      return ExecuteExecute(ast, context);
+    case kNodeExplain:
+      return ExecuteExplain(ast, context);
     default:
       break;
   }
   return DB_FAILED;
 }
 
+/**
+ * @return true if sn or its siblings have parameters, which only prepared
+ * statements bind
+ */
+static bool rec_has_parameter(pSyntaxNode sn){
+  for(;sn!=nullptr;sn=sn->next_){
+    if(sn->type_ == kNodePrepare) continue;
+    if(sn->type_ == kNodeParameter || rec_has_parameter(sn->child_)) return true;
+  }
+  return false;
+}
+
+dberr_t ExecuteEngine::ExecuteSql(const char *sql, ExecuteContext *context) {
+  string key;
+  vector<Literal> literals;
+  bool cached = PlanCache::Normalize(sql,key,literals);
+  if(cached){
+    PreparedStatement *statement = plan_cache_.Find(key);
+    if(statement != nullptr) return ExecuteStatement(statement,literals,context);
+  }
+  YY_BUFFER_STATE bp = yy_scan_string(sql);
+  if (bp == nullptr) {
+    LOG(ERROR) << "Failed to create yy buffer state." << std::endl;
+    exit(1);
+  }
+  yy_switch_to_buffer(bp);
+  // init parser module
+  MinisqlParserInit();
+  // parse
+  Explain::Clock::time_point start = Explain::Clock::now();
+  yyparse();
+  context->parse_time_ = Explain::Clock::now() - start;
+  pSyntaxNode ast = MinisqlGetParserRootNode();
+  dberr_t result;
+  if(ast != nullptr && rec_has_parameter(ast)){
+    cout<<"ERROR: Parameters are only allowed in prepared statements"<<endl;
+    result = DB_FAILED;
+  }
+  else if(cached && ast != nullptr && !MinisqlParserGetError()){
+    // the literals of the text become the parameters of the cached copy
+    auto statement = std::make_unique<PreparedStatement>(ast,true);
+    if(statement->GetParameterCount() == literals.size()){
+      result = ExecuteStatement(plan_cache_.Insert(key,std::move(statement)),literals,context);
+    }
+    else result = Execute(ast, context);
+  }
+  else result = Execute(ast, context);
+  // clean memory after parse
+  MinisqlParserFinish();
+  yy_delete_buffer(bp);
+  yylex_destroy();
+  return result;
+}
+
+dberr_t ExecuteEngine::ExecuteStatement(PreparedStatement *statement, const vector<Literal> &literals,
+                                        ExecuteContext *context) {
+  if(!statement->Bind(literals)){
+    cout<<"ERROR: The statement takes "<<statement->GetParameterCount()<<" parameters, "<<literals.size()<<" given"<<endl;
+    return DB_FAILED;
+  }
+  context->statement_ = statement;
+  dberr_t result = Execute(statement->GetTree(), context);
+  context->statement_ = nullptr;
+  return result;
+}
+
 dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteCreateDatabase" << std::endl;
@@ -224,7 +325,9 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
     IndexInfo *indexinfo = nullptr;
     string index_name = table_name + "_pk";
     //cout<<"index_name:"<<index_name<<endl;
-    current_catalog->CreateIndex(table_name, index_name, primary_keys, nullptr, indexinfo);
+    // constraint indexes keep a Bloom filter, lookups of absent keys skip the tree
+    current_catalog->CreateIndex(table_name, index_name, primary_keys, nullptr, indexinfo, true, kIndexBPlusTree, {},
+                                 true);
   }
 
   for(auto r:columns){
@@ -233,7 +336,8 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
       CatalogManager* current_catalog=current_db->catalog_mgr_;
       vector <string>unique_attribute_name = {r->GetName()};
       IndexInfo* indexinfo=nullptr;
-      current_catalog->CreateIndex(table_name,unique_index_name,unique_attribute_name,nullptr,indexinfo);
+      current_catalog->CreateIndex(table_name,unique_index_name,unique_attribute_name,nullptr,indexinfo,true,
+                                   kIndexBPlusTree,{},true);
     }
   }
   return IsCreate;
@@ -279,7 +383,11 @@ dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *conte
     cout << "Indexes of Table " << p->GetTableName() << ":" << endl;
     vector<IndexInfo *> indexes;
     current_db->catalog_mgr_->GetTableIndexes(p->GetTableName(), indexes);
-    for(auto q:indexes) cout << q->GetIndexName() << endl;
+    for(auto q:indexes){
+      cout << q->GetIndexName();
+      if(q->GetIndexMethod() == kIndexHash) cout << " (hash)";
+      cout << endl;
+    }
   }
   return DB_SUCCESS;
 }
@@ -294,6 +402,8 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   current_catalog->GetTable(table_name, tableinfo);
   //����֪����Ҫ����������ÿ��key�����֣�ͨ���������ж���Щkey�Ƿ�unique����һ�����ǾͲ��ܽ�������
   pSyntaxNode key_name=ast->child_->next_->next_->child_;//���ǵ�һ������
+  // keys containing a unique column are unique, any other index allows duplicates
+  bool unique = false;
   for(;key_name!=nullptr;key_name=key_name->next_){
     uint32_t key_index;//������ǵڼ���??
     dberr_t IsIn = tableinfo->GetSchema()->GetColumnIndex(key_name->val_,key_index);
@@ -302,10 +412,7 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
       return DB_FAILED;
     }
     const Column* ky=tableinfo->GetSchema()->GetColumn(key_index);
-    if(ky->IsUnique()==false){
-      cout<<"Can't Create Index On Non-unique Key!"<<endl;
-      return DB_FAILED;
-    }
+    unique = unique || ky->IsUnique();
   }
   vector <string> index_keys;
   //�õ�index_key�ĵ�һ�����???
@@ -313,17 +420,56 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   for(;index_key!=nullptr;index_key=index_key->next_){
     index_keys.push_back(index_key->val_);
   }
+  // optional INCLUDE (columns) then USING type follow the key columns
+  pSyntaxNode index_type=nullptr;
+  vector <string> include_keys;
+  for(pSyntaxNode option=ast->child_->next_->next_->next_;option!=nullptr;option=option->next_){
+    if(option->type_==kNodeIndexType){
+      index_type=option;
+      continue;
+    }
+    for(pSyntaxNode include_key=option->child_;include_key!=nullptr;include_key=include_key->next_){
+      uint32_t include_index;
+      if(tableinfo->GetSchema()->GetColumnIndex(include_key->val_,include_index)!=DB_SUCCESS){
+        cout<<"Attribute "<<include_key->val_<<" Isn't in The Table!"<<endl;
+        return DB_FAILED;
+      }
+      include_keys.push_back(include_key->val_);
+    }
+  }
+  // USING hash builds an extendible hash index, btree or no USING a B+ tree
+  IndexMethod method = kIndexBPlusTree;
+  if(index_type!=nullptr && index_type->child_!=nullptr){
+    string type_name=index_type->child_->val_;
+    std::transform(type_name.begin(),type_name.end(),type_name.begin(),::tolower);
+    if(type_name=="hash"){
+      method = kIndexHash;
+    }
+    else if(type_name!="btree" && type_name!="bplustree"){
+      cout<<"Unknown Index Type "<<index_type->child_->val_<<"!"<<endl;
+      return DB_FAILED;
+    }
+  }
+  if(method!=kIndexBPlusTree && !include_keys.empty()){
+    cout<<"INCLUDE Is Only Supported By B+ Tree Indexes!"<<endl;
+    return DB_FAILED;
+  }
   IndexInfo* indexinfo=nullptr;
   string index_name = ast->child_->val_;
-  dberr_t IsCreate=current_catalog->CreateIndex(table_name,index_name,index_keys,nullptr,indexinfo);
+  dberr_t IsCreate=current_catalog->CreateIndex(table_name,index_name,index_keys,nullptr,indexinfo,unique,method,include_keys,true);
   if(IsCreate==DB_TABLE_NOT_EXIST){
     cout<<"Table Not Exist!"<<endl;
   }
   if(IsCreate==DB_INDEX_ALREADY_EXIST){
     cout<<"Index Already Exist!"<<endl;
   }
+  if(IsCreate!=DB_SUCCESS){
+    return IsCreate;
+  }
 
   TableHeap* tableheap = tableinfo->GetTableHeap();
+  // entries of covering indexes also carry the included columns
+  index_keys.insert(index_keys.end(),include_keys.begin(),include_keys.end());
   vector<uint32_t>index_column_number;
   for (auto r = index_keys.begin(); r != index_keys.end() ; r++ ){//�������Ե�����
     uint32_t index ;
@@ -331,14 +477,19 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
     index_column_number.push_back(index);
   }
   vector<Field>fields;
-  for (auto iter=tableheap->Begin(nullptr) ; iter!= tableheap->End(); iter++) {
-    Row &it_row = *iter;
+  for (auto iter=tableheap->Begin(nullptr) ; iter!= tableheap->End(); ++iter) {
+    // key fields are read straight from the pinned tuple, the row is never materialized
+    const RowView &view = iter.GetRowView();
     vector<Field> index_fields;
     for (auto m=index_column_number.begin();m!=index_column_number.end();m++){
-      index_fields.push_back(*(it_row.GetField(*m)));//�õ���row��Ӧ�������Ե�ֵ
+      index_fields.push_back(view.GetField(*m));//�õ���row��Ӧ�������Ե�ֵ
+    }
+    Row index_row(std::move(index_fields));
+    if(indexinfo->GetIndex()->InsertEntry(index_row,view.GetRowId(),nullptr)!=DB_SUCCESS){
+      cout<<"Failed To Build Index, Duplicate Or Too Long Key!"<<endl;
+      current_catalog->DropIndex(table_name,index_name);
+      return DB_FAILED;
     }
-    Row index_row(index_fields);
-    indexinfo->GetIndex()->InsertEntry(index_row,it_row.GetRowId(),nullptr);
   }
   return IsCreate;
   //return DB_FAILED;
@@ -380,399 +531,1070 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
   return DB_FAILED;
 }
 
-vector<Row*> rec_sel(pSyntaxNode sn, std::vector<Row*>& r, TableInfo* t, CatalogManager* c){
-  if(sn == nullptr) return r;
+/**
+ * RowView accessors over a materialized row, so that rows fetched through an
+ * index are checked by the same code as tuples of a heap scan
+ */
+class RowFields {
+public:
+  explicit RowFields(const Row &row) : row_(row) {}
+
+  inline bool IsNull(uint32_t idx) const { return row_.GetField(idx)->IsNull(); }
+
+  inline int32_t GetInt(uint32_t idx) const { return TypeKernel<kTypeInt>::Get(*row_.GetField(idx)); }
+
+  inline float GetFloat(uint32_t idx) const { return TypeKernel<kTypeFloat>::Get(*row_.GetField(idx)); }
+
+  inline const char *GetChars(uint32_t idx, uint32_t *len) const {
+    *len = row_.GetField(idx)->GetLength();
+    return TypeKernel<kTypeChar>::Get(*row_.GetField(idx));
+  }
+
+private:
+  const Row &row_;
+};
+
+/**
+ * Columns of a single table, a qualified column must name the table
+ */
+struct TableScope {
+  TableInfo *table;
+
+  bool Resolve(pSyntaxNode column, uint32_t &index, TypeId &type) const {
+    if(column->child_ != nullptr && table->GetTableName() != column->child_->val_) return false;
+    if(table->GetSchema()->GetColumnIndex(column->val_, index)!=DB_SUCCESS) return false;
+    type = table->GetSchema()->GetColumn(index)->GetType();
+    return true;
+  }
+
+  vector<TypeId> Types() const {
+    vector<TypeId> types;
+    for(auto column:table->GetSchema()->GetColumns()) types.push_back(column->GetType());
+    return types;
+  }
+};
+
+/**
+ * Literal val as a constant of type, chars pointing into val. Numbers
+ * truncate toward zero into an int, which keeps inclusive bounds on ints
+ * from leaving out any of the values they take.
+ */
+static Field rec_constant(const char *val, TypeId type){
+  if(type==kTypeInt) return Field(type,int32_t(std::max<double>(INT32_MIN,std::min<double>(INT32_MAX,atof(val)))));
+  if(type==kTypeFloat) return Field(type,float(atof(val)));
+  return Field(type,const_cast<char *>(val),strlen(val),false);
+}
+
+/**
+ * Operator of compare operator op
+ * @return false if op is no comparison
+ */
+static bool rec_compare_op(const char *op, CompareOp &compare){
+  static const std::pair<const char *, CompareOp> ops[] = {
+      {"=", kCompareEqual}, {"<>", kCompareNotEqual}, {"<", kCompareLess},
+      {">", kCompareGreater}, {"<=", kCompareLessEqual}, {">=", kCompareGreaterEqual}};
+  for(auto &entry:ops){
+    if(strcmp(op,entry.first) == 0){
+      compare = entry.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Node of predicate comparing column, of type, to literal value converted to
+ * the column type, except a number compared with an int column, which keeps
+ * its fraction. A null literal never holds.
+ */
+static uint32_t rec_compile_value(pSyntaxNode value, uint32_t column, TypeId type, CompareOp op,
+                                  Predicate &predicate){
+  if(value->val_ == nullptr) return predicate.AddConstant(false);
+  if(value->type_ == kNodeNumber && type == kTypeInt) return predicate.AddCompareNumber(column,op,atof(value->val_));
+  return predicate.AddCompare(column,op,rec_constant(value->val_,type));
+}
+
+/**
+ * Compile condition tree sn into nodes of predicate, its columns resolved
+ * in scope to ordinals and its literals compiled by rec_compile_value. The
+ * parameters of statement, if sn is of its tree, are left for rec_bind. A
+ * column not found or an unknown operator never holds.
+ * @return the root node
+ */
+template<typename S>
+static uint32_t rec_compile(pSyntaxNode sn, const S &scope, Predicate &predicate,
+                            const PreparedStatement *statement = nullptr){
   if(sn->type_ == kNodeConnector){
-    
-    vector<Row*> ans;
-    if(strcmp(sn->val_,"and") == 0){
-      auto r1 = rec_sel(sn->child_,r,t,c);
-      ans = rec_sel(sn->child_->next_,r1,t,c);
-      return ans;
-    }
-    else if(strcmp(sn->val_,"or") == 0){
-      auto r1 = rec_sel(sn->child_,r,t,c);
-      auto r2 = rec_sel(sn->child_->next_,r,t,c);
-      for(uint32_t i=0;i<r1.size();i++){
-        ans.push_back(r1[i]);        
-      }
-      for(uint32_t i=0;i<r2.size();i++){
-        int flag=1;//û���ظ�
-        for(uint32_t j=0;j<r1.size();j++){
-          int f=1;
-          for(uint32_t k=0;k<r1[i]->GetFieldCount();k++){
-            if(!r1[i]->GetField(k)->CompareEquals(*r2[j]->GetField(k))){
-              f=0;break;
-            }
-          }
-          if(f==1){
-            flag=0;//���ظ�
-            break;}
-        }
-        if(flag==1) ans.push_back(r2[i]);        
-      } 
-      return ans;
+    bool conjunction = strcmp(sn->val_,"and") == 0;
+    if(!conjunction && strcmp(sn->val_,"or") != 0) return predicate.AddConstant(false);
+    uint32_t lhs = rec_compile(sn->child_,scope,predicate,statement);
+    return predicate.AddConnector(conjunction,lhs,rec_compile(sn->child_->next_,scope,predicate,statement));
+  }
+  uint32_t column, other;
+  TypeId type, other_type;
+  if(sn->type_ != kNodeCompareOperator || !scope.Resolve(sn->child_,column,type)){
+    return predicate.AddConstant(false);
+  }
+  if(strcmp(sn->val_,"is") == 0) return predicate.AddNullTest(column,true);
+  if(strcmp(sn->val_,"not") == 0) return predicate.AddNullTest(column,false);
+  CompareOp op;
+  pSyntaxNode value = sn->child_->next_;
+  if(!rec_compare_op(sn->val_,op)) return predicate.AddConstant(false);
+  if(value->type_ == kNodeIdentifier){
+    if(!scope.Resolve(value,other,other_type)) return predicate.AddConstant(false);
+    return predicate.AddCompareColumns(column,op,other);
+  }
+  uint32_t slot;
+  if(statement != nullptr && statement->FindParameter(value,slot)) return predicate.AddParameter(column,op,slot);
+  return rec_compile_value(value,column,type,op,predicate);
+}
+
+/**
+ * Compile the conjuncts of a condition on rows whose columns scope resolves,
+ * once per query instead of walking the syntax tree for every row, or once
+ * for all the executions of statement if the condition is of its tree
+ */
+template<typename S>
+static Predicate rec_predicate(const vector<pSyntaxNode> &conjuncts, const S &scope,
+                               const PreparedStatement *statement = nullptr){
+  Predicate predicate(scope.Types());
+  for(auto conjunct:conjuncts) predicate.AddConjunct(rec_compile(conjunct,scope,predicate,statement));
+  return predicate;
+}
+
+/**
+ * Bind the parameters of predicate, compiled from the tree of statement, to
+ * the literals bound to the statement last
+ */
+static void rec_bind(Predicate &predicate, const PreparedStatement &statement){
+  for(uint32_t i=0;i<predicate.GetParameters().size();i++){
+    Predicate::Parameter parameter = predicate.GetParameters()[i];
+    TypeId type = predicate.GetColumnType(parameter.column_);
+    pSyntaxNode value = statement.GetParameter(parameter.slot_);
+    predicate.BindParameter(i,rec_compile_value(value,parameter.column_,type,parameter.op_,predicate));
+  }
+}
+
+/**
+ * @return true if compare operator sn has a constant, non-null right-hand side
+ */
+static inline bool rec_is_constant(pSyntaxNode sn){
+  pSyntaxNode value = sn->child_->next_;
+  return value->type_ != kNodeIdentifier && value->val_ != nullptr;
+}
+
+/**
+ * Single field key of the compare value of sn, typed as column keymap
+ */
+static Row rec_compare_key(pSyntaxNode sn, TableInfo* t, uint32_t keymap){
+  vector<Field> bound{rec_constant(sn->child_->next_->val_,t->GetSchema()->GetColumn(keymap)->GetType())};
+  return Row(std::move(bound));
+}
+
+/**
+ * Single-column index on column name, a hash index only if equality_only
+ * @return null if the table has none
+ */
+static IndexInfo *rec_find_index(const char *name, bool equality_only, TableInfo* t, CatalogManager* c){
+  vector<IndexInfo*> indexes;
+  c->GetTableIndexes(t->GetTableName(),indexes);
+  // a hash index answers equality in one bucket, ranges need a B+ tree
+  IndexInfo *index = nullptr;
+  for(auto p:indexes){
+    if(p->GetKeyColumnCount()!=1 || p->GetIndexKeySchema()->GetColumns()[0]->GetName()!=name){
+      continue;
+    }
+    if(p->GetIndexMethod() == kIndexHash){
+      if(!equality_only) continue;
+      return p;
     }
+    if(index == nullptr) index = p;
   }
-  if(sn->type_ == kNodeCompareOperator){
-    string op = sn->val_;//operation type
-    string col_name = sn->child_->val_;//column name
-    string val = sn->child_->next_->val_;//compare value
+  return index;
+}
+
+/**
+ * Collect the equalities of a disjunction comparing one column to constants
+ * @return false if sn is anything else
+ */
+static bool rec_equal_disjuncts(pSyntaxNode sn, vector<pSyntaxNode> &equals){
+  if(sn->type_ == kNodeConnector){
+    return strcmp(sn->val_,"or") == 0 && rec_equal_disjuncts(sn->child_,equals) &&
+           rec_equal_disjuncts(sn->child_->next_,equals);
+  }
+  if(sn->type_ != kNodeCompareOperator || strcmp(sn->val_,"=") != 0 || !rec_is_constant(sn)){
+    return false;
+  }
+  if(!equals.empty() && strcmp(equals[0]->child_->val_,sn->child_->val_) != 0) return false;
+  equals.push_back(sn);
+  return true;
+}
+
+/**
+ * Index answering sn on its own, a compare operator on an indexed column or
+ * a disjunction of equalities on one
+ * @return null if no index applies
+ */
+static IndexInfo *rec_match_index(pSyntaxNode sn, TableInfo* t, CatalogManager* c){
+  vector<pSyntaxNode> equals;
+  if(sn->type_ == kNodeConnector){
+    if(!rec_equal_disjuncts(sn,equals)) return nullptr;
+    return rec_find_index(equals[0]->child_->val_,true,t,c);
+  }
+  if(sn->type_ != kNodeCompareOperator || !rec_is_constant(sn)) return nullptr;
+  string op = sn->val_;
+  if(op != "=" && op != "<" && op != "<=" && op != ">" && op != ">=") return nullptr;
+  return rec_find_index(sn->child_->val_,op == "=",t,c);
+}
+
+/**
+ * Row ids index gives for sn, which rec_match_index matched it to. A
+ * disjunction of equalities probes all its keys in one batch. Index bounds
+ * are inclusive, the rows still need to be checked on the condition.
+ * @return false if the index turns the scan down
+ */
+static bool rec_index_rids(pSyntaxNode sn, IndexInfo *index, TableInfo* t, vector<RowId> &rids){
+  vector<pSyntaxNode> equals;
+  if(sn->type_ == kNodeConnector && rec_equal_disjuncts(sn,equals)){
     uint32_t keymap;
-    vector<Row*> ans;
-    if(t->GetSchema()->GetColumnIndex(col_name, keymap)!=DB_SUCCESS){
-      cout<<"column not found"<<endl;
-      return ans;
-    }
-    const Column* key_col = t->GetSchema()->GetColumn(keymap);
-    TypeId type =  key_col->GetType();
-
-    if(op == "="){
-      if(type==kTypeInt)
-      {  
-        int valint = std::stoi(val);
-        Field benchmk(type,int(valint));
-        vector<Field> vect_benchmk;
-        vect_benchmk.push_back(benchmk);
-
-        vector <IndexInfo*> indexes;
-        c->GetTableIndexes(t->GetTableName(),indexes);
-        for(auto p=indexes.begin();p<indexes.end();p++){
-            if((*p)->GetIndexKeySchema()->GetColumnCount()==1){
-              if((*p)->GetIndexKeySchema()->GetColumns()[0]->GetName()==col_name){
-                cout<<"--select using index--"<<endl;
-                Row tmp_row(vect_benchmk);
-                vector<RowId> result;
-                (*p)->GetIndex()->ScanKey(tmp_row,result,nullptr);
-                for(auto q:result){
-                  if(q.GetPageId()<0) continue;
-                  Row *tr = new Row(q);
-                  t->GetTableHeap()->GetTuple(tr,nullptr);
-                  ans.push_back(tr);
-                }
-                return ans;
-              }
-            }
-        }   
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareEquals(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
-      
-      else if(type==kTypeFloat)
-      {  
-        float valfloat = std::stof(val);
-        Field benchmk(type,float(valfloat));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareEquals(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
+    if(t->GetSchema()->GetColumnIndex(equals[0]->child_->val_, keymap)!=DB_SUCCESS) return false;
+    vector<Row> keys;
+    for(auto equal:equals) keys.push_back(rec_compare_key(equal,t,keymap));
+    vector<vector<RowId>> result;
+    if(index->GetIndex()->ScanKeys(keys,result,nullptr) == DB_FAILED) return false;
+    // a key listed twice finds its rows twice
+    std::unordered_set<int64_t> fetched;
+    for(auto &key_rids:result){
+      for(auto rid:key_rids){
+        if(rid.GetPageId()>=0 && fetched.insert(rid.Get()).second) rids.push_back(rid);
       }
+    }
+    return true;
+  }
+  string op = sn->val_;
+  uint32_t keymap;
+  if(t->GetSchema()->GetColumnIndex(sn->child_->val_, keymap)!=DB_SUCCESS) return false;
+  Row key = rec_compare_key(sn,t,keymap);
+  const Row *low = (op == "=" || op == ">" || op == ">=") ? &key : nullptr;
+  const Row *high = (op == "=" || op == "<" || op == "<=") ? &key : nullptr;
+  vector<RowId> result;
+  dberr_t status = op == "=" ? index->GetIndex()->ScanKey(key,result,nullptr)
+                             : index->GetIndex()->ScanRange(low,high,result,nullptr);
+  if(status == DB_FAILED) return false;
+  for(auto rid:result){
+    if(rid.GetPageId()>=0) rids.push_back(rid);
+  }
+  return true;
+}
 
-      else if(type==kTypeChar){
-        char *ch = new char[val.size()];
-        strcpy(ch,val.c_str());//input compare object
-        // cout<<"ch "<<sizeof(ch)<<endl;
-        Field benchmk = Field(TypeId::kTypeChar, const_cast<char *>(ch), val.size(), true);
-        // Field benchmk(kTypeChar,ch,key_col->GetLength(),true);
-        vector<Field> vect_benchmk;
-        vect_benchmk.push_back(benchmk);
-
-        vector <IndexInfo*> indexes;
-        c->GetTableIndexes(t->GetTableName(),indexes);
-        for(auto p=indexes.begin();p<indexes.end();p++){
-            if((*p)->GetIndexKeySchema()->GetColumnCount()==1){
-              if((*p)->GetIndexKeySchema()->GetColumns()[0]->GetName()==col_name){
-                
-                cout<<"--select using index--"<<endl;
-                Row tmp_row(vect_benchmk);
-                vector<RowId> result;
-                (*p)->GetIndex()->ScanKey(tmp_row,result,nullptr);
-                for(auto q:result){
-                  if(q.GetPageId()<0) continue;
-                  // cout<<"index found"<<endl;
-                  Row *tr = new Row(q);
-                  t->GetTableHeap()->GetTuple(tr,nullptr);
-                  ans.push_back(tr);
-                }
-                return ans;
-              }
-            }
-        } 
-
-        for(uint32_t i=0;i<r.size();i++){
-          const char* test = r[i]->GetField(keymap)->GetData();
-          
-          if(strcmp(test,ch)==0){
-            vector<Field> f;
-            for(auto it:r[i]->GetFields()){
-              f.push_back(*it);
-            }
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
+/**
+ * Flatten the nested "and" connectors of sn
+ */
+static void rec_conjuncts(pSyntaxNode sn, vector<pSyntaxNode> &conjuncts){
+  if(sn->type_ == kNodeConnector && strcmp(sn->val_,"and") == 0){
+    rec_conjuncts(sn->child_,conjuncts);
+    rec_conjuncts(sn->child_->next_,conjuncts);
+    return;
+  }
+  conjuncts.push_back(sn);
+}
+
+/**
+ * Read the rows of rids from the table heap one at a time, visiting those
+ * predicate selects until visit returns false. A visited row is only valid
+ * during the call.
+ * @return false if visit stopped the fetches
+ */
+static bool rec_fetch(const Predicate &predicate, const vector<RowId> &rids, TableInfo* t,
+                      const std::function<bool(const Row &)> &visit){
+  ArenaMemHeap arena;
+  Row row(RowId(), &arena);
+  for(auto rid:rids){
+    row.Reset(rid);
+    arena.Reset();
+    if(t->GetTableHeap()->GetTuple(&row,nullptr) && predicate.Match(RowFields(row)) && !visit(row)) return false;
+  }
+  return true;
+}
+
+/**
+ * Tell the access path a select takes: explain operator id is named after
+ * it, without an explain a note is printed
+ */
+static void rec_note_path(Explain *explain, uint32_t id, const char *note, const string &path){
+  if(explain != nullptr) explain->SetName(id,path);
+  else cout<<"--select using "<<note<<"--"<<endl;
+}
+
+/**
+ * Row ids answering the conjuncts of a condition through a single-column
+ * index on the first one an index applies to, the rows still need to be
+ * checked on all the conjuncts. Explain operator id is named after the
+ * access path.
+ * @return false if no index applies
+ */
+static bool rec_index_scan(const vector<pSyntaxNode> &conjuncts, TableInfo* t, CatalogManager* c,
+                           vector<RowId> &rids, Explain *explain, uint32_t id){
+  for(auto conjunct:conjuncts){
+    IndexInfo *index = rec_match_index(conjunct,t,c);
+    if(index == nullptr) continue;
+    string path = "Index Scan on " + t->GetTableName() + " using " + index->GetIndexName();
+    // a plain EXPLAIN takes the index without probing it
+    if(explain != nullptr && !explain->IsAnalyze()){
+      explain->SetName(id,path);
+      return true;
     }
-    else if(op == "<"){
-      if(type==kTypeInt)
-      {  
-        int valint = std::stoi(val);
-        Field benchmk(type,int(valint));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareLessThan(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
-      else if(type==kTypeFloat)
-      {  
-        float valfloat = std::stof(val);
-        Field benchmk(type,float(valfloat));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareLessThan(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
-      else if(type==kTypeChar){
-        char* ch = new char[key_col->GetLength()+2];
-        strcpy(ch,val.c_str());
-        for(uint32_t i=0;i<r.size();i++){
-          const char* test = r[i]->GetField(keymap)->GetData();
-          if(strcmp(test,ch)<0){
-            vector<Field> f;
-            for(auto it:r[i]->GetFields()){
-              f.push_back(*it);
-            }
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
+    if(rec_index_rids(conjunct,index,t,rids)){
+      rec_note_path(explain,id,"index",path);
+      if(explain != nullptr) explain->Count(id,rids.size(),0);
+      return true;
     }
-    else if(op == ">"){
-      if(type==kTypeInt)
-      {  
-        int valint = std::stoi(val);
-        Field benchmk(type,int(valint));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareGreaterThan(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
-      else if(type==kTypeFloat)
-      {  
-        float valfloat = std::stof(val);
-        Field benchmk(type,float(valfloat));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareGreaterThan(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
-      else if(type==kTypeChar){
-        char* ch = new char[key_col->GetLength()];
-        strcpy(ch,val.c_str());//�Ƚ�Ŀ�����ch��
-
-        for(uint32_t i=0;i<r.size();i++){
-          const char* test = r[i]->GetField(keymap)->GetData();
-          
-          if(strcmp(test,ch)>0){
-            vector<Field> f;
-            for(auto it:r[i]->GetFields()){
-              f.push_back(*it);
-            }
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
+  }
+  return false;
+}
+
+/**
+ * Planner costs, in units of one sequential page read. An index probe
+ * descends through mostly cached inner pages, heap pages reached through an
+ * index are read in random order.
+ */
+static constexpr double SEQ_PAGE_COST = 1.0;
+static constexpr double RANDOM_PAGE_COST = 4.0;
+static constexpr double INDEX_PROBE_COST = 2.0;
+static constexpr double CPU_TUPLE_COST = 0.01;
+static constexpr double CPU_INDEX_TUPLE_COST = 0.005;
+static constexpr double CPU_OPERATOR_COST = 0.0025;
+// a guess for what the statistics cannot tell, eg: comparing two columns
+static constexpr double DEFAULT_SELECTIVITY = 1.0 / 3;
+// heap scans keep the pages of one batch of tuples pinned, at most these many
+static constexpr uint32_t SCAN_BATCH_PAGES = 16;
+// analyzed tables of this many pages are scanned by up to MAX_SCAN_WORKERS threads
+static constexpr uint32_t PARALLEL_SCAN_PAGES = 256;
+static constexpr uint32_t MAX_SCAN_WORKERS = 8;
+
+/**
+ * Fraction of the rows of the table satisfying sn, conjuncts and disjuncts
+ * taken as independent
+ */
+static double rec_selectivity(pSyntaxNode sn, TableInfo* t, const TableStatistics *stats){
+  if(sn == nullptr) return 1;
+  if(sn->type_ == kNodeConnector){
+    double left = rec_selectivity(sn->child_,t,stats), right = rec_selectivity(sn->child_->next_,t,stats);
+    if(strcmp(sn->val_,"and") == 0) return left * right;
+    return left + right - left * right;
+  }
+  uint32_t keymap;
+  if(sn->type_ != kNodeCompareOperator || t->GetSchema()->GetColumnIndex(sn->child_->val_, keymap)!=DB_SUCCESS){
+    return 0;
+  }
+  string op = sn->val_;
+  if(op == "is") return stats->NullSelectivity(keymap);
+  if(op == "not") return 1 - stats->NullSelectivity(keymap);
+  if(sn->child_->next_->type_ == kNodeIdentifier) return DEFAULT_SELECTIVITY;
+  if(sn->child_->next_->val_ == nullptr) return 0;
+  Row key = rec_compare_key(sn,t,keymap);
+  const Field *value = key.GetField(0);
+  if(op == "=") return stats->EqualSelectivity(keymap,*value);
+  if(op == "<>") return std::max(0.0, 1 - stats->NullSelectivity(keymap) - stats->EqualSelectivity(keymap,*value));
+  if(op == "<" || op == "<=") return stats->RangeSelectivity(keymap,nullptr,false,value,op == "<=");
+  if(op == ">" || op == ">=") return stats->RangeSelectivity(keymap,value,op == ">=",nullptr,false);
+  return 1;
+}
+
+/**
+ * Expected cost of fetching rows by row id from a table of pages, the pages
+ * hit at least once (Cardenas' formula) are each read at random
+ */
+static double rec_fetch_cost(double rows, double pages){
+  return RANDOM_PAGE_COST * pages * (1 - std::exp(-rows / pages)) + CPU_TUPLE_COST * rows;
+}
+
+/**
+ * Access path of a filtered scan: the heap, one index, or the intersection
+ * of the row ids of two indexes
+ */
+struct ScanPlan {
+  vector<pSyntaxNode> conjuncts;  /** answered by indexes, empty for a heap scan */
+  vector<IndexInfo*> indexes;
+  double cost;
+};
+
+/**
+ * Cheapest access path for the conjuncts of a condition under the statistics
+ * of the table
+ */
+static ScanPlan rec_plan_scan(const vector<pSyntaxNode> &conjuncts, TableInfo* t, CatalogManager* c,
+                              const TableStatistics *stats){
+  double rows = stats->GetRowCount(), pages = std::max<uint32_t>(stats->GetPageCount(), 1);
+  ScanPlan plan{{}, {}, SEQ_PAGE_COST * pages + CPU_TUPLE_COST * rows};
+  struct IndexPath {
+    pSyntaxNode conjunct;
+    IndexInfo *index;
+    double entries;
+    double probe_cost;
+  };
+  vector<IndexPath> paths;
+  for(auto conjunct:conjuncts){
+    IndexInfo *index = rec_match_index(conjunct,t,c);
+    if(index == nullptr) continue;
+    vector<pSyntaxNode> equals;
+    double probes = conjunct->type_ == kNodeConnector && rec_equal_disjuncts(conjunct,equals) ? equals.size() : 1;
+    double entries = rows * rec_selectivity(conjunct,t,stats);
+    paths.push_back({conjunct, index, entries, INDEX_PROBE_COST * probes + CPU_INDEX_TUPLE_COST * entries});
+    double cost = paths.back().probe_cost + rec_fetch_cost(entries,pages);
+    if(cost < plan.cost){
+      plan.conjuncts = {conjunct};
+      plan.indexes = {index};
+      plan.cost = cost;
     }
-    else if(op == "<="){
-      if(type==kTypeInt)
-      {  
-        int valint = std::stoi(val);
-        Field benchmk(type,int(valint));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareLessThanEquals(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
-      else if(type==kTypeFloat)
-      {  
-        float valfloat = std::stof(val);
-        Field benchmk(type,float(valfloat));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareLessThanEquals(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
-      else if(type==kTypeChar){
-        char* ch = new char[key_col->GetLength()];
-        strcpy(ch,val.c_str());//�Ƚ�Ŀ�����ch��
-
-        for(uint32_t i=0;i<r.size();i++){
-          const char* test = r[i]->GetField(keymap)->GetData();
-          
-          if(strcmp(test,ch)<=0){
-            vector<Field> f;
-            for(auto it:r[i]->GetFields()){
-              f.push_back(*it);
-            }
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
+  }
+  // the two most selective paths on distinct indexes, their row ids sorted and intersected
+  std::sort(paths.begin(),paths.end(),[](const IndexPath &a, const IndexPath &b){ return a.entries < b.entries; });
+  for(uint32_t i=1;i<paths.size();i++){
+    if(paths[i].index == paths[0].index) continue;
+    auto sort_cost = [](double n){ return n > 1 ? CPU_OPERATOR_COST * n * std::log2(n) : 0; };
+    double matched = rows > 0 ? paths[0].entries * paths[i].entries / rows : 0;
+    double cost = paths[0].probe_cost + paths[i].probe_cost + sort_cost(paths[0].entries) +
+                  sort_cost(paths[i].entries) + rec_fetch_cost(matched,pages);
+    if(cost < plan.cost){
+      plan.conjuncts = {paths[0].conjunct, paths[i].conjunct};
+      plan.indexes = {paths[0].index, paths[i].index};
+      plan.cost = cost;
     }
-    else if(op == ">="){
-      if(type==kTypeInt)
-      {  
-        int valint = std::stoi(val);
-        Field benchmk(type,int(valint));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareGreaterThanEquals(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
-      }
-      else if(type==kTypeFloat)
-      {  
-        float valfloat = std::stof(val);
-        Field benchmk(type,float(valfloat));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareGreaterThanEquals(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
+    break;
+  }
+  return plan;
+}
+
+/**
+ * Row ids answering the conjuncts of a condition on an analyzed table
+ * through the access path of rec_plan_scan, the rows still need to be
+ * checked on all of them. Explain operator id is named after the access path.
+ * @return false if a heap scan is cheaper
+ */
+static bool rec_planned_scan(const vector<pSyntaxNode> &conjuncts, TableInfo* t, CatalogManager* c,
+                             const TableStatistics *stats, vector<RowId> &rids, Explain *explain, uint32_t id){
+  if(conjuncts.empty()) return false;
+  ScanPlan plan = rec_plan_scan(conjuncts,t,c,stats);
+  if(plan.conjuncts.empty()) return false;
+  string single = "Index Scan on " + t->GetTableName() + " using " + plan.indexes[0]->GetIndexName();
+  string path = plan.conjuncts.size() < 2 ? single : "Index Intersection on " + t->GetTableName() + " using " +
+                                                     plan.indexes[0]->GetIndexName() + " and " +
+                                                     plan.indexes[1]->GetIndexName();
+  // a plain EXPLAIN takes the plan without probing the indexes
+  if(explain != nullptr && !explain->IsAnalyze()){
+    explain->SetName(id,path);
+    return true;
+  }
+  vector<RowId> other;
+  if(!rec_index_rids(plan.conjuncts[0],plan.indexes[0],t,rids)) return false;
+  auto by_rid = [](const RowId &a, const RowId &b){ return a.Get() < b.Get(); };
+  if(plan.conjuncts.size() == 2 && rec_index_rids(plan.conjuncts[1],plan.indexes[1],t,other)){
+    rec_note_path(explain,id,"index intersection",path);
+    if(explain != nullptr) explain->Count(id,rids.size() + other.size(),0);
+    std::sort(rids.begin(),rids.end(),by_rid);
+    std::sort(other.begin(),other.end(),by_rid);
+    vector<RowId> both;
+    std::set_intersection(rids.begin(),rids.end(),other.begin(),other.end(),std::back_inserter(both),by_rid);
+    rids.swap(both);
+  }
+  else{
+    rec_note_path(explain,id,"index",single);
+    if(explain != nullptr) explain->Count(id,rids.size(),0);
+  }
+  return true;
+}
+
+/**
+ * Worker threads for a heap scan, one unless the table is analyzed and large
+ * enough to pay for starting them
+ */
+static uint32_t rec_scan_workers(const TableStatistics *stats){
+  if(stats == nullptr || stats->GetPageCount() < PARALLEL_SCAN_PAGES) return 1;
+  uint32_t morsels = stats->GetPageCount() / ParallelScan::DEFAULT_MORSEL_PAGES;
+  return std::min({std::thread::hardware_concurrency(), MAX_SCAN_WORKERS, morsels});
+}
+
+/**
+ * Visit the rows of t satisfying every conjunct. Analyzed tables take the
+ * cheapest access path, others any index that applies; heap scans filter
+ * batches of tuples with a vector filter and only materialize the matches,
+ * large analyzed tables on several threads.
+ * A visited row is only valid during the call, the scan stops once visit
+ * returns false. Under an explain the scan is an operator below parent; a
+ * plain EXPLAIN reads nothing. Compiled, if given, is the conjuncts
+ * compiled already.
+ * @return false if a page of the table could not be fetched, every frame of
+ * the buffer pool being pinned
+ */
+static bool rec_scan_each(const vector<pSyntaxNode> &conjuncts, TableInfo* t, CatalogManager* c,
+                          const std::function<bool(const Row &)> &visit, Explain *explain = nullptr,
+                          uint32_t parent = Explain::NO_OPERATOR, const Predicate *compiled = nullptr){
+  Predicate predicate = compiled != nullptr ? Predicate({}) : rec_predicate(conjuncts,TableScope{t});
+  if(compiled == nullptr) compiled = &predicate;
+  uint32_t id = explain == nullptr ? Explain::NO_OPERATOR : explain->Add(parent,"Seq Scan on " + t->GetTableName());
+  Explain::Running running(explain,id);
+  std::function<bool(const Row &)> output = explain == nullptr ? visit : explain->Output(id,visit);
+  vector<RowId> rids;
+  TableStatistics *stats = t->GetStatistics();
+  if(stats != nullptr ? rec_planned_scan(conjuncts,t,c,stats,rids,explain,id)
+                      : rec_index_scan(conjuncts,t,c,rids,explain,id)){
+    rec_fetch(*compiled,rids,t,output);
+    return true;
+  }
+  uint32_t workers = rec_scan_workers(stats);
+  if(explain != nullptr && workers > 1){
+    explain->SetName(id,"Parallel Seq Scan on " + t->GetTableName() + " (" + std::to_string(workers) + " workers)");
+  }
+  if(compiled->IsFalse() || (explain != nullptr && !explain->IsAnalyze())) return true;
+  if(workers > 1){
+    ParallelScan scan(t->GetTableHeap(),*compiled,workers);
+    bool fetched = scan.Run(output);
+    if(explain != nullptr) explain->Count(id,scan.GetTupleCount(),0);
+    return fetched;
+  }
+  VectorFilter filter(*compiled);
+  uint16_t selection[VectorFilter::BATCH_SIZE];
+  ArenaMemHeap arena;
+  Row row(RowId(), &arena);
+  auto visit_batch = [&](const RowView *views, uint32_t count){
+    if(explain != nullptr) explain->Count(id,count,0);
+    uint32_t selected = filter.Select(views,count,selection);
+    for(uint32_t i=0;i<selected;i++){
+      const RowView &view = views[selection[i]];
+      row.Reset(view.GetRowId());
+      arena.Reset();
+      view.ToRow(&row);
+      if(!output(row)) return false;
+    }
+    return true;
+  };
+  return t->GetTableHeap()->ScanBatches(VectorFilter::BATCH_SIZE,SCAN_BATCH_PAGES,visit_batch);
+}
+
+bool rec_scan(pSyntaxNode sn, TableInfo* t, CatalogManager* c, MemHeap* h, vector<Row*> &ans, Explain *explain,
+              const Predicate *predicate){
+  vector<pSyntaxNode> conjuncts;
+  if(sn != nullptr) rec_conjuncts(sn,conjuncts);
+  bool fetched = rec_scan_each(conjuncts,t,c,[&](const Row &row){
+    ans.push_back(new Row(row, h));
+    return true;
+  },explain,Explain::NO_OPERATOR,predicate);
+  if(fetched) return true;
+  for(auto row:ans) delete row;
+  ans.clear();
+  return false;
+}
+
+/**
+ * Condition sn on the rows of the table of resolved compiled, once into
+ * resolved for statement, the cached statement running if any, and its
+ * parameters bound to the literals of this execution
+ */
+static const Predicate *rec_where(pSyntaxNode sn, PreparedStatement::Resolved &resolved, PreparedStatement *statement){
+  if(resolved.predicate_ == nullptr){
+    vector<pSyntaxNode> conjuncts;
+    rec_conjuncts(sn,conjuncts);
+    resolved.predicate_ = std::make_unique<Predicate>(rec_predicate(conjuncts,TableScope{resolved.table_},statement));
+    if(statement != nullptr) statement->compile_count_++;
+  }
+  if(statement != nullptr) rec_bind(*resolved.predicate_,*statement);
+  return resolved.predicate_.get();
+}
+
+/**
+ * Inclusive index bounds on column keymap from conjuncts comparing it to
+ * constants, kept in keys. Of several bounds on one side the first is
+ * taken, the rows are still checked on all the conjuncts.
+ * @return false if a conjunct is anything else
+ */
+static bool rec_column_bounds(const vector<pSyntaxNode> &conjuncts, TableInfo* t, uint32_t keymap, vector<Row> &keys,
+                              const Row *&low, const Row *&high){
+  const string &name = t->GetSchema()->GetColumn(keymap)->GetName();
+  keys.reserve(conjuncts.size());
+  low = high = nullptr;
+  for(auto conjunct:conjuncts){
+    if(conjunct->type_ != kNodeCompareOperator || !rec_is_constant(conjunct) || name != conjunct->child_->val_){
+      return false;
+    }
+    string op = conjunct->val_;
+    bool lower = op == "=" || op == ">" || op == ">=", upper = op == "=" || op == "<" || op == "<=";
+    if(!lower && !upper) return false;
+    keys.push_back(rec_compare_key(conjunct,t,keymap));
+    if(lower && low == nullptr) low = &keys.back();
+    if(upper && high == nullptr) high = &keys.back();
+  }
+  return true;
+}
+
+/**
+ * Visit the rows of t satisfying every conjunct in the key order of index,
+ * descending if desc, until visit returns false. Row ids are read in runs
+ * of the first limit entries between low and high; a run twice as long is
+ * read only when the rows of the last one fell short. Under an explain the
+ * scan is an operator below parent; a plain EXPLAIN reads nothing.
+ * @return false if the index has no key order
+ */
+static bool rec_ordered_scan(const vector<pSyntaxNode> &conjuncts, TableInfo* t, IndexInfo *index, bool desc,
+                             const Row *low, const Row *high, uint64_t limit,
+                             const std::function<bool(const Row &)> &visit, Explain *explain, uint32_t parent){
+  string path = string(desc ? "Index Scan Backward on " : "Index Scan on ") + t->GetTableName() + " using " +
+                index->GetIndexName();
+  uint32_t id = explain == nullptr ? Explain::NO_OPERATOR : explain->Add(parent,path);
+  Explain::Running running(explain,id);
+  if(explain != nullptr && !explain->IsAnalyze()) return true;
+  rec_note_path(explain,id,"index order",path);
+  std::function<bool(const Row &)> output = explain == nullptr ? visit : explain->Output(id,visit);
+  Predicate predicate = rec_predicate(conjuncts,TableScope{t});
+  uint64_t run = std::max<uint64_t>(limit,1);
+  size_t visited = 0;
+  while(true){
+    vector<RowId> rids;
+    uint32_t count = std::min<uint64_t>(run,UINT32_MAX);
+    dberr_t status = desc ? index->GetIndex()->ScanRangeReverse(low,high,rids,count,nullptr)
+                          : index->GetIndex()->ScanRangeForward(low,high,rids,count,nullptr);
+    if(status == DB_FAILED){
+      // a bound that does not fit the keys is left to the conjuncts
+      if(low == nullptr && high == nullptr) return false;
+      low = high = nullptr;
+      continue;
+    }
+    if(explain != nullptr) explain->Count(id,rids.size() - visited,0);
+    vector<RowId> fresh(rids.begin() + visited,rids.end());
+    if(!rec_fetch(predicate,fresh,t,output) || rids.size() < count) return true;
+    visited = rids.size();
+    run *= 2;
+  }
+}
+
+/**
+ * B+ tree indexes answering aggregates, all MIN or MAX of columns of t over
+ * the whole table, from the first or last key of an index on each column
+ * @return false if an aggregate is anything else or its column has no
+ * ordered index
+ */
+static bool rec_extreme_indexes(const vector<Aggregate> &aggregates, TableInfo* t, CatalogManager* c,
+                                vector<IndexInfo*> &indexes){
+  for(auto &function:aggregates){
+    if(function.kind_ != kAggregateMin && function.kind_ != kAggregateMax) return false;
+    const string &name = t->GetSchema()->GetColumn(function.column_)->GetName();
+    IndexInfo *index = rec_find_index(name.c_str(),false,t,c);
+    if(index == nullptr) return false;
+    indexes.push_back(index);
+  }
+  return true;
+}
+
+/**
+ * Append the values of aggregates to row, one key of each index of
+ * rec_extreme_indexes, null for a column holding only nulls
+ * @return false if an index has no key order
+ */
+static bool rec_index_extremes(const vector<Aggregate> &aggregates, const vector<IndexInfo*> &indexes, TableInfo* t,
+                               Row &row){
+  for(uint32_t i=0;i<aggregates.size();i++){
+    Row key(INVALID_ROWID);
+    dberr_t status = indexes[i]->GetIndex()->ScanFirstKey(aggregates[i].kind_ == kAggregateMax,key,nullptr);
+    if(status == DB_FAILED) return false;
+    if(status == DB_SUCCESS) row.EmplaceField(*key.GetField(0));
+    else row.EmplaceField(t->GetSchema()->GetColumn(aggregates[i].column_)->GetType());
+  }
+  return true;
+}
+
+/**
+ * Add the columns compared in the condition to used
+ * @return false if the condition names a column not in the table
+ */
+static bool rec_used_columns(pSyntaxNode sn, TableInfo* t, vector<uint32_t> &used){
+  if(sn == nullptr) return true;
+  if(sn->type_ == kNodeConnector){
+    return rec_used_columns(sn->child_,t,used) && rec_used_columns(sn->child_->next_,t,used);
+  }
+  uint32_t keymap;
+  if(sn->type_ != kNodeCompareOperator || t->GetSchema()->GetColumnIndex(sn->child_->val_, keymap)!=DB_SUCCESS){
+    return false;
+  }
+  used.push_back(keymap);
+  if(sn->child_->next_->type_ == kNodeIdentifier){
+    if(t->GetSchema()->GetColumnIndex(sn->child_->next_->val_, keymap)!=DB_SUCCESS) return false;
+    used.push_back(keymap);
+  }
+  return true;
+}
+
+/**
+ * Answer a select from the entries of one of indexes, those of the table,
+ * alone, when it covers: its key and included columns hold every column of
+ * the projection and of the condition, and the condition or a conjunct of a
+ * top-level "and" bounds its first key column. The rows are checked on
+ * predicate, the condition compiled. The table heap is never read: the rows
+ * only carry the covered columns, the others are null. Under an explain the
+ * scan is an operator below parent; a plain EXPLAIN reads nothing.
+ * @return false if no covering index applies
+ */
+static bool rec_covering_scan(pSyntaxNode sn, const vector<uint32_t> &columns, TableInfo* t,
+                              const vector<IndexInfo*> &indexes, const Predicate &predicate, MemHeap* h,
+                              vector<Row*> &ans, Explain *explain = nullptr, uint32_t parent = Explain::NO_OPERATOR){
+  vector<uint32_t> used(columns);
+  if(sn == nullptr || !rec_used_columns(sn,t,used)) return false;
+  vector<pSyntaxNode> conjuncts = {sn};
+  if(sn->type_ == kNodeConnector && strcmp(sn->val_,"and") == 0) conjuncts = {sn->child_, sn->child_->next_};
+  for(auto p:indexes){
+    const IndexMetadata *meta = p->GetIndexMeta();
+    if(!meta->IsCovering()) continue;
+    // position of every table column in the index entries, -1 if not stored
+    vector<int> position(t->GetSchema()->GetColumnCount(), -1);
+    vector<uint32_t> column_map(meta->GetKeyMapping());
+    column_map.insert(column_map.end(),meta->GetIncludeMapping().begin(),meta->GetIncludeMapping().end());
+    for(uint32_t i=0;i<column_map.size();i++) position[column_map[i]] = i;
+    if(std::any_of(used.begin(),used.end(),[&](uint32_t i){ return position[i] < 0; })) continue;
+    pSyntaxNode bound = nullptr;
+    for(auto conjunct:conjuncts){
+      if(conjunct->type_ != kNodeCompareOperator || !rec_is_constant(conjunct)) continue;
+      string op = conjunct->val_;
+      if(op != "=" && op != "<" && op != "<=" && op != ">" && op != ">=") continue;
+      if(t->GetSchema()->GetColumn(meta->GetKeyMapping()[0])->GetName() != conjunct->child_->val_) continue;
+      bound = conjunct;
+      break;
+    }
+    if(bound == nullptr) continue;
+    string op = bound->val_;
+    Row key = rec_compare_key(bound,t,meta->GetKeyMapping()[0]);
+    const Row *low = (op == "=" || op == ">" || op == ">=") ? &key : nullptr;
+    const Row *high = (op == "=" || op == "<" || op == "<=") ? &key : nullptr;
+    // a bound that does not fit the keys turns the index down before it is planned
+    if(!p->GetIndex()->AcceptsBounds(low,high)) continue;
+    string path = "Covering Index Scan on " + t->GetTableName() + " using " + p->GetIndexName();
+    uint32_t id = explain == nullptr ? Explain::NO_OPERATOR : explain->Add(parent,path);
+    if(explain != nullptr && !explain->IsAnalyze()) return true;
+    Explain::Running running(explain,id);
+    vector<Row*> entries;
+    p->GetIndex()->ScanRangeEntries(low,high,entries,h,nullptr);
+    if(explain == nullptr) cout<<"--select using covering index--"<<endl;
+    else explain->Count(id,entries.size(),0);
+    for(auto entry:entries){
+      Row *row = new Row(entry->GetRowId(), h);
+      for(uint32_t i=0;i<position.size();i++){
+        if(position[i] >= 0) row->EmplaceField(*entry->GetField(position[i]));
+        else row->EmplaceField(t->GetSchema()->GetColumn(i)->GetType());
       }
-      else if(type==kTypeChar){
-        char* ch = new char[key_col->GetLength()];
-        strcpy(ch,val.c_str());//�Ƚ�Ŀ�����ch��
+      delete entry;
+      if(predicate.Match(RowFields(*row))) ans.push_back(row);
+      else delete row;
+    }
+    if(explain != nullptr) explain->Count(id,0,ans.size());
+    return true;
+  }
+  return false;
+}
 
-        for(uint32_t i=0;i<r.size();i++){
-          const char* test = r[i]->GetField(keymap)->GetData();
-        
-          if(strcmp(test,ch)>=0){
-            vector<Field> f;
-            for(auto it:r[i]->GetFields()){
-              f.push_back(*it);
-            }
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
+/**
+ * Columns of the tables of a join, laid out one table after the other in
+ * the joined rows. A bare column must belong to exactly one of the tables.
+ */
+struct JoinScope {
+  vector<TableInfo*> tables;
+  vector<uint32_t> offsets;  /** of the first column of each table in the joined rows */
+
+  /**
+   * @return index of the table of column, -1 if no table or several have it
+   */
+  int TableOf(pSyntaxNode column, uint32_t &index) const {
+    int found = -1;
+    for(uint32_t i=0;i<tables.size();i++){
+      uint32_t pos;
+      if(column->child_ != nullptr && tables[i]->GetTableName() != column->child_->val_) continue;
+      if(tables[i]->GetSchema()->GetColumnIndex(column->val_, pos)!=DB_SUCCESS) continue;
+      if(found >= 0) return -1;
+      found = i;
+      index = pos;
+    }
+    return found;
+  }
+
+  bool Resolve(pSyntaxNode column, uint32_t &index, TypeId &type) const {
+    uint32_t pos;
+    int table = TableOf(column, pos);
+    if(table < 0) return false;
+    type = tables[table]->GetSchema()->GetColumn(pos)->GetType();
+    index = offsets[table] + pos;
+    return true;
+  }
+
+  /**
+   * @return types of the columns of the joined rows
+   */
+  vector<TypeId> Types() const {
+    vector<TypeId> types;
+    for(auto tableinfo:tables){
+      for(auto column:tableinfo->GetSchema()->GetColumns()) types.push_back(column->GetType());
+    }
+    return types;
+  }
+};
+
+/**
+ * Add the tables whose columns the condition compares to mask
+ * @return false if a column is in no table or ambiguous
+ */
+static bool rec_join_tables(pSyntaxNode sn, const JoinScope &scope, uint64_t &mask){
+  if(sn->type_ == kNodeConnector){
+    return rec_join_tables(sn->child_,scope,mask) && rec_join_tables(sn->child_->next_,scope,mask);
+  }
+  if(sn->type_ != kNodeCompareOperator) return false;
+  uint32_t index;
+  int table = scope.TableOf(sn->child_,index);
+  if(table < 0) return false;
+  mask |= uint64_t(1) << table;
+  if(sn->child_->next_->type_ == kNodeIdentifier){
+    table = scope.TableOf(sn->child_->next_,index);
+    if(table < 0) return false;
+    mask |= uint64_t(1) << table;
+  }
+  return true;
+}
+
+/**
+ * Size of a join input, a table filtered by the conjuncts pushed into its
+ * scan
+ */
+struct JoinInput {
+  double pages;
+  double rows;  /** of the whole table */
+  double selectivity;
+
+  inline double Bytes() const { return selectivity * pages * PAGE_SIZE; }
+
+  inline double Rows() const { return selectivity * rows; }
+};
+
+/**
+ * Estimate a join input from the statistics of an analyzed table, otherwise
+ * from its page count, which the table heap keeps once it has been read,
+ * taking the rows of its first page as typical
+ */
+static JoinInput rec_join_input(const vector<pSyntaxNode> &conjuncts, TableInfo* t){
+  TableStatistics *stats = t->GetStatistics();
+  if(stats != nullptr){
+    JoinInput input{double(stats->GetPageCount()), double(stats->GetRowCount()), 1};
+    for(auto conjunct:conjuncts) input.selectivity *= rec_selectivity(conjunct,t,stats);
+    return input;
+  }
+  uint32_t pages = 0, first_rows = 0;
+  t->GetTableHeap()->SamplePages(1,[&](const RowView &){ first_rows++; },pages);
+  return {double(pages), double(first_rows) * pages, std::pow(DEFAULT_SELECTIVITY,conjuncts.size())};
+}
+
+/**
+ * Left-deep chain of joins over the tables of a select in FROM order, step
+ * i joins the rows of tables [0, i) with table i. Conditions on one table
+ * are pushed into its scan, equalities between a column of table i and one
+ * of a table before it are the keys of step i, any other condition is
+ * checked once every table it names is joined. A step without keys is a
+ * cross product.
+ *
+ * A step probes an index of table i for each joined row when that is
+ * cheaper than reading the whole table, otherwise it hash joins, building
+ * on the side estimated smaller.
+ */
+struct JoinChain {
+  JoinScope scope;
+  vector<vector<pSyntaxNode>> filters;
+  vector<vector<pSyntaxNode>> residuals;
+  vector<vector<uint32_t>> left_keys;  /** columns of the joined rows of tables [0, i) */
+  vector<vector<uint32_t>> right_keys;  /** columns of table i */
+  vector<JoinInput> inputs;
+  CatalogManager *catalog;
+  BufferPoolManager *buffer_pool_manager;
+  Explain *explain{nullptr};  /** the steps and scans are its operators */
+  bool stopped{false};  /** set once the visitor of Run wants no more rows */
+
+  static constexpr uint32_t MAX_TABLES = 64;
+
+  /**
+   * Place every conjunct of the conditions at its step
+   * @return false if a conjunct names an unknown or ambiguous column
+   */
+  bool Plan(const vector<pSyntaxNode> &conjuncts){
+    uint32_t count = scope.tables.size();
+    filters.assign(count,{});
+    residuals.assign(count,{});
+    left_keys.assign(count,{});
+    right_keys.assign(count,{});
+    for(auto conjunct:conjuncts){
+      uint64_t mask = 0;
+      if(!rec_join_tables(conjunct,scope,mask)) return false;
+      uint32_t step = 63 - __builtin_clzll(mask);
+      if((mask & (mask - 1)) == 0) filters[step].push_back(conjunct);
+      else if(!AddKey(conjunct,step)) residuals[step].push_back(conjunct);
+    }
+    for(uint32_t i=0;i<count;i++) inputs.push_back(rec_join_input(filters[i],scope.tables[i]));
+    return true;
+  }
+
+  /**
+   * Take an equality of two columns of the same type as a key of step
+   */
+  bool AddKey(pSyntaxNode sn, uint32_t step){
+    if(sn->type_ != kNodeCompareOperator || strcmp(sn->val_,"=") != 0) return false;
+    uint32_t left, right;
+    int left_table = scope.TableOf(sn->child_,left), right_table = scope.TableOf(sn->child_->next_,right);
+    if(left_table == int(step)){
+      std::swap(left,right);
+      std::swap(left_table,right_table);
+    }
+    if(scope.tables[left_table]->GetSchema()->GetColumn(left)->GetType() !=
+       scope.tables[right_table]->GetSchema()->GetColumn(right)->GetType()){
+      return false;
+    }
+    left_keys[step].push_back(scope.offsets[left_table] + left);
+    right_keys[step].push_back(right);
+    return true;
+  }
+
+  /**
+   * Index for an index nested-loop join of step, on one of its key columns
+   * which becomes the first key, when probing it for every outer row beats
+   * hashing the table. Outer rows are estimated as many as those of the
+   * largest table joined, as if every join before followed a foreign key.
+   * @return null if the step hash joins
+   */
+  IndexInfo *ChooseIndex(uint32_t step, double outer_rows){
+    TableInfo *table = scope.tables[step];
+    IndexInfo *index = nullptr;
+    for(uint32_t k=0;k<right_keys[step].size() && index == nullptr;k++){
+      index = rec_find_index(table->GetSchema()->GetColumn(right_keys[step][k])->GetName().c_str(),true,table,catalog);
+      if(index != nullptr){
+        std::swap(left_keys[step][0],left_keys[step][k]);
+        std::swap(right_keys[step][0],right_keys[step][k]);
       }
     }
-    else if(op == "<>"){
-      if(type==kTypeInt)
-      {  
-        int valint = std::stoi(val);
-        Field benchmk(type,int(valint));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareNotEquals(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
+    if(index == nullptr) return nullptr;
+    // without statistics the inner key is taken as unique
+    const JoinInput &inner = inputs[step];
+    double pages = std::max(inner.pages,1.0), matches = outer_rows;
+    TableStatistics *stats = table->GetStatistics();
+    if(stats != nullptr){
+      matches *= inner.rows / std::max<uint32_t>(stats->GetColumn(right_keys[step][0]).distinct_count_,1);
+    }
+    double index_cost = INDEX_PROBE_COST * outer_rows + rec_fetch_cost(matches,pages);
+    double hash_cost = SEQ_PAGE_COST * pages + CPU_TUPLE_COST * (inner.rows + outer_rows);
+    return index_cost < hash_cost ? index : nullptr;
+  }
+
+  /**
+   * Visit the joined rows of tables [0, count), each only valid during the
+   * call, until visit returns false. Under an explain the step is an
+   * operator below parent.
+   * @return false if a hash join ran out of buffer pool pages to spill to,
+   * an index turned its keys down, or a page of a table could not be fetched
+   */
+  bool Run(uint32_t count, const std::function<bool(const Row &)> &visit, uint32_t parent = Explain::NO_OPERATOR){
+    if(count == 1){
+      return rec_scan_each(filters[0],scope.tables[0],catalog,visit,explain,parent);
+    }
+    uint32_t step = count - 1;
+    TableInfo *table = scope.tables[step];
+    vector<Column*> columns;
+    double left_bytes = 0, left_rows = 0;
+    for(uint32_t i=0;i<step;i++){
+      const vector<Column*> &table_columns = scope.tables[i]->GetSchema()->GetColumns();
+      columns.insert(columns.end(),table_columns.begin(),table_columns.end());
+      left_bytes += inputs[i].Bytes();
+      left_rows = std::max(left_rows,inputs[i].Rows());
+    }
+    Schema left_schema(columns);
+    IndexInfo *index = left_keys[step].empty() ? nullptr : ChooseIndex(step,left_rows);
+    bool build_table = inputs[step].Bytes() <= left_bytes;
+    uint32_t id = Explain::NO_OPERATOR;
+    if(explain != nullptr){
+      string name = table->GetTableName();
+      if(index != nullptr) name = "Index Join " + name + " using " + index->GetIndexName();
+      else{
+        name = (left_keys[step].empty() ? "Cross Join " : "Hash Join ") + name + ", building on " +
+               (build_table ? name : "the joined rows");
       }
-      else if(type==kTypeFloat)
-      {  
-        float valfloat = std::stof(val);
-        Field benchmk(type,float(valfloat));
-        for(uint32_t i=0;i<r.size();i++){
-          if(!r[i]->GetField(keymap)->CheckComparable(benchmk)){
-            cout<<"not comparable"<<endl;
-            return ans;
-          }
-          if(r[i]->GetField(keymap)->CompareNotEquals(benchmk)){
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
+      id = explain->Add(parent,name);
+    }
+    Explain::Running running(explain,id);
+    std::function<bool(const Row &)> output = explain == nullptr ? visit : explain->Output(id,visit);
+    ArenaMemHeap arena;
+    Row joined(RowId(), &arena);
+    Predicate residual = rec_predicate(residuals[step],scope);
+    auto emit = [&](const Row &left, const Row &right){
+      joined.Reset(RowId());
+      arena.Reset();
+      for(uint32_t i=0;i<left.GetFieldCount();i++) joined.EmplaceField(*left.GetField(i));
+      for(uint32_t i=0;i<right.GetFieldCount();i++) joined.EmplaceField(*right.GetField(i));
+      if(!stopped && residual.Match(RowFields(joined))) stopped = !output(joined);
+    };
+    bool ok = true;
+    if(index != nullptr){
+      if(explain == nullptr) cout<<"--join using index--"<<endl;
+      IndexJoin join(table->GetTableHeap(),table->GetSchema(),right_keys[step],index->GetIndex(),left_keys[step]);
+      // the conditions pushed into the scan of the table hold for the fetched tuples
+      Predicate filter = rec_predicate(filters[step],TableScope{table});
+      auto emit_filtered = [&](const Row &outer, const Row &inner){
+        if(filter.Match(RowFields(inner))) emit(outer,inner);
+      };
+      bool run = Run(step,[&](const Row &row){
+        ok = ok && join.Probe(row,emit_filtered);
+        return ok && !stopped;
+      },id);
+      return run && ok && join.Finish(emit_filtered);
+    }
+    if(build_table){
+      HashJoin join(buffer_pool_manager,table->GetSchema(),right_keys[step],&left_schema,left_keys[step]);
+      auto emit_swapped = [&](const Row &build, const Row &probe){ emit(probe,build); };
+      bool scanned = rec_scan_each(filters[step],table,catalog,[&](const Row &row){ return ok = join.Build(row); },
+                                   explain,id);
+      bool run = scanned && ok && Run(step,[&](const Row &row){
+        ok = join.Probe(row,emit_swapped);
+        return ok && !stopped;
+      },id);
+      ok = run && ok && join.Finish(emit_swapped);
+      if(explain != nullptr && join.IsSpilled()){
+        explain->AddDetail(id,"spilled " + std::to_string(join.GetSpilledPageCount()) + " pages");
       }
-      else if(type==kTypeChar){
-        char* ch = new char[key_col->GetLength()];
-        strcpy(ch,val.c_str());//�Ƚ�Ŀ�����ch��
-
-        for(uint32_t i=0;i<r.size();i++){
-          const char* test = r[i]->GetField(keymap)->GetData();
-          
-          if(strcmp(test,ch)!=0){
-            vector<Field> f;
-            for(auto it:r[i]->GetFields()){
-              f.push_back(*it);
-            }
-            Row* tr = new Row(*r[i]);
-            ans.push_back(tr);
-          }
-        }
+      return ok;
+    }
+    HashJoin join(buffer_pool_manager,&left_schema,left_keys[step],table->GetSchema(),right_keys[step]);
+    bool run = Run(step,[&](const Row &row){ return ok = join.Build(row); },id);
+    if(!run || !ok) return false;
+    bool scanned = rec_scan_each(filters[step],table,catalog,[&](const Row &row){
+      ok = join.Probe(row,emit);
+      return ok && !stopped;
+    },explain,id);
+    ok = scanned && ok && join.Finish(emit);
+    if(explain != nullptr && join.IsSpilled()){
+      explain->AddDetail(id,"spilled " + std::to_string(join.GetSpilledPageCount()) + " pages");
+    }
+    return ok;
+  }
+};
+
+PreparedStatement::Resolved *ExecuteEngine::ResolveTable(const string &table_name, ExecuteContext *context,
+                                                         PreparedStatement::Resolved &uncached){
+  PreparedStatement *statement = context->statement_;
+  PreparedStatement::Resolved &resolved = statement != nullptr ? statement->resolved_ : uncached;
+  if(resolved.version_ == catalog_version_) return &resolved;
+  resolved = PreparedStatement::Resolved();
+  if(statement != nullptr) statement->resolve_count_++;
+  if(current_db->catalog_mgr_->GetTable(table_name, resolved.table_) == DB_TABLE_NOT_EXIST) return nullptr;
+  current_db->catalog_mgr_->GetTableIndexes(table_name,resolved.indexes_);
+  for(auto index:resolved.indexes_){
+    vector<uint32_t> key_columns;
+    for(auto it:index->GetIndexKeySchema()->GetColumns()){
+      index_id_t tmp;
+      if(resolved.table_->GetSchema()->GetColumnIndex(it->GetName(),tmp)==DB_SUCCESS){
+        key_columns.push_back(tmp);
       }
     }
-    return ans;
+    resolved.key_columns_.push_back(std::move(key_columns));
   }
-  return r; 
+  resolved.version_ = catalog_version_;
+  return &resolved;
 }
 
 dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
@@ -780,20 +1602,33 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
   LOG(INFO) << "ExecuteSelect" << std::endl;
 #endif
   pSyntaxNode range = ast->child_;
-  vector<uint32_t> columns;
+  // joins, aggregates and any clause after WHERE go through the operators
+  bool plan = range->next_->type_ == kNodeJoin;
+  for(pSyntaxNode node=range->next_->next_;node!=nullptr;node=node->next_){
+    plan = plan || node->type_ != kNodeConditions;
+  }
+  for(pSyntaxNode col=range->type_ == kNodeColumnList ? range->child_ : nullptr;col!=nullptr;col=col->next_){
+    plan = plan || col->type_ == kNodeAggregate;
+  }
+  if(plan){
+    return ExecuteSelectPlan(ast, context);
+  }
   string table_name=range->next_->val_;
-  TableInfo *tableinfo = nullptr;
-  dberr_t GetRet = current_db->catalog_mgr_->GetTable(table_name, tableinfo);
-  if (GetRet==DB_TABLE_NOT_EXIST){
+  // a cached statement looks its table and columns up once per catalog version
+  PreparedStatement::Resolved uncached;
+  PreparedStatement::Resolved *resolved = ResolveTable(table_name,context,uncached);
+  if (resolved==nullptr){
     cout<<"Table Not Exist!"<<endl;
     return DB_FAILED;
   }
-  if(range->type_ == kNodeAllColumns){
+  TableInfo *tableinfo = resolved->table_;
+  vector<uint32_t> &columns = resolved->columns_;
+  if(columns.empty() && range->type_ == kNodeAllColumns){
     // cout<<"select all"<<endl;
     for(uint32_t i=0;i<tableinfo->GetSchema()->GetColumnCount();i++)
       columns.push_back(i);
   }
-  else if(range->type_ == kNodeColumnList){
+  else if(columns.empty() && range->type_ == kNodeColumnList){
     // vector<Column*> all_columns = tableinfo->GetSchema()->GetColumns();
     pSyntaxNode col = range->child_;
     while(col!=nullptr){
@@ -802,29 +1637,45 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
         columns.push_back(pos);
       }
       else{
+        columns.clear();
         cout<<"column not found"<<endl;
         return DB_FAILED;
       }
       col = col->next_;
     }
   }
-  cout<<"--------------------"<<endl;
-  //cout<<endl;
-  for(auto i:columns){
-    cout<<tableinfo->GetSchema()->GetColumn(i)->GetName()<<"   ";
+  // EXPLAIN prints the operators instead of the rows
+  Explain *explain = context->explain_;
+  if(explain == nullptr){
+    cout<<"--------------------"<<endl;
+    //cout<<endl;
+    for(auto i:columns){
+      cout<<tableinfo->GetSchema()->GetColumn(i)->GetName()<<"   ";
+    }
+    cout<<endl;
+    cout<<"--------------------"<<endl;
   }
-  cout<<endl;
-  cout<<"--------------------"<<endl;
+  else explain->StartExecute();
   if(range->next_->next_==nullptr)//û��ѡ������
   {
     int cnt=0;
-    for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
+    if(explain != nullptr){
+      uint32_t id = explain->Add(Explain::NO_OPERATOR,"Seq Scan on " + table_name);
+      Explain::Running running(explain,id);
+      if(explain->IsAnalyze()){
+        for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();++it) cnt++;
+      }
+      explain->Count(id,cnt,cnt);
+      return DB_SUCCESS;
+    }
+    for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();++it){
+      const RowView &view = it.GetRowView();
       for(uint32_t j=0;j<columns.size();j++){
-        if(it->GetField(columns[j])->IsNull()){
+        if(view.IsNull(columns[j])){
           cout<<"null";
         }
         else
-          it->GetField(columns[j])->fprint();
+          view.GetField(columns[j]).fprint();
         cout<<"  ";
         
       }
@@ -836,19 +1687,30 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
   }
   else if(range->next_->next_->type_ == kNodeConditions){
     pSyntaxNode cond = range->next_->next_->child_;
-    vector<Row*> origin_rows;
-    for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-      Row* tp = new Row(*it);
-      origin_rows.push_back(tp);
-    }    
-    auto ptr_rows  = rec_sel(cond, *&origin_rows,tableinfo,current_db->catalog_mgr_);
+    const Predicate *predicate = rec_where(cond,*resolved,context->statement_);
+    // an index holding every column read answers without the table heap
+    vector<Row*> ptr_rows;
+    if(!rec_covering_scan(cond,columns,tableinfo,resolved->indexes_,*predicate,&context->heap_,ptr_rows,explain) &&
+       !rec_scan(cond,tableinfo,current_db->catalog_mgr_,&context->heap_,ptr_rows,explain,predicate)){
+      cout<<"Select Failed!"<<endl;
+      return DB_FAILED;
+    }
+    if(explain != nullptr){
+      for(auto row:ptr_rows) delete row;
+      return DB_SUCCESS;
+    }
     
     for(auto it=ptr_rows.begin();it!=ptr_rows.end();it++){
       for(uint32_t j=0;j<columns.size();j++){
-        (*it)->GetField(columns[j])->fprint();
+        if((*it)->GetField(columns[j])->IsNull()){
+          cout<<"null";
+        }
+        else
+          (*it)->GetField(columns[j])->fprint();
         cout<<"  ";
       }
       cout<<endl;
+      delete *it;
     }
     cout<<"Select Success, Affects "<<ptr_rows.size()<<" Record!"<<endl;
   }
@@ -856,6 +1718,362 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
   return DB_SUCCESS;
 }
 
+/**
+ * Aggregate function of a select item
+ * @return false if the name is none of count, sum, avg, min and max
+ */
+static bool rec_aggregate_kind(const char *name, AggregateKind &kind){
+  static const std::pair<const char*, AggregateKind> kinds[] = {
+      {"count", kAggregateCount}, {"sum", kAggregateSum}, {"avg", kAggregateAvg},
+      {"min", kAggregateMin}, {"max", kAggregateMax}};
+  for(auto &entry:kinds){
+    if(strcasecmp(name,entry.first) == 0){
+      kind = entry.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Header of a select item as written, eg: "t.a" or "sum(a)"
+ */
+static string rec_item_name(pSyntaxNode item){
+  if(item->type_ == kNodeAggregate){
+    return string(item->val_) + "(" + (item->child_ == nullptr ? string("*") : rec_item_name(item->child_)) + ")";
+  }
+  return item->child_ != nullptr ? string(item->child_->val_) + "." + item->val_ : string(item->val_);
+}
+
+dberr_t ExecuteEngine::ExecuteSelectPlan(pSyntaxNode ast, ExecuteContext *context) {
+  pSyntaxNode range = ast->child_;
+  pSyntaxNode from = range->next_;
+  JoinChain chain;
+  chain.catalog = current_db->catalog_mgr_;
+  chain.buffer_pool_manager = current_db->bpm_;
+  chain.explain = context->explain_;
+  // the tables in FROM order, the ON conditions of inner joins are as good as the WHERE ones
+  vector<pSyntaxNode> conjuncts;
+  uint32_t column_count = 0;
+  pSyntaxNode first = from->type_ == kNodeJoin ? from->child_ : from;
+  for(pSyntaxNode node=first;node!=nullptr;node=from->type_ == kNodeJoin ? node->next_ : nullptr){
+    if(node->type_ == kNodeConditions){
+      rec_conjuncts(node->child_,conjuncts);
+      continue;
+    }
+    TableInfo *tableinfo = nullptr;
+    if(current_db->catalog_mgr_->GetTable(node->val_, tableinfo)==DB_TABLE_NOT_EXIST){
+      cout<<"Table Not Exist!"<<endl;
+      return DB_FAILED;
+    }
+    if(std::find(chain.scope.tables.begin(),chain.scope.tables.end(),tableinfo) != chain.scope.tables.end()){
+      cout<<"Table Joined Twice!"<<endl;
+      return DB_FAILED;
+    }
+    chain.scope.tables.push_back(tableinfo);
+    chain.scope.offsets.push_back(column_count);
+    column_count += tableinfo->GetSchema()->GetColumnCount();
+  }
+  if(chain.scope.tables.size() > JoinChain::MAX_TABLES){
+    cout<<"Too Many Tables!"<<endl;
+    return DB_FAILED;
+  }
+  pSyntaxNode group_by = nullptr, order_by = nullptr;
+  bool distinct = false;
+  uint64_t limit = ExternalSort::NO_LIMIT;
+  for(pSyntaxNode node=from->next_;node!=nullptr;node=node->next_){
+    if(node->type_ == kNodeConditions) rec_conjuncts(node->child_,conjuncts);
+    else if(node->type_ == kNodeGroupBy) group_by = node;
+    else if(node->type_ == kNodeDistinct) distinct = true;
+    else if(node->type_ == kNodeOrderBy) order_by = node;
+    else if(node->type_ == kNodeLimit){
+      const char *number = node->child_->val_;
+      if(number[0] == '\0' || number[strspn(number,"0123456789")] != '\0'){
+        cout<<"invalid limit "<<number<<endl;
+        return DB_FAILED;
+      }
+      limit = strtoull(number,nullptr,10);
+    }
+  }
+  if(!chain.Plan(conjuncts)){
+    cout<<"column not found"<<endl;
+    return DB_FAILED;
+  }
+  // the joined rows, laid out table after table
+  vector<Column*> input_columns;
+  for(auto tableinfo:chain.scope.tables){
+    const vector<Column*> &table_columns = tableinfo->GetSchema()->GetColumns();
+    input_columns.insert(input_columns.end(),table_columns.begin(),table_columns.end());
+  }
+  Schema input_schema(input_columns);
+  // every select item as a column of the joined rows, "*" as all of them
+  vector<pSyntaxNode> items;
+  vector<uint32_t> columns;
+  vector<string> names;
+  if(range->type_ == kNodeAllColumns){
+    for(uint32_t i=0;i<chain.scope.tables.size();i++){
+      TableInfo *tableinfo = chain.scope.tables[i];
+      for(uint32_t j=0;j<tableinfo->GetSchema()->GetColumnCount();j++){
+        items.push_back(nullptr);
+        columns.push_back(chain.scope.offsets[i] + j);
+        string name = tableinfo->GetSchema()->GetColumn(j)->GetName();
+        names.push_back(chain.scope.tables.size() > 1 ? tableinfo->GetTableName() + "." + name : name);
+      }
+    }
+  }
+  // the column of an item, that of its aggregate, none for count(*)
+  auto resolve = [&](pSyntaxNode item, uint32_t &pos){
+    TypeId type;
+    pos = Aggregate::COUNT_ALL;
+    pSyntaxNode column = item->type_ == kNodeAggregate ? item->child_ : item;
+    if(column == nullptr || chain.scope.Resolve(column,pos,type)) return true;
+    cout<<"column not found"<<endl;
+    return false;
+  };
+  if(range->type_ != kNodeAllColumns){
+    for(pSyntaxNode item=range->child_;item!=nullptr;item=item->next_){
+      uint32_t pos;
+      if(!resolve(item,pos)) return DB_FAILED;
+      items.push_back(item);
+      columns.push_back(pos);
+      names.push_back(rec_item_name(item));
+    }
+  }
+  // order by items the same way, they need not be selected
+  vector<pSyntaxNode> order_items;
+  vector<SortKey> order_keys;
+  for(pSyntaxNode node=order_by == nullptr ? nullptr : order_by->child_;node!=nullptr;node=node->next_){
+    uint32_t pos;
+    if(!resolve(node->child_,pos)) return DB_FAILED;
+    order_items.push_back(node->child_);
+    order_keys.push_back({pos, strcmp(node->val_,"desc") == 0});
+  }
+  // grouped rows hold the group keys then the aggregates, the items pick from them
+  bool aggregated = group_by != nullptr;
+  for(auto item:items) aggregated = aggregated || (item != nullptr && item->type_ == kNodeAggregate);
+  for(auto item:order_items) aggregated = aggregated || item->type_ == kNodeAggregate;
+  std::unique_ptr<HashAggregate> aggregate;
+  std::unique_ptr<Schema> aggregate_schema;
+  vector<Aggregate> aggregates;
+  // MIN and MAX of indexed columns over a whole table are first keys of their indexes
+  vector<IndexInfo*> extreme_indexes;
+  bool extremes = false;
+  Schema *output_schema = &input_schema;
+  if(aggregated){
+    vector<uint32_t> group_keys;
+    for(pSyntaxNode column=group_by == nullptr ? nullptr : group_by->child_;column!=nullptr;column=column->next_){
+      uint32_t pos;
+      TypeId type;
+      if(!chain.scope.Resolve(column,pos,type)){
+        cout<<"column not found"<<endl;
+        return DB_FAILED;
+      }
+      group_keys.push_back(pos);
+    }
+    vector<Column*> output_columns;
+    for(auto key:group_keys) output_columns.push_back(input_columns[key]);
+    // move column of item to its field in the grouped rows, an aggregate
+    // computed once for every item naming it
+    auto group_column = [&](pSyntaxNode item, uint32_t &column){
+      if(item == nullptr || item->type_ != kNodeAggregate){
+        auto key = std::find(group_keys.begin(),group_keys.end(),column);
+        if(key == group_keys.end()){
+          cout<<"column not in group by"<<endl;
+          return false;
+        }
+        column = key - group_keys.begin();
+        return true;
+      }
+      Aggregate function{kAggregateCount, column};
+      bool numeric = column == Aggregate::COUNT_ALL || input_columns[column]->GetType() != kTypeChar;
+      if(!rec_aggregate_kind(item->val_,function.kind_) ||
+         (column == Aggregate::COUNT_ALL && function.kind_ != kAggregateCount) ||
+         (!numeric && (function.kind_ == kAggregateSum || function.kind_ == kAggregateAvg))){
+        cout<<"invalid aggregate "<<rec_item_name(item)<<endl;
+        return false;
+      }
+      for(uint32_t j=0;j<aggregates.size();j++){
+        if(aggregates[j].kind_ == function.kind_ && aggregates[j].column_ == function.column_){
+          column = group_keys.size() + j;
+          return true;
+        }
+      }
+      TypeId type = HashAggregate::OutputType(function,&input_schema);
+      uint32_t index = output_columns.size();
+      string name = rec_item_name(item);
+      if(type == kTypeChar){
+        output_columns.push_back(ALLOC_COLUMN(context->heap_)(name,type,input_columns[column]->GetLength(),
+                                                              index,true,false));
+      }
+      else{
+        output_columns.push_back(ALLOC_COLUMN(context->heap_)(name,type,index,true,false));
+      }
+      column = index;
+      aggregates.push_back(function);
+      return true;
+    };
+    for(uint32_t i=0;i<items.size();i++){
+      if(!group_column(items[i],columns[i])) return DB_FAILED;
+    }
+    for(uint32_t i=0;i<order_items.size();i++){
+      if(!group_column(order_items[i],order_keys[i].column_)) return DB_FAILED;
+    }
+    extremes = group_by == nullptr && conjuncts.empty() && chain.scope.tables.size() == 1 &&
+               rec_extreme_indexes(aggregates,chain.scope.tables[0],current_db->catalog_mgr_,extreme_indexes);
+    if(!extremes) aggregate.reset(new HashAggregate(current_db->bpm_,&input_schema,group_keys,aggregates));
+    aggregate_schema.reset(new Schema(output_columns));
+    output_schema = aggregate_schema.get();
+  }
+  // distinct rows are the groups of all the selected columns, so they can
+  // only be ordered by selected columns
+  std::unique_ptr<HashAggregate> duplicates;
+  std::unique_ptr<Schema> distinct_schema;
+  if(distinct){
+    duplicates.reset(new HashAggregate(current_db->bpm_,output_schema,columns,{}));
+    for(auto &key:order_keys){
+      auto selected = std::find(columns.begin(),columns.end(),key.column_);
+      if(selected == columns.end()){
+        cout<<"order by column not selected"<<endl;
+        return DB_FAILED;
+      }
+      key.column_ = selected - columns.begin();
+    }
+    vector<Column*> distinct_columns;
+    for(auto column:columns) distinct_columns.push_back(output_schema->GetColumns()[column]);
+    distinct_schema.reset(new Schema(distinct_columns));
+    output_schema = distinct_schema.get();
+    for(uint32_t i=0;i<columns.size();i++) columns[i] = i;
+  }
+  // ORDER BY a column with an ordered index, LIMIT n on one table filtered
+  // on that column alone reads the index in order instead of sorting
+  IndexInfo *order_index = nullptr;
+  vector<Row> order_bounds;
+  const Row *order_low = nullptr, *order_high = nullptr;
+  if(chain.scope.tables.size() == 1 && !aggregated && !distinct && order_keys.size() == 1 &&
+     limit != ExternalSort::NO_LIMIT){
+    TableInfo *tableinfo = chain.scope.tables[0];
+    uint32_t column = order_keys[0].column_;
+    if(rec_column_bounds(conjuncts,tableinfo,column,order_bounds,order_low,order_high)){
+      const string &name = tableinfo->GetSchema()->GetColumn(column)->GetName();
+      order_index = rec_find_index(name.c_str(),false,tableinfo,current_db->catalog_mgr_);
+    }
+  }
+  // ORDER BY ... LIMIT keeps the first rows in a bounded heap
+  std::unique_ptr<ExternalSort> sort;
+  if(!order_keys.empty() && order_index == nullptr){
+    sort.reset(new ExternalSort(current_db->bpm_,output_schema,order_keys,limit));
+  }
+  // EXPLAIN prints the operators instead of the rows, those above the join
+  // chain added from the top
+  Explain *explain = context->explain_;
+  uint32_t top = Explain::NO_OPERATOR, limit_id = top, sort_id = top, distinct_id = top, aggregate_id = top;
+  if(explain != nullptr){
+    if(limit != ExternalSort::NO_LIMIT && sort == nullptr){
+      limit_id = top = explain->Add(top,"Limit " + std::to_string(limit));
+    }
+    if(sort != nullptr){
+      string name = limit != ExternalSort::NO_LIMIT ? "Top-N Sort, limit " + std::to_string(limit) : "Sort";
+      name += ", " + std::to_string(order_keys.size()) + (order_keys.size() == 1 ? " key" : " keys");
+      sort_id = top = explain->Add(top,name);
+    }
+    if(distinct) distinct_id = top = explain->Add(top,"Hash Distinct");
+    if(extremes){
+      string name = "Index Min/Max on " + chain.scope.tables[0]->GetTableName() + " using";
+      for(uint32_t i=0;i<extreme_indexes.size();i++){
+        auto named = extreme_indexes.begin() + i;
+        if(std::find(extreme_indexes.begin(),named,*named) != named) continue;
+        name += string(i == 0 ? " " : ", ") + extreme_indexes[i]->GetIndexName();
+      }
+      aggregate_id = top = explain->Add(top,name);
+    }
+    else if(aggregated){
+      string name = group_by == nullptr ? "Hash Aggregate" : "Hash Aggregate, group by";
+      for(pSyntaxNode column=group_by == nullptr ? nullptr : group_by->child_;column!=nullptr;column=column->next_){
+        name += string(column == group_by->child_ ? " " : ", ") + rec_item_name(column);
+      }
+      aggregate_id = top = explain->Add(top,name);
+    }
+    explain->StartExecute();
+  }
+  else{
+    cout<<"--------------------"<<endl;
+    for(auto &name:names){
+      cout<<name<<"   ";
+    }
+    cout<<endl;
+    cout<<"--------------------"<<endl;
+  }
+  uint64_t cnt=0;
+  bool ok = true;
+  // every sink tells whether it wants more rows: a LIMIT without anything
+  // in between stops the scan
+  std::function<bool(const Row &)> print = [&](const Row &row){
+    if(cnt >= limit) return false;
+    if(explain == nullptr){
+      for(auto j:columns){
+        if(row.GetField(j)->IsNull()){
+          cout<<"null";
+        }
+        else
+          row.GetField(j)->fprint();
+        cout<<"  ";
+      }
+      cout<<endl;
+    }
+    cnt++;
+    return cnt < limit;
+  };
+  std::function<bool(const Row &)> sort_add = [&](const Row &row){ return ok = ok && sort->Add(row); };
+  std::function<bool(const Row &)> sorted = sort != nullptr ? sort_add : print;
+  std::function<bool(const Row &)> distinct_add = [&](const Row &row){ return ok = ok && duplicates->Add(row); };
+  std::function<bool(const Row &)> grouped = distinct ? distinct_add : sorted;
+  std::function<bool(const Row &)> aggregate_add = [&](const Row &row){ return ok = ok && aggregate->Add(row); };
+  // what the operators emit once their input is over
+  std::function<bool(const Row &)> sort_out = print, distinct_out = sorted, aggregate_out = grouped;
+  if(explain != nullptr){
+    if(sort != nullptr) sort_out = explain->Output(sort_id,print);
+    if(distinct) distinct_out = explain->Output(distinct_id,sorted);
+    if(aggregated) aggregate_out = explain->Output(aggregate_id,grouped);
+  }
+  if(order_index != nullptr){
+    ok = rec_ordered_scan(conjuncts,chain.scope.tables[0],order_index,order_keys[0].descending_,order_low,
+                          order_high,limit,grouped,explain,top) && ok;
+  }
+  else if(!extremes) ok = chain.Run(chain.scope.tables.size(),aggregated ? aggregate_add : grouped,top) && ok;
+  if(extremes && (explain == nullptr || explain->IsAnalyze())){
+    Explain::Running running(explain,aggregate_id);
+    if(explain == nullptr) cout<<"--aggregate using index--"<<endl;
+    ArenaMemHeap arena;
+    Row row(RowId(), &arena);
+    ok = rec_index_extremes(aggregates,extreme_indexes,chain.scope.tables[0],row);
+    if(ok) aggregate_out(row);
+  }
+  else if(ok && aggregated && !extremes){
+    Explain::Running running(explain,aggregate_id);
+    ok = aggregate->Finish(aggregate_out) && ok;
+    if(explain != nullptr && aggregate->IsSpilled()) explain->AddDetail(aggregate_id,"spilled");
+  }
+  if(ok && distinct){
+    Explain::Running running(explain,distinct_id);
+    ok = duplicates->Finish(distinct_out) && ok;
+    if(explain != nullptr && duplicates->IsSpilled()) explain->AddDetail(distinct_id,"spilled");
+  }
+  if(ok && sort != nullptr){
+    Explain::Running running(explain,sort_id);
+    sort->Finish(sort_out);
+    if(explain != nullptr && sort->GetRunCount() > 0){
+      explain->AddDetail(sort_id,"spilled " + std::to_string(sort->GetRunCount()) + " runs");
+    }
+  }
+  if(limit_id != Explain::NO_OPERATOR) explain->Count(limit_id,0,cnt);
+  if(!ok){
+    cout<<"Select Failed!"<<endl;
+    return DB_FAILED;
+  }
+  if(explain == nullptr) cout<<"Select Success, Affects "<<cnt<<" Record!"<<endl;
+  return DB_SUCCESS;
+}
+
 dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteInsert" << std::endl;
@@ -867,12 +2085,15 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
   
   string table_name = ast->child_->val_;
   
-  TableInfo *tableinfo = nullptr;
-  
-  if(dbs_[current_db_]->catalog_mgr_->GetTable(table_name, tableinfo) == DB_TABLE_NOT_EXIST) {
+  // a cached statement looks its table and indexes up once per catalog version
+  PreparedStatement::Resolved uncached;
+  PreparedStatement::Resolved *found = ResolveTable(table_name,context,uncached);
+  if(found == nullptr) {
     cout << "Table '"<< table_name <<"' doesn't exist" << endl;
     return DB_FAILED;
   }
+  PreparedStatement::Resolved &resolved = *found;
+  TableInfo *tableinfo = resolved.table_;
   vector<Field> fields;
   pSyntaxNode column_pointer= ast->child_->next_->child_;//the head of inset values
   int cnt = tableinfo->GetSchema()->GetColumnCount();// the number of columns
@@ -882,37 +2103,27 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
     if (column_pointer==nullptr){//tht end of all insert values
       for ( int j = i ; j < cnt ; j ++ ){
         //cout<<"has null!"<<endl;
-        Field new_field(tableinfo->GetSchema()->GetColumn(j)->GetType());
-        fields.push_back(new_field);
+        fields.emplace_back(tableinfo->GetSchema()->GetColumn(j)->GetType());
       }
       break;
     }
     if(column_pointer->val_==nullptr ){
       //cout<<"has null!"<<endl;
-      Field new_field(now_type_id);
-      fields.push_back(new_field);
+      fields.emplace_back(now_type_id);
     }
     else{
       //cout<<"a number"<<endl;
       if (now_type_id==kTypeInt){//����
         int x = atoi(column_pointer->val_);
-        Field new_field (now_type_id,x);
-        fields.push_back(new_field);
+        fields.emplace_back(now_type_id,x);
       }
       else if(now_type_id==kTypeFloat){//������
         float f = atof(column_pointer->val_);
-        Field new_field (now_type_id,f);
-        fields.push_back(new_field);
+        fields.emplace_back(now_type_id,f);
       }
       else {//�ַ���
-        string s = column_pointer->val_;
-        // uint32_t len=tableinfo->GetSchema()->GetColumn(i)->GetLength();
-        // cout<<"insert char length "<<len<<endl;
-        char *c = new char[s.size()];
-        strcpy(c,s.c_str());
-        Field new_field = Field(TypeId::kTypeChar, const_cast<char *>(c), s.size(), true);
-        // Field new_field (now_type_id,c,len,true); 
-        fields.push_back(new_field);
+        // the field copies the chars, short values stay inline
+        fields.emplace_back(TypeId::kTypeChar, column_pointer->val_, strlen(column_pointer->val_), true);
       }
     }
     column_pointer = column_pointer->next_;
@@ -921,7 +2132,7 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
     cout<<"Column Count doesn't match!"<<endl;
     return DB_FAILED;
   }
-  Row row(fields);//构健一个row对象
+  Row row(std::move(fields));//构健一个row对象
   ASSERT(tableinfo!=nullptr,"TableInfo is Null!");
   TableHeap* tableheap=tableinfo->GetTableHeap();//得到堆表管理权
   bool Is_Insert=tableheap->InsertTuple(row,nullptr);
@@ -929,20 +2140,15 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
     cout<<"Insert Failed, Affects 0 Record!"<<endl;
     return DB_FAILED;
   }else{
-    vector <IndexInfo*> indexes;//得到所有索引的TableInfo
-    current_db->catalog_mgr_->GetTableIndexes(table_name,indexes);
+    const vector<IndexInfo*> &indexes = resolved.indexes_;
 
     for(auto p=indexes.begin();p<indexes.end();p++){
       //遍历所有的index
-      IndexSchema* index_schema = (*p)->GetIndexKeySchema();
       vector<Field> index_fields;
-      for(auto it:index_schema->GetColumns()){
-        index_id_t tmp;
-        if(tableinfo->GetSchema()->GetColumnIndex(it->GetName(),tmp)==DB_SUCCESS){
-          index_fields.push_back(fields[tmp]);
-        }
+      for(auto tmp:resolved.key_columns_[p-indexes.begin()]){
+        index_fields.push_back(*row.GetField(tmp));
       }
-      Row index_row(index_fields);
+      Row index_row(std::move(index_fields));
       dberr_t IsInsert=(*p)->GetIndex()->InsertEntry(index_row,row.GetRowId(),nullptr);
       //cout<<"RowID: "<<row.GetRowId().Get()<<endl;
       if(IsInsert==DB_FAILED){
@@ -950,15 +2156,11 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
         cout<<"Insert Failed, Affects 0 Record!"<<endl;
         //把前面插入过的全都撤销掉
         for(auto q=indexes.begin();q!=p;q++){
-          IndexSchema* index_schema_already = (*q)->GetIndexKeySchema();
           vector<Field> index_fields_already;
-          for(auto it:index_schema_already->GetColumns()){
-            index_id_t tmp_already;
-            if(tableinfo->GetSchema()->GetColumnIndex(it->GetName(),tmp_already)==DB_SUCCESS){
-              index_fields_already.push_back(fields[tmp_already]);
-            }
+          for(auto tmp_already:resolved.key_columns_[q-indexes.begin()]){
+            index_fields_already.push_back(*row.GetField(tmp_already));
           }
-          Row index_row_already(index_fields_already);
+          Row index_row_already(std::move(index_fields_already));
           (*q)->GetIndex()->RemoveEntry(index_row_already,row.GetRowId(),nullptr);
         }
         tableheap->MarkDelete(row.GetRowId(),nullptr);
@@ -982,50 +2184,47 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
     return DB_FAILED;
   }
   string table_name=ast->child_->val_;
-  TableInfo *tableinfo = nullptr;
   // dberr_t GetRet = current_db->catalog_mgr_->GetTable(table_name, tableinfo);
   // if (GetRet==DB_TABLE_NOT_EXIST){
   //   cout<<"Table Not Exist!"<<endl;
   //   return DB_FAILED;
   // }
-  if(dbs_[current_db_]->catalog_mgr_->GetTable(table_name, tableinfo) == DB_TABLE_NOT_EXIST) {
+  // a cached statement looks its table and indexes up once per catalog version
+  PreparedStatement::Resolved uncached;
+  PreparedStatement::Resolved *resolved = ResolveTable(table_name,context,uncached);
+  if(resolved == nullptr) {
     cout << "Table '"<< table_name <<"' doesn't exist" << endl;
     return DB_FAILED;
   }
+  TableInfo *tableinfo = resolved->table_;
   TableHeap *tableheap=tableinfo->GetTableHeap();//�õ�����Ӧ���ļ���
   auto del = ast->child_;
   vector<Row *> tar;
 
   if(del->next_==nullptr){//��ȡ����ѡ��������row������vector<Row*> tar��
-    for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-      Row* tp = new Row(*it);
+    for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();++it){
+      Row* tp = new Row(it.GetRowId(), &context->heap_);
+      it.GetRowView().ToRow(tp);
       tar.push_back(tp);
     }  
   }
-  else{
-    vector<Row*> origin_rows;
-    for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-      Row* tp = new Row(*it);
-      origin_rows.push_back(tp);
-    }
-    tar  = rec_sel(del->next_->child_, *&origin_rows,tableinfo,current_db->catalog_mgr_); 
+  else if(!rec_scan(del->next_->child_,tableinfo,current_db->catalog_mgr_,&context->heap_,tar,nullptr,
+                    rec_where(del->next_->child_,*resolved,context->statement_))){
+    cout<<"Delete Failed, Affects 0 Record!"<<endl;
+    return DB_FAILED;
   }
   for(auto it:tar){
     tableheap->ApplyDelete(it->GetRowId(),nullptr);
   }
   cout<<"Delete Success, Affects "<<tar.size()<<" Record!"<<endl;
-  vector <IndexInfo*> indexes;//���������������indexinfo
-  current_db->catalog_mgr_->GetTableIndexes(table_name,indexes);
+  const vector <IndexInfo*> &indexes = resolved->indexes_;//���������������indexinfo
   for(auto p=indexes.begin();p<indexes.end();p++){
     for(auto j:tar){
       vector<Field> index_fields;
-      for(auto it:(*p)->GetIndexKeySchema()->GetColumns()){
-        index_id_t tmp;
-        if(tableinfo->GetSchema()->GetColumnIndex(it->GetName(),tmp)==DB_SUCCESS){
-          index_fields.push_back(*j->GetField(tmp));
-        }
+      for(auto tmp:resolved->key_columns_[p-indexes.begin()]){
+        index_fields.push_back(*j->GetField(tmp));
       }
-      Row index_row(index_fields);
+      Row index_row(std::move(index_fields));
       (*p)->GetIndex()->RemoveEntry(index_row,j->GetRowId(),nullptr);
     }
   }
@@ -1037,31 +2236,50 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
   LOG(INFO) << "ExecuteUpdate" << std::endl;
 #endif
   string table_name=ast->child_->val_;
-  TableInfo *tableinfo = nullptr;
-  dberr_t GetRet = current_db->catalog_mgr_->GetTable(table_name, tableinfo);
-  if (GetRet==DB_TABLE_NOT_EXIST){
+  // a cached statement looks its table and indexes up once per catalog version
+  PreparedStatement::Resolved uncached;
+  PreparedStatement::Resolved *resolved = ResolveTable(table_name,context,uncached);
+  if (resolved==nullptr){
     cout<<"Table Not Exist!"<<endl;
     return DB_FAILED;
   }
+  TableInfo *tableinfo = resolved->table_;
   TableHeap* tableheap=tableinfo->GetTableHeap();//�õ�����Ӧ���ļ���
   auto updates = ast->child_->next_;
   vector<Row*> tar;
 
   if(updates->next_==nullptr){//��ȡ����ѡ��������row������vector<Row*> tar��
-    for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-      Row* tp = new Row(*it);
+    for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();++it){
+      Row* tp = new Row(it.GetRowId(), &context->heap_);
+      it.GetRowView().ToRow(tp);
       tar.push_back(tp);
     }
     // cout<<"---- all "<<tar.size()<<" ----"<<endl;    
   }
-  else{
-    vector<Row*> origin_rows;
-    for(auto it=tableinfo->GetTableHeap()->Begin(nullptr);it!=tableinfo->GetTableHeap()->End();it++){
-      Row* tp = new Row(*it);
-      origin_rows.push_back(tp);
+  else if(!rec_scan(updates->next_->child_,tableinfo,current_db->catalog_mgr_,&context->heap_,tar,nullptr,
+                    rec_where(updates->next_->child_,*resolved,context->statement_))){
+    cout<<"Update Failed, Affects 0 Record!"<<endl;
+    return DB_FAILED;
+  }
+  // index entries of the old values go first, they are keyed by the old row id
+  const vector <IndexInfo*> &indexes = resolved->indexes_;
+  auto index_key = [&](uint32_t i, Row *row){
+    vector<Field> index_fields;
+    for(auto tmp:resolved->key_columns_[i]){
+      index_fields.push_back(*row->GetField(tmp));
     }
-    tar  = rec_sel(updates->next_->child_, *&origin_rows,tableinfo,current_db->catalog_mgr_);
-    // cout<<"---- part "<<tar.size()<<" ----"<<endl;   
+    return Row(std::move(index_fields));
+  };
+  for(auto it:tar){
+    for(uint32_t i=0;i<indexes.size();i++){
+      indexes[i]->GetIndex()->RemoveEntry(index_key(i,it),it->GetRowId(),nullptr);
+    }
+  }
+  // the old values, to put back if the update can not be done
+  vector<Row> olds;
+  olds.reserve(tar.size());
+  for(auto it:tar){
+    olds.emplace_back(*it,&context->heap_);
   }
   updates = updates->child_;
   while(updates && updates->type_ == kNodeUpdateValue){//ֱ���ս��???
@@ -1070,31 +2288,61 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
     uint32_t index;//�ҵ�col��Ӧ��index
     tableinfo->GetSchema()->GetColumnIndex(col,index);
     TypeId tid = tableinfo->GetSchema()->GetColumn(index)->GetType();
+    // every row gets its own copy of the new value in its heap
     if(tid == kTypeInt){
-      Field* newval = new Field(kTypeInt,stoi(upval));
+      Field newval(kTypeInt,stoi(upval));
       for(auto it:tar){
-        it->GetFields()[index] = newval;
+        it->SetField(index,newval);
       }
     }
     else if(tid == kTypeFloat){
-      Field* newval = new Field(kTypeFloat,stof(upval));
+      Field newval(kTypeFloat,stof(upval));
       for(auto it:tar){
-        it->GetFields()[index] = newval;
+        it->SetField(index,newval);
       }
     }
     else if(tid == kTypeChar){
-      uint32_t len = tableinfo->GetSchema()->GetColumn(index)->GetLength();
-      char* tc = new char[len];
-      strcpy(tc,upval.c_str());
-      Field* newval = new Field(kTypeChar,tc,len,true);
+      Field newval(kTypeChar,const_cast<char *>(upval.c_str()),upval.size(),false);
       for(auto it:tar){
-        it->GetFields()[index] = newval;
+        it->SetField(index,newval);
       }
     }
     updates = updates->next_;
   }
+  // a new unique key may clash with a row not updated or with another new one
+  vector<std::pair<uint32_t,Row*>> inserted;
+  size_t updated = 0;
+  bool failed = false;
   for(auto it:tar){
-    tableheap->UpdateTuple(*it,it->GetRowId(),nullptr);
+    if(!tableheap->UpdateTuple(*it,it->GetRowId(),nullptr)){
+      failed = true;
+      break;
+    }
+    updated++;
+    for(uint32_t i=0;i<indexes.size();i++){
+      if(indexes[i]->GetIndex()->InsertEntry(index_key(i,it),it->GetRowId(),nullptr)==DB_FAILED){
+        failed = true;
+        break;
+      }
+      inserted.emplace_back(i,it);
+    }
+    if(failed) break;
+  }
+  if(failed){
+    // take the new entries out first, then put back every row and its old entries
+    for(auto &q:inserted){
+      indexes[q.first]->GetIndex()->RemoveEntry(index_key(q.first,q.second),q.second->GetRowId(),nullptr);
+    }
+    for(size_t i=0;i<updated;i++){
+      tableheap->UpdateTuple(olds[i],tar[i]->GetRowId(),nullptr);
+    }
+    for(auto &old:olds){
+      for(uint32_t i=0;i<indexes.size();i++){
+        indexes[i]->GetIndex()->InsertEntry(index_key(i,&old),old.GetRowId(),nullptr);
+      }
+    }
+    cout<<"Update Failed, Affects 0 Record!"<<endl;
+    return DB_FAILED;
   }
   cout<<"Update Success, Affects "<<tar.size()<<" Record!"<<endl;
   return DB_SUCCESS;
@@ -1133,18 +2381,8 @@ dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context)
   if (infile.is_open()){ //if open fails,return false
     string s;
     while(getline(infile,s)){//read line by line
-      YY_BUFFER_STATE bp = yy_scan_string(s.c_str());
-      if (bp == nullptr) {
-        LOG(ERROR) << "Failed to create yy buffer state." << std::endl;
-        exit(1);
-      }
-      yy_switch_to_buffer(bp);
-      // init parser module
-      MinisqlParserInit();
-      // parse
-      yyparse();
       ExecuteContext context;
-      Execute(MinisqlGetParserRootNode(), &context);
+      ExecuteSql(s.c_str(), &context);
     }
     return DB_SUCCESS;
   }
@@ -1162,3 +2400,74 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
   context->flag_quit_ = true;
   return DB_SUCCESS;
 }
+
+dberr_t ExecuteEngine::ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteAnalyze" << std::endl;
+#endif
+  if(current_db_ == ""){
+    cout << "ERROR: No database selected" << endl;
+    return DB_FAILED;
+  }
+  TableStatistics *stats;
+  dberr_t ret = current_db->catalog_mgr_->AnalyzeTable(ast->child_->val_, nullptr, stats);
+  if(ret == DB_TABLE_NOT_EXIST){
+    cout<<"Table Not Exist!"<<endl;
+    return ret;
+  }
+  if(ret != DB_SUCCESS) return ret;
+  cout<<"Analyze Success, "<<stats->GetRowCount()<<" Rows in "<<stats->GetPageCount()<<" Pages!"<<endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecutePrepare(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecutePrepare" << std::endl;
+#endif
+  string name = ast->child_->val_;
+  auto statement = std::make_unique<PreparedStatement>(ast->child_->next_);
+  uint32_t count = statement->GetParameterCount();
+  prepared_[name] = std::move(statement);
+  cout<<"Statement '"<<name<<"' Prepared, "<<count<<" Parameters!"<<endl;
+  return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteExecute(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteExecute" << std::endl;
+#endif
+  string name = ast->child_->val_;
+  auto it = prepared_.find(name);
+  if(it == prepared_.end()){
+    cout<<"Statement '"<<name<<"' doesn't exist"<<endl;
+    return DB_FAILED;
+  }
+  vector<Literal> literals;
+  pSyntaxNode values = ast->child_->next_;
+  for(pSyntaxNode value = values == nullptr ? nullptr : values->child_;value != nullptr;value = value->next_){
+    literals.push_back({value->type_, value->val_ == nullptr ? "" : value->val_});
+  }
+  return ExecuteStatement(it->second.get(),literals,context);
+}
+
+dberr_t ExecuteEngine::ExecuteExplain(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteExplain" << std::endl;
+#endif
+  if(current_db_ == ""){
+    cout << "ERROR: No database selected" << endl;
+    return DB_FAILED;
+  }
+  // EXPLAIN ANALYZE runs the select, discarding its rows
+  Explain explain(ast->val_ != nullptr,current_db->bpm_,current_db->disk_mgr_);
+  context->explain_ = &explain;
+  dberr_t ret = ExecuteSelect(ast->child_, context);
+  context->explain_ = nullptr;
+  if(ret != DB_SUCCESS) return ret;
+  cout<<"--------------------"<<endl;
+  cout<<"QUERY PLAN"<<endl;
+  cout<<"--------------------"<<endl;
+  explain.Print(cout,context->parse_time_);
+  cout<<"Explain Success!"<<endl;
+  return DB_SUCCESS;
+}
@@ -0,0 +1,97 @@
+#include "executor/explain.h"
+
+#include <cstdio>
+
+namespace {
+
+/**
+ * @return d in milliseconds, eg: "1.250 ms"
+ */
+std::string Milliseconds(Explain::Clock::duration d) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.3f ms", std::chrono::duration<double, std::milli>(d).count());
+  return buf;
+}
+
+}  // namespace
+
+Explain::Explain(bool analyze, BufferPoolManager *buffer_pool_manager, DiskManager *disk_manager)
+    : analyze_(analyze),
+      buffer_pool_manager_(buffer_pool_manager),
+      disk_manager_(disk_manager),
+      start_(Clock::now()),
+      execute_(start_),
+      entered_(start_) {}
+
+uint32_t Explain::Add(uint32_t parent, std::string name) {
+  uint32_t id = operators_.size();
+  operators_.push_back({std::move(name), parent, {}});
+  if (parent != NO_OPERATOR) operators_[parent].children_.push_back(id);
+  return id;
+}
+
+void Explain::Count(uint32_t id, uint64_t rows_in, uint64_t rows_out) {
+  operators_[id].rows_in_ += rows_in;
+  operators_[id].rows_out_ += rows_out;
+}
+
+uint32_t Explain::Switch(uint32_t id) {
+  uint32_t previous = running_;
+  if (id == previous) return previous;
+  if (analyze_) {
+    // charge the operator leaving what happened since it was entered
+    Clock::time_point now = Clock::now();
+    uint64_t hits = buffer_pool_manager_->GetHitCount(), misses = buffer_pool_manager_->GetMissCount();
+    uint64_t reads = disk_manager_->GetReadCount(), writes = disk_manager_->GetWriteCount();
+    if (previous != NO_OPERATOR) {
+      Operator &op = operators_[previous];
+      op.time_ += now - entered_;
+      op.hits_ += hits - hits_;
+      op.misses_ += misses - misses_;
+      op.reads_ += reads - reads_;
+      op.writes_ += writes - writes_;
+    }
+    entered_ = now;
+    hits_ = hits;
+    misses_ = misses;
+    reads_ = reads;
+    writes_ = writes;
+  }
+  running_ = id;
+  return previous;
+}
+
+Explain::Visit Explain::Output(uint32_t id, Visit visit) {
+  uint32_t parent = operators_[id].parent_;
+  return [this, id, parent, visit = std::move(visit)](const Row &row) {
+    operators_[id].rows_out_++;
+    if (parent != NO_OPERATOR) operators_[parent].rows_in_++;
+    Running running(this, parent);
+    return visit(row);
+  };
+}
+
+void Explain::Print(std::ostream &os, Clock::duration parse_time) const {
+  Clock::time_point end = Clock::now();
+  for (uint32_t id = 0; id < operators_.size(); id++) {
+    if (operators_[id].parent_ == NO_OPERATOR) Print(os, id, 0);
+  }
+  if (analyze_) {
+    os << "Parse: " << Milliseconds(parse_time) << ", Plan: " << Milliseconds(execute_ - start_)
+       << ", Execute: " << Milliseconds(end - execute_) << std::endl;
+  }
+}
+
+void Explain::Print(std::ostream &os, uint32_t id, uint32_t depth) const {
+  const Operator &op = operators_[id];
+  os << std::string(depth * 2, ' ') << (depth > 0 ? "-> " : "") << op.name_;
+  if (analyze_) {
+    os << "  (time=" << Milliseconds(op.time_) << ", rows in=" << op.rows_in_ << " out=" << op.rows_out_
+       << ", hits=" << op.hits_ << " misses=" << op.misses_ << ", read=" << op.reads_ << " written=" << op.writes_
+       << ")";
+  }
+  os << std::endl;
+  for (auto child : op.children_) {
+    Print(os, child, depth + 1);
+  }
+}
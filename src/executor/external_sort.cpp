@@ -0,0 +1,239 @@
+#include "executor/external_sort.h"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+#include "record/type_kernel.h"
+
+namespace {
+
+inline void AppendBigEndian(std::string &key, uint32_t bits) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<char>(bits >> shift));
+  }
+}
+
+/**
+ * Reader of a run with its current row and the normalized key of the row
+ */
+struct RunCursor {
+  explicit RunCursor(const SpillFile *run) : reader_(run), row_(RowId(), &arena_) {}
+
+  SpillFile::Reader reader_;
+  ArenaMemHeap arena_;
+  Row row_;
+  std::string key_;
+};
+
+}  // namespace
+
+ExternalSort::ExternalSort(BufferPoolManager *buffer_pool_manager, Schema *schema, std::vector<SortKey> keys,
+                           uint64_t limit, size_t memory_budget)
+    : buffer_pool_manager_(buffer_pool_manager),
+      schema_(schema),
+      sort_keys_(std::move(keys)),
+      limit_(limit),
+      memory_budget_(memory_budget),
+      top_n_(limit != NO_LIMIT) {}
+
+void ExternalSort::NormalizeKey(const Row &row, std::string &key) const {
+  for (const auto &sort_key : sort_keys_) {
+    size_t begin = key.size();
+    const Field *field = row.GetField(sort_key.column_);
+    if (field->IsNull()) {
+      key.push_back(0);
+    } else {
+      key.push_back(1);
+      switch (field->GetTypeId()) {
+        case kTypeInt:
+          AppendBigEndian(key, static_cast<uint32_t>(TypeKernel<kTypeInt>::Get(*field)) ^ 0x80000000u);
+          break;
+        case kTypeFloat: {
+          // 0 and -0 compare equal, negative floats order by their inverted bits
+          float value = TypeKernel<kTypeFloat>::Get(*field) == 0 ? 0 : TypeKernel<kTypeFloat>::Get(*field);
+          uint32_t bits;
+          memcpy(&bits, &value, sizeof(bits));
+          AppendBigEndian(key, (bits & 0x80000000u) != 0 ? ~bits : bits ^ 0x80000000u);
+          break;
+        }
+        default: {
+          // a zero byte is followed by 0xff, the terminator is two zero bytes
+          const char *data = TypeKernel<kTypeChar>::Get(*field);
+          for (uint32_t i = 0; i < field->GetLength(); i++) {
+            key.push_back(data[i]);
+            if (data[i] == 0) key.push_back(static_cast<char>(0xff));
+          }
+          key.append(2, 0);
+          break;
+        }
+      }
+    }
+    if (sort_key.descending_) {
+      for (size_t i = begin; i < key.size(); i++) {
+        key[i] = static_cast<char>(~key[i]);
+      }
+    }
+  }
+}
+
+void ExternalSort::Insert(Row &&row, uint64_t sequence) {
+  key_.clear();
+  NormalizeKey(row, key_);
+  memory_ += row.GetSerializedSize(schema_) + sizeof(Row) + row.GetFieldCount() * sizeof(Field) + key_.size() +
+             sizeof(Entry);
+  rows_.emplace_back(std::move(row));
+  entries_.push_back({static_cast<uint32_t>(keys_.size()), static_cast<uint32_t>(key_.size()), sequence,
+                      &rows_.back()});
+  keys_.insert(keys_.end(), key_.begin(), key_.end());
+}
+
+void ExternalSort::Offer(const Row &row) {
+  key_.clear();
+  NormalizeKey(row, key_);
+  uint64_t sequence = sequence_++;
+  auto less = [](const Candidate &lhs, const Candidate &rhs) {
+    return Less(lhs.key_, lhs.sequence_, rhs.key_, rhs.sequence_);
+  };
+  if (heap_.size() == limit_) {
+    // a row equal to the largest one came later, it sorts after it
+    if (!Less(key_, sequence, heap_.front().key_, heap_.front().sequence_)) return;
+    std::pop_heap(heap_.begin(), heap_.end(), less);
+    memory_ -= heap_.back().key_.size() + heap_.back().row_.size();
+  } else {
+    heap_.emplace_back();
+    memory_ += sizeof(Candidate);
+  }
+  // the dropped candidate is overwritten in place, reusing its strings
+  Candidate &candidate = heap_.back();
+  candidate.key_ = key_;
+  candidate.sequence_ = sequence;
+  candidate.row_.resize(row.GetSerializedSize(schema_));
+  row.SerializeTo(candidate.row_.data(), schema_);
+  memory_ += candidate.key_.size() + candidate.row_.size();
+  std::push_heap(heap_.begin(), heap_.end(), less);
+  if (memory_ > memory_budget_) {
+    LeaveTopN();
+  }
+}
+
+void ExternalSort::LeaveTopN() {
+  top_n_ = false;
+  memory_ = 0;
+  for (auto &candidate : heap_) {
+    Row row(RowId(), &arena_);
+    row.DeserializeFrom(candidate.row_.data(), schema_);
+    Insert(std::move(row), candidate.sequence_);
+  }
+  heap_.clear();
+  heap_.shrink_to_fit();
+}
+
+bool ExternalSort::Add(const Row &row) {
+  if (limit_ == 0) return true;
+  if (top_n_) {
+    Offer(row);
+    if (top_n_) return true;
+  } else {
+    Insert(Row(row, &arena_), sequence_++);
+  }
+  return memory_ <= memory_budget_ || Spill();
+}
+
+void ExternalSort::SortEntries() {
+  auto less = [this](const Entry &lhs, const Entry &rhs) {
+    return Less(KeyOf(lhs), lhs.sequence_, KeyOf(rhs), rhs.sequence_);
+  };
+  // rows past the limit are never emitted, their order does not matter
+  if (limit_ < entries_.size()) {
+    std::partial_sort(entries_.begin(), entries_.begin() + limit_, entries_.end(), less);
+  } else {
+    std::sort(entries_.begin(), entries_.end(), less);
+  }
+}
+
+bool ExternalSort::Spill() {
+  SortEntries();
+  runs_.emplace_back(buffer_pool_manager_);
+  uint64_t count = std::min<uint64_t>(entries_.size(), limit_);
+  for (uint64_t i = 0; i < count; i++) {
+    if (!runs_.back().Append(*entries_[i].row_, schema_)) return false;
+  }
+  ClearEntries();
+  return true;
+}
+
+void ExternalSort::ClearEntries() {
+  entries_.clear();
+  keys_.clear();
+  rows_.clear();
+  arena_.Reset();
+  memory_ = 0;
+}
+
+void ExternalSort::Finish(const Emit &emit) {
+  if (top_n_) {
+    std::sort_heap(heap_.begin(), heap_.end(), [](const Candidate &lhs, const Candidate &rhs) {
+      return Less(lhs.key_, lhs.sequence_, rhs.key_, rhs.sequence_);
+    });
+    ArenaMemHeap arena;
+    Row row(RowId(), &arena);
+    for (auto &candidate : heap_) {
+      row.Reset(RowId());
+      arena.Reset();
+      row.DeserializeFrom(candidate.row_.data(), schema_);
+      emit(row);
+    }
+    heap_.clear();
+    memory_ = 0;
+    return;
+  }
+  SortEntries();
+  uint64_t in_memory = std::min<uint64_t>(entries_.size(), limit_);
+  if (runs_.empty()) {
+    for (uint64_t i = 0; i < in_memory; i++) {
+      emit(*entries_[i].row_);
+    }
+    ClearEntries();
+    return;
+  }
+  // k-way merge of the runs and the sort buffer, which was filled last;
+  // ties go to the earlier source so that equal rows keep their input order
+  std::vector<std::unique_ptr<RunCursor>> cursors;
+  for (const auto &run : runs_) {
+    cursors.emplace_back(new RunCursor(&run));
+  }
+  const uint32_t buffer = cursors.size();
+  uint64_t next = 0;
+  auto advance = [&](RunCursor &cursor) {
+    cursor.row_.Reset(RowId());
+    cursor.arena_.Reset();
+    if (!cursor.reader_.Next(&cursor.row_, schema_)) return false;
+    cursor.key_.clear();
+    NormalizeKey(cursor.row_, cursor.key_);
+    return true;
+  };
+  auto key_of = [&](uint32_t source) -> std::string_view {
+    return source == buffer ? KeyOf(entries_[next]) : std::string_view(cursors[source]->key_);
+  };
+  auto greater = [&](uint32_t lhs, uint32_t rhs) { return Less(key_of(rhs), rhs, key_of(lhs), lhs); };
+  std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(greater)> queue(greater);
+  for (uint32_t i = 0; i < buffer; i++) {
+    if (advance(*cursors[i])) queue.push(i);
+  }
+  if (in_memory > 0) queue.push(buffer);
+  for (uint64_t emitted = 0; emitted < limit_ && !queue.empty(); emitted++) {
+    uint32_t source = queue.top();
+    queue.pop();
+    if (source == buffer) {
+      emit(*entries_[next].row_);
+      if (++next < in_memory) queue.push(source);
+    } else {
+      emit(cursors[source]->row_);
+      if (advance(*cursors[source])) queue.push(source);
+    }
+  }
+  cursors.clear();
+  runs_.clear();
+  ClearEntries();
+}
@@ -0,0 +1,263 @@
+#include "executor/hash_aggregate.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "record/type_kernel.h"
+
+HashAggregate::HashAggregate(BufferPoolManager *buffer_pool_manager, Schema *schema, std::vector<uint32_t> group_keys,
+                             std::vector<Aggregate> aggregates, size_t memory_budget)
+    : buffer_pool_manager_(buffer_pool_manager),
+      schema_(schema),
+      group_keys_(std::move(group_keys)),
+      aggregates_(std::move(aggregates)),
+      memory_budget_(memory_budget),
+      slots_(INITIAL_SLOTS, Slot{0, EMPTY_SLOT}) {}
+
+TypeId HashAggregate::OutputType(const Aggregate &aggregate, const Schema *schema) {
+  switch (aggregate.kind_) {
+    case kAggregateCount:
+      return kTypeInt;
+    case kAggregateAvg:
+      return kTypeFloat;
+    default:
+      return schema->GetColumn(aggregate.column_)->GetType();
+  }
+}
+
+void HashAggregate::NormalizeKey(const Row &row) {
+  key_.clear();
+  for (auto key : group_keys_) {
+    const Field *field = row.GetField(key);
+    if (field->IsNull()) {
+      key_.push_back(0);
+      continue;
+    }
+    key_.push_back(1);
+    switch (field->GetTypeId()) {
+      case kTypeInt: {
+        int32_t value = TypeKernel<kTypeInt>::Get(*field);
+        key_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        break;
+      }
+      case kTypeFloat: {
+        // 0 and -0 compare equal
+        float value = TypeKernel<kTypeFloat>::Get(*field) == 0 ? 0 : TypeKernel<kTypeFloat>::Get(*field);
+        key_.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        break;
+      }
+      default: {
+        uint32_t len = field->GetLength();
+        key_.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        key_.append(TypeKernel<kTypeChar>::Get(*field), len);
+        break;
+      }
+    }
+  }
+}
+
+uint32_t HashAggregate::Find(uint64_t hash, uint32_t &slot) const {
+  uint32_t mask = slots_.size() - 1;
+  for (slot = hash & mask;; slot = (slot + 1) & mask) {
+    const Slot &probe = slots_[slot];
+    if (probe.group_ == EMPTY_SLOT) return EMPTY_SLOT;
+    if (probe.hash_ == hash && GroupKey(probe.group_) == key_) return probe.group_;
+  }
+}
+
+uint32_t HashAggregate::Insert(uint64_t hash, uint32_t slot) {
+  uint32_t group = key_offsets_.size() - 1;
+  keys_.insert(keys_.end(), key_.begin(), key_.end());
+  key_offsets_.push_back(keys_.size());
+  accumulators_.resize(accumulators_.size() + aggregates_.size(), Accumulator{0, 0, 0, 0, 0});
+  slots_[slot] = Slot{hash, group};
+  // at most half full, probes stay short
+  if (2 * (group + 1) > slots_.size()) {
+    Grow();
+  }
+  return group;
+}
+
+void HashAggregate::Grow() {
+  std::vector<Slot> slots(2 * slots_.size(), Slot{0, EMPTY_SLOT});
+  uint32_t mask = slots.size() - 1;
+  for (const auto &slot : slots_) {
+    if (slot.group_ == EMPTY_SLOT) continue;
+    uint32_t i = slot.hash_ & mask;
+    while (slots[i].group_ != EMPTY_SLOT) {
+      i = (i + 1) & mask;
+    }
+    slots[i] = slot;
+  }
+  slots_.swap(slots);
+}
+
+void HashAggregate::Update(Accumulator &accumulator, const Aggregate &aggregate, const Row &row) {
+  if (aggregate.column_ == Aggregate::COUNT_ALL) {
+    accumulator.count_++;
+    return;
+  }
+  const Field *field = row.GetField(aggregate.column_);
+  if (field->IsNull()) return;
+  bool first = accumulator.count_++ == 0;
+  if (aggregate.kind_ == kAggregateCount) return;
+  bool sum = aggregate.kind_ == kAggregateSum || aggregate.kind_ == kAggregateAvg;
+  bool min = aggregate.kind_ == kAggregateMin;
+  switch (field->GetTypeId()) {
+    case kTypeInt: {
+      int64_t value = TypeKernel<kTypeInt>::Get(*field);
+      if (sum) {
+        accumulator.integer_ += value;
+      } else if (first || (min ? value < accumulator.integer_ : value > accumulator.integer_)) {
+        accumulator.integer_ = value;
+      }
+      break;
+    }
+    case kTypeFloat: {
+      double value = TypeKernel<kTypeFloat>::Get(*field);
+      if (sum) {
+        accumulator.number_ += value;
+      } else if (first || (min ? value < accumulator.number_ : value > accumulator.number_)) {
+        accumulator.number_ = value;
+      }
+      break;
+    }
+    default: {
+      const char *value = TypeKernel<kTypeChar>::Get(*field);
+      uint32_t len = field->GetLength();
+      int cmp = first ? 0
+                      : TypeKernel<kTypeChar>::Compare(value, len, chars_.data() + accumulator.chars_offset_,
+                                                       accumulator.chars_len_);
+      // a replaced value stays in chars_ until the table is cleared
+      if (first || (min ? cmp < 0 : cmp > 0)) {
+        accumulator.chars_offset_ = chars_.size();
+        accumulator.chars_len_ = len;
+        chars_.insert(chars_.end(), value, value + len);
+      }
+      break;
+    }
+  }
+}
+
+size_t HashAggregate::GetMemory() const {
+  return slots_.size() * sizeof(Slot) + keys_.size() + key_offsets_.size() * sizeof(uint32_t) +
+         accumulators_.size() * sizeof(Accumulator) + chars_.size();
+}
+
+bool HashAggregate::Accumulate(const Row &row, uint32_t depth, std::vector<SpillFile> &partitions) {
+  NormalizeKey(row);
+  uint64_t hash = std::hash<std::string_view>()(key_);
+  uint32_t slot;
+  uint32_t group = Find(hash, slot);
+  if (group == EMPTY_SLOT) {
+    if (partitions.empty() && GetMemory() > memory_budget_ && depth + 1 < MAX_DEPTH) {
+      spilled_ = true;
+      for (uint32_t i = 0; i < PARTITION_COUNT; i++) {
+        partitions.emplace_back(buffer_pool_manager_);
+      }
+    }
+    if (!partitions.empty()) {
+      return partitions[PartitionOf(hash, depth)].Append(row, schema_);
+    }
+    group = Insert(hash, slot);
+  }
+  for (uint32_t i = 0; i < aggregates_.size(); i++) {
+    Update(accumulators_[group * aggregates_.size() + i], aggregates_[i], row);
+  }
+  return true;
+}
+
+bool HashAggregate::Add(const Row &row) { return Accumulate(row, 0, partitions_); }
+
+void HashAggregate::EmitGroups(const Emit &emit) {
+  ArenaMemHeap arena;
+  Row out(RowId(), &arena);
+  for (uint32_t group = 0; group + 1 < key_offsets_.size(); group++) {
+    out.Reset(RowId());
+    arena.Reset();
+    // the key fields back from their normalized bytes
+    const char *key = keys_.data() + key_offsets_[group];
+    for (auto column : group_keys_) {
+      TypeId type = schema_->GetColumn(column)->GetType();
+      if (*key++ == 0) {
+        out.EmplaceField(type);
+        continue;
+      }
+      if (type == kTypeInt) {
+        out.EmplaceField(type, MACH_READ_FROM(int32_t, key));
+        key += sizeof(int32_t);
+      } else if (type == kTypeFloat) {
+        out.EmplaceField(type, MACH_READ_FROM(float, key));
+        key += sizeof(float);
+      } else {
+        uint32_t len = MACH_READ_UINT32(key);
+        out.EmplaceField(type, const_cast<char *>(key + sizeof(uint32_t)), len, true);
+        key += sizeof(uint32_t) + len;
+      }
+    }
+    for (uint32_t i = 0; i < aggregates_.size(); i++) {
+      const Aggregate &aggregate = aggregates_[i];
+      const Accumulator &accumulator = accumulators_[group * aggregates_.size() + i];
+      TypeId type = OutputType(aggregate, schema_);
+      if (aggregate.kind_ == kAggregateCount) {
+        out.EmplaceField(type, static_cast<int32_t>(accumulator.count_));
+        continue;
+      }
+      bool integer = aggregate.column_ != Aggregate::COUNT_ALL &&
+                     schema_->GetColumn(aggregate.column_)->GetType() == kTypeInt;
+      bool fits = accumulator.integer_ >= INT32_MIN && accumulator.integer_ <= INT32_MAX;
+      if (accumulator.count_ == 0 || (aggregate.kind_ == kAggregateSum && integer && !fits)) {
+        out.EmplaceField(type);
+      } else if (aggregate.kind_ == kAggregateAvg) {
+        double total = integer ? accumulator.integer_ : accumulator.number_;
+        out.EmplaceField(type, static_cast<float>(total / accumulator.count_));
+      } else if (type == kTypeInt) {
+        out.EmplaceField(type, static_cast<int32_t>(accumulator.integer_));
+      } else if (type == kTypeFloat) {
+        out.EmplaceField(type, static_cast<float>(accumulator.number_));
+      } else {
+        out.EmplaceField(type, chars_.data() + accumulator.chars_offset_, accumulator.chars_len_, true);
+      }
+    }
+    emit(out);
+  }
+  ClearTable();
+}
+
+void HashAggregate::ClearTable() {
+  slots_.assign(INITIAL_SLOTS, Slot{0, EMPTY_SLOT});
+  keys_.clear();
+  key_offsets_.assign(1, 0);
+  accumulators_.clear();
+  chars_.clear();
+}
+
+bool HashAggregate::FinishPartitions(std::vector<SpillFile> &partitions, uint32_t depth, const Emit &emit) {
+  for (auto &partition : partitions) {
+    std::vector<SpillFile> children;
+    SpillFile::Reader reader(&partition);
+    ArenaMemHeap arena;
+    Row row(RowId(), &arena);
+    for (; reader.Next(&row, schema_); row.Reset(RowId()), arena.Reset()) {
+      if (!Accumulate(row, depth + 1, children)) return false;
+    }
+    partition.Clear();
+    EmitGroups(emit);
+    if (!FinishPartitions(children, depth + 1, emit)) return false;
+  }
+  return true;
+}
+
+bool HashAggregate::Finish(const Emit &emit) {
+  // no input still makes the one group of an aggregate without keys
+  if (group_keys_.empty() && key_offsets_.size() == 1) {
+    key_.clear();
+    uint32_t slot;
+    Find(std::hash<std::string_view>()(key_), slot);
+    Insert(std::hash<std::string_view>()(key_), slot);
+  }
+  EmitGroups(emit);
+  bool ok = FinishPartitions(partitions_, 0, emit);
+  partitions_.clear();
+  return ok;
+}
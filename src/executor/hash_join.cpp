@@ -0,0 +1,169 @@
+#include "executor/hash_join.h"
+
+#include "record/type_kernel.h"
+
+HashJoin::HashJoin(BufferPoolManager *buffer_pool_manager, Schema *build_schema, std::vector<uint32_t> build_keys,
+                   Schema *probe_schema, std::vector<uint32_t> probe_keys, size_t memory_budget)
+    : buffer_pool_manager_(buffer_pool_manager),
+      build_schema_(build_schema),
+      build_keys_(std::move(build_keys)),
+      probe_schema_(probe_schema),
+      probe_keys_(std::move(probe_keys)),
+      memory_budget_(memory_budget) {}
+
+bool HashJoin::HashKey(const Row &row, const std::vector<uint32_t> &keys, uint64_t &hash) {
+  hash = 0;
+  for (auto key : keys) {
+    const Field *field = row.GetField(key);
+    if (field->IsNull()) return false;
+    hash = (hash ^ HashField(*field)) * 0x9e3779b97f4a7c15ULL;
+  }
+  // the partition bits are taken from the bottom, mix the top ones into them
+  hash ^= hash >> 29;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 32;
+  return true;
+}
+
+void HashJoin::Insert(Row &&row, uint64_t hash) {
+  memory_ += row.GetSerializedSize(build_schema_) + sizeof(Row) + row.GetFieldCount() * sizeof(Field) +
+             4 * sizeof(void *);
+  rows_.emplace_back(std::move(row));
+  table_.emplace(hash, &rows_.back());
+}
+
+void HashJoin::ProbeTable(const Row &row, uint64_t hash, const Emit &emit) const {
+  auto range = table_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Row &build = *it->second;
+    bool equal = true;
+    for (uint32_t i = 0; i < build_keys_.size() && equal; i++) {
+      equal = CompareFields(*build.GetField(build_keys_[i]), *row.GetField(probe_keys_[i])) == 0;
+    }
+    if (equal) {
+      emit(build, row);
+    }
+  }
+}
+
+void HashJoin::ClearTable() {
+  table_.clear();
+  rows_.clear();
+  arena_.Reset();
+  memory_ = 0;
+}
+
+bool HashJoin::Build(const Row &row) {
+  uint64_t hash;
+  if (!HashKey(row, build_keys_, hash)) return true;
+  if (IsSpilled()) {
+    return build_partitions_[PartitionOf(hash, 0)].Append(row, build_schema_);
+  }
+  Insert(Row(row, &arena_), hash);
+  return memory_ <= memory_budget_ || Spill();
+}
+
+bool HashJoin::Spill() {
+  spilled_ = true;
+  for (uint32_t i = 0; i < PARTITION_COUNT; i++) {
+    build_partitions_.emplace_back(buffer_pool_manager_);
+    probe_partitions_.emplace_back(buffer_pool_manager_);
+  }
+  for (const auto &row : rows_) {
+    uint64_t hash;
+    HashKey(row, build_keys_, hash);
+    if (!build_partitions_[PartitionOf(hash, 0)].Append(row, build_schema_)) return false;
+  }
+  ClearTable();
+  return true;
+}
+
+bool HashJoin::Probe(const Row &row, const Emit &emit) {
+  uint64_t hash;
+  if (!HashKey(row, probe_keys_, hash)) return true;
+  if (IsSpilled()) {
+    return probe_partitions_[PartitionOf(hash, 0)].Append(row, probe_schema_);
+  }
+  ProbeTable(row, hash, emit);
+  return true;
+}
+
+size_t HashJoin::EstimateMemory(const SpillFile &file) {
+  // loaded rows take about twice their serialized size
+  return 2 * static_cast<size_t>(file.GetPageCount()) * PAGE_SIZE;
+}
+
+bool HashJoin::Finish(const Emit &emit) {
+  bool ok = true;
+  for (uint32_t i = 0; i < build_partitions_.size() && ok; i++) {
+    spilled_pages_ += build_partitions_[i].GetPageCount() + probe_partitions_[i].GetPageCount();
+    ok = JoinPartition(build_partitions_[i], probe_partitions_[i], 0, emit);
+    build_partitions_[i].Clear();
+    probe_partitions_[i].Clear();
+  }
+  build_partitions_.clear();
+  probe_partitions_.clear();
+  return ok;
+}
+
+bool HashJoin::JoinPartition(SpillFile &build, SpillFile &probe, uint32_t depth, const Emit &emit) {
+  if (build.IsEmpty() || probe.IsEmpty()) return true;
+  if (EstimateMemory(build) > memory_budget_ && depth + 1 < MAX_DEPTH) {
+    // split both sides on the next hash bits
+    std::vector<SpillFile> builds, probes;
+    for (uint32_t i = 0; i < PARTITION_COUNT; i++) {
+      builds.emplace_back(buffer_pool_manager_);
+      probes.emplace_back(buffer_pool_manager_);
+    }
+    auto split = [&](SpillFile &file, Schema *schema, const std::vector<uint32_t> &keys,
+                     std::vector<SpillFile> &parts) {
+      SpillFile::Reader reader(&file);
+      ArenaMemHeap arena;
+      Row row(RowId(), &arena);
+      for (; reader.Next(&row, schema); arena.Reset(), row.Reset(RowId())) {
+        uint64_t hash;
+        HashKey(row, keys, hash);
+        if (!parts[PartitionOf(hash, depth + 1)].Append(row, schema)) return false;
+      }
+      file.Clear();
+      return true;
+    };
+    if (!split(build, build_schema_, build_keys_, builds) || !split(probe, probe_schema_, probe_keys_, probes)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < PARTITION_COUNT; i++) {
+      spilled_pages_ += builds[i].GetPageCount() + probes[i].GetPageCount();
+      if (!JoinPartition(builds[i], probes[i], depth + 1, emit)) return false;
+      builds[i].Clear();
+      probes[i].Clear();
+    }
+    return true;
+  }
+  // load the build side a budget at a time, the probe side is read once per load
+  SpillFile::Reader build_reader(&build);
+  bool more = true;
+  while (more) {
+    more = false;
+    Row row(RowId(), &arena_);
+    while (build_reader.Next(&row, build_schema_)) {
+      uint64_t hash;
+      HashKey(row, build_keys_, hash);
+      Insert(std::move(row), hash);
+      row = Row(RowId(), &arena_);
+      if (memory_ > memory_budget_) {
+        more = true;
+        break;
+      }
+    }
+    SpillFile::Reader probe_reader(&probe);
+    ArenaMemHeap arena;
+    Row probe_row(RowId(), &arena);
+    for (; probe_reader.Next(&probe_row, probe_schema_); arena.Reset(), probe_row.Reset(RowId())) {
+      uint64_t hash;
+      HashKey(probe_row, probe_keys_, hash);
+      ProbeTable(probe_row, hash, emit);
+    }
+    ClearTable();
+  }
+  return true;
+}
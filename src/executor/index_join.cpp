@@ -0,0 +1,70 @@
+#include "executor/index_join.h"
+
+#include <algorithm>
+
+#include "record/type_kernel.h"
+
+IndexJoin::IndexJoin(TableHeap *inner_heap, Schema *inner_schema, std::vector<uint32_t> inner_keys, Index *index,
+                     std::vector<uint32_t> outer_keys, uint32_t batch_size)
+    : inner_heap_(inner_heap),
+      inner_schema_(inner_schema),
+      inner_keys_(std::move(inner_keys)),
+      index_(index),
+      outer_keys_(std::move(outer_keys)),
+      batch_size_(batch_size) {
+  keys_.reserve(batch_size_);
+}
+
+bool IndexJoin::Probe(const Row &row, const Emit &emit) {
+  for (auto key : outer_keys_) {
+    if (row.GetField(key)->IsNull()) return true;
+  }
+  // a char longer than the inner column matches nothing and fits no index key
+  const Field *key = row.GetField(outer_keys_[0]);
+  const Column *column = inner_schema_->GetColumn(inner_keys_[0]);
+  if (key->GetTypeId() == kTypeChar && key->GetLength() > column->GetLength()) return true;
+  outer_rows_.emplace_back(row, &arena_);
+  keys_.emplace_back(RowId(), &arena_);
+  keys_.back().EmplaceField(*key);
+  return outer_rows_.size() < batch_size_ || ProbeBatch(emit);
+}
+
+bool IndexJoin::Finish(const Emit &emit) { return outer_rows_.empty() || ProbeBatch(emit); }
+
+bool IndexJoin::ProbeBatch(const Emit &emit) {
+  batch_count_++;
+  std::vector<std::vector<RowId>> result;
+  bool ok = index_->ScanKeys(keys_, result, nullptr) != DB_FAILED;
+  // every match as its row id and outer row, in page order
+  std::vector<std::pair<int64_t, uint32_t>> matches;
+  for (uint32_t i = 0; ok && i < result.size(); i++) {
+    for (auto rid : result[i]) {
+      if (rid.GetPageId() >= 0) matches.emplace_back(rid.Get(), i);
+    }
+  }
+  std::sort(matches.begin(), matches.end());
+  ArenaMemHeap arena;
+  Row inner(RowId(), &arena);
+  bool fetched = false;
+  for (uint32_t i = 0; i < matches.size(); i++) {
+    if (i == 0 || matches[i].first != matches[i - 1].first) {
+      inner.Reset(RowId(matches[i].first));
+      arena.Reset();
+      fetched = inner_heap_->GetTuple(&inner, nullptr);
+    }
+    if (!fetched) continue;
+    const Row &outer = outer_rows_[matches[i].second];
+    bool equal = true;
+    for (uint32_t k = 0; k < inner_keys_.size() && equal; k++) {
+      const Field *field = inner.GetField(inner_keys_[k]);
+      equal = !field->IsNull() && CompareFields(*field, *outer.GetField(outer_keys_[k])) == 0;
+    }
+    if (equal) {
+      emit(outer, inner);
+    }
+  }
+  keys_.clear();
+  outer_rows_.clear();
+  arena_.Reset();
+  return ok;
+}
@@ -0,0 +1,94 @@
+#include "executor/parallel_scan.h"
+
+#include <thread>
+
+#include "executor/vector_filter.h"
+
+ParallelScan::ParallelScan(TableHeap *table_heap, const Predicate &predicate, uint32_t workers,
+                           uint32_t morsel_pages)
+    : table_heap_(table_heap),
+      predicate_(predicate),
+      workers_(std::max(workers, 1u)),
+      morsel_pages_(std::max(morsel_pages, 1u)) {}
+
+void ParallelScan::Work() {
+  VectorFilter filter(predicate_);
+  uint16_t selection[VectorFilter::BATCH_SIZE];
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    space_.wait(lock, [&] {
+      return stopped_ || next_page_ == page_ids_.size() || morsels_.size() < workers_ * WINDOW_PER_WORKER;
+    });
+    if (stopped_ || next_page_ == page_ids_.size()) break;
+    // claiming a morsel only reads the page list, the pages are fetched unlatched
+    morsels_.emplace_back(new Morsel);
+    Morsel *morsel = morsels_.back().get();
+    claimed_++;
+    size_t end = std::min<size_t>(next_page_ + morsel_pages_, page_ids_.size());
+    morsel->page_ids_.assign(page_ids_.begin() + next_page_, page_ids_.begin() + end);
+    next_page_ = end;
+    lock.unlock();
+    auto visit_batch = [&](const RowView *views, uint32_t count) {
+      scanned_ += count;
+      uint32_t selected = filter.Select(views, count, selection);
+      for (uint32_t i = 0; i < selected; i++) {
+        const RowView &view = views[selection[i]];
+        morsel->rows_.emplace_back(view.GetRowId(), &morsel->heap_);
+        view.ToRow(&morsel->rows_.back());
+      }
+      return !stopped_;
+    };
+    bool fetched = predicate_.IsFalse() ||
+                   table_heap_->ScanPageBatches(morsel->page_ids_, VectorFilter::BATCH_SIZE, morsel_pages_, visit_batch);
+    lock.lock();
+    if (!fetched) {
+      // the rows of the table after this morsel are not worth scanning any more
+      failed_ = true;
+      stopped_ = true;
+      space_.notify_all();
+    }
+    morsel->done_ = true;
+    ready_.notify_all();
+  }
+  running_--;
+  ready_.notify_all();
+}
+
+bool ParallelScan::Run(const Visit &visit) {
+  if (!table_heap_->GetPageIds(page_ids_)) return false;
+  running_ = workers_;
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < workers_; i++) {
+    threads.emplace_back(&ParallelScan::Work, this);
+  }
+  while (true) {
+    std::unique_ptr<Morsel> morsel;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      ready_.wait(lock, [&] {
+        if (failed_) return true;
+        return morsels_.empty() ? next_page_ == page_ids_.size() || running_ == 0 : morsels_.front()->done_;
+      });
+      if (failed_ || morsels_.empty()) break;
+      morsel = std::move(morsels_.front());
+      morsels_.pop_front();
+      space_.notify_one();
+    }
+    bool more = true;
+    for (auto &row : morsel->rows_) {
+      if (!(more = visit(row))) break;
+    }
+    if (!more) break;
+  }
+  // the workers leave their morsels unfinished
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    stopped_ = true;
+    space_.notify_all();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  morsels_.clear();
+  return !failed_;
+}
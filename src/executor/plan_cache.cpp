@@ -0,0 +1,149 @@
+#include "executor/plan_cache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace {
+
+/**
+ * @return number of nodes in the subtrees of node and its siblings
+ */
+size_t CountNodes(pSyntaxNode node) {
+  size_t count = 0;
+  for (; node != nullptr; node = node->next_) {
+    count += 1 + CountNodes(node->child_);
+  }
+  return count;
+}
+
+/**
+ * @return length of the number the lexer reads at p, 0 if none
+ */
+size_t NumberLength(const char *p) {
+  const char *q = p;
+  if (*q == '-') q++;
+  while (isdigit(*q)) q++;
+  if (*q == '.' && isdigit(q[1])) {
+    q++;
+    while (isdigit(*q)) q++;
+  }
+  bool digits = false;
+  for (const char *r = p; r < q; r++) digits = digits || isdigit(*r);
+  return digits ? q - p : 0;
+}
+
+}  // namespace
+
+PreparedStatement::PreparedStatement(pSyntaxNode tree, bool literal_parameters) {
+  // the values point into vals_, which must not grow while copying
+  size_t count = CountNodes(tree);
+  nodes_.reserve(count);
+  vals_.reserve(count);
+  Copy(tree, literal_parameters);
+  // the lexer creates the nodes of the tokens in text order
+  std::sort(parameters_.begin(), parameters_.end(),
+            [&](uint32_t a, uint32_t b) { return nodes_[a]->id_ < nodes_[b]->id_; });
+}
+
+pSyntaxNode PreparedStatement::Copy(pSyntaxNode node, bool literal_parameters) {
+  if (node == nullptr) return nullptr;
+  uint32_t id = nodes_.size();
+  nodes_.emplace_back(new SyntaxNode(*node));
+  vals_.emplace_back(node->val_ == nullptr ? "" : node->val_);
+  pSyntaxNode copy = nodes_.back().get();
+  copy->val_ = node->val_ == nullptr ? nullptr : &vals_[id][0];
+  if (node->type_ == kNodeParameter ||
+      (literal_parameters && (node->type_ == kNodeNumber || node->type_ == kNodeString))) {
+    parameters_.push_back(id);
+  }
+  copy->child_ = Copy(node->child_, literal_parameters);
+  copy->next_ = Copy(node->next_, literal_parameters);
+  return copy;
+}
+
+bool PreparedStatement::Bind(const std::vector<Literal> &literals) {
+  if (literals.size() != parameters_.size()) return false;
+  for (uint32_t i = 0; i < parameters_.size(); i++) {
+    SyntaxNode *node = nodes_[parameters_[i]].get();
+    node->type_ = literals[i].type_;
+    if (literals[i].type_ == kNodeNull) {
+      node->val_ = nullptr;
+      continue;
+    }
+    std::string &val = vals_[parameters_[i]];
+    val = literals[i].val_;
+    node->val_ = &val[0];
+  }
+  return true;
+}
+
+bool PreparedStatement::FindParameter(pSyntaxNode node, uint32_t &slot) const {
+  for (slot = 0; slot < parameters_.size(); slot++) {
+    if (nodes_[parameters_[slot]].get() == node) return true;
+  }
+  return false;
+}
+
+bool PlanCache::Normalize(const char *sql, std::string &key, std::vector<Literal> &literals) {
+  key.clear();
+  literals.clear();
+  const char *p = sql;
+  while (isspace(*p)) p++;
+  static const char *statements[] = {"select", "insert", "delete", "update"};
+  bool cached = false;
+  for (auto statement : statements) {
+    size_t len = strlen(statement);
+    cached = cached || (strncmp(p, statement, len) == 0 && !isalnum(p[len]) && p[len] != '_');
+  }
+  if (!cached) return false;
+  while (*p != '\0') {
+    if (isspace(*p)) {
+      while (isspace(*p)) p++;
+      key.push_back(' ');
+    } else if (*p == '"') {
+      // the lexer takes the chars between the quotes as they are, escapes too
+      const char *q = p + 1;
+      while (*q != '\0' && *q != '"') q += (*q == '\\' && q[1] != '\0') ? 2 : 1;
+      if (*q == '\0') return false;
+      literals.push_back({kNodeString, std::string(p + 1, q)});
+      key.push_back('?');
+      p = q + 1;
+    } else if (isalpha(*p) || *p == '_') {
+      // identifiers and keywords, their digits are no numbers
+      while (isalnum(*p) || *p == '_') key.push_back(*p++);
+    } else if (size_t len = NumberLength(p)) {
+      literals.push_back({kNodeNumber, std::string(p, len)});
+      key.push_back('?');
+      p += len;
+    } else if (*p == '?') {
+      return false;
+    } else {
+      key.push_back(*p++);
+    }
+  }
+  while (!key.empty() && key.back() == ' ') key.pop_back();
+  return true;
+}
+
+PreparedStatement *PlanCache::Find(const std::string &key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) return nullptr;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second.get();
+}
+
+PreparedStatement *PlanCache::Insert(const std::string &key, std::unique_ptr<PreparedStatement> statement) {
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.erase(it->second);
+    entries_.erase(it);
+  }
+  lru_.emplace_front(key, std::move(statement));
+  entries_[key] = lru_.begin();
+  if (entries_.size() > capacity_) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  return lru_.front().second.get();
+}
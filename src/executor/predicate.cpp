@@ -0,0 +1,174 @@
+#include "executor/predicate.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+
+/**
+ * Bit cmp + 1 set for every three-way compare outcome cmp op holds on
+ */
+uint8_t HoldsMask(CompareOp op) {
+  switch (op) {
+    case kCompareEqual:
+      return 0b010;
+    case kCompareNotEqual:
+      return 0b101;
+    case kCompareLess:
+      return 0b001;
+    case kCompareGreater:
+      return 0b100;
+    case kCompareLessEqual:
+      return 0b011;
+    case kCompareGreaterEqual:
+      return 0b110;
+  }
+  return 0;
+}
+
+}  // namespace
+
+uint32_t Predicate::AddNode(Node node) {
+  nodes_.push_back(std::move(node));
+  return nodes_.size() - 1;
+}
+
+uint32_t Predicate::AddCompare(uint32_t column, CompareOp op, const Field &constant) {
+  if (constant.IsNull()) return AddConstant(false);
+  Node node{kPredicateCompare, op, column, 0, false, 0, 0, 0, ""};
+  switch (constant.GetTypeId()) {
+    case kTypeInt:
+      node.int_ = TypeKernel<kTypeInt>::Get(constant);
+      break;
+    case kTypeFloat:
+      node.float_ = TypeKernel<kTypeFloat>::Get(constant);
+      break;
+    default:
+      node.chars_.assign(constant.GetData(), constant.GetLength());
+      break;
+  }
+  return AddNode(std::move(node));
+}
+
+uint32_t Predicate::AddCompareNumber(uint32_t column, CompareOp op, double number) {
+  if (types_[column] == kTypeChar) return AddConstant(false);
+  if (types_[column] == kTypeInt && number >= INT32_MIN && number <= INT32_MAX &&
+      number == static_cast<int32_t>(number)) {
+    return AddCompare(column, op, Field(kTypeInt, static_cast<int32_t>(number)));
+  }
+  if (types_[column] == kTypeFloat && std::fabs(number) <= FLT_MAX && number == static_cast<float>(number)) {
+    return AddCompare(column, op, Field(kTypeFloat, static_cast<float>(number)));
+  }
+  // no value equals the number, and past the int range every value compares the same
+  int cmp = 0;
+  if (types_[column] == kTypeInt && (number > INT32_MAX || number < INT32_MIN)) cmp = number > 0 ? -1 : 1;
+  if (op == kCompareEqual || op == kCompareNotEqual || cmp != 0) {
+    bool holds = cmp == 0 ? op == kCompareNotEqual : (HoldsMask(op) >> (cmp + 1)) & 1;
+    return holds ? AddNullTest(column, false) : AddConstant(false);
+  }
+  return AddNode({kPredicateCompareNumber, op, column, 0, false, 0, 0, number, ""});
+}
+
+uint32_t Predicate::AddParameter(uint32_t column, CompareOp op, uint32_t slot) {
+  uint32_t node = AddNode({kPredicateParameter, op, column, slot, false, 0, 0, 0, ""});
+  parameters_.push_back({slot, column, op, node});
+  return node;
+}
+
+uint32_t Predicate::AddCompareColumns(uint32_t column, CompareOp op, uint32_t other) {
+  if ((types_[column] == kTypeChar) != (types_[other] == kTypeChar)) return AddConstant(false);
+  if (column == other) {
+    // a column equals itself unless it is null
+    bool reflexive = op == kCompareEqual || op == kCompareLessEqual || op == kCompareGreaterEqual;
+    return reflexive ? AddNullTest(column, false) : AddConstant(false);
+  }
+  return AddNode({kPredicateCompareColumns, op, column, other, false, 0, 0, 0, ""});
+}
+
+uint32_t Predicate::AddNullTest(uint32_t column, bool is_null) {
+  return AddNode({kPredicateNullTest, kCompareEqual, column, 0, is_null, 0, 0, 0, ""});
+}
+
+uint32_t Predicate::AddConnector(bool conjunction, uint32_t lhs, uint32_t rhs) {
+  // false absorbs a conjunction and true a disjunction, the other value drops out
+  int lhs_value = ConstantOf(lhs), rhs_value = ConstantOf(rhs);
+  if (lhs_value == !conjunction || rhs_value == !conjunction) return AddConstant(!conjunction);
+  if (lhs_value >= 0) return rhs;
+  if (rhs_value >= 0) return lhs;
+  return AddNode({kPredicateConnector, kCompareEqual, lhs, rhs, conjunction, 0, 0, 0, ""});
+}
+
+uint32_t Predicate::AddConstant(bool value) {
+  return AddNode({kPredicateConstant, kCompareEqual, 0, 0, value, 0, 0, 0, ""});
+}
+
+void Predicate::AddConjunct(uint32_t node) {
+  if (ConstantOf(node) == 1) return;
+  conjuncts_.push_back(node);
+  EmitProgram();
+}
+
+void Predicate::BindParameter(uint32_t parameter, uint32_t node) {
+  // the comparisons of parameters are leaves, no other node refers to the one moved
+  nodes_[parameters_[parameter].node_] = std::move(nodes_[node]);
+  if (node + 1 == nodes_.size()) nodes_.pop_back();
+  EmitProgram();
+}
+
+void Predicate::EmitProgram() {
+  // one program for all the conjuncts, a false one jumps past the end
+  program_.clear();
+  false_ = std::any_of(conjuncts_.begin(), conjuncts_.end(),
+                       [&](uint32_t conjunct) { return ConstantOf(conjunct) == 0; });
+  if (false_) return;
+  std::vector<uint32_t> jumps;
+  for (auto conjunct : conjuncts_) {
+    Emit(conjunct);
+    jumps.push_back(program_.size());
+    program_.push_back({kJumpIfFalse, 0, 0, 0, 0, 0, 0, 0, ""});
+  }
+  for (auto jump : jumps) {
+    program_[jump].target_ = program_.size();
+  }
+}
+
+void Predicate::Emit(uint32_t id) {
+  const Node &node = nodes_[id];
+  switch (node.kind_) {
+    case kPredicateConnector: {
+      // the rhs only runs when the lhs does not decide
+      Emit(node.column_);
+      uint32_t jump = program_.size();
+      program_.push_back({node.flag_ ? kJumpIfFalse : kJumpIfTrue, 0, 0, 0, 0, 0, 0, 0, ""});
+      Emit(node.other_);
+      program_[jump].target_ = program_.size();
+      break;
+    }
+    case kPredicateConstant:
+    case kPredicateParameter:
+      // a parameter not bound yet never holds, its flag is false
+      program_.push_back({kConstant, node.flag_, 0, 0, 0, 0, 0, 0, ""});
+      break;
+    case kPredicateNullTest:
+      program_.push_back({kIsNull, node.flag_, node.column_, 0, 0, 0, 0, 0, ""});
+      break;
+    case kPredicateCompare: {
+      OpCode code = types_[node.column_] == kTypeInt     ? kCompareInt
+                    : types_[node.column_] == kTypeFloat ? kCompareFloat
+                                                         : kCompareChars;
+      program_.push_back({code, HoldsMask(node.op_), node.column_, 0, 0, node.int_, node.float_, 0, node.chars_});
+      break;
+    }
+    case kPredicateCompareNumber:
+      program_.push_back({kCompareNumber, HoldsMask(node.op_), node.column_, 0, 0, 0, 0, node.number_, ""});
+      break;
+    case kPredicateCompareColumns: {
+      OpCode code = types_[node.column_] == kTypeChar                                   ? kCompareCharColumns
+                    : types_[node.column_] == kTypeInt && types_[node.other_] == kTypeInt ? kCompareIntColumns
+                                                                                          : kCompareNumberColumns;
+      program_.push_back({code, HoldsMask(node.op_), node.column_, node.other_, 0, 0, 0, 0, ""});
+      break;
+    }
+  }
+}
@@ -0,0 +1,286 @@
+#include "executor/vector_filter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "record/type_kernel.h"
+
+namespace {
+
+/**
+ * Call kernel with the comparison functor of op, each instantiation of the
+ * kernel is a loop with the comparison inlined
+ */
+template <typename Kernel>
+inline void DispatchCompare(CompareOp op, Kernel &&kernel) {
+  switch (op) {
+    case kCompareEqual:
+      kernel(std::equal_to<>());
+      break;
+    case kCompareNotEqual:
+      kernel(std::not_equal_to<>());
+      break;
+    case kCompareLess:
+      kernel(std::less<>());
+      break;
+    case kCompareGreater:
+      kernel(std::greater<>());
+      break;
+    case kCompareLessEqual:
+      kernel(std::less_equal<>());
+      break;
+    case kCompareGreaterEqual:
+      kernel(std::greater_equal<>());
+      break;
+  }
+}
+
+}  // namespace
+
+VectorFilter::VectorFilter(const Predicate &predicate)
+    : predicate_(predicate), columns_(predicate.GetColumnCount()), masks_(predicate.nodes_.size()) {
+  for (auto conjunct : predicate_.conjuncts_) {
+    Prepare(conjunct);
+  }
+}
+
+void VectorFilter::Prepare(uint32_t id) {
+  const Node &node = predicate_.nodes_[id];
+  masks_[id].resize(BATCH_SIZE);
+  switch (node.kind_) {
+    case Predicate::kPredicateConnector:
+      Prepare(node.column_);
+      Prepare(node.other_);
+      break;
+    case Predicate::kPredicateCompareNumber:
+      lhs_.resize(BATCH_SIZE);
+      Use(node.column_);
+      break;
+    case Predicate::kPredicateCompareColumns:
+      Use(node.other_);
+      lhs_.resize(BATCH_SIZE);
+      rhs_.resize(BATCH_SIZE);
+      Use(node.column_);
+      break;
+    case Predicate::kPredicateCompare:
+    case Predicate::kPredicateNullTest:
+      Use(node.column_);
+      break;
+    case Predicate::kPredicateConstant:
+    case Predicate::kPredicateParameter:
+      break;
+  }
+}
+
+void VectorFilter::Use(uint32_t column) {
+  ColumnVector &vector = columns_[column];
+  if (vector.used_) return;
+  vector.used_ = true;
+  vector.nulls_.resize(BATCH_SIZE);
+  switch (predicate_.types_[column]) {
+    case kTypeInt:
+      vector.ints_.resize(BATCH_SIZE);
+      break;
+    case kTypeFloat:
+      vector.floats_.resize(BATCH_SIZE);
+      break;
+    default:
+      vector.chars_.resize(BATCH_SIZE);
+      vector.lens_.resize(BATCH_SIZE);
+      break;
+  }
+}
+
+void VectorFilter::Load(const RowView *views, uint32_t count) {
+  for (uint32_t column = 0; column < columns_.size(); column++) {
+    ColumnVector &vector = columns_[column];
+    if (!vector.used_) continue;
+    uint8_t *nulls = vector.nulls_.data();
+    for (uint32_t i = 0; i < count; i++) {
+      nulls[i] = views[i].IsNull(column);
+    }
+    // nulls decode as zeros, their mask bits are cleared anyway
+    switch (predicate_.types_[column]) {
+      case kTypeInt:
+        for (uint32_t i = 0; i < count; i++) {
+          vector.ints_[i] = nulls[i] ? 0 : views[i].GetInt(column);
+        }
+        break;
+      case kTypeFloat:
+        for (uint32_t i = 0; i < count; i++) {
+          vector.floats_[i] = nulls[i] ? 0 : views[i].GetFloat(column);
+        }
+        break;
+      default:
+        for (uint32_t i = 0; i < count; i++) {
+          vector.lens_[i] = 0;
+          vector.chars_[i] = nulls[i] ? nullptr : views[i].GetChars(column, &vector.lens_[i]);
+        }
+        break;
+    }
+  }
+}
+
+void VectorFilter::EvaluateCompare(const Node &node, uint32_t count, uint8_t *mask) {
+  const ColumnVector &vector = columns_[node.column_];
+  const uint8_t *nulls = vector.nulls_.data();
+  switch (predicate_.types_[node.column_]) {
+    case kTypeInt: {
+      const int32_t *values = vector.ints_.data();
+      int32_t constant = node.int_;
+      DispatchCompare(node.op_, [&](auto compare) {
+        for (uint32_t i = 0; i < count; i++) {
+          mask[i] = compare(values[i], constant) & (nulls[i] ^ 1);
+        }
+      });
+      break;
+    }
+    case kTypeFloat: {
+      const float *values = vector.floats_.data();
+      float constant = node.float_;
+      DispatchCompare(node.op_, [&](auto compare) {
+        for (uint32_t i = 0; i < count; i++) {
+          mask[i] = compare(values[i], constant) & (nulls[i] ^ 1);
+        }
+      });
+      break;
+    }
+    default: {
+      const char *constant = node.chars_.data();
+      uint32_t len = node.chars_.size();
+      DispatchCompare(node.op_, [&](auto compare) {
+        for (uint32_t i = 0; i < count; i++) {
+          mask[i] = !nulls[i] &&
+                    compare(TypeKernel<kTypeChar>::Compare(vector.chars_[i], vector.lens_[i], constant, len), 0);
+        }
+      });
+      break;
+    }
+  }
+}
+
+void VectorFilter::EvaluateCompareNumber(const Node &node, uint32_t count, uint8_t *mask) {
+  const ColumnVector &vector = columns_[node.column_];
+  const uint8_t *nulls = vector.nulls_.data();
+  // the column widens to doubles, as mixed numbers of two columns do
+  if (predicate_.types_[node.column_] == kTypeInt) {
+    std::copy(vector.ints_.begin(), vector.ints_.begin() + count, lhs_.begin());
+  } else {
+    std::copy(vector.floats_.begin(), vector.floats_.begin() + count, lhs_.begin());
+  }
+  const double *values = lhs_.data();
+  double constant = node.number_;
+  DispatchCompare(node.op_, [&](auto compare) {
+    for (uint32_t i = 0; i < count; i++) {
+      mask[i] = compare(values[i], constant) & (nulls[i] ^ 1);
+    }
+  });
+}
+
+void VectorFilter::EvaluateCompareColumns(const Node &node, uint32_t count, uint8_t *mask) {
+  const ColumnVector &lhs = columns_[node.column_], &rhs = columns_[node.other_];
+  const uint8_t *lhs_nulls = lhs.nulls_.data(), *rhs_nulls = rhs.nulls_.data();
+  TypeId lhs_type = predicate_.types_[node.column_];
+  TypeId rhs_type = predicate_.types_[node.other_];
+  if (lhs_type == kTypeChar) {
+    DispatchCompare(node.op_, [&](auto compare) {
+      for (uint32_t i = 0; i < count; i++) {
+        mask[i] = !lhs_nulls[i] && !rhs_nulls[i] &&
+                  compare(TypeKernel<kTypeChar>::Compare(lhs.chars_[i], lhs.lens_[i], rhs.chars_[i], rhs.lens_[i]), 0);
+      }
+    });
+    return;
+  }
+  auto kernel = [&](const auto *lhs_values, const auto *rhs_values) {
+    DispatchCompare(node.op_, [&](auto compare) {
+      for (uint32_t i = 0; i < count; i++) {
+        mask[i] = compare(lhs_values[i], rhs_values[i]) & ((lhs_nulls[i] | rhs_nulls[i]) ^ 1);
+      }
+    });
+  };
+  if (lhs_type == kTypeInt && rhs_type == kTypeInt) {
+    kernel(lhs.ints_.data(), rhs.ints_.data());
+  } else if (lhs_type == kTypeFloat && rhs_type == kTypeFloat) {
+    kernel(lhs.floats_.data(), rhs.floats_.data());
+  } else {
+    // mixed numbers compare as doubles
+    for (uint32_t i = 0; i < count; i++) {
+      lhs_[i] = lhs_type == kTypeInt ? lhs.ints_[i] : lhs.floats_[i];
+      rhs_[i] = rhs_type == kTypeInt ? rhs.ints_[i] : rhs.floats_[i];
+    }
+    kernel(lhs_.data(), rhs_.data());
+  }
+}
+
+void VectorFilter::Evaluate(uint32_t id, uint32_t count) {
+  const Node &node = predicate_.nodes_[id];
+  uint8_t *mask = masks_[id].data();
+  switch (node.kind_) {
+    case Predicate::kPredicateCompare:
+      EvaluateCompare(node, count, mask);
+      break;
+    case Predicate::kPredicateCompareNumber:
+      EvaluateCompareNumber(node, count, mask);
+      break;
+    case Predicate::kPredicateCompareColumns:
+      EvaluateCompareColumns(node, count, mask);
+      break;
+    case Predicate::kPredicateNullTest: {
+      const uint8_t *nulls = columns_[node.column_].nulls_.data();
+      uint8_t flip = node.flag_ ? 0 : 1;
+      for (uint32_t i = 0; i < count; i++) {
+        mask[i] = nulls[i] ^ flip;
+      }
+      break;
+    }
+    case Predicate::kPredicateConnector: {
+      Evaluate(node.column_, count);
+      Evaluate(node.other_, count);
+      const uint8_t *lhs = masks_[node.column_].data(), *rhs = masks_[node.other_].data();
+      if (node.flag_) {
+        for (uint32_t i = 0; i < count; i++) {
+          mask[i] = lhs[i] & rhs[i];
+        }
+      } else {
+        for (uint32_t i = 0; i < count; i++) {
+          mask[i] = lhs[i] | rhs[i];
+        }
+      }
+      break;
+    }
+    case Predicate::kPredicateConstant:
+      memset(mask, node.flag_ ? 1 : 0, count);
+      break;
+    case Predicate::kPredicateParameter:
+      // not bound yet
+      memset(mask, 0, count);
+      break;
+  }
+}
+
+uint32_t VectorFilter::Select(const RowView *views, uint32_t count, uint16_t *selection) {
+  ASSERT(count <= BATCH_SIZE, "Batch too large.");
+  if (predicate_.IsFalse()) return 0;
+  Load(views, count);
+  selected_.resize(BATCH_SIZE);
+  uint8_t *selected = selected_.data();
+  memset(selected, 1, count);
+  for (auto conjunct : predicate_.conjuncts_) {
+    Evaluate(conjunct, count);
+    const uint8_t *mask = masks_[conjunct].data();
+    uint8_t any = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      selected[i] &= mask[i];
+      any |= selected[i];
+    }
+    if (any == 0) return 0;
+  }
+  // branch free compaction, a position is overwritten unless selected
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    selection[n] = i;
+    n += selected[i];
+  }
+  return n;
+}
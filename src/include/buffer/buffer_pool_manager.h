@@ -1,6 +1,7 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <unordered_map>
@@ -13,6 +14,11 @@
 
 using namespace std;
 
+/**
+ * Pages of the database file cached in a fixed pool of frames. Every method
+ * takes the latch of the pool, so that threads can fetch and unpin pages
+ * concurrently; the contents of a page are guarded by its own latch.
+ */
 class BufferPoolManager {
 public:
   explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
@@ -33,6 +39,16 @@ public:
 
   bool CheckAllUnpinned();
 
+  /**
+   * @return number of fetches of a page already in the pool
+   */
+  inline uint64_t GetHitCount() const { return hit_count_; }
+
+  /**
+   * @return number of fetches which read the page from disk
+   */
+  inline uint64_t GetMissCount() const { return miss_count_; }
+
 private:
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
@@ -53,6 +69,8 @@ private:
   Replacer *replacer_;                                      // to find an unpinned page for replacement
   std::list<frame_id_t> free_list_;                         // to find a free page for replacement
   recursive_mutex latch_;                                   // to protect shared data structure
+  std::atomic<uint64_t> hit_count_{0};                      // fetches found in the pool
+  std::atomic<uint64_t> miss_count_{0};                     // fetches read from disk
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
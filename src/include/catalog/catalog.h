@@ -77,7 +77,9 @@ class CatalogManager {
   dberr_t GetTables(std::vector<TableInfo *> &tables) const;
 
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
-                      const std::vector<std::string> &index_keys, Transaction *txn, IndexInfo *&index_info);
+                      const std::vector<std::string> &index_keys, Transaction *txn, IndexInfo *&index_info,
+                      bool unique = true, IndexMethod method = kIndexBPlusTree,
+                      const std::vector<std::string> &include_keys = {}, bool bloom_filter = false);
 
   dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
 
@@ -87,6 +89,12 @@ class CatalogManager {
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Collect the statistics of a table from a sample of its pages and persist
+   * them on a page referenced by its metadata, replacing earlier ones
+   */
+  dberr_t AnalyzeTable(const std::string &table_name, Transaction *txn, TableStatistics *&statistics);
+
  private:
   dberr_t FlushCatalogMetaPage() const;
 
@@ -5,15 +5,52 @@
 
 #include "catalog/table.h"
 #include "index/b_plus_tree_index.h"
+#include "index/covering_b_plus_tree_index.h"
+#include "index/extendible_hash_index.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
+#include "index/packed_key.h"
 #include "record/schema.h"
 
+/**
+ * Key layout of a B+ tree index, chosen from the key schema when the index is
+ * created and persisted with its metadata
+ */
+enum IndexKeyType : uint32_t {
+  kKeyGeneric = 0,  /** serialized key row, GenericKey<key size> */
+  kKeyInt,          /** single int column, NativeKey<int32_t, key size> */
+  kKeyFloat,        /** single float column, NativeKey<float, key size> */
+  kKeyPacked        /** order preserving encoded key in variable length slots, PackedKey<key size> */
+};
+
+/**
+ * Access method of an index, picked with CREATE INDEX ... USING
+ */
+enum IndexMethod : uint32_t {
+  kIndexBPlusTree = 0,  /** ordered, answers point and range scans */
+  kIndexHash            /** extendible hash, answers point lookups only */
+};
+
 class IndexMetadata {
   friend class IndexInfo;
 
  public:
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                               const std::vector<uint32_t> &key_map, MemHeap *heap);
+                               const std::vector<uint32_t> &key_map, MemHeap *heap, bool unique = true,
+                               IndexKeyType key_type = kKeyGeneric, uint32_t key_size = DEFAULT_KEY_SIZE,
+                               IndexMethod method = kIndexBPlusTree, const std::vector<uint32_t> &include_map = {},
+                               bool bloom_filter = false);
+
+  /**
+   * Pick the narrowest key layout able to hold every key of the columns
+   * key_map of table_schema, row id suffix of non-unique indexes included.
+   * Hash indexes always store the packed encoding, sized to the widest key.
+   * Covering indexes store the packed encoding of the key and the columns
+   * include_map followed by the row id.
+   */
+  static void SelectKeyType(const Schema *table_schema, const std::vector<uint32_t> &key_map, bool unique,
+                            IndexKeyType &key_type, uint32_t &key_size, IndexMethod method = kIndexBPlusTree,
+                            const std::vector<uint32_t> &include_map = {});
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -29,20 +66,55 @@ class IndexMetadata {
 
   inline const std::vector<uint32_t> &GetKeyMapping() const { return key_map_; }
 
+  inline const std::vector<uint32_t> &GetIncludeMapping() const { return include_map_; }
+
+  inline bool IsCovering() const { return !include_map_.empty(); }
+
+  inline bool HasBloomFilter() const { return bloom_filter_; }
+
   inline index_id_t GetIndexId() const { return index_id_; }
 
+  inline bool IsUnique() const { return unique_; }
+
+  inline IndexKeyType GetKeyType() const { return key_type_; }
+
+  inline uint32_t GetKeySize() const { return key_size_; }
+
+  inline IndexMethod GetIndexMethod() const { return method_; }
+
+  static constexpr uint32_t DEFAULT_KEY_SIZE = 32;
+  static constexpr uint32_t MAX_KEY_SIZE = 128;
+  static constexpr uint32_t MAX_PACKED_KEY_SIZE = 256;
+
  private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                         const std::vector<uint32_t> &key_map):index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map){}
+                         const std::vector<uint32_t> &key_map, bool unique = true, IndexKeyType key_type = kKeyGeneric,
+                         uint32_t key_size = DEFAULT_KEY_SIZE, IndexMethod method = kIndexBPlusTree,
+                         const std::vector<uint32_t> &include_map = {}, bool bloom_filter = false)
+      : index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map), unique_(unique),
+        key_type_(key_type), key_size_(key_size), method_(method), include_map_(include_map),
+        bloom_filter_(bloom_filter) {}
 
  private:
   static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
+  static constexpr uint32_t INDEX_METADATA_V2_MAGIC_NUM = 344529;  /** adds the option flags */
+  static constexpr uint32_t INDEX_METADATA_V3_MAGIC_NUM = 344530;  /** adds the key type and size */
+  static constexpr uint32_t INDEX_METADATA_V4_MAGIC_NUM = 344531;  /** adds the included columns */
+  static constexpr uint32_t INDEX_FLAG_UNIQUE = 1;
+  static constexpr uint32_t INDEX_FLAG_HASH = 2;
+  static constexpr uint32_t INDEX_FLAG_BLOOM = 4;
   index_id_t index_id_;
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_; /** The mapping of index key to tuple key */
+  bool unique_{true};             /** false if duplicate keys are allowed, old metadata is always unique */
+  IndexKeyType key_type_{kKeyGeneric};
+  uint32_t key_size_{DEFAULT_KEY_SIZE};  /** old metadata always used GenericKey<32> */
+  IndexMethod method_{kIndexBPlusTree};
+  std::vector<uint32_t> include_map_; /** columns stored beside the key in the leaves, not part of the key */
+  bool bloom_filter_{false};          /** B+ tree indexes only, lookups of absent keys skip the tree */
 };
 
 /**
@@ -61,8 +133,10 @@ class IndexInfo {
     // Step1: init index metadata and table info
     meta_data_ = meta_data;
     table_info_ = table_info;
-    // Step2: mapping index key to key schema
-    key_schema_ = Schema::ShallowCopySchema(table_info->GetSchema(), meta_data_->key_map_, heap_);
+    // Step2: mapping index key to key schema, included columns follow the key columns
+    std::vector<uint32_t> column_map(meta_data_->key_map_);
+    column_map.insert(column_map.end(), meta_data_->include_map_.begin(), meta_data_->include_map_.end());
+    key_schema_ = Schema::ShallowCopySchema(table_info->GetSchema(), column_map, heap_);
     // Step3: call CreateIndex to create the index
     index_ = CreateIndex(buffer_pool_manager);
   }
@@ -71,8 +145,20 @@ class IndexInfo {
 
   inline std::string GetIndexName() { return meta_data_->GetIndexName(); }
 
+  /**
+   * Columns of the index entries, the key columns then the included columns
+   */
   inline IndexSchema *GetIndexKeySchema() { return key_schema_; }
 
+  /**
+   * @return number of leading columns of the key schema which are the key
+   */
+  inline uint32_t GetKeyColumnCount() const { return meta_data_->GetIndexColumnCount(); }
+
+  inline IndexMethod GetIndexMethod() const { return meta_data_->GetIndexMethod(); }
+
+  inline const IndexMetadata *GetIndexMeta() const { return meta_data_; }
+
   inline MemHeap *GetMemHeap() const { return heap_; }
 
   inline TableInfo *GetTableInfo() const { return table_info_; }
@@ -81,15 +167,24 @@ class IndexInfo {
   explicit IndexInfo()
       : meta_data_{nullptr}, index_{nullptr}, table_info_{nullptr}, key_schema_{nullptr}, heap_(new SimpleMemHeap()) {}
 
-  //the cause of the bug
-  Index *CreateIndex(BufferPoolManager *buffer_pool_manager) {
-    using INDEX_KEY_TYPE = GenericKey<32>;
-    using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
-    BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE> *bpt =
-        new BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>(meta_data_->GetIndexId(), key_schema_,
-                                                                         buffer_pool_manager);
+  /**
+   * Instantiate the hash index, or the B+ tree index matching the key layout
+   * of the metadata
+   */
+  Index *CreateIndex(BufferPoolManager *buffer_pool_manager);
+
+  template<size_t KeySize>
+  Index *NewCoveringIndex(BufferPoolManager *buffer_pool_manager) {
+    return new CoveringBPlusTreeIndex<KeySize>(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager,
+                                               meta_data_->IsUnique(), GetKeyColumnCount(),
+                                               meta_data_->HasBloomFilter());
+  }
 
-    return bpt;
+  template<typename KeyType, typename KeyComparator>
+  Index *NewBPlusTreeIndex(BufferPoolManager *buffer_pool_manager) {
+    return new BPlusTreeIndex<KeyType, RowId, KeyComparator>(meta_data_->GetIndexId(), key_schema_,
+                                                             buffer_pool_manager, meta_data_->IsUnique(),
+                                                             meta_data_->HasBloomFilter());
   }
 
  private:
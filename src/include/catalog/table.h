@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "glog/logging.h"
+#include "catalog/table_statistics.h"
 #include "record/schema.h"
 #include "storage/table_heap.h"
 
@@ -28,6 +29,12 @@ public:
 
   inline Schema *GetSchema() const { return schema_; }
 
+  /**
+   * @return page holding the statistics of the last ANALYZE, INVALID_PAGE_ID if never analyzed
+   */
+  inline page_id_t GetStatisticsPageId() const { return statistics_page_id_; }
+
+  inline void SetStatisticsPageId(page_id_t page_id) { statistics_page_id_ = page_id; }
 
 private:
   TableMetadata() = delete;
@@ -36,10 +43,12 @@ private:
 
 private:
   static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  static constexpr uint32_t TABLE_METADATA_V2_MAGIC_NUM = 344529;  /** adds the statistics page */
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
   Schema *schema_;
+  page_id_t statistics_page_id_{INVALID_PAGE_ID};
 };
 
 /**
@@ -73,12 +82,22 @@ public:
 
   inline page_id_t GetRootPageId() const { return table_meta_->root_page_id_; }
 
+  inline TableMetadata *GetTableMeta() const { return table_meta_; }
+
+  /**
+   * @return statistics of the last ANALYZE, null if the table was never analyzed
+   */
+  inline TableStatistics *GetStatistics() const { return statistics_; }
+
+  inline void SetStatistics(TableStatistics *statistics) { statistics_ = statistics; }
+
 private:
   explicit TableInfo() : heap_(new SimpleMemHeap()) {};
 
 private:
   TableMetadata *table_meta_;
   TableHeap *table_heap_;
+  TableStatistics *statistics_{nullptr};
   MemHeap *heap_; /** store all objects allocated in table_meta and table heap */
 };
 
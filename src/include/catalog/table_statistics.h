@@ -0,0 +1,92 @@
+#ifndef MINISQL_TABLE_STATISTICS_H
+#define MINISQL_TABLE_STATISTICS_H
+
+#include <vector>
+
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+/**
+ * Statistics of one column, scaled to the whole table.
+ *
+ * Values are mapped to doubles by ToScalar, the histogram is equi-depth:
+ * every bucket [bounds[i], bounds[i + 1]] holds the same share of the
+ * non-null values, a value spanning several buckets repeats its bound.
+ */
+struct ColumnStatistics {
+  uint32_t null_count_{0};
+  uint32_t distinct_count_{0};
+  std::vector<double> bounds_;
+};
+
+/**
+ * Statistics of a table collected by ANALYZE from a sample of its pages:
+ * row and page counts, and per column null counts, distinct value estimates
+ * and equi-depth histograms. Selectivities are fractions of the rows of the
+ * table, compare values must be of the column type.
+ */
+class TableStatistics {
+public:
+  /**
+   * Read every tuple of at most SAMPLE_PAGES pages spread over the table
+   */
+  static TableStatistics *Collect(TableHeap *table_heap, Schema *schema, MemHeap *heap);
+
+  uint32_t SerializeTo(char *buf) const;
+
+  uint32_t GetSerializedSize() const;
+
+  static uint32_t DeserializeFrom(char *buf, TableStatistics *&statistics, MemHeap *heap);
+
+  inline uint32_t GetRowCount() const { return row_count_; }
+
+  inline uint32_t GetPageCount() const { return page_count_; }
+
+  inline uint32_t GetSampleRowCount() const { return sample_rows_; }
+
+  inline const ColumnStatistics &GetColumn(uint32_t column) const { return columns_[column]; }
+
+  /**
+   * Fraction of the rows whose column is null
+   */
+  double NullSelectivity(uint32_t column) const;
+
+  /**
+   * Fraction of the rows whose column equals value
+   */
+  double EqualSelectivity(uint32_t column, const Field &value) const;
+
+  /**
+   * Fraction of the rows whose column lies between low and high, a null
+   * bound is open
+   */
+  double RangeSelectivity(uint32_t column, const Field *low, bool low_inclusive, const Field *high,
+                          bool high_inclusive) const;
+
+  /**
+   * Order preserving map of a non-null field to a double, chars by their
+   * first bytes
+   */
+  static double ToScalar(const Field &field);
+
+  static constexpr uint32_t SAMPLE_PAGES = 128;
+  static constexpr uint32_t HISTOGRAM_BUCKETS = 32;
+
+private:
+  TableStatistics() = default;
+
+  /**
+   * Fraction of the non-null values of column below value
+   */
+  double Below(uint32_t column, double value) const;
+
+private:
+  static constexpr uint32_t TABLE_STATISTICS_MAGIC_NUM = 344540;
+  uint32_t row_count_{0};
+  uint32_t page_count_{0};
+  uint32_t sample_rows_{0};
+  std::vector<ColumnStatistics> columns_;
+};
+
+#endif  // MINISQL_TABLE_STATISTICS_H
@@ -5,15 +5,25 @@
 #include <unordered_map>
 #include "common/dberr.h"
 #include "common/instance.h"
+#include "executor/explain.h"
+#include "executor/plan_cache.h"
 #include "transaction/transaction.h"
 #include "storage/table_iterator.h"
 #include "parser/syntax_tree.h"
 
-vector<Row*> rec_sel(pSyntaxNode a, std::vector<Row*>& b, TableInfo* c);
+/**
+ * Rows of table c satisfying condition a, heap scans filter on tuple views.
+ * The fields of the rows added to f are allocated from heap e. Under explain
+ * g the scan is one of its operators. Predicate h, if given, is condition a
+ * compiled already.
+ * @return false if a page of the table could not be fetched, f is left empty
+ */
+bool rec_scan(pSyntaxNode a, TableInfo* c, CatalogManager* d, MemHeap* e, vector<Row*> &f, Explain *g = nullptr,
+              const Predicate *h = nullptr);
 
 extern "C" {
 int yyparse(void);
-FILE *yyyin;
+extern FILE *yyyin;
 #include "parser/minisql_lex.h"
 #include "parser/parser.h"
 }
@@ -27,6 +37,12 @@ FILE *yyyin;
 struct ExecuteContext {
   bool flag_quit_{false};
   Transaction *txn_{nullptr};
+  ArenaMemHeap heap_{STATEMENT_HEAP_BLOCK_SIZE};  /** transient rows of the statement, released with the context */
+  PreparedStatement *statement_{nullptr};  /** cached statement running, keeps what it resolved for the next run */
+  Explain *explain_{nullptr};  /** operators of the select under EXPLAIN, which prints no rows */
+  Explain::Clock::duration parse_time_{0};  /** of the statement by ExecuteSql */
+
+  static constexpr size_t STATEMENT_HEAP_BLOCK_SIZE = 64 * 1024;
 };
 
 /**
@@ -47,6 +63,14 @@ public:
    */
   dberr_t Execute(pSyntaxNode ast, ExecuteContext *context);
 
+  /**
+   * Parse and execute statement sql, selects, inserts, deletes and updates
+   * through the plan cache
+   */
+  dberr_t ExecuteSql(const char *sql, ExecuteContext *context);
+
+  inline PlanCache &GetPlanCache() { return plan_cache_; }
+
 private:
   dberr_t ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context);
 
@@ -70,6 +94,13 @@ private:
 
   dberr_t ExecuteSelect(pSyntaxNode ast, ExecuteContext *context);
 
+  /**
+   * Select through the join chain and the operators above it, for the
+   * selects ExecuteSelect hands over: joins, aggregates, GROUP BY, DISTINCT,
+   * ORDER BY and LIMIT
+   */
+  dberr_t ExecuteSelectPlan(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteInsert(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteDelete(pSyntaxNode ast, ExecuteContext *context);
@@ -86,11 +117,37 @@ private:
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecutePrepare(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteExecute(pSyntaxNode ast, ExecuteContext *context);
+
+  dberr_t ExecuteExplain(pSyntaxNode ast, ExecuteContext *context);
+
+  /**
+   * Table table_name of a select, insert, delete or update and the key
+   * columns of its indexes, looked up once per catalog version for the
+   * cached statement running and into uncached for others
+   * @return null if the table does not exist
+   */
+  PreparedStatement::Resolved *ResolveTable(const std::string &table_name, ExecuteContext *context,
+                                            PreparedStatement::Resolved &uncached);
+
+  /**
+   * Bind literals to statement and execute it
+   */
+  dberr_t ExecuteStatement(PreparedStatement *statement, const std::vector<Literal> &literals,
+                           ExecuteContext *context);
+
   
 private:
   [[maybe_unused]] std::unordered_map<std::string, DBStorageEngine *> dbs_;  /** all opened databases */
   [[maybe_unused]] std::string current_db_;  /** current database */
   DBStorageEngine* current_db;
+  PlanCache plan_cache_;  /** statements by normalized text */
+  std::unordered_map<std::string, std::unique_ptr<PreparedStatement>> prepared_;  /** statements by name */
+  uint64_t catalog_version_{1};  /** bumped by every statement changing the catalog */
   
 };
 
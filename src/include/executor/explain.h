@@ -0,0 +1,137 @@
+#ifndef MINISQL_EXPLAIN_H
+#define MINISQL_EXPLAIN_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "record/row.h"
+#include "storage/disk_manager.h"
+
+/**
+ * Operator tree of a select, as EXPLAIN prints it.
+ *
+ * Without ANALYZE the engine only adds the operators it chooses, the scans
+ * at the leaves read nothing. With ANALYZE the select runs and every
+ * operator is charged the wall time, buffer pool hits and misses and disk
+ * pages read and written while it is the running one: the engine enters an
+ * operator when calling into it and leaves it when handing a row on to its
+ * parent, so the figures of an operator leave out those of its inputs.
+ * What the workers of a parallel scan read is charged to the operator
+ * running on the calling thread at the time.
+ */
+class Explain {
+public:
+  using Clock = std::chrono::steady_clock;
+  using Visit = std::function<bool(const Row &row)>;
+
+  Explain(bool analyze, BufferPoolManager *buffer_pool_manager, DiskManager *disk_manager);
+
+  /**
+   * Add an operator below parent, NO_OPERATOR for the root
+   * @return id of the operator
+   */
+  uint32_t Add(uint32_t parent, std::string name);
+
+  /**
+   * Name operator id, once it is known what it does
+   */
+  inline void SetName(uint32_t id, std::string name) { operators_[id].name_ = std::move(name); }
+
+  /**
+   * Append what operator id turned out to do to its name, eg: that it spilled
+   */
+  inline void AddDetail(uint32_t id, const std::string &detail) { operators_[id].name_ += ", " + detail; }
+
+  /**
+   * Add rows an operator took in other than from its children, eg: the
+   * tuples a scan read, and rows it gave out other than through Output
+   */
+  void Count(uint32_t id, uint64_t rows_in, uint64_t rows_out);
+
+  /**
+   * Make operator id the running one, NO_OPERATOR for none
+   * @return the operator running before
+   */
+  uint32_t Switch(uint32_t id);
+
+  /**
+   * Visitor handing the rows of operator id to visit, the parent's, counting
+   * them and running visit as the parent
+   */
+  Visit Output(uint32_t id, Visit visit);
+
+  /**
+   * Planning is over, the operators start running
+   */
+  inline void StartExecute() { execute_ = Clock::now(); }
+
+  /**
+   * Print the tree, and under ANALYZE the figures of the operators and how
+   * long parse, plan and execute took
+   */
+  void Print(std::ostream &os, Clock::duration parse_time) const;
+
+  inline bool IsAnalyze() const { return analyze_; }
+
+  /**
+   * Runs operator id for the life of the scope, nothing without an explain
+   */
+  class Running {
+  public:
+    Running(Explain *explain, uint32_t id)
+        : explain_(explain), previous_(explain == nullptr ? NO_OPERATOR : explain->Switch(id)) {}
+
+    ~Running() {
+      if (explain_ != nullptr) explain_->Switch(previous_);
+    }
+
+    Running(const Running &) = delete;
+    Running &operator=(const Running &) = delete;
+
+  private:
+    Explain *explain_;
+    uint32_t previous_;
+  };
+
+  static constexpr uint32_t NO_OPERATOR = UINT32_MAX;
+
+private:
+  /**
+   * What an operator has been charged so far
+   */
+  struct Operator {
+    std::string name_;
+    uint32_t parent_;
+    std::vector<uint32_t> children_;
+    uint64_t rows_in_{0};
+    uint64_t rows_out_{0};
+    Clock::duration time_{0};
+    uint64_t hits_{0};
+    uint64_t misses_{0};
+    uint64_t reads_{0};
+    uint64_t writes_{0};
+  };
+
+  void Print(std::ostream &os, uint32_t id, uint32_t depth) const;
+
+  bool analyze_;
+  BufferPoolManager *buffer_pool_manager_;
+  DiskManager *disk_manager_;
+  std::vector<Operator> operators_;
+  uint32_t running_{NO_OPERATOR};
+  Clock::time_point start_;
+  Clock::time_point execute_;
+  /** clock and counters when the running operator was entered */
+  Clock::time_point entered_;
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  uint64_t reads_{0};
+  uint64_t writes_{0};
+};
+
+#endif  // MINISQL_EXPLAIN_H
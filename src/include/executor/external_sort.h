@@ -0,0 +1,143 @@
+#ifndef MINISQL_EXTERNAL_SORT_H
+#define MINISQL_EXTERNAL_SORT_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "record/row.h"
+#include "storage/spill_file.h"
+#include "utils/mem_heap.h"
+
+/**
+ * One sort key column of the input rows
+ */
+struct SortKey {
+  uint32_t column_;
+  bool descending_;
+};
+
+/**
+ * Sort of a stream of rows on key columns, with an optional limit on the
+ * rows emitted.
+ *
+ * Rows are compared through their normalized key, the key fields written
+ * into one byte string whose memcmp order is the order of the fields:
+ * nulls first, ints and floats big endian with their sign flipped, chars
+ * escaped and terminated so that a prefix sorts first, every byte of a
+ * descending field inverted. Rows with equal keys keep their input order.
+ *
+ * Rows are sorted in memory until they outgrow the memory budget, then each
+ * budget of rows is sorted into a run on a spill file and Finish merges the
+ * runs with the rows left in memory. With a limit every run is cut to the
+ * limit, and while the limit rows fit the budget no run is written: they
+ * are kept in a bounded heap whose largest key is dropped for a smaller
+ * one.
+ */
+class ExternalSort {
+public:
+  using Emit = std::function<void(const Row &)>;
+
+  ExternalSort(BufferPoolManager *buffer_pool_manager, Schema *schema, std::vector<SortKey> keys,
+               uint64_t limit = NO_LIMIT, size_t memory_budget = DEFAULT_MEMORY_BUDGET);
+
+  /**
+   * @return false if a run had to be spilled and the buffer pool is full
+   */
+  bool Add(const Row &row);
+
+  /**
+   * Emit the rows in order, at most limit of them, after the last input row
+   */
+  void Finish(const Emit &emit);
+
+  /**
+   * @return number of sorted runs written to spill files
+   */
+  inline uint32_t GetRunCount() const { return runs_.size(); }
+
+  /**
+   * @return true while the rows are kept in a bounded heap
+   */
+  inline bool IsTopN() const { return top_n_; }
+
+  static constexpr uint64_t NO_LIMIT = UINT64_MAX;
+  static constexpr size_t DEFAULT_MEMORY_BUDGET = 1 << 20;
+
+private:
+  /**
+   * Row in memory, its normalized key in keys_ and its input position
+   */
+  struct Entry {
+    uint32_t key_offset_;
+    uint32_t key_len_;
+    uint64_t sequence_;
+    const Row *row_;
+  };
+
+  /**
+   * Row of the bounded heap, kept serialized
+   */
+  struct Candidate {
+    std::string key_;
+    uint64_t sequence_;
+    std::string row_;
+  };
+
+  /**
+   * Append the normalized key of row to key
+   */
+  void NormalizeKey(const Row &row, std::string &key) const;
+
+  inline std::string_view KeyOf(const Entry &entry) const {
+    return std::string_view(keys_.data() + entry.key_offset_, entry.key_len_);
+  }
+
+  static inline bool Less(std::string_view lhs, uint64_t lhs_sequence, std::string_view rhs, uint64_t rhs_sequence) {
+    int ret = lhs.compare(rhs);
+    return ret < 0 || (ret == 0 && lhs_sequence < rhs_sequence);
+  }
+
+  void Insert(Row &&row, uint64_t sequence);
+
+  void Offer(const Row &row);
+
+  /**
+   * Move the heap into the sort buffer once it outgrows the budget
+   */
+  void LeaveTopN();
+
+  void SortEntries();
+
+  /**
+   * Write the sorted buffer to a new run
+   */
+  bool Spill();
+
+  void ClearEntries();
+
+  BufferPoolManager *buffer_pool_manager_;
+  Schema *schema_;
+  std::vector<SortKey> sort_keys_;
+  uint64_t limit_;
+  size_t memory_budget_;
+  uint64_t sequence_{0};
+  // the sort buffer, rows live in the arena
+  ArenaMemHeap arena_;
+  std::deque<Row> rows_;
+  std::vector<char> keys_;
+  std::vector<Entry> entries_;
+  size_t memory_{0};
+  // the bounded heap, largest key on top
+  bool top_n_;
+  std::vector<Candidate> heap_;
+  std::vector<SpillFile> runs_;
+  std::string key_;
+  std::vector<char> buf_;
+};
+
+#endif  // MINISQL_EXTERNAL_SORT_H
@@ -0,0 +1,157 @@
+#ifndef MINISQL_HASH_AGGREGATE_H
+#define MINISQL_HASH_AGGREGATE_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "record/row.h"
+#include "storage/spill_file.h"
+#include "utils/mem_heap.h"
+
+enum AggregateKind { kAggregateCount, kAggregateSum, kAggregateAvg, kAggregateMin, kAggregateMax };
+
+/**
+ * One aggregate function of a column of the input rows, COUNT_ALL counts
+ * the rows themselves
+ */
+struct Aggregate {
+  AggregateKind kind_;
+  uint32_t column_;
+
+  static constexpr uint32_t COUNT_ALL = UINT32_MAX;
+};
+
+/**
+ * Hash aggregation of a stream of rows on group key columns.
+ *
+ * Groups are found in an open-addressing table through their normalized
+ * key, the key fields written into one byte string that two keys share
+ * exactly when their fields compare equal, nulls included. Once the groups
+ * outgrow the memory budget, rows of new groups are split into
+ * PARTITION_COUNT spill files by key hash while the groups in memory keep
+ * aggregating; Finish emits the groups in memory and then aggregates each
+ * partition the same way, on the next hash bits.
+ *
+ * Output rows hold the group key fields, then one field per aggregate:
+ * COUNT an int, SUM the type of its column, AVG a float, MIN and MAX the
+ * type and value of their column. Aggregates skip null values and are null
+ * over none, except COUNT which is 0; a sum out of the int range is null.
+ * Without group keys there is exactly one output row, even for no input.
+ */
+class HashAggregate {
+public:
+  using Emit = std::function<void(const Row &)>;
+
+  HashAggregate(BufferPoolManager *buffer_pool_manager, Schema *schema, std::vector<uint32_t> group_keys,
+                std::vector<Aggregate> aggregates, size_t memory_budget = DEFAULT_MEMORY_BUDGET);
+
+  /**
+   * @return false if the row had to be spilled and the buffer pool is full
+   */
+  bool Add(const Row &row);
+
+  /**
+   * Emit every group, after the last input row
+   * @return false if a partition could not be spilled again
+   */
+  bool Finish(const Emit &emit);
+
+  /**
+   * @return type of the output field of aggregate over rows of schema
+   */
+  static TypeId OutputType(const Aggregate &aggregate, const Schema *schema);
+
+  /**
+   * @return true once the groups outgrew the memory budget
+   */
+  inline bool IsSpilled() const { return spilled_; }
+
+  static constexpr size_t DEFAULT_MEMORY_BUDGET = 1 << 20;
+  static constexpr uint32_t PARTITION_COUNT = 32;
+  static constexpr uint32_t PARTITION_BITS = 5;
+  static constexpr uint32_t MAX_DEPTH = 4;
+
+private:
+  /**
+   * Running state of one aggregate of one group, min and max of chars are
+   * kept in chars_
+   */
+  struct Accumulator {
+    uint64_t count_;
+    int64_t integer_;
+    double number_;
+    uint32_t chars_offset_;
+    uint32_t chars_len_;
+  };
+
+  static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+  static constexpr uint32_t INITIAL_SLOTS = 256;
+
+  struct Slot {
+    uint64_t hash_;
+    uint32_t group_;
+  };
+
+  /**
+   * Write the normalized group key of row into key_
+   */
+  void NormalizeKey(const Row &row);
+
+  inline std::string_view GroupKey(uint32_t group) const {
+    return std::string_view(keys_.data() + key_offsets_[group], key_offsets_[group + 1] - key_offsets_[group]);
+  }
+
+  /**
+   * @return group of key_, EMPTY_SLOT if new, slot its probe ended at
+   */
+  uint32_t Find(uint64_t hash, uint32_t &slot) const;
+
+  uint32_t Insert(uint64_t hash, uint32_t slot);
+
+  void Grow();
+
+  void Update(Accumulator &accumulator, const Aggregate &aggregate, const Row &row);
+
+  size_t GetMemory() const;
+
+  /**
+   * Aggregate row at depth, spilling rows of new groups to partitions once
+   * the budget is exceeded
+   */
+  bool Accumulate(const Row &row, uint32_t depth, std::vector<SpillFile> &partitions);
+
+  void EmitGroups(const Emit &emit);
+
+  void ClearTable();
+
+  /**
+   * Aggregate and emit the partitions spilled at depth
+   */
+  bool FinishPartitions(std::vector<SpillFile> &partitions, uint32_t depth, const Emit &emit);
+
+  static inline uint32_t PartitionOf(uint64_t hash, uint32_t depth) {
+    // slots are taken from the low bits, partitions from the high ones
+    return (hash >> (64 - (depth + 1) * PARTITION_BITS)) & (PARTITION_COUNT - 1);
+  }
+
+  BufferPoolManager *buffer_pool_manager_;
+  Schema *schema_;
+  std::vector<uint32_t> group_keys_;
+  std::vector<Aggregate> aggregates_;
+  size_t memory_budget_;
+  // the table: slots, the normalized keys of the groups one after the other
+  // and the accumulators of each group
+  std::vector<Slot> slots_;
+  std::vector<char> keys_;
+  std::vector<uint32_t> key_offsets_{0};
+  std::vector<Accumulator> accumulators_;
+  std::vector<char> chars_;
+  std::string key_;
+  std::vector<SpillFile> partitions_;
+  bool spilled_{false};
+};
+
+#endif  // MINISQL_HASH_AGGREGATE_H
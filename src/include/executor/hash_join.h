@@ -0,0 +1,117 @@
+#ifndef MINISQL_HASH_JOIN_H
+#define MINISQL_HASH_JOIN_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "record/row.h"
+#include "storage/spill_file.h"
+#include "utils/mem_heap.h"
+
+/**
+ * Grace hash join of two row streams on equal key columns.
+ *
+ * Build rows go into an in-memory hash table until it outgrows the memory
+ * budget. The table is then split into PARTITION_COUNT spill files by key
+ * hash, and so are the build rows that follow and every probe row. Finish
+ * joins each pair of partitions in memory, partitioning again on the next
+ * hash bits while a build partition is still too large; one that cannot
+ * shrink any more, eg: a single key value, is joined a budget at a time.
+ *
+ * Keys are compared with CompareFields, build and probe key columns must be
+ * of the same types. Null keys never match.
+ */
+class HashJoin {
+public:
+  using Emit = std::function<void(const Row &build, const Row &probe)>;
+
+  HashJoin(BufferPoolManager *buffer_pool_manager, Schema *build_schema, std::vector<uint32_t> build_keys,
+           Schema *probe_schema, std::vector<uint32_t> probe_keys, size_t memory_budget = DEFAULT_MEMORY_BUDGET);
+
+  /**
+   * @return false if the row had to be spilled and the buffer pool is full
+   */
+  bool Build(const Row &row);
+
+  /**
+   * Emit the matches of row, which only end up in Finish once the build
+   * side has spilled
+   * @return false if the row had to be spilled and the buffer pool is full
+   */
+  bool Probe(const Row &row, const Emit &emit);
+
+  /**
+   * Join the spilled partitions, after the last probe row
+   * @return false if repartitioning ran out of buffer pool pages
+   */
+  bool Finish(const Emit &emit);
+
+  /**
+   * @return true once the build side outgrew the memory budget
+   */
+  inline bool IsSpilled() const { return spilled_; }
+
+  /**
+   * @return number of pages written to spill files so far
+   */
+  inline uint32_t GetSpilledPageCount() const { return spilled_pages_; }
+
+  static constexpr size_t DEFAULT_MEMORY_BUDGET = 1 << 20;
+  static constexpr uint32_t PARTITION_COUNT = 32;
+  static constexpr uint32_t PARTITION_BITS = 5;
+  static constexpr uint32_t MAX_DEPTH = 4;
+
+private:
+  /**
+   * Mixed hash of the key columns of row
+   * @return false if a key is null
+   */
+  static bool HashKey(const Row &row, const std::vector<uint32_t> &keys, uint64_t &hash);
+
+  static inline uint32_t PartitionOf(uint64_t hash, uint32_t depth) {
+    return (hash >> (depth * PARTITION_BITS)) & (PARTITION_COUNT - 1);
+  }
+
+  void Insert(Row &&row, uint64_t hash);
+
+  void ProbeTable(const Row &row, uint64_t hash, const Emit &emit) const;
+
+  void ClearTable();
+
+  /**
+   * Move the hash table into new build partitions
+   */
+  bool Spill();
+
+  /**
+   * Join a build partition with its probe partition, created at depth
+   */
+  bool JoinPartition(SpillFile &build, SpillFile &probe, uint32_t depth, const Emit &emit);
+
+  /**
+   * @return rough memory of the rows of file once loaded
+   */
+  static size_t EstimateMemory(const SpillFile &file);
+
+  BufferPoolManager *buffer_pool_manager_;
+  Schema *build_schema_;
+  std::vector<uint32_t> build_keys_;
+  Schema *probe_schema_;
+  std::vector<uint32_t> probe_keys_;
+  size_t memory_budget_;
+  // the in-memory hash table, rows live in the arena
+  ArenaMemHeap arena_;
+  std::deque<Row> rows_;
+  std::unordered_multimap<uint64_t, const Row *> table_;
+  size_t memory_{0};
+  std::vector<SpillFile> build_partitions_;
+  std::vector<SpillFile> probe_partitions_;
+  bool spilled_{false};
+  uint32_t spilled_pages_{0};
+};
+
+#endif  // MINISQL_HASH_JOIN_H
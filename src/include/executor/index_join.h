@@ -0,0 +1,68 @@
+#ifndef MINISQL_INDEX_JOIN_H
+#define MINISQL_INDEX_JOIN_H
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "index/index.h"
+#include "record/row.h"
+#include "storage/table_heap.h"
+#include "utils/mem_heap.h"
+
+/**
+ * Index nested-loop join of a stream of outer rows with the tuples of an
+ * inner table, through an index on its first key column.
+ *
+ * Outer rows are buffered into batches. The keys of a batch probe the index
+ * at once, which takes them in key order so that consecutive probes mostly
+ * land on leaves already in the buffer pool, and the matching tuples are
+ * then fetched in row id order, each one once per batch.
+ *
+ * Further key columns are compared on the fetched tuples. Keys are compared
+ * with CompareFields, outer and inner key columns must be of the same types.
+ * Null keys never match.
+ */
+class IndexJoin {
+public:
+  using Emit = std::function<void(const Row &outer, const Row &inner)>;
+
+  IndexJoin(TableHeap *inner_heap, Schema *inner_schema, std::vector<uint32_t> inner_keys, Index *index,
+            std::vector<uint32_t> outer_keys, uint32_t batch_size = DEFAULT_BATCH_SIZE);
+
+  /**
+   * Emit the matches of row, once its batch is full
+   * @return false if the index turned the batch down
+   */
+  bool Probe(const Row &row, const Emit &emit);
+
+  /**
+   * Emit the matches of the last batch, after the last outer row
+   * @return false if the index turned the batch down
+   */
+  bool Finish(const Emit &emit);
+
+  /**
+   * @return number of batches probed so far
+   */
+  inline uint32_t GetBatchCount() const { return batch_count_; }
+
+  static constexpr uint32_t DEFAULT_BATCH_SIZE = 1024;
+
+private:
+  bool ProbeBatch(const Emit &emit);
+
+  TableHeap *inner_heap_;
+  Schema *inner_schema_;
+  std::vector<uint32_t> inner_keys_;
+  Index *index_;
+  std::vector<uint32_t> outer_keys_;
+  uint32_t batch_size_;
+  // the buffered outer rows and their index keys, fields live in the arena
+  ArenaMemHeap arena_;
+  std::deque<Row> outer_rows_;
+  std::vector<Row> keys_;
+  uint32_t batch_count_{0};
+};
+
+#endif  // MINISQL_INDEX_JOIN_H
@@ -0,0 +1,91 @@
+#ifndef MINISQL_PARALLEL_SCAN_H
+#define MINISQL_PARALLEL_SCAN_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "executor/predicate.h"
+#include "record/row.h"
+#include "storage/table_heap.h"
+#include "utils/mem_heap.h"
+
+/**
+ * Sequential scan of a table heap by a pool of worker threads, morsel by
+ * morsel.
+ *
+ * The calling thread takes the page list of the table up front, the workers
+ * take turns cutting the next morsel of consecutive pages off it. Each filters the tuples of its morsel a batch at a time with a
+ * vector filter of its own and materializes the rows selected into the
+ * buffer of the morsel. The calling thread, as the exchange, hands the
+ * buffers to the consumer in the order of the page list, so that the rows
+ * come out as from a sequential scan; at most a window of morsels is
+ * buffered ahead of the consumer.
+ *
+ * The consumer must not modify the table during the scan, whose pages the
+ * workers hold read latched.
+ */
+class ParallelScan {
+public:
+  using Visit = std::function<bool(const Row &row)>;
+
+  ParallelScan(TableHeap *table_heap, const Predicate &predicate, uint32_t workers,
+               uint32_t morsel_pages = DEFAULT_MORSEL_PAGES);
+
+  /**
+   * Visit the rows the predicate selects, each only valid during the call,
+   * until visit returns false
+   * @return false if a page of the table could not be read, the rows visited
+   * until then are part of the result only
+   */
+  bool Run(const Visit &visit);
+
+  /**
+   * @return number of morsels the workers scanned
+   */
+  inline uint64_t GetMorselCount() const { return claimed_; }
+
+  /**
+   * @return number of tuples the workers filtered
+   */
+  inline uint64_t GetTupleCount() const { return scanned_; }
+
+  static constexpr uint32_t DEFAULT_MORSEL_PAGES = 16;
+
+  static constexpr uint32_t WINDOW_PER_WORKER = 2;
+
+private:
+  /**
+   * Pages of a morsel and the rows selected on them
+   */
+  struct Morsel {
+    std::vector<page_id_t> page_ids_;
+    ArenaMemHeap heap_;
+    std::deque<Row> rows_;
+    bool done_{false};
+  };
+
+  void Work();
+
+  TableHeap *table_heap_;
+  const Predicate &predicate_;
+  uint32_t workers_;
+  uint32_t morsel_pages_;
+  std::mutex latch_;
+  std::condition_variable ready_;  /** the first morsel is done, or there are no more */
+  std::condition_variable space_;  /** the window has room for another morsel */
+  std::deque<std::unique_ptr<Morsel>> morsels_;  /** claimed and not yet consumed, in page list order */
+  std::vector<page_id_t> page_ids_;
+  size_t next_page_{0};  /** index of the first page of the next morsel in page_ids_ */
+  uint64_t claimed_{0};
+  uint32_t running_{0};  /** workers which have not exited */
+  std::atomic<bool> stopped_{false};
+  bool failed_{false};  /** a worker could not fetch a page */
+  std::atomic<uint64_t> scanned_{0};
+};
+
+#endif  // MINISQL_PARALLEL_SCAN_H
@@ -0,0 +1,134 @@
+#ifndef MINISQL_PLAN_CACHE_H
+#define MINISQL_PLAN_CACHE_H
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/indexes.h"
+#include "catalog/table.h"
+#include "executor/predicate.h"
+#include "parser/syntax_tree.h"
+
+/**
+ * Literal bound to a parameter: a kNodeNumber, kNodeString or kNodeNull
+ */
+struct Literal {
+  SyntaxNodeType type_;
+  std::string val_;
+};
+
+/**
+ * Statement parsed once and executed many times with other literals.
+ *
+ * The syntax tree is copied out of the parser, which frees its nodes after
+ * every statement. Its parameters, '?' in the text, are bound in text order
+ * before each execution by turning them into the literals in place. Copies
+ * for the plan cache take the numbers and strings as parameters instead.
+ *
+ * Executing the statement may leave what it resolved in the catalog here,
+ * tagged with the catalog version; any DDL bumps the version, invalidating
+ * it while the tree stays valid. Its condition is compiled along with it,
+ * the parameters left to bind before every execution.
+ */
+class PreparedStatement {
+public:
+  explicit PreparedStatement(pSyntaxNode tree, bool literal_parameters = false);
+
+  PreparedStatement(const PreparedStatement &) = delete;
+
+  PreparedStatement &operator=(const PreparedStatement &) = delete;
+
+  /**
+   * Bind literals to the parameters
+   * @return false if their counts differ
+   */
+  bool Bind(const std::vector<Literal> &literals);
+
+  inline pSyntaxNode GetTree() const { return nodes_.empty() ? nullptr : nodes_[0].get(); }
+
+  inline uint32_t GetParameterCount() const { return parameters_.size(); }
+
+  /**
+   * @return true if node of the tree is a parameter, its position in text
+   * order in slot
+   */
+  bool FindParameter(pSyntaxNode node, uint32_t &slot) const;
+
+  /**
+   * @return node of parameter slot, the literal bound to it last
+   */
+  inline pSyntaxNode GetParameter(uint32_t slot) const { return nodes_[parameters_[slot]].get(); }
+
+  /**
+   * Target table and the key columns of its indexes, the columns a select
+   * outputs and the WHERE clause compiled on the rows of the table, valid
+   * at version_
+   */
+  struct Resolved {
+    uint64_t version_{0};
+    TableInfo *table_{nullptr};
+    std::vector<IndexInfo *> indexes_;
+    std::vector<std::vector<uint32_t>> key_columns_;
+    std::vector<uint32_t> columns_;
+    std::unique_ptr<Predicate> predicate_;  /** null until compiled */
+  };
+
+  Resolved resolved_;
+  uint32_t resolve_count_{0};  /** times resolved_ was looked up in the catalog */
+  uint32_t compile_count_{0};  /** times its predicate was compiled */
+
+private:
+  pSyntaxNode Copy(pSyntaxNode node, bool literal_parameters);
+
+  std::vector<std::unique_ptr<SyntaxNode>> nodes_;  /** nodes_[0] is the root */
+  std::vector<std::string> vals_;  /** values of nodes_, their val_ point into them */
+  std::vector<uint32_t> parameters_;  /** positions in nodes_ of the parameters, in text order */
+};
+
+/**
+ * Statements by their normalized text, the least recently used evicted
+ * beyond capacity.
+ *
+ * Normalizing a statement collapses its whitespace and replaces its numbers
+ * and strings with '?', so that statements differing only in their literals
+ * share a syntax tree and the parser is skipped for all but the first of
+ * them.
+ */
+class PlanCache {
+public:
+  explicit PlanCache(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
+
+  /**
+   * Normalized text of sql and its literals in text order
+   * @return false if sql is no select, insert, delete or update, or already
+   * has parameters
+   */
+  static bool Normalize(const char *sql, std::string &key, std::vector<Literal> &literals);
+
+  /**
+   * @return statement cached under key, null if none
+   */
+  PreparedStatement *Find(const std::string &key);
+
+  /**
+   * Cache statement under key, its parameters the literals of the text
+   * @return the cached statement
+   */
+  PreparedStatement *Insert(const std::string &key, std::unique_ptr<PreparedStatement> statement);
+
+  inline size_t GetSize() const { return entries_.size(); }
+
+  static constexpr size_t DEFAULT_CAPACITY = 256;
+
+private:
+  using Entry = std::pair<std::string, std::unique_ptr<PreparedStatement>>;
+
+  size_t capacity_;
+  std::list<Entry> lru_;  /** the most recently used first */
+  std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+};
+
+#endif  // MINISQL_PLAN_CACHE_H
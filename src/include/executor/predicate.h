@@ -0,0 +1,275 @@
+#ifndef MINISQL_PREDICATE_H
+#define MINISQL_PREDICATE_H
+
+#include <string>
+#include <vector>
+
+#include "record/field.h"
+#include "record/type_kernel.h"
+
+enum CompareOp {
+  kCompareEqual,
+  kCompareNotEqual,
+  kCompareLess,
+  kCompareGreater,
+  kCompareLessEqual,
+  kCompareGreaterEqual
+};
+
+/**
+ * Conditions compiled once per query and evaluated on many rows.
+ *
+ * The conditions are a tree of nodes on column ordinals: comparisons with a
+ * typed constant, a number or another column, null tests, AND, OR and constants.
+ * Nodes whose outcome is known fold into constants as they are added, eg: a
+ * comparison with null or a connector of constants. The rows selected are
+ * those every conjunct holds for; Match runs them as a flat program, one
+ * instruction per comparison plus a jump per connector to short-circuit it.
+ *
+ * A comparison never holds on a null. Numbers of mixed types compare as
+ * doubles, chars only with chars.
+ *
+ * A comparison with a parameter is compiled before its value is known and
+ * never holds until BindParameter turns it into the comparison with the
+ * value, so that statements run many times compile their conditions once.
+ */
+class Predicate {
+  friend class VectorFilter;
+
+public:
+  explicit Predicate(std::vector<TypeId> types) : types_(std::move(types)) {}
+
+  /**
+   * @return node comparing column to constant, which is of the column type
+   */
+  uint32_t AddCompare(uint32_t column, CompareOp op, const Field &constant);
+
+  /**
+   * @return node comparing numeric column to number as doubles; a number the
+   * column type holds exactly compares in that type, one no value of the
+   * column can equal or fall between folds into a constant or a null test
+   */
+  uint32_t AddCompareNumber(uint32_t column, CompareOp op, double number);
+
+  /**
+   * @return node comparing column to parameter slot, the value bound to it
+   * taking its place later
+   */
+  uint32_t AddParameter(uint32_t column, CompareOp op, uint32_t slot);
+
+  /**
+   * @return node comparing column to another column of the row
+   */
+  uint32_t AddCompareColumns(uint32_t column, CompareOp op, uint32_t other);
+
+  /**
+   * @return node holding if column is null, or is not
+   */
+  uint32_t AddNullTest(uint32_t column, bool is_null);
+
+  /**
+   * @return node holding if both lhs and rhs, or either of them, hold
+   */
+  uint32_t AddConnector(bool conjunction, uint32_t lhs, uint32_t rhs);
+
+  /**
+   * @return node holding always, or never
+   */
+  uint32_t AddConstant(bool value);
+
+  /**
+   * Select only the rows node holds for
+   */
+  void AddConjunct(uint32_t node);
+
+  /**
+   * Comparison of a column with a parameter, node of which the value bound
+   * to it takes the place
+   */
+  struct Parameter {
+    uint32_t slot_;
+    uint32_t column_;
+    CompareOp op_;
+    uint32_t node_;
+  };
+
+  inline const std::vector<Parameter> &GetParameters() const { return parameters_; }
+
+  /**
+   * Bind parameter, its position in GetParameters, to a value: node, the
+   * comparison with the value last added, is moved to the place of the
+   * parameter
+   */
+  void BindParameter(uint32_t parameter, uint32_t node);
+
+  /**
+   * @return true if no row can match
+   */
+  inline bool IsFalse() const { return false_; }
+
+  inline uint32_t GetColumnCount() const { return types_.size(); }
+
+  inline TypeId GetColumnType(uint32_t column) const { return types_[column]; }
+
+  /**
+   * @return true if every conjunct holds on row, which has the RowView
+   * accessors IsNull, GetInt, GetFloat and GetChars
+   */
+  template <typename R>
+  bool Match(const R &row) const {
+    bool holds = !false_;
+    for (uint32_t pc = 0; pc < program_.size(); pc++) {
+      const Instruction &in = program_[pc];
+      switch (in.code_) {
+        case kJumpIfFalse:
+          if (!holds) pc = in.target_ - 1;
+          break;
+        case kJumpIfTrue:
+          if (holds) pc = in.target_ - 1;
+          break;
+        case kConstant:
+          holds = in.holds_ != 0;
+          break;
+        case kIsNull:
+          holds = row.IsNull(in.column_) != (in.holds_ == 0);
+          break;
+        case kCompareInt:
+          holds = !row.IsNull(in.column_) &&
+                  Holds(in, TypeKernel<kTypeInt>::Compare(row.GetInt(in.column_), in.int_));
+          break;
+        case kCompareFloat:
+          holds = !row.IsNull(in.column_) &&
+                  Holds(in, TypeKernel<kTypeFloat>::Compare(row.GetFloat(in.column_), in.float_));
+          break;
+        case kCompareNumber: {
+          if (row.IsNull(in.column_)) {
+            holds = false;
+            break;
+          }
+          double value = types_[in.column_] == kTypeInt ? row.GetInt(in.column_) : row.GetFloat(in.column_);
+          holds = Holds(in, (value > in.number_) - (value < in.number_));
+          break;
+        }
+        case kCompareChars: {
+          if (row.IsNull(in.column_)) {
+            holds = false;
+            break;
+          }
+          uint32_t len;
+          const char *chars = row.GetChars(in.column_, &len);
+          holds = Holds(in, TypeKernel<kTypeChar>::Compare(chars, len, in.chars_.data(), in.chars_.size()));
+          break;
+        }
+        case kCompareIntColumns:
+          holds = !row.IsNull(in.column_) && !row.IsNull(in.other_) &&
+                  Holds(in, TypeKernel<kTypeInt>::Compare(row.GetInt(in.column_), row.GetInt(in.other_)));
+          break;
+        case kCompareNumberColumns: {
+          if (row.IsNull(in.column_) || row.IsNull(in.other_)) {
+            holds = false;
+            break;
+          }
+          double lhs = types_[in.column_] == kTypeInt ? row.GetInt(in.column_) : row.GetFloat(in.column_);
+          double rhs = types_[in.other_] == kTypeInt ? row.GetInt(in.other_) : row.GetFloat(in.other_);
+          holds = Holds(in, (lhs > rhs) - (lhs < rhs));
+          break;
+        }
+        case kCompareCharColumns: {
+          if (row.IsNull(in.column_) || row.IsNull(in.other_)) {
+            holds = false;
+            break;
+          }
+          uint32_t lhs_len, rhs_len;
+          const char *lhs = row.GetChars(in.column_, &lhs_len);
+          const char *rhs = row.GetChars(in.other_, &rhs_len);
+          holds = Holds(in, TypeKernel<kTypeChar>::Compare(lhs, lhs_len, rhs, rhs_len));
+          break;
+        }
+      }
+    }
+    return holds;
+  }
+
+private:
+  enum NodeKind {
+    kPredicateCompare,
+    kPredicateCompareNumber,
+    kPredicateCompareColumns,
+    kPredicateNullTest,
+    kPredicateConnector,
+    kPredicateConstant,
+    kPredicateParameter
+  };
+
+  struct Node {
+    NodeKind kind_;
+    CompareOp op_;
+    uint32_t column_;  /** or the lhs of a connector */
+    uint32_t other_;  /** column compared with, the rhs of a connector, or the slot of a parameter */
+    bool flag_;  /** is null, conjunction, or the constant value */
+    int32_t int_;
+    float float_;
+    double number_;
+    std::string chars_;
+  };
+
+  enum OpCode {
+    kJumpIfFalse,
+    kJumpIfTrue,
+    kConstant,
+    kIsNull,
+    kCompareInt,
+    kCompareFloat,
+    kCompareNumber,
+    kCompareChars,
+    kCompareIntColumns,
+    kCompareNumberColumns,
+    kCompareCharColumns
+  };
+
+  /**
+   * One step of the program, its outcome replaces the one before; a
+   * comparison holds if bit cmp + 1 of holds_ is set
+   */
+  struct Instruction {
+    OpCode code_;
+    uint8_t holds_;
+    uint32_t column_;
+    uint32_t other_;
+    uint32_t target_;
+    int32_t int_;
+    float float_;
+    double number_;
+    std::string chars_;
+  };
+
+  static inline bool Holds(const Instruction &in, int cmp) {
+    // chars compare to any negative or positive int, as memcmp does
+    return (in.holds_ >> ((cmp > 0) - (cmp < 0) + 1)) & 1;
+  }
+
+  uint32_t AddNode(Node node);
+
+  /**
+   * @return value of node if it is a constant, -1 otherwise
+   */
+  inline int ConstantOf(uint32_t node) const {
+    return nodes_[node].kind_ == kPredicateConstant ? nodes_[node].flag_ : -1;
+  }
+
+  /**
+   * Program of the conjuncts
+   */
+  void EmitProgram();
+
+  void Emit(uint32_t node);
+
+  std::vector<TypeId> types_;
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> conjuncts_;
+  std::vector<Parameter> parameters_;
+  bool false_{false};
+  std::vector<Instruction> program_;
+};
+
+#endif  // MINISQL_PREDICATE_H
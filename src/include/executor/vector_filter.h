@@ -0,0 +1,75 @@
+#ifndef MINISQL_VECTOR_FILTER_H
+#define MINISQL_VECTOR_FILTER_H
+
+#include <vector>
+
+#include "executor/predicate.h"
+#include "record/row_view.h"
+
+/**
+ * Predicate evaluated on the tuples of a table a batch at a time.
+ *
+ * Select decodes each column the predicate reads into a vector for the
+ * whole batch, then every node of the predicate computes a byte mask over
+ * the batch with a loop specialized for its type and operator, branch free
+ * so that the compiler turns it into SIMD instructions; connectors combine
+ * masks byte by byte. The rows set in the mask of every conjunct are
+ * selected, those Predicate::Match holds on.
+ */
+class VectorFilter {
+public:
+  explicit VectorFilter(const Predicate &predicate);
+
+  /**
+   * Evaluate the conjuncts on at most BATCH_SIZE tuples
+   * @return number of rows selected, their positions in views ascending in
+   * selection
+   */
+  uint32_t Select(const RowView *views, uint32_t count, uint16_t *selection);
+
+  static constexpr uint32_t BATCH_SIZE = 1024;
+
+private:
+  using Node = Predicate::Node;
+
+  /**
+   * Values of one column over a batch, the chars point into the tuples
+   */
+  struct ColumnVector {
+    bool used_{false};
+    std::vector<uint8_t> nulls_;
+    std::vector<int32_t> ints_;
+    std::vector<float> floats_;
+    std::vector<const char *> chars_;
+    std::vector<uint32_t> lens_;
+  };
+
+  /**
+   * Allocate the masks of node and its children and the vectors of the
+   * columns they read
+   */
+  void Prepare(uint32_t node);
+
+  void Use(uint32_t column);
+
+  void Load(const RowView *views, uint32_t count);
+
+  /**
+   * Write the mask of node over count rows into masks_[node]
+   */
+  void Evaluate(uint32_t node, uint32_t count);
+
+  void EvaluateCompare(const Node &node, uint32_t count, uint8_t *mask);
+
+  void EvaluateCompareNumber(const Node &node, uint32_t count, uint8_t *mask);
+
+  void EvaluateCompareColumns(const Node &node, uint32_t count, uint8_t *mask);
+
+  Predicate predicate_;
+  std::vector<ColumnVector> columns_;
+  std::vector<std::vector<uint8_t>> masks_;
+  std::vector<double> lhs_, rhs_;  /** mixed numbers of a comparison */
+  std::vector<uint8_t> selected_;
+};
+
+#endif  // MINISQL_VECTOR_FILTER_H
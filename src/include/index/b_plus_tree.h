@@ -12,12 +12,22 @@
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/**
+ * Separator pushed up to the parent when a leaf splits, any key s with
+ * left < s <= right will do. Key types with shorter separators overload it.
+ */
+template<typename KeyType>
+inline KeyType ShortestSeparator(const KeyType &left, const KeyType &right) {
+  return right;
+}
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) We only support unique key, non-unique indexes make their keys unique
+ *     by appending the row id (see GenericKey::SetRowId)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -29,7 +39,7 @@ class BPlusTree {
 
 public:
   explicit BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LeafPage::MAX_SIZE, int internal_max_size = InternalPage::MAX_SIZE);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -37,18 +47,32 @@ public:
   // Insert a key-value pair into this B+ tree.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
-  // Remove a key and its value from this B+ tree.
-  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+  // Remove a key and its value from this B+ tree, false if the key was absent.
+  bool Remove(const KeyType &key, Transaction *transaction = nullptr);
 
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction = nullptr);
 
+  // return the values of all keys in [low, high], a null bound is unbounded
+  bool GetRange(const KeyType *low, const KeyType *high, std::vector<ValueType> &result,
+                Transaction *transaction = nullptr);
+
+  // return the values of keys in [lows[i], highs[i]] in result[i], for ascending disjoint ranges;
+  // a range starting in the current or next leaf does not descend from the root again
+  void GetRanges(const std::vector<KeyType> &lows, const std::vector<KeyType> &highs,
+                 std::vector<std::vector<ValueType>> &result, Transaction *transaction = nullptr);
+
   INDEXITERATOR_TYPE Begin();
 
   INDEXITERATOR_TYPE Begin(const KeyType &key);
 
   INDEXITERATOR_TYPE End();
 
+  // iterators for backward scans, at the last pair or the last pair not above key
+  INDEXITERATOR_TYPE RBegin();
+
+  INDEXITERATOR_TYPE RBegin(const KeyType &key);
+
   // expose for test purpose
   Page *FindLeafPage(const KeyType &key, bool leftMost = false,bool rightMost=false);
 
@@ -75,7 +99,7 @@ public:
       cout<<"leaf_page: "<<page_id<<"  ";
       LeafPage* leafpage = reinterpret_cast<LeafPage *>(treepage);
       for ( int i = 0 ; i < leafpage->GetSize() ; i ++ ){
-        cout<<leafpage->array_[i].first<<" ";
+        cout<<leafpage->KeyAt(i)<<" ";
       }
       cout<<"   parent_page_id: "<<leafpage->GetParentPageId();
       cout<<endl;
@@ -84,7 +108,7 @@ public:
       cout<<"internal_page: "<<page_id<<"  ";
       InternalPage* interalpage = reinterpret_cast<InternalPage *>(treepage);
       for ( int i = 0 ; i < interalpage->GetSize() ; i ++ ){
-        cout<<interalpage->array_[i].first<<" "<<interalpage->array_[i].second<<"   ";
+        cout<<interalpage->KeyAt(i)<<" "<<interalpage->ValueAt(i)<<"   ";
       }
       cout<<"   parent_page_id: "<<interalpage->GetParentPageId();
       cout<<endl;
@@ -97,10 +121,17 @@ private:
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                        Transaction *transaction = nullptr);
+                        Transaction *transaction = nullptr, bool right_edge = false);
 
+  // Split at the right edge of the tree keeps RIGHT_EDGE_FILL percent in node
   template<typename N>
-  N *Split(N *node);
+  N *Split(N *node, bool right_edge = false);
+
+  /**
+   * @return the cached rightmost leaf, pinned, if key goes after all of its
+   * keys; null otherwise
+   */
+  LeafPage *FindRightmostLeaf(const KeyType &key);
 
   template<typename N>
   bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
@@ -110,7 +141,7 @@ private:
                 int index, Transaction *transaction = nullptr);
 
   template<typename N>
-  void Redistribute(N *neighbor_node, N *node, int index);
+  bool Redistribute(N *neighbor_node, N *node, int index);
 
   bool AdjustRoot(BPlusTreePage *node);
 
@@ -128,6 +159,10 @@ private:
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  // last leaf of the tree, appends skip the descent; dropped by removes
+  page_id_t rightmost_leaf_id_{INVALID_PAGE_ID};
+
+  static constexpr int RIGHT_EDGE_FILL = 90;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
\ No newline at end of file
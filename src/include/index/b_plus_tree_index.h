@@ -2,6 +2,7 @@
 #define MINISQL_B_PLUS_TREE_INDEX_H
 
 #include "index/b_plus_tree.h"
+#include "index/bloom_filter.h"
 #include "index/index.h"
 
 #define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator>
@@ -9,7 +10,8 @@
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
 public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager);
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                 bool unique = true, bool bloom_filter = false);
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
@@ -17,6 +19,23 @@ public:
 
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
 
+  /**
+   * Keys are probed in key order in one pass over the leaves, see BPlusTree::GetRanges
+   */
+  dberr_t ScanKeys(const std::vector<Row> &keys, std::vector<std::vector<RowId>> &result, Transaction *txn) override;
+
+  dberr_t ScanRange(const Row *low, const Row *high, std::vector<RowId> &result, Transaction *txn) override;
+
+  bool AcceptsBounds(const Row *low, const Row *high) const override;
+
+  dberr_t ScanRangeReverse(const Row *low, const Row *high, std::vector<RowId> &result, uint32_t limit,
+                           Transaction *txn) override;
+
+  dberr_t ScanRangeForward(const Row *low, const Row *high, std::vector<RowId> &result, uint32_t limit,
+                           Transaction *txn) override;
+
+  dberr_t ScanFirstKey(bool reverse, Row &key, Transaction *txn) override;
+
   dberr_t Destroy() override;
 
   INDEXITERATOR_TYPE GetBeginIterator();
@@ -25,11 +44,49 @@ public:
 
   INDEXITERATOR_TYPE GetEndIterator();
 
+  INDEXITERATOR_TYPE GetRBeginIterator();
+
+  INDEXITERATOR_TYPE GetRBeginIterator(const KeyType &key);
+
+  /**
+   * @return Bloom filter over the keys, loaded or rebuilt on first use; null
+   * if the index has none
+   */
+  BloomFilter *GetBloomFilter();
+
+  inline uint32_t GetKeyColumnCount() const { return key_column_count_; }
+
 protected:
+  /**
+   * Serialize key into index_key, keys of non-unique indexes get rid as suffix.
+   * @return false if the key does not fit into KeyType
+   */
+  bool MakeKey(const Row &key, RowId rid, KeyType &index_key) const;
+
+  /**
+   * Serialize the scan bounds low and high, a null bound is left untouched
+   * @return false if a bound does not fit into KeyType
+   */
+  virtual bool MakeBounds(const Row *low, const Row *high, KeyType &low_key, KeyType &high_key) const;
+
+  /**
+   * @return true if the Bloom filter proves that no entry has the key columns of key
+   */
+  bool FilterExcludes(const Row &key);
+
+  /**
+   * Refill the Bloom filter from the leaves, sized for at least capacity keys
+   */
+  void RebuildFilter(uint32_t capacity);
+
   // comparator for key
   KeyComparator comparator_;
   // container
   BPLUSTREE_TYPE container_;
+  // leading columns of the key schema forming the key, filtered on
+  uint32_t key_column_count_;
+  // null unless the index keeps a Bloom filter
+  std::unique_ptr<BloomFilter> filter_;
 };
 
 #endif //MINISQL_B_PLUS_TREE_INDEX_H
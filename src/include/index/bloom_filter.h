@@ -0,0 +1,114 @@
+#ifndef MINISQL_BLOOM_FILTER_H
+#define MINISQL_BLOOM_FILTER_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "record/row.h"
+
+/**
+ * Counting Bloom filter over the keys of an index, kept in memory so that
+ * lookups of keys which are definitely absent never fetch an index page.
+ *
+ * Counters are 4 bits wide so that removed keys are taken out again, a
+ * saturated counter is never decremented. The filter is sized for a capacity
+ * of keys and the owner rebuilds it twice as large once it holds more.
+ *
+ * The counters are written to a chain of pages when the filter is destroyed,
+ * the first page is found through the index roots page under FilterRootId.
+ * Loading marks the pages not clean until the next write back, a filter left
+ * behind by a crash fails to load and must be rebuilt.
+ */
+class BloomFilter {
+public:
+  BloomFilter(index_id_t index_id, BufferPoolManager *buffer_pool_manager);
+
+  /**
+   * Write the counters back if the filter is in use
+   */
+  ~BloomFilter();
+
+  /**
+   * Hash of the leading column_count fields of key, equal keys of any index
+   * layout hash alike
+   */
+  static uint64_t HashKey(const Row &key, uint32_t column_count);
+
+  /**
+   * Read the counters written back by the last owner
+   * @return false if there are none or they are stale, the filter is then empty
+   */
+  bool Load();
+
+  /**
+   * Drop every key and size the filter for capacity keys
+   */
+  void Reset(uint32_t capacity);
+
+  /**
+   * Write the counters to the pages of the filter and mark them clean
+   */
+  void Flush();
+
+  /**
+   * Delete the pages of the filter, the filter is no longer written back
+   */
+  void Destroy();
+
+  bool MayContain(uint64_t hash) const;
+
+  void Add(uint64_t hash);
+
+  void Remove(uint64_t hash);
+
+  /**
+   * @return true if the filter holds more keys than it was sized for
+   */
+  inline bool IsOverloaded() const { return count_ > capacity_; }
+
+  inline bool IsLoaded() const { return loaded_; }
+
+  inline uint32_t GetCapacity() const { return capacity_; }
+
+  inline uint32_t GetCount() const { return count_; }
+
+  static index_id_t FilterRootId(index_id_t index_id) { return index_id | FILTER_ROOT_FLAG; }
+
+  static constexpr uint32_t DEFAULT_CAPACITY = 1024;
+
+private:
+  inline uint32_t CounterAt(uint32_t index) const {
+    uint8_t byte = counters_[index >> 1];
+    return (index & 1) ? byte >> 4 : byte & 0xf;
+  }
+
+  inline void SetCounter(uint32_t index, uint32_t value) {
+    uint8_t &byte = counters_[index >> 1];
+    byte = (index & 1) ? (byte & 0x0f) | (value << 4) : (byte & 0xf0) | value;
+  }
+
+  /**
+   * Page ids of the chain holding the counters, allocated on demand
+   */
+  void GetPages(std::vector<page_id_t> &pages, bool allocate);
+
+  /**
+   * Set the clean flag of the first page
+   */
+  void MarkClean(bool clean);
+
+  static constexpr uint32_t COUNTERS_PER_KEY = 10;
+  static constexpr uint32_t HASH_COUNT = 7;
+  static constexpr uint32_t MAX_COUNTER = 0xf;
+  static constexpr index_id_t FILTER_ROOT_FLAG = 0x80000000u;
+
+  index_id_t index_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  bool loaded_{false};
+  uint32_t capacity_{0};
+  uint32_t count_{0};
+  uint32_t mask_{0};                /** counters - 1, the number of counters is a power of 2 */
+  std::vector<uint8_t> counters_;
+};
+
+#endif  // MINISQL_BLOOM_FILTER_H
@@ -0,0 +1,52 @@
+#ifndef MINISQL_COVERING_B_PLUS_TREE_INDEX_H
+#define MINISQL_COVERING_B_PLUS_TREE_INDEX_H
+
+#include "index/b_plus_tree_index.h"
+#include "index/packed_key.h"
+
+#define COVERING_INDEX_TYPE CoveringBPlusTreeIndex<KeySize>
+
+/**
+ * B+ tree index whose leaf entries also store the values of included
+ * columns, so that queries reading only those columns never touch the heap.
+ *
+ * The key schema is the key columns followed by the included columns, every
+ * entry is their packed encoding followed by the row id: entries of one key
+ * are adjacent and ordered by the included values. Keys given to scans hold
+ * only the key columns and match as a prefix. Uniqueness is checked on the
+ * key columns before an insert.
+ */
+template<size_t KeySize>
+class CoveringBPlusTreeIndex : public BPlusTreeIndex<PackedKey<KeySize>, RowId, PackedComparator<KeySize>> {
+  using KeyType = PackedKey<KeySize>;
+  using BaseIndex = BPlusTreeIndex<PackedKey<KeySize>, RowId, PackedComparator<KeySize>>;
+
+public:
+  CoveringBPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                         bool unique, uint32_t key_column_count, bool bloom_filter = false);
+
+  /**
+   * @param key values of the key and included columns
+   */
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t ScanRangeEntries(const Row *low, const Row *high, std::vector<Row *> &result, MemHeap *heap,
+                           Transaction *txn) override;
+
+private:
+  /**
+   * Serialize the leading key columns of key as a scan bound, an upper bound
+   * sorts after every entry starting with them
+   * @return false if the bound does not fit into KeyType
+   */
+  bool MakeBound(const Row &key, bool upper, KeyType &bound) const;
+
+  /**
+   * Bounds over the leading key columns, used by every range scan of the base index
+   */
+  bool MakeBounds(const Row *low, const Row *high, KeyType &low_key, KeyType &high_key) const override;
+
+  bool unique_;
+};
+
+#endif  // MINISQL_COVERING_B_PLUS_TREE_INDEX_H
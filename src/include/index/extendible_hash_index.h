@@ -0,0 +1,86 @@
+#ifndef MINISQL_EXTENDIBLE_HASH_INDEX_H
+#define MINISQL_EXTENDIBLE_HASH_INDEX_H
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "index/index.h"
+#include "page/hash_table_bucket_page.h"
+#include "page/hash_table_directory_page.h"
+
+/**
+ * Disk resident extendible hash index, answering point lookups with a
+ * directory page and one bucket page instead of a root to leaf descent.
+ *
+ * Keys are stored as their PackedKeyCodec encoding, at most key size bytes.
+ * The directory page id is kept in the index roots page like the root of a
+ * B+ tree, the index takes its pages on the first insert. Full buckets split
+ * and double the directory up to its maximum depth; a bucket which cannot
+ * split, or whose entries all share one hash, chains overflow pages.
+ *
+ * Keys are unordered, ScanRange only answers ranges of a single key.
+ */
+class ExtendibleHashIndex : public Index {
+public:
+  ExtendibleHashIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                      bool unique, uint32_t key_size);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
+
+  /**
+   * @return DB_FAILED unless low and high are the same key
+   */
+  dberr_t ScanRange(const Row *low, const Row *high, std::vector<RowId> &result, Transaction *txn) override;
+
+  dberr_t Destroy() override;
+
+  /**
+   * @return global depth of the directory, 0 for an empty index
+   */
+  uint32_t GetGlobalDepth() const;
+
+  static constexpr uint32_t MAX_KEY_SIZE = 256;
+
+private:
+  /**
+   * Encode key into buf, which holds MAX_KEY_SIZE bytes
+   * @return false if the key does not fit into the key size
+   */
+  bool MakeKey(const Row &key, char *buf, uint32_t &len) const;
+
+  static uint32_t Hash(const char *key, uint32_t len);
+
+  /**
+   * Page ids of the bucket at index of the directory and of its overflow pages
+   */
+  void GetChain(const HashTableDirectoryPage *directory, uint32_t index, std::vector<page_id_t> &chain) const;
+
+  /**
+   * Split the bucket at index of the directory, doubling the directory if the
+   * bucket is as deep as the directory
+   */
+  void SplitBucket(HashTableDirectoryPage *directory, uint32_t index);
+
+  /**
+   * @return true if the bucket holds no entry and has no overflow page
+   */
+  bool IsEmptyBucket(page_id_t page_id) const;
+
+  /**
+   * Merge the bucket at index of the directory with its split image while
+   * both are as deep and one of them is empty, then halve the directory
+   * while possible
+   */
+  void MergeBucket(HashTableDirectoryPage *directory, uint32_t index);
+
+  BufferPoolManager *buffer_pool_manager_;
+  bool unique_;
+  uint32_t key_size_;
+  page_id_t directory_page_id_{INVALID_PAGE_ID};
+};
+
+#endif  // MINISQL_EXTENDIBLE_HASH_INDEX_H
@@ -2,9 +2,11 @@
 #define MINISQL_GENERIC_KEY_H
 
 #include <cstring>
+#include <memory>
 
 #include "record/row.h"
 #include "record/field.h"
+#include "record/row_comparator.h"
 
 template<size_t KeySize>
 class GenericKey {
@@ -24,6 +26,24 @@ public:
     return;
   }
 
+  /**
+   * Whether key serializes into this key type, with room for a row id if asked
+   */
+  static inline bool Fits(const Row &key, Schema *schema, bool with_row_id) {
+    return key.GetSerializedSize(schema) + (with_row_id ? ROW_ID_SIZE : 0) <= KeySize;
+  }
+
+  /**
+   * Keys of non-unique indexes end with the row id of the entry, so equal key
+   * values still give distinct entries, ordered by row id.
+   */
+  inline void SetRowId(RowId rid) {
+    ASSERT(KeySize >= ROW_ID_SIZE, "Index key too small for a row id.");
+    MACH_WRITE_TO(int64_t, data + (KeySize - ROW_ID_SIZE), rid.Get());
+  }
+
+  inline RowId GetRowId() const { return RowId(MACH_READ_FROM(int64_t, data + (KeySize - ROW_ID_SIZE))); }
+
   // compare
   inline bool operator==(const GenericKey &other) {
     return memcmp(data, other.data, KeySize) == 0;
@@ -42,6 +62,8 @@ public:
     return os;
   }
 
+  static constexpr size_t ROW_ID_SIZE = sizeof(int64_t);
+
   // actual location of data, extends past the end.
   char data[KeySize];
 };
@@ -54,35 +76,47 @@ class GenericComparator {
 public:
   inline int operator()(const GenericKey<KeySize> &lhs,
                         const GenericKey<KeySize> &rhs) const {
-    int column_count = key_schema_->GetColumnCount();
+    int ret = CompareKey(lhs, rhs);
+    if (ret != 0 || unique_) {
+      return ret;
+    }
+    // duplicate key values are told apart by the row id suffix
+    int64_t lhs_rid = lhs.GetRowId().Get();
+    int64_t rhs_rid = rhs.GetRowId().Get();
+    return (lhs_rid > rhs_rid) - (lhs_rid < rhs_rid);
+  }
+
+  /**
+   * Compare the key values only, ignoring the row id of non-unique keys
+   */
+  inline int CompareKey(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    // keys are compared in place, without building a row per side
+    if (RowComparator::IsCompact(lhs.data) && RowComparator::IsCompact(rhs.data)) {
+      return row_comparator_->CompareSerialized(lhs.data, rhs.data);
+    }
     Row lhs_key(INVALID_ROWID);
     Row rhs_key(INVALID_ROWID);
     lhs.DeserializeToKey(lhs_key, key_schema_);
     rhs.DeserializeToKey(rhs_key, key_schema_);
-
-    for (int i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue)
-        return -1;
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue)
-        return 1;
-    }
-    // equals
-    return 0;
+    return row_comparator_->Compare(lhs_key, rhs_key);
   }
 
+  inline bool IsUnique() const { return unique_; }
+
   GenericComparator(const GenericComparator &other) {
     this->key_schema_ = other.key_schema_;
+    this->row_comparator_ = other.row_comparator_;
+    this->unique_ = other.unique_;
   }
 
   // constructor
-  GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  GenericComparator(Schema *key_schema, bool unique = true)
+          : key_schema_(key_schema), row_comparator_(std::make_shared<RowComparator>(key_schema)), unique_(unique) {}
 
 private:
   Schema *key_schema_;
+  std::shared_ptr<const RowComparator> row_comparator_;  /** kernels of the key schema, shared by copies */
+  bool unique_;
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
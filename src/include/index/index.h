@@ -2,6 +2,7 @@
 #define MINISQL_INDEX_H
 
 #include <memory>
+#include <vector>
 
 #include "common/dberr.h"
 #include "record/row.h"
@@ -20,6 +21,74 @@ public:
 
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) = 0;
 
+  /**
+   * Row ids of every key of keys, result[i] holding those of keys[i].
+   * Indexes may answer the batch at once, by default each key is scanned alone.
+   * @return DB_KEY_NOT_FOUND if no key was found
+   */
+  virtual dberr_t ScanKeys(const std::vector<Row> &keys, std::vector<std::vector<RowId>> &result, Transaction *txn) {
+    result.assign(keys.size(), {});
+    bool found = false;
+    for (size_t i = 0; i < keys.size(); i++) {
+      dberr_t status = ScanKey(keys[i], result[i], txn);
+      if (status == DB_FAILED) {
+        return DB_FAILED;
+      }
+      found = found || status == DB_SUCCESS;
+    }
+    return found ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+  }
+
+  /**
+   * Row ids of all entries with low <= key <= high, a null bound is unbounded.
+   * Bounds are inclusive, callers filter strict comparisons themselves.
+   */
+  virtual dberr_t ScanRange(const Row *low, const Row *high, std::vector<RowId> &result, Transaction *txn) = 0;
+
+  /**
+   * Whether the range scans of this index take low and high as bounds, a null
+   * bound is unbounded. Indexes without key order return false.
+   */
+  virtual bool AcceptsBounds(const Row *low, const Row *high) const {
+    return false;
+  }
+
+  /**
+   * Entries with low <= key <= high of an index storing whole entries, as
+   * rows of the key schema allocated from heap. Other indexes return DB_FAILED.
+   */
+  virtual dberr_t ScanRangeEntries(const Row *low, const Row *high, std::vector<Row *> &result, MemHeap *heap,
+                                   Transaction *txn) {
+    return DB_FAILED;
+  }
+
+  /**
+   * Row ids of at most limit entries with low <= key <= high, from the
+   * largest key down. Indexes without key order return DB_FAILED.
+   */
+  virtual dberr_t ScanRangeReverse(const Row *low, const Row *high, std::vector<RowId> &result, uint32_t limit,
+                                   Transaction *txn) {
+    return DB_FAILED;
+  }
+
+  /**
+   * Row ids of at most limit entries with low <= key <= high, from the
+   * smallest key up. Indexes without key order return DB_FAILED.
+   */
+  virtual dberr_t ScanRangeForward(const Row *low, const Row *high, std::vector<RowId> &result, uint32_t limit,
+                                   Transaction *txn) {
+    return DB_FAILED;
+  }
+
+  /**
+   * Smallest key whose first field is not null, or the largest if reverse, as
+   * a row of the key schema. Indexes without key order return DB_FAILED.
+   * @return DB_KEY_NOT_FOUND if the index has no such key
+   */
+  virtual dberr_t ScanFirstKey(bool reverse, Row &key, Transaction *txn) {
+    return DB_FAILED;
+  }
+
   virtual dberr_t Destroy() = 0;
 
 protected:
@@ -1,6 +1,7 @@
 #ifndef MINISQL_INDEX_ITERATOR_H
 #define MINISQL_INDEX_ITERATOR_H
 
+#include "page/b_plus_tree_internal_page.h"
 #include "page/b_plus_tree_leaf_page.h"
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
@@ -8,10 +9,14 @@
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
 public:
   // you may define your own constructor based on your member variables
   explicit IndexIterator();
   explicit IndexIterator(LeafPage *lp, int idx, BufferPoolManager *bpm);
+  /** The iterator owns a pin on its leaf, moving hands it over */
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator(const IndexIterator &other) = delete;
   ~IndexIterator();
 
   /** Return the key/value pair this iterator is currently pointing at. */
@@ -20,6 +25,16 @@ public:
   /** Move to the next key/value pair.*/
   IndexIterator &operator++();
 
+  /**
+   * Move to the previous key/value pair, past the first one the iterator is
+   * at the end. Leaves are only linked forward, the previous leaf is found
+   * through the parents: the rightmost leaf under the nearest left sibling.
+   */
+  IndexIterator &operator--();
+
+  /** Return whether the iterator is past the last pair of the last leaf, or before the first pair of the first */
+  bool IsEnd() const;
+
   /** Return whether two iterators are equal */
   bool operator==(const IndexIterator &itr) const;
 
@@ -27,10 +42,16 @@ public:
   bool operator!=(const IndexIterator &itr) const;
 
 private:
+  /**
+   * @return the leaf before the current one, pinned; null for the first leaf
+   */
+  LeafPage *PrevLeaf() const;
+
   // add your own private member variables here
   BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf_page;
   int index_;
   BufferPoolManager *buffer_pool_manager;
+  MappingType item_;  /** copy of the current pair, pages of packed keys do not store pairs */
 };
 
 
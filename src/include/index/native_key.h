@@ -0,0 +1,116 @@
+#ifndef MINISQL_NATIVE_KEY_H
+#define MINISQL_NATIVE_KEY_H
+
+#include <cstring>
+#include <type_traits>
+
+#include "record/row.h"
+#include "record/field.h"
+#include "record/type_kernel.h"
+
+/**
+ * Key of an index on a single int or float column.
+ *
+ * The value is stored as is instead of as a serialized row, so a key is only
+ * as wide as the value plus a null flag and compares with a single native
+ * compare. Same interface as GenericKey: KeySize is 8 for unique indexes and
+ * 16 for non-unique ones, whose keys end with the row id.
+ *
+ * | value(4) | null(4) | row id(8), non-unique only |
+ */
+template<typename T, size_t KeySize>
+class NativeKey {
+  static_assert(std::is_same<T, int32_t>::value || std::is_same<T, float>::value, "Unsupported native key type.");
+
+public:
+  static constexpr TypeId TYPE_ID = std::is_same<T, float>::value ? TypeId::kTypeFloat : TypeId::kTypeInt;
+
+  inline void SerializeFromKey(const Row &key, Schema *schema) {
+    ASSERT(key.GetFieldCount() == 1 && schema->GetColumn(0)->GetType() == TYPE_ID, "Key does not match native key.");
+    memset(data, 0, KeySize);
+    const Field *field = key.GetField(0);
+    if (field->IsNull()) {
+      MACH_WRITE_TO(int32_t, data + sizeof(T), 1);
+    } else {
+      MACH_WRITE_TO(T, data, TypeKernel<TYPE_ID>::Get(*field));
+    }
+  }
+
+  inline void DeserializeToKey(Row &key, Schema *schema) const {
+    if (IsNull()) {
+      key.EmplaceField(TYPE_ID);
+    } else {
+      key.EmplaceField(TYPE_ID, GetValue());
+    }
+  }
+
+  static inline bool Fits(const Row &key, Schema *schema, bool with_row_id) {
+    return key.GetFieldCount() == 1 && sizeof(T) + sizeof(int32_t) + (with_row_id ? ROW_ID_SIZE : 0) <= KeySize;
+  }
+
+  inline T GetValue() const { return MACH_READ_FROM(T, data); }
+
+  inline bool IsNull() const { return MACH_READ_FROM(int32_t, data + sizeof(T)) != 0; }
+
+  inline void SetRowId(RowId rid) {
+    ASSERT(KeySize >= sizeof(T) + sizeof(int32_t) + ROW_ID_SIZE, "Index key too small for a row id.");
+    MACH_WRITE_TO(int64_t, data + (KeySize - ROW_ID_SIZE), rid.Get());
+  }
+
+  inline RowId GetRowId() const { return RowId(MACH_READ_FROM(int64_t, data + (KeySize - ROW_ID_SIZE))); }
+
+  // NOTE: for test purpose only
+  friend std::ostream &operator<<(std::ostream &os, const NativeKey &key) {
+    if (key.IsNull()) {
+      os << "null";
+    } else {
+      os << key.GetValue();
+    }
+    return os;
+  }
+
+  static constexpr size_t ROW_ID_SIZE = sizeof(int64_t);
+
+  char data[KeySize];
+};
+
+/**
+ * Function object returns true if lhs < rhs, used for trees
+ */
+template<typename T, size_t KeySize>
+class NativeComparator {
+  using KeyType = NativeKey<T, KeySize>;
+
+public:
+  inline int operator()(const KeyType &lhs, const KeyType &rhs) const {
+    int ret = CompareKey(lhs, rhs);
+    if (ret != 0 || unique_) {
+      return ret;
+    }
+    int64_t lhs_rid = lhs.GetRowId().Get();
+    int64_t rhs_rid = rhs.GetRowId().Get();
+    return (lhs_rid > rhs_rid) - (lhs_rid < rhs_rid);
+  }
+
+  /**
+   * Compare the key values only, nulls first as in RowComparator
+   */
+  inline int CompareKey(const KeyType &lhs, const KeyType &rhs) const {
+    bool lhs_null = lhs.IsNull();
+    bool rhs_null = rhs.IsNull();
+    if (lhs_null || rhs_null) {
+      return static_cast<int>(rhs_null) - static_cast<int>(lhs_null);
+    }
+    return TypeKernel<KeyType::TYPE_ID>::Compare(lhs.GetValue(), rhs.GetValue());
+  }
+
+  inline bool IsUnique() const { return unique_; }
+
+  // constructor
+  NativeComparator(Schema *key_schema, bool unique = true) : unique_(unique) {}
+
+private:
+  bool unique_;
+};
+
+#endif  // MINISQL_NATIVE_KEY_H
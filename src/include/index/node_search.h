@@ -0,0 +1,118 @@
+#ifndef MINISQL_NODE_SEARCH_H
+#define MINISQL_NODE_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "index/native_key.h"
+
+/**
+ * Search kernels over the int values of native keys in a B+ tree node.
+ *
+ * Entries of a node are (key, value) pairs of a fixed stride, the key value
+ * is its first 4 bytes and the null flag the next 4. A search first halves
+ * the range without branches down to a few cache lines, then counts the
+ * remaining entries below the probe with SIMD compares: AVX2 gathers when
+ * the build targets it, SSE4.2 compares otherwise, scalar code as the last
+ * resort. The instruction set is chosen at compile time, -march=native.
+ */
+class NodeSearchKernel {
+public:
+  /**
+   * Index of the first entry of [begin, end) not below value, or above value
+   * if upper; non-null values sort after nulls and entries must be sorted.
+   */
+  static int Bound(const char *base, size_t stride, int begin, int end, int32_t value, bool upper);
+
+  /**
+   * Same as Bound with a plain scalar loop, for tests and benchmarks
+   */
+  static int BoundScalar(const char *base, size_t stride, int begin, int end, int32_t value, bool upper);
+
+  // ranges at most this long are counted by the SIMD loop instead of halved
+  static constexpr int LINEAR_THRESHOLD = 16;
+};
+
+/**
+ * Lower and upper bound of a key among node entries [begin, end), by binary
+ * search with the comparator
+ */
+template<typename KeyType, typename KeyComparator>
+class BinaryNodeSearch {
+public:
+  template<typename Entry>
+  static inline int LowerBound(const Entry *array, int begin, int end, const KeyType &key,
+                               const KeyComparator &comparator) {
+    while (begin < end) {
+      int mid = begin + (end - begin) / 2;
+      if (comparator(array[mid].first, key) < 0) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin;
+  }
+
+  template<typename Entry>
+  static inline int UpperBound(const Entry *array, int begin, int end, const KeyType &key,
+                               const KeyComparator &comparator) {
+    while (begin < end) {
+      int mid = begin + (end - begin) / 2;
+      if (comparator(array[mid].first, key) <= 0) {
+        begin = mid + 1;
+      } else {
+        end = mid;
+      }
+    }
+    return begin;
+  }
+};
+
+/**
+ * Bound search used by B+ tree pages, native int keys use NodeSearchKernel
+ */
+template<typename KeyType, typename KeyComparator>
+class NodeSearch : public BinaryNodeSearch<KeyType, KeyComparator> {};
+
+template<size_t KeySize>
+class NodeSearch<NativeKey<int32_t, KeySize>, NativeComparator<int32_t, KeySize>> {
+  using KeyType = NativeKey<int32_t, KeySize>;
+  using KeyComparator = NativeComparator<int32_t, KeySize>;
+  using Fallback = BinaryNodeSearch<KeyType, KeyComparator>;
+
+public:
+  template<typename Entry>
+  static inline int LowerBound(const Entry *array, int begin, int end, const KeyType &key,
+                               const KeyComparator &comparator) {
+    return Bound(array, begin, end, key, comparator, false);
+  }
+
+  template<typename Entry>
+  static inline int UpperBound(const Entry *array, int begin, int end, const KeyType &key,
+                               const KeyComparator &comparator) {
+    return Bound(array, begin, end, key, comparator, true);
+  }
+
+private:
+  template<typename Entry>
+  static inline int Bound(const Entry *array, int begin, int end, const KeyType &key,
+                          const KeyComparator &comparator, bool upper) {
+    if (key.IsNull()) {
+      return upper ? Fallback::UpperBound(array, begin, end, key, comparator)
+                   : Fallback::LowerBound(array, begin, end, key, comparator);
+    }
+    const char *base = reinterpret_cast<const char *>(array);
+    int32_t value = key.GetValue();
+    if (comparator.IsUnique()) {
+      return NodeSearchKernel::Bound(base, sizeof(Entry), begin, end, value, upper);
+    }
+    // entries of an equal value are ordered by row id, only those are compared in full
+    int low = NodeSearchKernel::Bound(base, sizeof(Entry), begin, end, value, false);
+    int high = NodeSearchKernel::Bound(base, sizeof(Entry), low, end, value, true);
+    return upper ? Fallback::UpperBound(array, low, high, key, comparator)
+                 : Fallback::LowerBound(array, low, high, key, comparator);
+  }
+};
+
+#endif  // MINISQL_NODE_SEARCH_H
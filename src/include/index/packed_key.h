@@ -0,0 +1,298 @@
+#ifndef MINISQL_PACKED_KEY_H
+#define MINISQL_PACKED_KEY_H
+
+#include <cstring>
+#include <string>
+
+#include "record/row.h"
+#include "record/field.h"
+#include "record/type_kernel.h"
+
+/**
+ * Order preserving encoding of index keys.
+ *
+ * Every column is encoded so that memcmp of two encoded keys gives the same
+ * order as RowComparator on the keys:
+ *  - a flag byte, 0 for null (nulls first) and 1 otherwise, then the value
+ *  - int: big endian with the sign bit flipped
+ *  - float: big endian bits, all flipped for negatives, sign only otherwise
+ *  - char: the bytes with 0x00 escaped as 0x00 0xff, ended by 0x00 0x00
+ *  - the row id of non-unique keys, as int but 8 bytes wide
+ *
+ * Encoded keys are variable length and a shorter key which is a prefix of a
+ * longer one sorts first, so the pages can store keys without padding, share
+ * prefixes between neighbouring keys and cut separators short.
+ */
+class PackedKeyCodec {
+public:
+  static inline uint32_t EncodedSize(const Row &key, Schema *schema) {
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+      const Field *field = key.GetField(i);
+      size += FLAG_SIZE;
+      if (field->IsNull()) {
+        continue;
+      }
+      if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar) {
+        const char *chars = TypeKernel<TypeId::kTypeChar>::Get(*field);
+        uint32_t len = field->GetLength();
+        size += len + TERMINATOR_SIZE;
+        for (uint32_t j = 0; j < len; j++) {
+          size += chars[j] == 0 ? 1 : 0;
+        }
+      } else {
+        size += sizeof(uint32_t);
+      }
+    }
+    return size;
+  }
+
+  /**
+   * @return bytes written to buf, which must hold EncodedSize(key, schema)
+   */
+  static inline uint32_t Encode(const Row &key, Schema *schema, char *buf) {
+    char *temp = buf;
+    for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+      const Field *field = key.GetField(i);
+      if (field->IsNull()) {
+        *temp++ = 0;
+        continue;
+      }
+      *temp++ = 1;
+      switch (schema->GetColumn(i)->GetType()) {
+        case TypeId::kTypeInt:
+          WriteBigEndian32(temp, static_cast<uint32_t>(TypeKernel<TypeId::kTypeInt>::Get(*field)) ^ SIGN_BIT_32);
+          temp += sizeof(uint32_t);
+          break;
+        case TypeId::kTypeFloat:
+          WriteBigEndian32(temp, EncodeFloat(TypeKernel<TypeId::kTypeFloat>::Get(*field)));
+          temp += sizeof(uint32_t);
+          break;
+        default: {
+          const char *chars = TypeKernel<TypeId::kTypeChar>::Get(*field);
+          for (uint32_t j = 0; j < field->GetLength(); j++) {
+            *temp++ = chars[j];
+            if (chars[j] == 0) {
+              *temp++ = static_cast<char>(0xff);
+            }
+          }
+          *temp++ = 0;
+          *temp++ = 0;
+          break;
+        }
+      }
+    }
+    return temp - buf;
+  }
+
+  /**
+   * Decode the columns of an encoded key into key, a row id suffix is ignored
+   * @return bytes consumed
+   */
+  static inline uint32_t Decode(const char *buf, Row &key, Schema *schema) {
+    const char *temp = buf;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      TypeId type = schema->GetColumn(i)->GetType();
+      if (*temp++ == 0) {
+        key.EmplaceField(type);
+        continue;
+      }
+      switch (type) {
+        case TypeId::kTypeInt:
+          key.EmplaceField(type, static_cast<int32_t>(ReadBigEndian32(temp) ^ SIGN_BIT_32));
+          temp += sizeof(uint32_t);
+          break;
+        case TypeId::kTypeFloat:
+          key.EmplaceField(type, DecodeFloat(ReadBigEndian32(temp)));
+          temp += sizeof(uint32_t);
+          break;
+        default: {
+          std::string chars;
+          while (temp[0] != 0 || temp[1] != 0) {
+            chars.push_back(*temp);
+            temp += temp[0] == 0 ? 2 : 1;
+          }
+          temp += TERMINATOR_SIZE;
+          key.EmplaceField(type, const_cast<char *>(chars.data()), static_cast<uint32_t>(chars.size()), true);
+          break;
+        }
+      }
+    }
+    return temp - buf;
+  }
+
+  static inline void EncodeRowId(RowId rid, char *buf) {
+    uint64_t value = static_cast<uint64_t>(rid.Get()) ^ SIGN_BIT_64;
+    WriteBigEndian32(buf, static_cast<uint32_t>(value >> 32));
+    WriteBigEndian32(buf + sizeof(uint32_t), static_cast<uint32_t>(value));
+  }
+
+  static inline RowId DecodeRowId(const char *buf) {
+    uint64_t value = static_cast<uint64_t>(ReadBigEndian32(buf)) << 32 | ReadBigEndian32(buf + sizeof(uint32_t));
+    return RowId(static_cast<int64_t>(value ^ SIGN_BIT_64));
+  }
+
+  /**
+   * Bytes first, then length, as TypeKernel<kTypeChar>
+   */
+  static inline int Compare(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+    return TypeKernel<TypeId::kTypeChar>::Compare(lhs, lhs_len, rhs, rhs_len);
+  }
+
+  static inline uint32_t CommonPrefix(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+    uint32_t len = std::min(lhs_len, rhs_len);
+    uint32_t i = 0;
+    while (i < len && lhs[i] == rhs[i]) {
+      i++;
+    }
+    return i;
+  }
+
+  static constexpr uint32_t FLAG_SIZE = 1;
+  static constexpr uint32_t TERMINATOR_SIZE = 2;
+  static constexpr uint32_t ROW_ID_SIZE = sizeof(int64_t);
+
+private:
+  static inline uint32_t EncodeFloat(float value) {
+    // -0.0 equals 0.0 under the float kernel, give them one encoding
+    if (value == 0.0f) {
+      value = 0.0f;
+    }
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & SIGN_BIT_32) ? ~bits : bits | SIGN_BIT_32;
+  }
+
+  static inline float DecodeFloat(uint32_t bits) {
+    bits = (bits & SIGN_BIT_32) ? bits & ~SIGN_BIT_32 : ~bits;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  static inline void WriteBigEndian32(char *buf, uint32_t value) {
+    for (int i = 3; i >= 0; i--) {
+      buf[i] = static_cast<char>(value & 0xff);
+      value >>= 8;
+    }
+  }
+
+  static inline uint32_t ReadBigEndian32(const char *buf) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+      value = value << 8 | static_cast<uint8_t>(buf[i]);
+    }
+    return value;
+  }
+
+  static constexpr uint32_t SIGN_BIT_32 = 0x80000000u;
+  static constexpr uint64_t SIGN_BIT_64 = 0x8000000000000000ull;
+};
+
+/**
+ * Key of an index stored in packed pages, see PackedKeyCodec for the format.
+ *
+ * KeySize bounds the encoded key, row id suffix of non-unique keys included;
+ * the pages only store the used len bytes. Same interface as GenericKey.
+ */
+template<size_t KeySize>
+class PackedKey {
+public:
+  /**
+   * A key of only the leading columns of schema sorts before every key
+   * starting with the same columns
+   */
+  inline void SerializeFromKey(const Row &key, Schema *schema) {
+    ASSERT(key.GetFieldCount() <= schema->GetColumnCount(), "field nums not match.");
+    ASSERT(PackedKeyCodec::EncodedSize(key, schema) <= KeySize, "Index key size exceed max key size.");
+    len = PackedKeyCodec::Encode(key, schema, data);
+  }
+
+  inline void DeserializeToKey(Row &key, Schema *schema) const {
+    uint32_t ofs = PackedKeyCodec::Decode(data, key, schema);
+    ASSERT(ofs <= len, "Index key size exceed max key size.");
+  }
+
+  static inline bool Fits(const Row &key, Schema *schema, bool with_row_id) {
+    return PackedKeyCodec::EncodedSize(key, schema) + (with_row_id ? ROW_ID_SIZE : 0) <= KeySize;
+  }
+
+  /**
+   * Append the row id to the key of a non-unique index, once per key
+   */
+  inline void SetRowId(RowId rid) {
+    ASSERT(len + ROW_ID_SIZE <= KeySize, "Index key too small for a row id.");
+    PackedKeyCodec::EncodeRowId(rid, data + len);
+    len += ROW_ID_SIZE;
+  }
+
+  /**
+   * Append a byte above any column flag, the key then sorts after every key
+   * starting with its current bytes
+   */
+  inline void SetUpperBound() {
+    ASSERT(len < KeySize, "Index key too small for an upper bound.");
+    data[len++] = static_cast<char>(0xff);
+  }
+
+  inline RowId GetRowId() const { return PackedKeyCodec::DecodeRowId(data + len - ROW_ID_SIZE); }
+
+  /**
+   * Copy an encoded key, used by the pages to rebuild stored keys
+   */
+  inline void Assign(const char *buf, uint32_t size) {
+    ASSERT(size <= KeySize, "Index key size exceed max key size.");
+    memcpy(data, buf, size);
+    len = size;
+  }
+
+  inline uint32_t GetLength() const { return len; }
+
+  // NOTE: for test purpose only
+  friend std::ostream &operator<<(std::ostream &os, const PackedKey &key) {
+    static const char *digits = "0123456789abcdef";
+    for (uint32_t i = 0; i < key.len; i++) {
+      auto byte = static_cast<uint8_t>(key.data[i]);
+      os << digits[byte >> 4] << digits[byte & 0xf];
+    }
+    return os;
+  }
+
+  static constexpr size_t ROW_ID_SIZE = PackedKeyCodec::ROW_ID_SIZE;
+
+  uint16_t len{0};
+  char data[KeySize];
+};
+
+/**
+ * Shortest key s with left < s <= right, used as separator when a leaf of
+ * packed keys splits: a prefix of right one byte past the first difference.
+ */
+template<size_t KeySize>
+inline PackedKey<KeySize> ShortestSeparator(const PackedKey<KeySize> &left, const PackedKey<KeySize> &right) {
+  uint32_t common = PackedKeyCodec::CommonPrefix(left.data, left.len, right.data, right.len);
+  PackedKey<KeySize> separator;
+  separator.Assign(right.data, std::min<uint32_t>(common + 1, right.len));
+  return separator;
+}
+
+/**
+ * Function object returns true if lhs < rhs, used for trees
+ */
+template<size_t KeySize>
+class PackedComparator {
+public:
+  inline int operator()(const PackedKey<KeySize> &lhs, const PackedKey<KeySize> &rhs) const {
+    return PackedKeyCodec::Compare(lhs.data, lhs.len, rhs.data, rhs.len);
+  }
+
+  inline bool IsUnique() const { return unique_; }
+
+  // constructor
+  PackedComparator(Schema *key_schema, bool unique = true) : unique_(unique) {}
+
+private:
+  bool unique_;
+};
+
+#endif  // MINISQL_PACKED_KEY_H
@@ -3,6 +3,7 @@
 
 #include <queue>
 #include "page/b_plus_tree_page.h"
+#include "page/packed_key_array.h"
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 24
@@ -49,6 +50,9 @@ public:
 
   void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
 
+  // Keep about keep_percent of the entries, move the rest to recipient
+  void MoveTailTo(BPlusTreeInternalPage *recipient, int keep_percent, BufferPoolManager *buffer_pool_manager);
+
   void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                         BufferPoolManager *buffer_pool_manager);
 
@@ -57,6 +61,21 @@ public:
 
   void MoveAllToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                          BufferPoolManager *buffer_pool_manager);
+
+  // space checks used by the tree to decide on splits, merges and redistributions
+  inline bool HasRoomFor(const KeyType &key) const { return GetSize() <= GetMaxSize(); }
+
+  inline bool CanSetKeyAt(int index, const KeyType &key) const { return true; }
+
+  inline bool NeedsSplit() const { return GetSize() > GetMaxSize(); }
+
+  inline bool IsUnderflow() const { return GetSize() < GetMinSize(); }
+
+  inline bool CanMergeWith(const BPlusTreeInternalPage *sibling, const KeyType &middle_key) const {
+    return GetSize() + sibling->GetSize() < GetMaxSize();
+  }
+
+  static constexpr int MAX_SIZE = INTERNAL_PAGE_SIZE;
 private:
   int IndexLookup(const KeyType &key, const KeyComparator &comparator) const;
 
@@ -71,4 +90,93 @@ public:
   MappingType array_[0];
 };
 
+template<size_t KeySize>
+class PackedKey;
+
+template<size_t KeySize>
+class PackedComparator;
+
+#define B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE \
+  BPlusTreeInternalPage<PackedKey<KeySize>, ValueType, PackedComparator<KeySize>>
+
+/**
+ * Internal page of packed keys (see PackedKey).
+ *
+ * Same interface as above, keys live in a PackedKeyArray and take only their
+ * own length. Separators coming from leaf splits are cut to the shortest key
+ * telling the two leaves apart, so they are mostly much shorter than the keys.
+ * The page keeps room for one more entry of the widest key at all times, and
+ * splits as soon as it does not.
+ *
+ * | HEADER | PACKED KEY ARRAY |
+ */
+template<size_t KeySize, typename ValueType>
+class BPlusTreeInternalPage<PackedKey<KeySize>, ValueType, PackedComparator<KeySize>> : public BPlusTreePage {
+  using KeyType = PackedKey<KeySize>;
+  using KeyComparator = PackedComparator<KeySize>;
+
+public:
+  static constexpr int MAX_SIZE =
+          (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (2 * sizeof(uint16_t) + sizeof(ValueType)) - 1;
+
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = MAX_SIZE);
+
+  KeyType KeyAt(int index) const;
+
+  void SetKeyAt(int index, const KeyType &key);
+
+  int ValueIndex(const ValueType &value) const;
+
+  ValueType ValueAt(int index) const;
+
+  ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
+
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  void Remove(int index);
+
+  ValueType RemoveAndReturnOnlyChild();
+
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
+
+  void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
+
+  // Keep about keep_percent of the entries, move the rest to recipient
+  void MoveTailTo(BPlusTreeInternalPage *recipient, int keep_percent, BufferPoolManager *buffer_pool_manager);
+
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                         BufferPoolManager *buffer_pool_manager);
+
+  void MoveAllToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+
+  bool HasRoomFor(const KeyType &key) const;
+
+  bool CanSetKeyAt(int index, const KeyType &key) const;
+
+  inline bool NeedsSplit() const { return GetSize() > GetMaxSize() || keys_.GetUsedBytes() > GetMaxUsedBytes(); }
+
+  inline bool IsUnderflow() const {
+    return GetSize() < GetMinSize() && keys_.GetUsedBytes() * 2 < keys_.GetCapacity();
+  }
+
+  bool CanMergeWith(const BPlusTreeInternalPage *sibling, const KeyType &middle_key) const;
+
+private:
+  /**
+   * Bytes usable at rest, the rest is kept for one more entry
+   */
+  inline uint32_t GetMaxUsedBytes() const { return keys_.GetCapacity() - KeySize - keys_.GetSlotSize(); }
+
+  void MoveTo(BPlusTreeInternalPage *recipient, int begin, int count, int pos,
+              BufferPoolManager *buffer_pool_manager);
+
+  PackedKeyArray keys_;
+};
+
 #endif  // MINISQL_B_PLUS_TREE_INTERNAL_PAGE_H
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "page/b_plus_tree_page.h"
+#include "page/packed_key_array.h"
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 28
@@ -58,6 +59,9 @@ public:
   // Split and Merge utility methods
   void MoveHalfTo(BPlusTreeLeafPage *recipient);
 
+  // Keep about keep_percent of the entries, move the rest to recipient
+  void MoveTailTo(BPlusTreeLeafPage *recipient, int keep_percent);
+
   void MoveAllTo(BPlusTreeLeafPage *recipient);
 
   void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
@@ -65,6 +69,19 @@ public:
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
   void MoveAllToFrontOf(BPlusTreeLeafPage *recipient);
+
+  // space checks used by the tree to decide on splits and merges
+  inline bool HasRoomFor(const KeyType &key) const { return GetSize() <= GetMaxSize(); }
+
+  inline bool NeedsSplit() const { return GetSize() > GetMaxSize(); }
+
+  inline bool IsUnderflow() const { return GetSize() < GetMinSize(); }
+
+  inline bool CanMergeWith(const BPlusTreeLeafPage *sibling) const {
+    return GetSize() + sibling->GetSize() < GetMaxSize();
+  }
+
+  static constexpr int MAX_SIZE = LEAF_PAGE_SIZE;
 private:
   void CopyNFrom(MappingType *items, int size);
 
@@ -78,4 +95,79 @@ public:
   MappingType array_[0];
 };
 
+template<size_t KeySize>
+class PackedKey;
+
+template<size_t KeySize>
+class PackedComparator;
+
+#define B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE BPlusTreeLeafPage<PackedKey<KeySize>, ValueType, PackedComparator<KeySize>>
+
+/**
+ * Leaf page of packed keys (see PackedKey).
+ *
+ * Same interface as above, but the keys live in a PackedKeyArray: each key
+ * takes only its encoded length and the prefix shared by all keys of the page
+ * is stored once. Pages are full when the bytes of the next key do not fit,
+ * max size only bounds the number of entries.
+ *
+ * | HEADER | NextPageId (4) | PrevPageId (4) | PACKED KEY ARRAY |
+ */
+template<size_t KeySize, typename ValueType>
+class BPlusTreeLeafPage<PackedKey<KeySize>, ValueType, PackedComparator<KeySize>> : public BPlusTreePage {
+  using KeyType = PackedKey<KeySize>;
+  using KeyComparator = PackedComparator<KeySize>;
+
+public:
+  static constexpr int MAX_SIZE = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (2 * sizeof(uint16_t) + sizeof(ValueType)) - 1;
+
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = MAX_SIZE);
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  KeyType KeyAt(int index) const;
+
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  MappingType GetItem(int index);
+
+  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  bool Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const;
+
+  int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
+
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+
+  // Keep about keep_percent of the entries, move the rest to recipient
+  void MoveTailTo(BPlusTreeLeafPage *recipient, int keep_percent);
+
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
+
+  void MoveAllToFrontOf(BPlusTreeLeafPage *recipient);
+
+  bool HasRoomFor(const KeyType &key) const;
+
+  inline bool NeedsSplit() const { return GetSize() > GetMaxSize(); }
+
+  inline bool IsUnderflow() const {
+    return GetSize() < GetMinSize() && keys_.GetUsedBytes() * 2 < keys_.GetCapacity();
+  }
+
+  bool CanMergeWith(const BPlusTreeLeafPage *sibling) const;
+
+private:
+  void MoveTo(BPlusTreeLeafPage *recipient, int begin, int count, int pos);
+
+  page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  PackedKeyArray keys_;
+};
+
 #endif  // MINISQL_B_PLUS_TREE_LEAF_PAGE_H
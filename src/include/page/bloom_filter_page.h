@@ -0,0 +1,60 @@
+#ifndef MINISQL_BLOOM_FILTER_PAGE_H
+#define MINISQL_BLOOM_FILTER_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * One page of the counters of an index Bloom filter, the pages of a filter
+ * are chained through the next page id. Only the header of the first page is
+ * read on load: a filter not written back on shutdown is not clean and is
+ * rebuilt from the index.
+ *
+ * Format (size in byte):
+ *  ----------------------------------------------------------------------------
+ * | NextPageId (4) | Clean (4) | Capacity (4) | Count (4) | Size (4) | Data |
+ *  ----------------------------------------------------------------------------
+ */
+class BloomFilterPage {
+public:
+  inline void Init(uint32_t capacity, uint32_t count, uint32_t size) {
+    next_page_id_ = INVALID_PAGE_ID;
+    clean_ = 0;
+    capacity_ = capacity;
+    count_ = count;
+    size_ = size;
+  }
+
+  inline page_id_t GetNextPageId() const { return next_page_id_; }
+
+  inline void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  inline bool IsClean() const { return clean_ != 0; }
+
+  inline void SetClean(bool clean) { clean_ = clean ? 1 : 0; }
+
+  inline uint32_t GetCapacity() const { return capacity_; }
+
+  inline uint32_t GetCount() const { return count_; }
+
+  /**
+   * @return counter bytes stored on this page
+   */
+  inline uint32_t GetSize() const { return size_; }
+
+  inline char *GetData() { return data_; }
+
+  static constexpr uint32_t HEADER_SIZE = sizeof(page_id_t) + 4 * sizeof(uint32_t);
+  static constexpr uint32_t DATA_SIZE = PAGE_SIZE - HEADER_SIZE;
+
+private:
+  page_id_t next_page_id_;
+  uint32_t clean_;
+  uint32_t capacity_;
+  uint32_t count_;
+  uint32_t size_;
+  char data_[0];
+};
+
+#endif  // MINISQL_BLOOM_FILTER_PAGE_H
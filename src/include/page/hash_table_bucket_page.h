@@ -0,0 +1,125 @@
+#ifndef MINISQL_HASH_TABLE_BUCKET_PAGE_H
+#define MINISQL_HASH_TABLE_BUCKET_PAGE_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+
+/**
+ * Bucket of an extendible hash index, holding unordered (key, row id) pairs.
+ *
+ * Keys are PackedKeyCodec encodings, equal keys have equal bytes. The hashes
+ * of the keys are kept apart in one array, lookups scan it and only compare
+ * the keys of equal hashes; splits never rehash. A bucket which can no longer
+ * split chains overflow pages through the next page id.
+ *
+ * Format (size in byte):
+ *  ------------------------------------------------------------------------
+ * | NextPageId (4) | Count (4) | KeySize (4) | Capacity (4) |
+ *  ------------------------------------------------------------------------
+ * | Hash(0) ... Hash(capacity-1) (4 each) | ENTRY(0) ... ENTRY(n-1) |
+ *  ------------------------------------------------------------------------
+ *
+ *  Entry format (size in byte, 10 + key size):
+ *  ------------------------------------
+ * | RowId (8) | KeyLength (2) | Key |
+ *  ------------------------------------
+ */
+class HashTableBucketPage {
+public:
+  void Init(uint32_t key_size);
+
+  inline int GetSize() const { return count_; }
+
+  inline int GetCapacity() const { return capacity_; }
+
+  inline bool IsFull() const { return count_ >= capacity_; }
+
+  inline bool IsEmpty() const { return count_ == 0; }
+
+  inline page_id_t GetNextPageId() const { return next_page_id_; }
+
+  inline void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  inline uint32_t HashAt(int index) const { return hashes_[index]; }
+
+  inline RowId ValueAt(int index) const {
+    int64_t rid;
+    memcpy(&rid, EntryAt(index), sizeof(int64_t));
+    return RowId(rid);
+  }
+
+  /**
+   * @return true if the key at index is the len bytes of key
+   */
+  bool KeyEquals(int index, uint32_t hash, const char *key, uint32_t len) const;
+
+  /**
+   * Append the row ids of every entry of key to result
+   * @return true if any was found
+   */
+  bool Find(uint32_t hash, const char *key, uint32_t len, std::vector<RowId> &result) const;
+
+  /**
+   * @return index of the first entry of key, -1 if absent
+   */
+  int IndexOf(uint32_t hash, const char *key, uint32_t len) const;
+
+  /**
+   * @return index of the entry of key and rid, -1 if absent
+   */
+  int IndexOf(uint32_t hash, const char *key, uint32_t len, RowId rid) const;
+
+  /**
+   * Append an entry, the bucket must not be full
+   */
+  void Insert(uint32_t hash, const char *key, uint32_t len, RowId rid);
+
+  /**
+   * Remove the entry at index, the last entry takes its slot
+   */
+  void RemoveAt(int index);
+
+  /**
+   * Move the entries whose hash has bit set to recipient, an empty bucket of
+   * the same key size
+   */
+  void SplitTo(HashTableBucketPage *recipient, uint32_t bit);
+
+private:
+  inline uint32_t GetEntrySize() const { return ENTRY_HEADER_SIZE + key_size_; }
+
+  inline char *EntryAt(int index) {
+    return reinterpret_cast<char *>(hashes_ + capacity_) + index * GetEntrySize();
+  }
+
+  inline const char *EntryAt(int index) const {
+    return reinterpret_cast<const char *>(hashes_ + capacity_) + index * GetEntrySize();
+  }
+
+  inline bool KeyBytesEqual(int index, const char *key, uint32_t len) const {
+    const char *entry = EntryAt(index);
+    uint16_t key_len;
+    memcpy(&key_len, entry + sizeof(int64_t), sizeof(uint16_t));
+    return key_len == len && memcmp(entry + ENTRY_HEADER_SIZE, key, len) == 0;
+  }
+
+  /**
+   * Copy the entry at index of from, hash included, to index of this bucket
+   */
+  void CopyEntry(int index, const HashTableBucketPage *from, int from_index);
+
+  static constexpr uint32_t HEADER_SIZE = 4 * sizeof(uint32_t);
+  static constexpr uint32_t ENTRY_HEADER_SIZE = sizeof(int64_t) + sizeof(uint16_t);
+
+  page_id_t next_page_id_;
+  uint32_t count_;
+  uint32_t key_size_;
+  uint32_t capacity_;
+  uint32_t hashes_[0];
+};
+
+#endif  // MINISQL_HASH_TABLE_BUCKET_PAGE_H
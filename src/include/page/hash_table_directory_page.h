@@ -0,0 +1,78 @@
+#ifndef MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+#define MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * Directory of an extendible hash index, a single page.
+ *
+ * Slot i of the directory holds the bucket of every key whose hash ends
+ * with the global depth low bits of i. A bucket of local depth d is shared by
+ * the 2^(global depth - d) slots agreeing on the d low bits.
+ *
+ * Format (size in byte):
+ *  ---------------------------------------------------------------------
+ * | GlobalDepth (4) | LocalDepth (1) x 512 | BucketPageId (4) x 512 |
+ *  ---------------------------------------------------------------------
+ */
+class HashTableDirectoryPage {
+public:
+  /**
+   * A directory of depth 0, its only slot on bucket_page_id
+   */
+  void Init(page_id_t bucket_page_id);
+
+  inline uint32_t GetGlobalDepth() const { return global_depth_; }
+
+  inline uint32_t GetGlobalDepthMask() const { return (1u << global_depth_) - 1; }
+
+  inline uint32_t Size() const { return 1u << global_depth_; }
+
+  inline uint32_t GetBucketIndex(uint32_t hash) const { return hash & GetGlobalDepthMask(); }
+
+  inline page_id_t GetBucketPageId(uint32_t index) const { return bucket_page_ids_[index]; }
+
+  inline void SetBucketPageId(uint32_t index, page_id_t bucket_page_id) { bucket_page_ids_[index] = bucket_page_id; }
+
+  inline uint32_t GetLocalDepth(uint32_t index) const { return local_depths_[index]; }
+
+  inline void SetLocalDepth(uint32_t index, uint32_t local_depth) { local_depths_[index] = local_depth; }
+
+  /**
+   * @return the slot of the bucket split from, or merged with, the bucket of index
+   */
+  inline uint32_t GetSplitImageIndex(uint32_t index) const {
+    return index ^ (1u << (local_depths_[index] - 1));
+  }
+
+  inline bool CanGrow() const { return global_depth_ < MAX_GLOBAL_DEPTH; }
+
+  /**
+   * Double the directory, the new upper half mirrors the lower one
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * @return true if every bucket has a local depth below the global depth
+   */
+  bool CanShrink() const;
+
+  /**
+   * Halve the directory, CanShrink must hold
+   */
+  void DecrGlobalDepth();
+
+  static constexpr uint32_t MAX_GLOBAL_DEPTH = 9;
+  static constexpr uint32_t DIRECTORY_ARRAY_SIZE = 1u << MAX_GLOBAL_DEPTH;
+
+private:
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+static_assert(sizeof(HashTableDirectoryPage) <= PAGE_SIZE, "Hash directory larger than a page.");
+
+#endif  // MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
@@ -0,0 +1,180 @@
+#ifndef MINISQL_PACKED_KEY_ARRAY_H
+#define MINISQL_PACKED_KEY_ARRAY_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * Variable-length key slots of the B+ tree pages of packed keys.
+ *
+ * Keys are byte strings ordered by memcmp, shorter first on ties (see
+ * PackedKeyCodec). The array is laid out in place behind the page header:
+ *  --------------------------------------------------------------------
+ * | HEADER | PREFIX | SLOT(0) ... SLOT(n-1) | FREE | KEY BYTES (heap) |
+ *  --------------------------------------------------------------------
+ *
+ *  Slot format (size in byte, 4 + value size):
+ *  -------------------------------------------
+ * | Offset (2) | Length (2) | Value |
+ *  -------------------------------------------
+ *
+ * Offset and length locate the key bytes following the prefix in the heap,
+ * which grows down from the end of the page. With prefix compression on, the
+ * prefix holds the bytes shared by every key of the array and only the
+ * remaining suffixes are stored; since keys are sorted, that is the common
+ * prefix of the first and the last key. Removed key bytes stay in the heap
+ * until an insert runs out of contiguous free space and the array is rebuilt.
+ */
+class PackedKeyArray {
+public:
+  void Init(uint32_t capacity, uint32_t value_size, bool compress_prefix);
+
+  inline int GetSize() const { return count_; }
+
+  inline uint32_t GetCapacity() const { return capacity_; }
+
+  inline uint32_t GetPrefixLength() const { return prefix_len_; }
+
+  inline uint32_t GetSlotSize() const { return SLOT_HEADER_SIZE + value_size_; }
+
+  inline uint32_t GetKeyLength(int index) const { return prefix_len_ + SlotLength(index); }
+
+  /**
+   * Bytes taken by the prefix, the slots and the live key bytes
+   */
+  inline uint32_t GetUsedBytes() const { return prefix_len_ + count_ * GetSlotSize() + GetHeapBytes(); }
+
+  /**
+   * Sum of the lengths of the keys, shared prefix included
+   */
+  inline uint32_t GetKeyBytes() const { return GetHeapBytes() + count_ * prefix_len_; }
+
+  /**
+   * Copy the whole key at index into buf
+   * @return key length
+   */
+  uint32_t CopyKey(int index, char *buf) const;
+
+  int CompareKey(int index, const char *key, uint32_t len) const;
+
+  /**
+   * @return first index in [begin, size) whose key is not less than key
+   */
+  int LowerBound(const char *key, uint32_t len, int begin = 0) const;
+
+  /**
+   * @return first index in [begin, size) whose key is greater than key
+   */
+  int UpperBound(const char *key, uint32_t len, int begin = 0) const;
+
+  inline void GetValue(int index, void *value) const {
+    memcpy(value, SlotAt(index) + SLOT_HEADER_SIZE, value_size_);
+  }
+
+  inline void SetValue(int index, const void *value) {
+    memcpy(SlotAt(index) + SLOT_HEADER_SIZE, value, value_size_);
+  }
+
+  /**
+   * Used bytes once key is inserted, an upper bound if the prefix shrinks
+   */
+  uint32_t GetBytesAfterInsert(const char *key, uint32_t len) const;
+
+  /**
+   * Used bytes once the key at index is replaced by key
+   */
+  uint32_t GetBytesAfterSetKey(int index, const char *key, uint32_t len) const;
+
+  /**
+   * Used bytes of an array holding the keys of both arrays, an upper bound
+   */
+  static uint32_t GetBytesAfterMerge(const PackedKeyArray &lhs, const PackedKeyArray &rhs);
+
+  /**
+   * Index splitting the array so that the lower part [0, index) holds about
+   * lower_percent of the bytes, halves by default. Neither part is empty.
+   */
+  int GetSplitIndex(int lower_percent = 50) const;
+
+  /**
+   * Insert key at index, GetBytesAfterInsert must fit in the capacity
+   */
+  void Insert(int index, const char *key, uint32_t len, const void *value);
+
+  void Remove(int index);
+
+  /**
+   * Replace the key at index, GetBytesAfterSetKey must fit in the capacity
+   */
+  void SetKey(int index, const char *key, uint32_t len);
+
+  /**
+   * Move count entries from begin on to position pos of recipient
+   */
+  void MoveTo(PackedKeyArray *recipient, int begin, int count, int pos);
+
+private:
+  /**
+   * An entry to rebuild the array from, the key is head followed by tail
+   */
+  struct EntryRef {
+    const char *head;
+    uint32_t head_len;
+    const char *tail;
+    uint32_t tail_len;
+    const char *value;
+
+    inline uint32_t Length() const { return head_len + tail_len; }
+
+    inline char At(uint32_t i) const { return i < head_len ? head[i] : tail[i - head_len]; }
+  };
+
+  void CollectEntries(int begin, int end, std::vector<EntryRef> *entries) const;
+
+  /**
+   * Rebuild the array from entries without garbage, the prefix recomputed.
+   * Entries may point into the array itself.
+   */
+  void Assign(const std::vector<EntryRef> &entries);
+
+  inline uint32_t GetHeapBytes() const { return capacity_ - heap_top_ - garbage_; }
+
+  inline bool SharesPrefix(const char *key, uint32_t len) const {
+    return len >= prefix_len_ && memcmp(data_, key, prefix_len_) == 0;
+  }
+
+  inline char *SlotAt(int index) { return data_ + prefix_len_ + index * GetSlotSize(); }
+
+  inline const char *SlotAt(int index) const { return data_ + prefix_len_ + index * GetSlotSize(); }
+
+  inline uint16_t SlotOffset(int index) const {
+    uint16_t offset;
+    memcpy(&offset, SlotAt(index), sizeof(uint16_t));
+    return offset;
+  }
+
+  inline uint16_t SlotLength(int index) const {
+    uint16_t len;
+    memcpy(&len, SlotAt(index) + sizeof(uint16_t), sizeof(uint16_t));
+    return len;
+  }
+
+  inline void SetSlot(int index, uint16_t offset, uint16_t len) {
+    memcpy(SlotAt(index), &offset, sizeof(uint16_t));
+    memcpy(SlotAt(index) + sizeof(uint16_t), &len, sizeof(uint16_t));
+  }
+
+  static constexpr uint32_t SLOT_HEADER_SIZE = 2 * sizeof(uint16_t);
+
+  uint16_t count_;
+  uint16_t prefix_len_;
+  uint16_t heap_top_;   /** offset of the lowest heap byte */
+  uint16_t garbage_;    /** bytes of removed keys still in the heap */
+  uint16_t capacity_;
+  uint16_t value_size_;
+  uint16_t compress_prefix_;
+  char data_[0];
+};
+
+#endif  // MINISQL_PACKED_KEY_ARRAY_H
@@ -12,7 +12,8 @@
 }
 
 %token <syntax_node> CREATE DROP SELECT INSERT DELETE UPDATE
-%token <syntax_node> TRXBEGIN TRXCOMMIT TRXROLLBACK QUIT EXECFILE SHOW USE USING
+%token <syntax_node> TRXBEGIN TRXCOMMIT TRXROLLBACK QUIT EXECFILE SHOW USE USING INCLUDE ANALYZE JOIN DISTINCT GROUP BY
+%token <syntax_node> ORDER LIMIT ASC DESC PREPARE EXECUTE AS EXPLAIN
 %token <syntax_node> DATABASE DATABASES TABLE TABLES INDEX INDEXES
 %token <syntax_node> ON FROM WHERE INTO SET VALUES PRIMARY KEY UNIQUE
 %token <syntax_node> CHAR INT FLOAT AND OR NOT IS FLAGNULL
@@ -22,12 +23,14 @@
 %type <syntax_node> sql_create_database sql_drop_database sql_show_databases sql_use_database
 %type <syntax_node> sql_show_tables sql_create_table sql_drop_table
 %type <syntax_node> column_definition_list column_definition column_type column_list
-%type <syntax_node> sql_create_index sql_drop_index sql_show_indexes
+%type <syntax_node> sql_create_index index_include index_using sql_drop_index sql_show_indexes
 %type <syntax_node> sql_trx_begin sql_trx_commit sql_trx_rollback
-%type <syntax_node> sql_select select_columns column_values column_value operator
+%type <syntax_node> sql_select select_distinct select_columns select_items select_item select_where select_group_by
+%type <syntax_node> select_order_by order_items order_item select_limit
+%type <syntax_node> table_refs column_refs column_ref column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_quit sql_exec_file sql_analyze sql_prepare sql_prepared sql_execute sql_explain
 
 %%
 
@@ -58,6 +61,10 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_analyze { $$ = $1; }
+  | sql_prepare { $$ = $1; }
+  | sql_execute { $$ = $1; }
+  | sql_explain { $$ = $1; }
   ;
 
 sql_create_database:
@@ -161,24 +168,39 @@ sql_drop_table:
   ;
 
 sql_create_index:
-  CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' {
+  CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' index_include index_using {
     $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, $5);
     pSyntaxNode index_keys_node = CreateSyntaxNode(kNodeColumnList, "index keys");
     SyntaxNodeAddChildren(index_keys_node, $7);
     SyntaxNodeAddChildren($$, index_keys_node);
+    if ($9 != NULL) {
+      SyntaxNodeAddChildren($$, $9);
+    }
+    if ($10 != NULL) {
+      SyntaxNodeAddChildren($$, $10);
+    }
   }
-  | CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' USING IDENTIFIER {
-      $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
-      SyntaxNodeAddChildren($$, $3);
-      SyntaxNodeAddChildren($$, $5);
-      pSyntaxNode index_keys_node = CreateSyntaxNode(kNodeColumnList, "index keys");
-      SyntaxNodeAddChildren(index_keys_node, $7);
-      SyntaxNodeAddChildren($$, index_keys_node);
-      pSyntaxNode index_type_node = CreateSyntaxNode(kNodeIndexType, "index type");
-      SyntaxNodeAddChildren(index_type_node, $10);
-      SyntaxNodeAddChildren($$, index_type_node);
+  ;
+
+index_include:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | INCLUDE '(' column_list ')' {
+    $$ = CreateSyntaxNode(kNodeColumnList, "include columns");
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+index_using:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | USING IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeIndexType, "index type");
+    SyntaxNodeAddChildren($$, $2);
   }
   ;
 
@@ -196,18 +218,132 @@ sql_show_indexes:
   ;
 
 sql_select:
-  SELECT select_columns FROM IDENTIFIER {
+  SELECT select_distinct select_columns FROM table_refs select_where select_group_by select_order_by select_limit {
+    /* columns, tables, then the optional clauses present */
     $$ = CreateSyntaxNode(kNodeSelect, NULL);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, $5);
+    if ($6 != NULL) {
+      SyntaxNodeAddChildren($$, $6);
+    }
+    if ($7 != NULL) {
+      SyntaxNodeAddChildren($$, $7);
+    }
+    if ($2 != NULL) {
+      SyntaxNodeAddChildren($$, $2);
+    }
+    if ($8 != NULL) {
+      SyntaxNodeAddChildren($$, $8);
+    }
+    if ($9 != NULL) {
+      SyntaxNodeAddChildren($$, $9);
+    }
+  }
+  ;
+
+select_distinct:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | DISTINCT {
+    $$ = CreateSyntaxNode(kNodeDistinct, NULL);
+  }
+  ;
+
+select_where:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | WHERE where_conditions {
+    $$ = CreateSyntaxNode(kNodeConditions, NULL);
     SyntaxNodeAddChildren($$, $2);
-    SyntaxNodeAddChildren($$, $4);
   }
-  | SELECT select_columns FROM IDENTIFIER WHERE where_conditions {
-    $$ = CreateSyntaxNode(kNodeSelect, NULL);
+  ;
+
+select_group_by:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | GROUP BY column_refs {
+    $$ = CreateSyntaxNode(kNodeGroupBy, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+select_order_by:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | ORDER BY order_items {
+    $$ = CreateSyntaxNode(kNodeOrderBy, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+order_items:
+  order_item ',' order_items {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | order_item {
+    $$ = $1;
+  }
+  ;
+
+order_item:
+  select_item {
+    /* the direction is the value, the column or aggregate the child */
+    $$ = CreateSyntaxNode(kNodeOrderItem, "asc");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  | select_item ASC {
+    $$ = CreateSyntaxNode(kNodeOrderItem, "asc");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  | select_item DESC {
+    $$ = CreateSyntaxNode(kNodeOrderItem, "desc");
+    SyntaxNodeAddChildren($$, $1);
+  }
+  ;
+
+select_limit:
+  /* empty */ {
+    $$ = NULL;
+  }
+  | LIMIT NUMBER {
+    $$ = CreateSyntaxNode(kNodeLimit, NULL);
     SyntaxNodeAddChildren($$, $2);
-    SyntaxNodeAddChildren($$, $4);
-    pSyntaxNode condition_node = CreateSyntaxNode(kNodeConditions, NULL);
-    SyntaxNodeAddChildren(condition_node, $6);
-    SyntaxNodeAddChildren($$, condition_node);
+  }
+  | LIMIT '?' {
+    $$ = CreateSyntaxNode(kNodeLimit, NULL);
+    SyntaxNodeAddChildren($$, CreateSyntaxNode(kNodeParameter, NULL));
+  }
+  ;
+
+table_refs:
+  IDENTIFIER {
+    $$ = $1;
+  }
+  | table_refs ',' IDENTIFIER {
+    if ($1->type_ == kNodeJoin) {
+      $$ = $1;
+    } else {
+      $$ = CreateSyntaxNode(kNodeJoin, NULL);
+      SyntaxNodeAddChildren($$, $1);
+    }
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | table_refs JOIN IDENTIFIER ON where_conditions {
+    if ($1->type_ == kNodeJoin) {
+      $$ = $1;
+    } else {
+      $$ = CreateSyntaxNode(kNodeJoin, NULL);
+      SyntaxNodeAddChildren($$, $1);
+    }
+    SyntaxNodeAddChildren($$, $3);
+    pSyntaxNode on_node = CreateSyntaxNode(kNodeConditions, NULL);
+    SyntaxNodeAddChildren(on_node, $5);
+    SyntaxNodeAddChildren($$, on_node);
   }
   ;
 
@@ -215,12 +351,59 @@ select_columns:
   '*' {
     $$ = CreateSyntaxNode(kNodeAllColumns, NULL);
   }
-  | column_list {
+  | select_items {
     $$ = CreateSyntaxNode(kNodeColumnList, "select columns");
     SyntaxNodeAddChildren($$, $1);
   }
   ;
 
+select_items:
+  select_item ',' select_items {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | select_item {
+    $$ = $1;
+  }
+  ;
+
+select_item:
+  column_ref {
+    $$ = $1;
+  }
+  | IDENTIFIER '(' '*' ')' {
+    /* the function name stays the value */
+    $$ = $1;
+    $$->type_ = kNodeAggregate;
+  }
+  | IDENTIFIER '(' column_ref ')' {
+    $$ = $1;
+    $$->type_ = kNodeAggregate;
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+column_refs:
+  column_ref ',' column_refs {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
+  | column_ref {
+    $$ = $1;
+  }
+  ;
+
+column_ref:
+  IDENTIFIER {
+    $$ = $1;
+  }
+  | IDENTIFIER '.' IDENTIFIER {
+    /* the column, its table as child */
+    $$ = $3;
+    SyntaxNodeAddChildren($$, $1);
+  }
+  ;
+
 where_conditions:
   where_conditions connector where_condition  {
     $$ = $2;
@@ -242,7 +425,12 @@ connector:
   ;
 
 where_condition:
-  IDENTIFIER operator column_value {
+  column_ref operator column_value {
+    $$ = $2;
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | column_ref operator column_ref {
     $$ = $2;
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $3);
@@ -259,6 +447,9 @@ column_value:
   | FLAGNULL {
     $$ = CreateSyntaxNode(kNodeNull, NULL);
   }
+  | '?' {
+    $$ = CreateSyntaxNode(kNodeParameter, NULL);
+  }
   ;
 
 operator:
@@ -393,6 +584,53 @@ sql_exec_file:
   }
   ;
 
+sql_analyze:
+  ANALYZE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeAnalyze, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
+sql_prepare:
+  PREPARE IDENTIFIER AS sql_prepared {
+    $$ = CreateSyntaxNode(kNodePrepare, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
+sql_prepared:
+  sql_select { $$ = $1; }
+  | sql_insert { $$ = $1; }
+  | sql_delete { $$ = $1; }
+  | sql_update { $$ = $1; }
+  ;
+
+sql_execute:
+  EXECUTE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeExecute, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | EXECUTE IDENTIFIER '(' column_values ')' {
+    $$ = CreateSyntaxNode(kNodeExecute, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    pSyntaxNode values_node = CreateSyntaxNode(kNodeColumnValues, NULL);
+    SyntaxNodeAddChildren(values_node, $4);
+    SyntaxNodeAddChildren($$, values_node);
+  }
+  ;
+
+sql_explain:
+  EXPLAIN sql_select {
+    $$ = CreateSyntaxNode(kNodeExplain, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | EXPLAIN ANALYZE sql_select {
+    $$ = CreateSyntaxNode(kNodeExplain, "analyze");
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
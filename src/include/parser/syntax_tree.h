@@ -43,7 +43,19 @@ typedef enum {
   kNodeIndexType, /** type of index */
   kNodeTrxBegin, /** begin transaction command */
   kNodeTrxCommit, /** commit transaction command */
-  kNodeTrxRollback /** rollback transaction command */
+  kNodeTrxRollback, /** rollback transaction command */
+  kNodeAnalyze, /** analyze table command */
+  kNodeJoin, /** tables joined in a select, ON conditions are a kNodeConditions child */
+  kNodeAggregate, /** aggregate function in a select, its column as child, none for count(*) */
+  kNodeGroupBy, /** group by columns of a select */
+  kNodeDistinct, /** distinct select */
+  kNodeOrderBy, /** order by items of a select */
+  kNodeOrderItem, /** one order by item, "asc" or "desc", its column or aggregate as child */
+  kNodeLimit, /** limit of a select, its number as child */
+  kNodeParameter, /** '?' in a prepared statement, bound to a number, string or null before it runs */
+  kNodePrepare, /** prepare command, the statement name and the statement as children */
+  kNodeExecute, /** execute command, the statement name and the kNodeColumnValues bound as children */
+  kNodeExplain /** explain command, "analyze" to run the statement, the select as child */
 } SyntaxNodeType;
 
 /**
@@ -9,6 +9,8 @@
 #include "record/type_id.h"
 
 class Field {
+  friend class Row;
+
   friend class Type;
 
   friend class TypeInt;
@@ -17,6 +19,9 @@ class Field {
 
   friend class TypeFloat;
 
+  template<TypeId type>
+  friend struct TypeKernel;
+
 public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
@@ -49,7 +54,12 @@ public:
       value_.chars_ = nullptr;
       manage_data_ = false;
     } else {
-      if (manage_data) {
+      if (manage_data && len <= FIELD_INLINE_LEN) {
+        // short values are kept inside the field, no allocation
+        memcpy(value_.inline_, data, len);
+        is_inline_ = true;
+        manage_data_ = false;
+      } else if (manage_data) {
         ASSERT(len < VARCHAR_MAX_LEN, "Field length exceeds max varchar length");
         value_.chars_ = new char[len];
         memcpy(value_.chars_, data, len);
@@ -66,6 +76,7 @@ public:
     len_ = other.len_;
     is_null_ = other.is_null_;
     manage_data_ = other.manage_data_;
+    is_inline_ = other.is_inline_;
     if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_) {
       value_.chars_ = new char[len_];
       memcpy(value_.chars_, other.value_.chars_, len_);
@@ -74,16 +85,33 @@ public:
     }
   }
 
+  // move constructor, takes over the char data of other
+  Field(Field &&other) noexcept
+          : value_(other.value_), type_id_(other.type_id_), len_(other.len_), is_null_(other.is_null_),
+            manage_data_(other.manage_data_), is_inline_(other.is_inline_) {
+    other.manage_data_ = false;
+  }
+
   // copy
   Field &operator=(Field &other) {
     Swap(*this, other);
     return *this;
   }
 
+  // move
+  Field &operator=(Field &&other) noexcept {
+    Swap(*this, other);
+    return *this;
+  }
+
   inline bool IsNull() const {
     return is_null_;
   }
 
+  inline TypeId GetTypeId() const {
+    return type_id_;
+  }
+
   inline uint32_t GetLength() const {
     return Type::GetInstance(type_id_)->GetLength(*this);
   }
@@ -136,27 +164,34 @@ public:
     std::swap(first.len_, second.len_);
     std::swap(first.is_null_, second.is_null_);
     std::swap(first.manage_data_, second.manage_data_);
+    std::swap(first.is_inline_, second.is_inline_);
   }
   void fprint(){
     if(type_id_ == kTypeFloat) std::cout<<value_.float_;
     else if(type_id_ == kTypeInt) std::cout<<value_.integer_;
     else{ 
       char o[len_+1];
-      memcpy(o,value_.chars_,len_);
+      memcpy(o,GetCharData(),len_);
       o[len_] = '\0';
       std::cout<<o;
       }
   }
+  static constexpr uint32_t FIELD_INLINE_LEN = 16;
+
 protected:
+  inline const char *GetCharData() const { return is_inline_ ? value_.inline_ : value_.chars_; }
+
   union Val {
     int32_t integer_;
     float float_;
     char *chars_;
+    char inline_[FIELD_INLINE_LEN];  /** short char values, see is_inline_ */
   } value_;
   TypeId type_id_;
   uint32_t len_;
   bool is_null_{false};
   bool manage_data_{false};
+  bool is_inline_{false};
 };
 
 
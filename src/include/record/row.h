@@ -18,10 +18,21 @@
  * --------------------------------------------
  * | Field Nums | Null bitmap |
  * -------------------------------------------
- *  
  *
+ *  Compact row format (ROW_COMPACT_MAGIC_NUM), written by default:
+ * ------------------------------------------------------------------------------------
+ * | Magic (4) | Field Nums (2) | Null bitmap (1 bit/field) | Fixed region | Var offsets | Var data |
+ * ------------------------------------------------------------------------------------
+ *  Int and float fields live in the fixed region at offsets computed from the schema
+ *  (null ones still take their slot), each char field has a 2-byte end offset
+ *  relative to the row start, so every field is reached in O(1).
+ *  Rows in the old format (ROW_MAGIC_NUM) are still read.
  */
 class Row {
+  friend class RowView;
+
+  friend class RowComparator;
+
 public:
   /**
    * Row used for insert
@@ -30,8 +41,17 @@ public:
   explicit Row(std::vector<Field> &fields) : heap_(new SimpleMemHeap) {
     // deep copy
     for (auto &field : fields) {
-      void *buf = heap_->Allocate(sizeof(Field));
-      fields_.push_back(new(buf)Field(field));
+      fields_.push_back(CopyField(field));
+    }
+  }
+
+  /**
+   * Row used for insert, the fields and their char data are moved into the row
+   */
+  explicit Row(std::vector<Field> &&fields) : heap_(new SimpleMemHeap) {
+    fields_.reserve(fields.size());
+    for (auto &field : fields) {
+      fields_.push_back(ALLOC_P(heap_, Field)(std::move(field)));
     }
   }
 
@@ -45,25 +65,98 @@ public:
    */
   Row(RowId rid) : rid_(rid), heap_(new SimpleMemHeap) {}
 
+  /**
+   * Row whose fields and char data are allocated from heap, eg: the arena of
+   * a statement. The heap is not owned and must outlive the row.
+   */
+  Row(RowId rid, MemHeap *heap) : rid_(rid), heap_(heap), own_heap_(false) {}
+
   /**
    * Row copy function
    */
-  Row(const Row &other) : heap_(new SimpleMemHeap) {
-    if (!fields_.empty()) {
-      for (auto &field : fields_) {
-        heap_->Free(field);
-      }
-      fields_.clear();
+  Row(const Row &other) : rid_(other.rid_), heap_(new SimpleMemHeap) {
+    for (auto &field : other.fields_) {
+      fields_.push_back(CopyField(*field));
     }
-    rid_ = other.rid_;
+  }
+
+  /**
+   * Row copy function, copy into a heap owned by the caller
+   */
+  Row(const Row &other, MemHeap *heap) : rid_(other.rid_), heap_(heap), own_heap_(false) {
     for (auto &field : other.fields_) {
-      void *buf = heap_->Allocate(sizeof(Field));
-      fields_.push_back(new(buf)Field(*field));
+      fields_.push_back(CopyField(*field));
+    }
+  }
+
+  /**
+   * Row move function, the fields stay where they are and change owner
+   */
+  Row(Row &&other) noexcept
+          : rid_(other.rid_), fields_(std::move(other.fields_)), heap_(other.heap_), own_heap_(other.own_heap_) {
+    other.fields_.clear();
+    other.heap_ = nullptr;
+    other.own_heap_ = false;
+  }
+
+  Row &operator=(Row &&other) noexcept {
+    if (this != &other) {
+      DestroyFields();
+      if (own_heap_) {
+        delete heap_;
+      }
+      rid_ = other.rid_;
+      fields_ = std::move(other.fields_);
+      heap_ = other.heap_;
+      own_heap_ = other.own_heap_;
+      other.fields_.clear();
+      other.heap_ = nullptr;
+      other.own_heap_ = false;
     }
+    return *this;
   }
 
   virtual ~Row() {
-    delete heap_;
+    DestroyFields();
+    if (own_heap_) {
+      delete heap_;
+    }
+  }
+
+  /**
+   * Drop all fields so the row can be deserialized again. Only for rows on a
+   * heap the caller resets itself, the old fields are not freed one by one.
+   */
+  inline void Reset(RowId rid) {
+    rid_ = rid;
+    DestroyFields();
+  }
+
+  /**
+   * Construct a field in place at the end of the row, arguments are those of
+   * a Field constructor. Managed char data is copied into the row's heap.
+   */
+  template<typename... Args>
+  inline Field *EmplaceField(Args &&... args) {
+    Field *field = ALLOC_P(heap_, Field)(std::forward<Args>(args)...);
+    if (field->type_id_ == TypeId::kTypeChar && field->manage_data_) {
+      Field *copy = CopyField(*field);
+      field->~Field();
+      heap_->Free(field);
+      field = copy;
+    }
+    fields_.push_back(field);
+    return field;
+  }
+
+  /**
+   * Replace the field at idx by a copy of field, eg: the new value of update
+   */
+  inline void SetField(uint32_t idx, const Field &field) {
+    ASSERT(idx < fields_.size(), "Failed to access field");
+    fields_[idx]->~Field();
+    heap_->Free(fields_[idx]);
+    fields_[idx] = CopyField(field);
   }
 
   /**
@@ -94,14 +187,68 @@ public:
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
+  /**
+   * Size of the compact header up to the end of the var offset array
+   */
+  static inline uint32_t GetCompactHeaderSize(const Schema *schema) {
+    uint32_t count = schema->GetColumnCount();
+    return sizeof(uint32_t) + sizeof(uint16_t) + (count + 7) / 8 + schema->GetFixedRegionSize() +
+           sizeof(uint16_t) * schema->GetVarColumnCount();
+  }
+
 private:
   Row &operator=(const Row &other) = delete;
 
+  uint32_t DeserializeLegacy(char *buf, Schema *schema);
+
+  /**
+   * Copy field into heap_, char data included
+   */
+  Field *CopyField(const Field &field) {
+    if (field.type_id_ == TypeId::kTypeChar && !field.IsNull()) {
+      return NewCharField(field.GetCharData(), field.len_);
+    }
+    return ALLOC_P(heap_, Field)(field);
+  }
+
+  /**
+   * Char field on heap_, short values are stored inline in the field,
+   * longer ones are copied into heap_ and not managed by the field
+   */
+  inline Field *NewCharField(const char *data, uint32_t len) {
+    if (len <= Field::FIELD_INLINE_LEN) {
+      return ALLOC_P(heap_, Field)(TypeId::kTypeChar, const_cast<char *>(data), len, true);
+    }
+    return ALLOC_P(heap_, Field)(TypeId::kTypeChar, CopyChars(data, len), len, false);
+  }
+
+  /**
+   * Run the field destructors, the memory itself goes back with the heap
+   */
+  inline void DestroyFields() {
+    for (auto field : fields_) {
+      field->~Field();
+    }
+    fields_.clear();
+  }
+
+  inline char *CopyChars(const char *data, uint32_t len) {
+    char *chars = reinterpret_cast<char *>(heap_->Allocate(len > 0 ? len : 1));
+    memcpy(chars, data, len);
+    return chars;
+  }
+
+  inline bool UseCompactFormat(const Schema *schema) const {
+    return schema != nullptr && schema->GetColumnCount() == fields_.size();
+  }
+
 private:
   RowId rid_{};
   std::vector<Field *> fields_;   /** Make sure that all fields are created by mem heap */
   MemHeap *heap_{nullptr};
+  bool own_heap_{true};
   static constexpr uint32_t ROW_MAGIC_NUM = 1055820;
+  static constexpr uint32_t ROW_COMPACT_MAGIC_NUM = 1055821;
 };
 
 #endif //MINISQL_TUPLE_H
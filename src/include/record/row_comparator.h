@@ -0,0 +1,78 @@
+#ifndef MINISQL_ROW_COMPARATOR_H
+#define MINISQL_ROW_COMPARATOR_H
+
+#include <vector>
+#include "record/row.h"
+#include "record/schema.h"
+#include "record/type_kernel.h"
+
+/**
+ * Three-way comparator over all columns of a schema.
+ *
+ * The per-column kernels are picked once from the schema when the comparator
+ * is built, so comparing two rows costs no virtual call and no CmpBool. Rows
+ * can be compared either materialized or still serialized in the compact
+ * format (see Row), in which case nothing is decoded at all. Nulls sort
+ * before every value and equal to each other, so rows with null columns
+ * still have a total order inside an index.
+ */
+class RowComparator {
+public:
+  explicit RowComparator(const Schema *schema);
+
+  inline const Schema *GetSchema() const { return schema_; }
+
+  /**
+   * Compare two materialized rows of the schema
+   */
+  int Compare(const Row &lhs, const Row &rhs) const;
+
+  /**
+   * Compare two rows serialized in the compact format with this schema
+   */
+  inline int CompareSerialized(const char *lhs, const char *rhs) const { return compare_serialized_(*this, lhs, rhs); }
+
+  static inline bool IsCompact(const char *buf) { return MACH_READ_UINT32(buf) == Row::ROW_COMPACT_MAGIC_NUM; }
+
+private:
+  using FieldCompareFn = int (*)(const Field &, const Field &);
+  using ColumnCompareFn = int (*)(const RowComparator &, uint32_t, const char *, const char *);
+  using SerializedCompareFn = int (*)(const RowComparator &, const char *, const char *);
+
+  template<TypeId type>
+  static int CompareColumn(const RowComparator &cmp, uint32_t idx, const char *lhs, const char *rhs);
+
+  /**
+   * Single column keys, the common index case, skip the column loop
+   */
+  template<TypeId type>
+  static int CompareSingle(const RowComparator &cmp, const char *lhs, const char *rhs);
+
+  static int CompareMulti(const RowComparator &cmp, const char *lhs, const char *rhs);
+
+  inline bool IsNull(const char *buf, uint32_t idx) const { return buf[bitmap_begin_ + idx / 8] & (1 << (idx % 8)); }
+
+  /**
+   * Begin and length of a char column, offsets are relative to buf
+   */
+  inline const char *GetChars(const char *buf, uint32_t idx, uint32_t *len) const {
+    uint32_t slot = layout_[idx];
+    uint32_t begin = slot == 0 ? header_size_ : MACH_READ_FROM(uint16_t, buf + var_begin_ + sizeof(uint16_t) * (slot - 1));
+    *len = MACH_READ_FROM(uint16_t, buf + var_begin_ + sizeof(uint16_t) * slot) - begin;
+    return buf + begin;
+  }
+
+private:
+  const Schema *schema_;
+  uint32_t column_count_;
+  uint32_t bitmap_begin_;
+  uint32_t fixed_begin_;
+  uint32_t var_begin_;
+  uint32_t header_size_;
+  std::vector<uint32_t> layout_;
+  std::vector<FieldCompareFn> field_compare_;
+  std::vector<ColumnCompareFn> column_compare_;
+  SerializedCompareFn compare_serialized_;
+};
+
+#endif //MINISQL_ROW_COMPARATOR_H
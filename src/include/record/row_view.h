@@ -0,0 +1,96 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <vector>
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * RowView is a read-only view over a serialized tuple (see Row for the format).
+ *
+ * It does not own or copy the tuple bytes, so the page holding them must stay
+ * pinned for as long as the view (and any Field returned by it) is used.
+ * Fields are decoded lazily: the header is only parsed on the first access,
+ * and only the requested column is turned into a Field. Compact rows are
+ * addressed in O(1) through the schema layout, old format rows fall back to
+ * a single walk over the payloads.
+ */
+class RowView {
+public:
+  RowView() = default;
+
+  RowView(const char *data, Schema *schema, RowId rid = RowId()) { Reset(data, schema, rid); }
+
+  /**
+   * Point the view at another serialized tuple, reusing the decode buffers
+   */
+  void Reset(const char *data, Schema *schema, RowId rid = RowId()) {
+    data_ = data;
+    schema_ = schema;
+    rid_ = rid;
+    decoded_ = false;
+  }
+
+  inline bool IsValid() const { return data_ != nullptr; }
+
+  inline const char *GetData() const { return data_; }
+
+  inline Schema *GetSchema() const { return schema_; }
+
+  inline RowId GetRowId() const { return rid_; }
+
+  uint32_t GetFieldCount() const;
+
+  bool IsNull(uint32_t idx) const;
+
+  int32_t GetInt(uint32_t idx) const;
+
+  float GetFloat(uint32_t idx) const;
+
+  /**
+   * @return pointer to the chars inside the tuple, not null terminated
+   */
+  const char *GetChars(uint32_t idx, uint32_t *len) const;
+
+  /**
+   * Decode a single column into a Field which does not manage its data,
+   * char payload still points into the tuple bytes.
+   */
+  Field GetField(uint32_t idx) const;
+
+  /**
+   * Materialize the whole tuple into row, the rid of the view is wrapped in row
+   */
+  void ToRow(Row *row) const;
+
+private:
+  void DecodeHeader() const;
+
+  /**
+   * Begin offset and length of a char field in the compact format
+   */
+  inline void GetVarRange(uint32_t idx, uint32_t *begin, uint32_t *len) const {
+    uint32_t slot = schema_->GetLayoutOffset(idx);
+    uint32_t end = MACH_READ_FROM(uint16_t, var_offsets_ + sizeof(uint16_t) * slot);
+    *begin = slot == 0 ? Row::GetCompactHeaderSize(schema_)
+                       : MACH_READ_FROM(uint16_t, var_offsets_ + sizeof(uint16_t) * (slot - 1));
+    *len = end - *begin;
+  }
+
+  const char *data_{nullptr};
+  Schema *schema_{nullptr};
+  RowId rid_{};
+  mutable bool decoded_{false};
+  mutable bool compact_{false};
+  mutable uint32_t count_{0};
+  mutable const char *bitmap_{nullptr};     /** compact format only */
+  mutable const char *fixed_{nullptr};
+  mutable const char *var_offsets_{nullptr};
+  mutable std::vector<bool> nulls_;         /** old format only */
+  mutable std::vector<uint32_t> offsets_;   /** payload offset of each field, relative to data_ */
+};
+
+#endif //MINISQL_ROW_VIEW_H
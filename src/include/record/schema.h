@@ -10,7 +10,7 @@
 
 class Schema {
 public:
-  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {}
+  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) { InitRowLayout(); }
 
   inline const std::vector<Column *> &GetColumns() const { return columns_; }
 
@@ -28,6 +28,17 @@ public:
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * Compact row layout of this schema, see Row.
+   * For fixed-width columns it is the offset inside the fixed region,
+   * for char columns it is the slot in the var-len offset array.
+   */
+  inline uint32_t GetLayoutOffset(const uint32_t column_index) const { return layout_[column_index]; }
+
+  inline uint32_t GetFixedRegionSize() const { return fixed_size_; }
+
+  inline uint32_t GetVarColumnCount() const { return var_count_; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -72,9 +83,15 @@ public:
    */
   static uint32_t DeserializeFrom(char *buf, Schema *&schema, MemHeap *heap);
 
+private:
+  void InitRowLayout();
+
 private:
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;   /** don't need to delete pointer to column */
+  std::vector<uint32_t> layout_;
+  uint32_t fixed_size_{0};
+  uint32_t var_count_{0};
 };
 
 using IndexSchema = Schema;
@@ -0,0 +1,129 @@
+#ifndef MINISQL_TYPE_KERNEL_H
+#define MINISQL_TYPE_KERNEL_H
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include "common/macros.h"
+#include "record/field.h"
+#include "record/type_id.h"
+
+/**
+ * Compile-time counterpart of the Type singletons.
+ *
+ * Type dispatches every compare and serialize through a virtual call and
+ * answers with a tri-state CmpBool. Hot loops which already know the column
+ * type (tree search, scan filters) use TypeKernel<type> instead: all members
+ * are static and inline, and compares return a plain three-way int. Callers
+ * check nulls themselves, the kernels only see non-null values.
+ */
+template<TypeId type>
+struct TypeKernel;
+
+template<>
+struct TypeKernel<TypeId::kTypeInt> {
+  using ValueType = int32_t;
+
+  static constexpr uint32_t kSize = sizeof(int32_t);
+
+  static inline ValueType Get(const Field &field) { return field.value_.integer_; }
+
+  static inline ValueType Read(const char *buf) { return MACH_READ_FROM(int32_t, buf); }
+
+  static inline void Write(const Field &field, char *buf) { MACH_WRITE_TO(int32_t, buf, field.value_.integer_); }
+
+  static inline int Compare(ValueType lhs, ValueType rhs) { return (lhs > rhs) - (lhs < rhs); }
+
+  static inline int Compare(const Field &lhs, const Field &rhs) { return Compare(Get(lhs), Get(rhs)); }
+
+  static inline uint64_t Hash(const Field &field) { return static_cast<uint32_t>(Get(field)); }
+};
+
+template<>
+struct TypeKernel<TypeId::kTypeFloat> {
+  using ValueType = float;
+
+  static constexpr uint32_t kSize = sizeof(float);
+
+  static inline ValueType Get(const Field &field) { return field.value_.float_; }
+
+  static inline ValueType Read(const char *buf) { return MACH_READ_FROM(float, buf); }
+
+  static inline void Write(const Field &field, char *buf) { MACH_WRITE_TO(float, buf, field.value_.float_); }
+
+  static inline int Compare(ValueType lhs, ValueType rhs) { return (lhs > rhs) - (lhs < rhs); }
+
+  static inline int Compare(const Field &lhs, const Field &rhs) { return Compare(Get(lhs), Get(rhs)); }
+
+  static inline uint64_t Hash(const Field &field) {
+    // 0 and -0 compare equal
+    ValueType value = Get(field) == 0 ? 0 : Get(field);
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+};
+
+template<>
+struct TypeKernel<TypeId::kTypeChar> {
+  static inline const char *Get(const Field &field) { return field.GetCharData(); }
+
+  /**
+   * Same order as CompareStrings in types.cpp: bytes first, then length
+   */
+  static inline int Compare(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+    int ret = memcmp(lhs, rhs, std::min(lhs_len, rhs_len));
+    if (ret == 0 && lhs_len != rhs_len) {
+      ret = lhs_len < rhs_len ? -1 : 1;
+    }
+    return ret;
+  }
+
+  static inline int Compare(const Field &lhs, const Field &rhs) {
+    return Compare(Get(lhs), lhs.len_, Get(rhs), rhs.len_);
+  }
+
+  static inline uint64_t Hash(const Field &field) {
+    return std::hash<std::string_view>()(std::string_view(Get(field), field.len_));
+  }
+};
+
+/**
+ * Three-way compare of two non-null fields of the same type, one switch
+ * instead of a virtual call per comparison operator.
+ */
+inline int CompareFields(const Field &lhs, const Field &rhs) {
+  switch (lhs.GetTypeId()) {
+    case TypeId::kTypeInt:
+      return TypeKernel<TypeId::kTypeInt>::Compare(lhs, rhs);
+    case TypeId::kTypeFloat:
+      return TypeKernel<TypeId::kTypeFloat>::Compare(lhs, rhs);
+    case TypeId::kTypeChar:
+      return TypeKernel<TypeId::kTypeChar>::Compare(lhs, rhs);
+    default:
+      break;
+  }
+  ASSERT(false, "Unknown field type.");
+  return 0;
+}
+
+/**
+ * Hash of a non-null field, equal fields of one type hash equal
+ */
+inline uint64_t HashField(const Field &field) {
+  switch (field.GetTypeId()) {
+    case TypeId::kTypeInt:
+      return TypeKernel<TypeId::kTypeInt>::Hash(field);
+    case TypeId::kTypeFloat:
+      return TypeKernel<TypeId::kTypeFloat>::Hash(field);
+    case TypeId::kTypeChar:
+      return TypeKernel<TypeId::kTypeChar>::Hash(field);
+    default:
+      break;
+  }
+  ASSERT(false, "Unknown field type.");
+  return 0;
+}
+
+#endif //MINISQL_TYPE_KERNEL_H
@@ -70,6 +70,16 @@ public:
     return meta_data_;
   }
 
+  /**
+   * @return number of pages read from the file, bitmap and meta pages too
+   */
+  inline uint64_t GetReadCount() const { return read_count_; }
+
+  /**
+   * @return number of pages written to the file
+   */
+  inline uint64_t GetWriteCount() const { return write_count_; }
+
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
 private:
@@ -100,6 +110,8 @@ private:
   // with multiple buffer pool instances, need to protect file access
   std::recursive_mutex db_io_latch_;
   bool closed{false};
+  std::atomic<uint64_t> read_count_{0};
+  std::atomic<uint64_t> write_count_{0};
   char meta_data_[PAGE_SIZE];
 };
 
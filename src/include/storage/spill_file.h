@@ -0,0 +1,83 @@
+#ifndef MINISQL_SPILL_FILE_H
+#define MINISQL_SPILL_FILE_H
+
+#include "buffer/buffer_pool_manager.h"
+#include "record/row.h"
+
+/**
+ * Temporary append-only file of rows on a chain of buffer pool pages, for
+ * operators whose state outgrows their memory budget (eg: the partitions of
+ * a hash join).
+ *
+ * Pages hold the next page id, the number of bytes used, then a byte stream
+ * of rows, each its serialized size followed by its bytes. A row may span
+ * several pages. The pages are returned to the buffer pool by Clear or when
+ * the file is destroyed, they are never referenced by the catalog.
+ */
+class SpillFile {
+public:
+  explicit SpillFile(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {}
+
+  SpillFile(const SpillFile &) = delete;
+
+  SpillFile(SpillFile &&other) noexcept;
+
+  ~SpillFile() { Clear(); }
+
+  /**
+   * @return false if the buffer pool has no page left
+   */
+  bool Append(const Row &row, Schema *schema);
+
+  /**
+   * Sequential reader over the rows of a file, which must not be appended to
+   * while it is read
+   */
+  class Reader {
+  public:
+    explicit Reader(const SpillFile *file) : file_(file), page_id_(file->first_page_id_) {}
+
+    /**
+     * Deserialize the next row into row, which holds no field yet
+     * @return false at the end of the file
+     */
+    bool Next(Row *row, Schema *schema);
+
+  private:
+    bool Read(char *buf, uint32_t len);
+
+    const SpillFile *file_;
+    page_id_t page_id_;
+    uint32_t offset_{0};
+    std::vector<char> buf_;
+  };
+
+  /**
+   * Give every page back to the buffer pool
+   */
+  void Clear();
+
+  inline uint64_t GetRowCount() const { return row_count_; }
+
+  inline uint32_t GetPageCount() const { return page_count_; }
+
+  inline bool IsEmpty() const { return row_count_ == 0; }
+
+private:
+  bool Write(const char *data, uint32_t len);
+
+  static constexpr uint32_t OFFSET_NEXT_PAGE_ID = 0;
+  static constexpr uint32_t OFFSET_USED = 4;
+  static constexpr uint32_t SIZE_HEADER = 8;
+  static constexpr uint32_t CAPACITY = PAGE_SIZE - SIZE_HEADER;
+
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  uint32_t last_used_{CAPACITY};
+  uint32_t page_count_{0};
+  uint64_t row_count_{0};
+  std::vector<char> buf_;
+};
+
+#endif  // MINISQL_SPILL_FILE_H
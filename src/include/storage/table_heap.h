@@ -1,6 +1,9 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <functional>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "page/table_page.h"
 #include "storage/table_iterator.h"
@@ -88,6 +91,38 @@ class TableHeap {
    */
   TableIterator End();
 
+  /**
+   * Visit every tuple of at most max_pages pages spread evenly over the table.
+   * Only the sampled pages are read, once the page list is known.
+   * @param[out] page_count number of pages of the table
+   * @return number of pages visited
+   */
+  uint32_t SamplePages(uint32_t max_pages, const std::function<void(const RowView &)> &visit, uint32_t &page_count);
+
+  /**
+   * Visit the tuples of the table in order, in batches of at most batch_size
+   * views over at most max_pages pages, which stay pinned and read latched
+   * during the call
+   * @param visit returns false to stop the scan
+   * @return false if a page could not be fetched, the scan stops there
+   */
+  bool ScanBatches(uint32_t batch_size, uint32_t max_pages,
+                   const std::function<bool(const RowView *views, uint32_t count)> &visit);
+
+  /**
+   * Visit the tuples of pages page_ids of the table as ScanBatches does, for
+   * threads scanning parts of the table at once
+   * @return false if a page could not be fetched, the scan stops there
+   */
+  bool ScanPageBatches(const std::vector<page_id_t> &page_ids, uint32_t batch_size, uint32_t max_pages,
+                       const std::function<bool(const RowView *views, uint32_t count)> &visit);
+
+  /**
+   * Copy the ids of the pages of the table, in list order, to page_ids
+   * @return false if the page list could not be read
+   */
+  bool GetPageIds(std::vector<page_id_t> &page_ids);
+
   /**
    * @return the id of the first page of this table
    */
@@ -108,6 +143,8 @@ class TableHeap {
     first_page->Init(first_page_id_,INVALID_PAGE_ID,log_manager, txn);
     //first_page->SetNextPageId(INVALID_PAGE_ID);
     buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    page_ids_.push_back(first_page_id_);
+    page_ids_loaded_ = true;
   };
 
   /**
@@ -120,11 +157,28 @@ class TableHeap {
         schema_(schema),
         log_manager_(log_manager),
         lock_manager_(lock_manager) {}
+
+  /**
+   * Read the page list into page_ids_, once: InsertTuple appends the pages it
+   * adds from then on
+   * @return false if a page could not be fetched
+   */
+  bool LoadPageIds();
+
+  /**
+   * Scan in batches from page page_id on, next gives the page after a page
+   * @return false if a page could not be fetched
+   */
+  bool ScanBatchesFrom(page_id_t page_id, const std::function<page_id_t(TablePage *page)> &next,
+                       uint32_t batch_size, uint32_t max_pages,
+                       const std::function<bool(const RowView *views, uint32_t count)> &visit);
   
  private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
   Schema *schema_;
+  std::vector<page_id_t> page_ids_;  /** pages in list order, once loaded */
+  bool page_ids_loaded_{false};
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
 };
@@ -3,11 +3,20 @@
 
 #include "common/rowid.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "transaction/transaction.h"
 
 
 class TableHeap;
 
+class TablePage;
+
+/**
+ * The iterator keeps the page of the current tuple pinned, so the tuple can be
+ * read through GetRowView() without copying. A Row is only materialized when
+ * it is dereferenced; it is reused across steps and its fields live in an arena
+ * reset on every step, so a scan does not allocate per row.
+ */
 class TableIterator {
 
  public:
@@ -28,15 +37,34 @@ class TableIterator {
 
   Row *operator->();
 
+  /**
+   * Zero-copy access to the current tuple, valid until the iterator moves
+   */
+  inline const RowView &GetRowView() const { return view_; }
+
+  inline RowId GetRowId() const { return rid_; }
+
   TableIterator &operator++();
 
   TableIterator operator++(int);
 
   TableIterator& operator=(const TableIterator &other);
+ private:
+  void PinPage(page_id_t page_id);
+
+  void ReleasePage();
+
+  inline void ReleaseRow() { row_valid_ = false; }
+
  private:
   // add your own private member variables here
-  TableHeap *tableHeap_;
-  Row *row_;
+  TableHeap *tableHeap_{nullptr};
+  TablePage *page_{nullptr};  /** page of the current tuple, pinned by this iterator */
+  RowId rid_{INVALID_ROWID};
+  RowView view_;
+  ArenaMemHeap heap_;         /** fields of row_, reset on every step */
+  Row *row_{nullptr};         /** materialized on demand */
+  bool row_valid_{false};
 };
 
 #endif //MINISQL_TABLE_ITERATOR_H
@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <cstdlib>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 #include "common/macros.h"
 
 class MemHeap {
@@ -47,6 +49,7 @@ public:
     auto iter = allocated_.find(ptr);
     if (iter != allocated_.end()) {
       allocated_.erase(iter);
+      free(ptr);
     }
   }
 
@@ -54,4 +57,72 @@ private:
   std::unordered_set<void *> allocated_;
 };
 
+/**
+ * Bump pointer heap for transient objects, eg: rows and fields produced while
+ * executing one statement.
+ *
+ * Free is a no-op. All memory is given back at once by Reset() (blocks are kept
+ * and reused) or when the heap is destroyed, so destructors of objects placed
+ * here are never run and they must not own other resources.
+ */
+class ArenaMemHeap : public MemHeap {
+public:
+  explicit ArenaMemHeap(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {}
+
+  ~ArenaMemHeap() {
+    for (auto &block : blocks_) {
+      free(block.first);
+    }
+  }
+
+  void *Allocate(size_t size) {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size > static_cast<size_t>(end_ - cur_)) {
+      NextBlock(size);
+    }
+    void *buf = cur_;
+    cur_ += size;
+    return buf;
+  }
+
+  void Free(void *ptr) {}
+
+  /**
+   * Release everything allocated so far, memory blocks are kept for reuse
+   */
+  void Reset() {
+    next_block_ = 0;
+    cur_ = end_ = nullptr;
+  }
+
+  inline size_t GetBlockCount() const { return blocks_.size(); }
+
+private:
+  void NextBlock(size_t size) {
+    while (next_block_ < blocks_.size()) {
+      auto &block = blocks_[next_block_++];
+      if (block.second >= size) {
+        cur_ = block.first;
+        end_ = cur_ + block.second;
+        return;
+      }
+    }
+    size_t len = size > block_size_ ? size : block_size_;
+    char *buf = reinterpret_cast<char *>(malloc(len));
+    ASSERT(buf != nullptr, "Out of memory exception");
+    blocks_.emplace_back(buf, len);
+    next_block_ = blocks_.size();
+    cur_ = buf;
+    end_ = buf + len;
+  }
+
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 8192;
+  static constexpr size_t ALIGNMENT = 8;
+  size_t block_size_;
+  std::vector<std::pair<char *, size_t>> blocks_;
+  size_t next_block_{0};
+  char *cur_{nullptr};
+  char *end_{nullptr};
+};
+
 #endif //MINISQL_MEM_HEAP_H
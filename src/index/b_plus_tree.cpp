@@ -3,6 +3,8 @@
 #include "index/b_plus_tree.h"
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
+#include "index/packed_key.h"
 #include "page/index_roots_page.h"
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -43,6 +45,9 @@ bool BPLUSTREE_TYPE::IsEmpty() const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction) {
+  if (IsEmpty()) {
+    return false;
+  }
   Page *page = FindLeafPage(key);
   // Find the key in this leaf page
   LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
@@ -54,6 +59,96 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result
   return ret;
 }
 
+/*
+ * Collect the values of all keys between low and high, both inclusive, by
+ * walking the leaf chain from the first key not less than low.
+ * This method is used for range queries and duplicate keys
+ * @return : true means at least one key is in range
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetRange(const KeyType *low, const KeyType *high, std::vector<ValueType> &result,
+                              Transaction *transaction) {
+  if (IsEmpty()) {
+    return false;
+  }
+  size_t found = result.size();
+  Page *page = low == nullptr ? FindLeafPage(KeyType(), true) : FindLeafPage(*low);
+  LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = low == nullptr ? 0 : leaf_page->KeyIndex(*low, comparator_);
+  while (true) {
+    for (; index < leaf_page->GetSize(); index++) {
+      if (high != nullptr && comparator_(leaf_page->KeyAt(index), *high) > 0) {
+        buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+        return result.size() > found;
+      }
+      result.push_back(leaf_page->GetItem(index).second);
+    }
+    page_id_t next_page_id = leaf_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    leaf_page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(next_page_id)->GetData());
+    index = 0;
+  }
+  return result.size() > found;
+}
+
+/*
+ * Collect the values of many ranges in one walk over the leaves. Ranges come
+ * in ascending order and do not overlap, so each one starts at or after the
+ * leaf where the previous one ended: the root is only visited again when a
+ * range starts beyond that leaf and the next one.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetRanges(const std::vector<KeyType> &lows, const std::vector<KeyType> &highs,
+                               std::vector<std::vector<ValueType>> &result, Transaction *transaction) {
+  result.assign(lows.size(), {});
+  if (IsEmpty()) {
+    return;
+  }
+  // pinned leaf of the last range
+  LeafPage *leaf_page = nullptr;
+  auto is_after = [&](const KeyType &key, LeafPage *leaf) {
+    return leaf->GetSize() == 0 || comparator_(key, leaf->KeyAt(leaf->GetSize() - 1)) > 0;
+  };
+  for (size_t i = 0; i < lows.size(); i++) {
+    if (leaf_page != nullptr && is_after(lows[i], leaf_page)) {
+      page_id_t next_page_id = leaf_page->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+      leaf_page = nullptr;
+      if (next_page_id != INVALID_PAGE_ID) {
+        leaf_page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(next_page_id)->GetData());
+        if (is_after(lows[i], leaf_page)) {
+          buffer_pool_manager_->UnpinPage(next_page_id, false);
+          leaf_page = nullptr;
+        }
+      }
+    }
+    if (leaf_page == nullptr) {
+      Page *page = FindLeafPage(lows[i]);
+      buffer_pool_manager_->FetchPage(page->GetPageId());
+      leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+    }
+    int index = leaf_page->KeyIndex(lows[i], comparator_);
+    while (true) {
+      for (; index < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(index), highs[i]) <= 0; index++) {
+        result[i].push_back(leaf_page->GetItem(index).second);
+      }
+      page_id_t next_page_id = leaf_page->GetNextPageId();
+      if (index < leaf_page->GetSize() || next_page_id == INVALID_PAGE_ID) {
+        break;
+      }
+      buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+      leaf_page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(next_page_id)->GetData());
+      index = 0;
+    }
+  }
+  if (leaf_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -110,40 +205,93 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  // 1. Find the leaf page to insert
-  Page *page = FindLeafPage(key);
-
-  LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  // 1. Find the leaf page to insert, appends go straight to the rightmost leaf
+  LeafPage *leaf_page = FindRightmostLeaf(key);
+  bool append = leaf_page != nullptr;
+  if (!append) {
+    leaf_page = reinterpret_cast<LeafPage *>(FindLeafPage(key)->GetData());
+    append = leaf_page->GetNextPageId() == INVALID_PAGE_ID &&
+             comparator_(key, leaf_page->KeyAt(leaf_page->GetSize() - 1)) > 0;
+  }
+  // Leaves of variable length keys may have to split before the key fits
+  while (!leaf_page->HasRoomFor(key)) {
+    LeafPage *new_page = Split(leaf_page, append);
+    KeyType separator = ShortestSeparator(leaf_page->KeyAt(leaf_page->GetSize() - 1), new_page->KeyAt(0));
+    InsertIntoParent(leaf_page, separator, new_page, transaction, append);
+    UpdateRootPageId(0);
+    if (comparator_(key, separator) >= 0) {
+      buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
+      leaf_page = new_page;
+    } else {
+      buffer_pool_manager_->UnpinPage(new_page->GetPageId(), true);
+    }
+  }
   int bef_size = leaf_page->GetSize();
   int insert_size = leaf_page->Insert(key, value, comparator_);
 
   // Key already exists, then return false
   if (bef_size == insert_size){
-    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);//unpin且不是脏页
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);//unpin且不是脏页
     return false;
   }
-  // If leaf page is full, then split it
-  if (insert_size>leaf_max_size_){
-    LeafPage* NewPage = Split(leaf_page);
-    InsertIntoParent(leaf_page, NewPage->KeyAt(0), NewPage, transaction);
+  // If leaf page is full, then split it, appends leave the old leaf nearly full
+  if (leaf_page->NeedsSplit()){
+    LeafPage* NewPage = Split(leaf_page, append);
+    KeyType separator = ShortestSeparator(leaf_page->KeyAt(leaf_page->GetSize() - 1), NewPage->KeyAt(0));
+    InsertIntoParent(leaf_page, separator, NewPage, transaction, append);
+    if (NewPage->GetNextPageId() == INVALID_PAGE_ID) {
+      rightmost_leaf_id_ = NewPage->GetPageId();
+    }
     // two new pages are created, so we need to unpin both of them
-    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
     buffer_pool_manager_->UnpinPage(NewPage->GetPageId(), true);
     UpdateRootPageId(0);
-  }else buffer_pool_manager_->UnpinPage(page->GetPageId(),true);
+  }else{
+    if (leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+      rightmost_leaf_id_ = leaf_page->GetPageId();
+    }
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(),true);
+  }
   return true;
 }
 
+/*
+ * Fetch the rightmost leaf remembered by the last insert, keys above all of
+ * its keys are appended there without a descent from the root
+ */
+INDEX_TEMPLATE_ARGUMENTS
+typename BPLUSTREE_TYPE::LeafPage *BPLUSTREE_TYPE::FindRightmostLeaf(const KeyType &key) {
+  if (rightmost_leaf_id_ == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(rightmost_leaf_id_);
+  if (page == nullptr) {
+    // every frame is pinned, the caller descends from the root instead
+    return nullptr;
+  }
+  auto *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  // the cache may be stale, only a last leaf whose keys are all below key will do
+  if (leaf_page->IsLeafPage() && leaf_page->GetNextPageId() == INVALID_PAGE_ID && leaf_page->GetSize() > 0 &&
+      comparator_(key, leaf_page->KeyAt(leaf_page->GetSize() - 1)) > 0) {
+    return leaf_page;
+  }
+  buffer_pool_manager_->UnpinPage(rightmost_leaf_id_, false);
+  rightmost_leaf_id_ = INVALID_PAGE_ID;
+  return nullptr;
+}
+
 /*
  * Split input page and return newly created page.
  * Using template N to represent either internal page or leaf page.
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then move half
- * of key & value pairs from input page to newly created page
+ * of key & value pairs from input page to newly created page.
+ * At the right edge only RIGHT_EDGE_FILL percent stays in the input page,
+ * the new rightmost page takes the rest and further appends.
  */
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
-N *BPLUSTREE_TYPE::Split(N *node) {
+N *BPLUSTREE_TYPE::Split(N *node, bool right_edge) {
   //分裂结点并返回新建的结点
   //既可以是中间结点也可以是叶子结点
   //新建一个页
@@ -164,7 +312,7 @@ N *BPLUSTREE_TYPE::Split(N *node) {
       //初始化新页
       new_leaf_node->Init(new_page_id,old_leaf_node->GetParentPageId(),leaf_max_size_);
       //挪过去一半
-      old_leaf_node->MoveHalfTo(new_leaf_node);
+      old_leaf_node->MoveTailTo(new_leaf_node, right_edge ? RIGHT_EDGE_FILL : 50);
       //更新叶子结点连接顺序
       new_leaf_node->SetNextPageId(old_leaf_node->GetNextPageId());
       old_leaf_node->SetNextPageId(new_page_id);
@@ -179,7 +327,7 @@ N *BPLUSTREE_TYPE::Split(N *node) {
       //初始化新页
       new_internal_node->Init(new_page_id,old_internal_node->GetParentPageId(),internal_max_size_);
       //挪过去一半
-      old_internal_node->MoveHalfTo(new_internal_node,buffer_pool_manager_);
+      old_internal_node->MoveTailTo(new_internal_node, right_edge ? RIGHT_EDGE_FILL : 50, buffer_pool_manager_);
       //中间结点中间并无连接关系，因此并不需要更新
       new_node=reinterpret_cast<N*>(new_internal_node);
     }
@@ -198,7 +346,8 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  */
 //old_node是左孩子，new_node是右孩子，key是他们的分界
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,Transaction *transaction) {
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,Transaction *transaction,
+                                      bool right_edge) {
   page_id_t ParentPageId= old_node->GetParentPageId();
   if (ParentPageId==INVALID_PAGE_ID){//old_node原本是根节点
     // cout<<"old_node is root"<<endl;
@@ -224,19 +373,21 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
     InternalPage*parent_page = reinterpret_cast<InternalPage *>(page->GetData());
     page_id_t old_node_value = old_node->GetPageId();
     page_id_t new_node_value = new_node->GetPageId();
-    int new_size = parent_page->InsertNodeAfter(old_node_value,key,new_node_value);
-    if (new_size<=internal_max_size_){//不需要分裂
+    parent_page->InsertNodeAfter(old_node_value,key,new_node_value);
+    if (!parent_page->NeedsSplit()){//不需要分裂
       //unpin父节点，设置为脏页
       buffer_pool_manager_->UnpinPage(ParentPageId,true);
     }
     else{//父节点也满了
       //父节点分裂产生新的结点split_new_page
-      InternalPage *spilt_new_page = Split(parent_page);
+      // the parent is at the right edge too if new_node became its last child
+      right_edge = right_edge && parent_page->ValueAt(parent_page->GetSize() - 1) == new_node_value;
+      InternalPage *spilt_new_page = Split(parent_page, right_edge);
       //old_node->SetParentPageId(spilt_new_page->GetPageId());
       //new_node->SetParentPageId(spilt_new_page->GetPageId());
       //递归地将父节点和父节点分裂产生的新结点插到父节点的父节点中
       KeyType new_key = spilt_new_page->KeyAt(0);
-      InsertIntoParent(parent_page,new_key,spilt_new_page,transaction);
+      InsertIntoParent(parent_page,new_key,spilt_new_page,transaction,right_edge);
       //递归结束之后，要把父节点和父节点分裂产生的新结点unpin，并设为脏页
       buffer_pool_manager_->UnpinPage(parent_page->GetPageId(),true);
       buffer_pool_manager_->UnpinPage(spilt_new_page->GetPageId(),true);
@@ -255,12 +406,14 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  * necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+bool BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   //删除包含key的键值对
   //如果当前的树为空，立即返回
   //如果树不空，则找到对应的叶结点并删除，必要时执行合并或重新分配
+  // merges may free the cached rightmost leaf
+  rightmost_leaf_id_ = INVALID_PAGE_ID;
   if(IsEmpty()){
-    return;
+    return false;
   }else{
     //找到相应的叶结点
     Page* leaf_page=FindLeafPage(key);
@@ -294,9 +447,10 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
       //删除失败
       //Unpin一个页
       buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(),false);
-      return;
+      return false;
     }
   }
+  return true;
 }
 
 /*
@@ -322,7 +476,7 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
   }else{
     //中间结点或叶结点
     // cout<<"In CoalorRedis: isn't root."<<endl;
-    if(node->GetSize()>=node->GetMinSize()){
+    if(!node->IsUnderflow()){
       //不需要调整
       return false;
     }else{
@@ -353,13 +507,26 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
       cout<<"node size: "<<node->GetSize()<<endl;
       cout<<"sibling_node size: "<<sibling_node->GetSize()<<endl;
       */
-      if(sibling_node->GetSize()+node->GetSize()>=node->GetMaxSize()){
+      bool can_merge;
+      if(node->IsLeafPage()){
+        can_merge=reinterpret_cast<LeafPage*>(node)->CanMergeWith(reinterpret_cast<LeafPage*>(sibling_node));
+      }else{
+        //合并时父结点中的分隔键会下移到合并后的结点
+        KeyType middle_key=parent_node->KeyAt(node_index==0?1:node_index);
+        can_merge=reinterpret_cast<InternalPage*>(node)->CanMergeWith(reinterpret_cast<InternalPage*>(sibling_node),
+                                                                     middle_key);
+      }
+      if(!can_merge){
         //重新分配sibling和当前
         // cout<<"use redistrubute"<<endl;
         //传的index是当前结点的index
-        Redistribute(sibling_node,node,node_index);
-        buffer_pool_manager_->UnpinPage(parent_page->GetPageId(),true);
-        buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(),true);
+        // a node of packed keys may neither merge nor borrow: the key moved in
+        // can shorten its common prefix and grow every key, or the new
+        // separator may not fit in the parent. It stays underfull then, which
+        // lookups and scans do not mind, the next removal from it tries again.
+        bool moved=Redistribute(sibling_node,node,node_index);
+        buffer_pool_manager_->UnpinPage(parent_page->GetPageId(),moved);
+        buffer_pool_manager_->UnpinPage(sibling_page->GetPageId(),moved);
         return false;//不需要删除
       }else{
         // cout<<"use coalesce"<<endl;
@@ -410,7 +577,7 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
       page_id_t RearLeaf_page_id=(*neighbor_node)->GetPageId();
       (*neighbor_node)->SetPageId((*node)->GetPageId());
       (*node)->SetPageId(RearLeaf_page_id);*/
-      Page* first_page=FindLeafPage((*node)->array_[1].first,true);
+      Page* first_page=FindLeafPage(KeyType(),true);
       
       LeafPage* first_node=reinterpret_cast<LeafPage*>(first_page->GetData());
       if ((*node)->GetPageId()!=first_node->GetPageId()){
@@ -446,7 +613,7 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
       ////////////////
     }
     //index++;
-    (*parent)->array_[1].first = (*parent)->array_[0].first;
+    (*parent)->SetKeyAt(1,(*parent)->KeyAt(0));
   }
   else{
     if (is_leaf){
@@ -476,11 +643,12 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
  * Using template N to represent either internal page or leaf page.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
+ * @return  false if the pages had no room for the move and nothing changed
  */
 //重新分配——从兄弟那儿借一个
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
-void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
+bool BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
   bool is_leaf = node->IsLeafPage();
   if (is_leaf){
     LeafPage* neighbor_leaf = reinterpret_cast<LeafPage *>(neighbor_node);
@@ -493,14 +661,25 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
     Page* page = buffer_pool_manager_->FetchPage(parent_page_id);
     InternalPage* parent_page = reinterpret_cast<InternalPage *>(page->GetData());
     ASSERT(parent_page!=nullptr,"In Redistribute: parent_page is null!");
+    // pages of variable length keys may have no room for the moved key or the new separator
+    if (neighbor_leaf->GetSize() < 2){
+      buffer_pool_manager_->UnpinPage(parent_page_id,false);
+      return false;
+    }
     if (index == 0){
       //这时neighbor_node在node的后面
       //这时候(node,neighbor_node)
       //把neighbor_node的第一对key&value放到node的最后
+      KeyType moved_key = neighbor_leaf->KeyAt(0);
+      KeyType separator = ShortestSeparator(moved_key, neighbor_leaf->KeyAt(1));
+      if (!leaf->HasRoomFor(moved_key) || !parent_page->CanSetKeyAt(1, separator)){
+        buffer_pool_manager_->UnpinPage(parent_page_id,false);
+        return false;
+      }
       neighbor_leaf->MoveFirstToEndOf(leaf);
       //父节点的第一个孩子是node，第二个孩子是neighbor_node
       //       第一个key 是非法，第二个key 是neighbor_node中最小的
-      parent_page->SetKeyAt(1,neighbor_leaf->KeyAt(0));
+      parent_page->SetKeyAt(1,separator);
       //unpin父页并设为脏页
       buffer_pool_manager_->UnpinPage(parent_page_id,true);
     }
@@ -510,12 +689,19 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
       //把neighbor_node的最后一对key&value放到node的前面
       ASSERT(neighbor_leaf!=nullptr,"In Redistribute 1: neighbor leaf is null!");
       ASSERT(leaf!=nullptr,"In Redistribute 1: leaf is null!");
+      int last = neighbor_leaf->GetSize()-1;
+      KeyType moved_key = neighbor_leaf->KeyAt(last);
+      KeyType separator = ShortestSeparator(neighbor_leaf->KeyAt(last-1), moved_key);
+      if (!leaf->HasRoomFor(moved_key) || !parent_page->CanSetKeyAt(index, separator)){
+        buffer_pool_manager_->UnpinPage(parent_page_id,false);
+        return false;
+      }
       neighbor_leaf->MoveLastToFrontOf(leaf);
       //父节点的第index-1个孩子是neighbor_node，第index个孩子是node
       //       第index-1个key    不变        ，第index个key 是node中最小的
       ASSERT(parent_page!=nullptr,"In Redistribute 1: parent_page is null!");
       // cout<<"In Redistribute: index is"<<index<<endl;
-      parent_page->SetKeyAt(index,leaf->KeyAt(0));
+      parent_page->SetKeyAt(index,separator);
       //unpin父页并设为脏页
       buffer_pool_manager_->UnpinPage(parent_page_id,true);
     }
@@ -534,6 +720,11 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
       //注意neighbor_node的第一对中的key是非法的，故需要从parent中获得
       KeyType middle_key = parent_page->KeyAt(1);
       //KeyType middle_key=internal->KeyAt(0);
+      if (neighbor_internal->GetSize() < 2 || !internal->HasRoomFor(middle_key) ||
+          !parent_page->CanSetKeyAt(1, neighbor_internal->KeyAt(1))){
+        buffer_pool_manager_->UnpinPage(parent_page_id,false);
+        return false;
+      }
       neighbor_internal->MoveFirstToEndOf(internal,middle_key,buffer_pool_manager_);
       //父节点的第一个孩子是node，第二个孩子是neighbor_node
       //       第一个key 是非法，第二个key 是neighbor_node中最小的
@@ -547,6 +738,10 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
       //KeyType middle_key = parent_page->KeyAt(index);
       KeyType middle_key=neighbor_internal->KeyAt(neighbor_internal->GetSize()-1);
       // cout<<"middle key: "<<middle_key<<endl;
+      if (!internal->HasRoomFor(middle_key) || !parent_page->CanSetKeyAt(index, middle_key)){
+        buffer_pool_manager_->UnpinPage(parent_page_id,false);
+        return false;
+      }
       neighbor_internal->MoveLastToFrontOf(internal,middle_key,buffer_pool_manager_);
       //父节点的第index-1个孩子是neighbor_node，第index个孩子是node
       //       第index-1个key    不变        ，第index个key 是node中最小的
@@ -555,6 +750,7 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
       buffer_pool_manager_->UnpinPage(parent_page_id,true);
     }
   }
+  return true;
 }
 
 /*
@@ -613,6 +809,8 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
   Page* first_page=FindLeafPage(KeyType(),true);
+  // the iterator holds a pin on its leaf, FindLeafPage returns it unpinned
+  buffer_pool_manager_->FetchPage(first_page->GetPageId());
   LeafPage* first_node=reinterpret_cast<LeafPage*>(first_page->GetData());
   return INDEXITERATOR_TYPE(first_node,0,buffer_pool_manager_);
 }
@@ -625,8 +823,16 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
   Page *page = FindLeafPage(key);
+  buffer_pool_manager_->FetchPage(page->GetPageId());
   LeafPage *leaf_page =  reinterpret_cast<LeafPage *>(page->GetData());
   int index = leaf_page->KeyIndex(key,comparator_);
+  // key is above every key of the leaf, the first larger key starts the next leaf
+  if (index == leaf_page->GetSize() && leaf_page->GetNextPageId() != INVALID_PAGE_ID) {
+    page_id_t next_page_id = leaf_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+    leaf_page = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(next_page_id)->GetData());
+    index = 0;
+  }
   return INDEXITERATOR_TYPE(leaf_page,index,buffer_pool_manager_);
 }
 
@@ -638,10 +844,38 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
   Page *page = FindLeafPage(KeyType(),false,true);
+  buffer_pool_manager_->FetchPage(page->GetPageId());
   LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
   return INDEXITERATOR_TYPE(leaf_page,leaf_page->GetSize(),buffer_pool_manager_);
 }
 
+/*
+ * Input parameter is void, construct an index iterator positioned at the
+ * last key/value pair, decrementing it walks the tree backwards
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin() {
+  INDEXITERATOR_TYPE iter = End();
+  --iter;
+  return iter;
+}
+
+/*
+ * Input parameter is high key, construct an index iterator positioned at the
+ * last pair whose key is not above it, at the end if there is none
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &key) {
+  INDEXITERATOR_TYPE iter = Begin(key);
+  if (!iter.IsEnd() && comparator_((*iter).first, key) == 0) {
+    return iter;
+  }
+  --iter;
+  return iter;
+}
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
@@ -855,4 +1089,31 @@ template
 class BPlusTree<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTree<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTree<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTree<GenericKey<128>, RowId, GenericComparator<128>>;
+
+template
+class BPlusTree<NativeKey<int32_t, 8>, RowId, NativeComparator<int32_t, 8>>;
+
+template
+class BPlusTree<NativeKey<int32_t, 16>, RowId, NativeComparator<int32_t, 16>>;
+
+template
+class BPlusTree<NativeKey<float, 8>, RowId, NativeComparator<float, 8>>;
+
+template
+class BPlusTree<NativeKey<float, 16>, RowId, NativeComparator<float, 16>>;
+
+template
+class BPlusTree<PackedKey<32>, RowId, PackedComparator<32>>;
+
+template
+class BPlusTree<PackedKey<64>, RowId, PackedComparator<64>>;
+
+template
+class BPlusTree<PackedKey<128>, RowId, PackedComparator<128>>;
+
+template
+class BPlusTree<PackedKey<256>, RowId, PackedComparator<256>>;
@@ -1,51 +1,283 @@
+#include <algorithm>
+#include <climits>
+#include <limits>
 #include "index/b_plus_tree_index.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
+#include "index/packed_key.h"
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema,
-                                     BufferPoolManager *buffer_pool_manager)
+                                     BufferPoolManager *buffer_pool_manager, bool unique, bool bloom_filter)
         : Index(index_id, key_schema),
-          comparator_(key_schema_),
-          container_(index_id, buffer_pool_manager, comparator_) {
+          comparator_(key_schema_, unique),
+          container_(index_id, buffer_pool_manager, comparator_),
+          key_column_count_(key_schema->GetColumnCount()) {
+  if (bloom_filter) {
+    filter_.reset(new BloomFilter(index_id, buffer_pool_manager));
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+BloomFilter *BPLUSTREE_INDEX_TYPE::GetBloomFilter() {
+  // read on first use, once subclasses have set the key columns
+  if (filter_ != nullptr && !filter_->IsLoaded() && !filter_->Load()) {
+    RebuildFilter(BloomFilter::DEFAULT_CAPACITY);
+  }
+  return filter_.get();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::FilterExcludes(const Row &key) {
+  BloomFilter *filter = GetBloomFilter();
+  return filter != nullptr && key.GetFieldCount() >= key_column_count_ &&
+         !filter->MayContain(BloomFilter::HashKey(key, key_column_count_));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::RebuildFilter(uint32_t capacity) {
+  std::vector<uint64_t> hashes;
+  if (!container_.IsEmpty()) {
+    for (auto iter = container_.Begin(); !iter.IsEnd(); ++iter) {
+      Row key(INVALID_ROWID);
+      (*iter).first.DeserializeToKey(key, key_schema_);
+      hashes.push_back(BloomFilter::HashKey(key, key_column_count_));
+    }
+  }
+  filter_->Reset(std::max<uint32_t>(capacity, hashes.size() * 2));
+  for (auto hash : hashes) {
+    filter_->Add(hash);
+  }
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::MakeKey(const Row &key, RowId rid, KeyType &index_key) const {
+  if (!KeyType::Fits(key, key_schema_, !comparator_.IsUnique())) {
+    return false;
+  }
+  index_key.SerializeFromKey(key, key_schema_);
+  if (!comparator_.IsUnique()) {
+    index_key.SetRowId(rid);
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::MakeBounds(const Row *low, const Row *high, KeyType &low_key, KeyType &high_key) const {
+  // the smallest and largest row id suffix cover every duplicate of a bound
+  return (low == nullptr || MakeKey(*low, RowId(LLONG_MIN), low_key)) &&
+         (high == nullptr || MakeKey(*high, RowId(LLONG_MAX), high_key));
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  if (!MakeKey(key, row_id, index_key)) {
+    return DB_FAILED;
+  }
 
   bool status = container_.Insert(index_key, row_id, txn);
 
   if (!status) {
     return DB_FAILED;
   }
+  BloomFilter *filter = GetBloomFilter();
+  if (filter != nullptr) {
+    filter->Add(BloomFilter::HashKey(key, key_column_count_));
+    if (filter->IsOverloaded()) {
+      RebuildFilter(filter->GetCapacity() * 2);
+    }
+  }
   return DB_SUCCESS;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  if (!MakeKey(key, row_id, index_key)) {
+    return DB_FAILED;
+  }
 
-  container_.Remove(index_key, txn);
+  BloomFilter *filter = GetBloomFilter();
+  if (container_.Remove(index_key, txn) && filter != nullptr) {
+    filter->Remove(BloomFilter::HashKey(key, key_column_count_));
+  }
   return DB_SUCCESS;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn) {
+  if (FilterExcludes(key)) {
+    return DB_KEY_NOT_FOUND;
+  }
+  if (!comparator_.IsUnique()) {
+    return ScanRange(&key, &key, result, txn);
+  }
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  if (!MakeKey(key, INVALID_ROWID, index_key)) {
+    return DB_FAILED;
+  }
   if (container_.GetValue(index_key, result, txn)) {
     return DB_SUCCESS;
   }
   return DB_KEY_NOT_FOUND;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanKeys(const vector<Row> &keys, vector<vector<RowId>> &result, Transaction *txn) {
+  result.assign(keys.size(), {});
+  // every key becomes the range of its entries, keys of unique indexes a single entry
+  vector<size_t> probes;
+  vector<KeyType> lows(keys.size()), highs(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    bool fits = comparator_.IsUnique() ? MakeKey(keys[i], INVALID_ROWID, lows[i])
+                                       : MakeBounds(&keys[i], &keys[i], lows[i], highs[i]);
+    if (!fits) {
+      return DB_FAILED;
+    }
+    if (comparator_.IsUnique()) {
+      highs[i] = lows[i];
+    }
+    if (!FilterExcludes(keys[i])) {
+      probes.push_back(i);
+    }
+  }
+  std::sort(probes.begin(), probes.end(),
+            [&](size_t lhs, size_t rhs) { return comparator_(lows[lhs], lows[rhs]) < 0; });
+  // equal keys are probed once
+  vector<size_t> distinct;
+  vector<KeyType> probe_lows, probe_highs;
+  for (auto i : probes) {
+    if (distinct.empty() || comparator_(lows[distinct.back()], lows[i]) != 0) {
+      distinct.push_back(i);
+      probe_lows.push_back(lows[i]);
+      probe_highs.push_back(highs[i]);
+    }
+  }
+  vector<vector<RowId>> values;
+  container_.GetRanges(probe_lows, probe_highs, values, txn);
+  bool found = false;
+  for (size_t i = 0, j = 0; i < probes.size(); i++) {
+    if (j + 1 < distinct.size() && comparator_(lows[distinct[j + 1]], lows[probes[i]]) == 0) {
+      j++;
+    }
+    result[probes[i]] = values[j];
+    found = found || !values[j].empty();
+  }
+  return found ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::AcceptsBounds(const Row *low, const Row *high) const {
+  KeyType low_key, high_key;
+  return MakeBounds(low, high, low_key, high_key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanRange(const Row *low, const Row *high, vector<RowId> &result, Transaction *txn) {
+  KeyType low_key, high_key;
+  if (!MakeBounds(low, high, low_key, high_key)) {
+    return DB_FAILED;
+  }
+  if (container_.GetRange(low == nullptr ? nullptr : &low_key, high == nullptr ? nullptr : &high_key, result, txn)) {
+    return DB_SUCCESS;
+  }
+  return DB_KEY_NOT_FOUND;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanRangeReverse(const Row *low, const Row *high, vector<RowId> &result, uint32_t limit,
+                                               Transaction *txn) {
+  KeyType low_key, high_key;
+  if (!MakeBounds(low, high, low_key, high_key)) {
+    return DB_FAILED;
+  }
+  if (container_.IsEmpty()) {
+    return DB_KEY_NOT_FOUND;
+  }
+  // one descent to the high bound, then backwards through the leaves
+  size_t found = result.size();
+  auto iter = high == nullptr ? container_.RBegin() : container_.RBegin(high_key);
+  for (uint32_t count = 0; !iter.IsEnd() && count < limit; --iter, count++) {
+    const auto &entry = *iter;
+    if (low != nullptr && comparator_(entry.first, low_key) < 0) {
+      break;
+    }
+    result.push_back(entry.second);
+  }
+  return result.size() == found ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanRangeForward(const Row *low, const Row *high, vector<RowId> &result, uint32_t limit,
+                                               Transaction *txn) {
+  KeyType low_key, high_key;
+  if (!MakeBounds(low, high, low_key, high_key)) {
+    return DB_FAILED;
+  }
+  if (container_.IsEmpty()) {
+    return DB_KEY_NOT_FOUND;
+  }
+  size_t found = result.size();
+  auto iter = low == nullptr ? container_.Begin() : container_.Begin(low_key);
+  for (uint32_t count = 0; !iter.IsEnd() && count < limit; ++iter, count++) {
+    const auto &entry = *iter;
+    if (high != nullptr && comparator_(entry.first, high_key) > 0) {
+      break;
+    }
+    result.push_back(entry.second);
+  }
+  return result.size() == found ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanFirstKey(bool reverse, Row &key, Transaction *txn) {
+  if (container_.IsEmpty()) {
+    return DB_KEY_NOT_FOUND;
+  }
+  // nulls sort first, the largest key is null only if every key is
+  if (reverse) {
+    Row entry(INVALID_ROWID);
+    (*container_.RBegin()).first.DeserializeToKey(entry, key_schema_);
+    if (entry.GetField(0)->IsNull()) {
+      return DB_KEY_NOT_FOUND;
+    }
+    key = std::move(entry);
+    return DB_SUCCESS;
+  }
+  // one descent past the nulls, to the smallest value of the first column
+  vector<Field> smallest;
+  TypeId type = key_schema_->GetColumn(0)->GetType();
+  if (type == TypeId::kTypeInt) {
+    smallest.emplace_back(type, std::numeric_limits<int32_t>::min());
+  } else if (type == TypeId::kTypeFloat) {
+    smallest.emplace_back(type, -std::numeric_limits<float>::infinity());
+  } else {
+    smallest.emplace_back(type, const_cast<char *>(""), 0, true);
+  }
+  Row low(std::move(smallest));
+  KeyType low_key, high_key;
+  if (!MakeBounds(&low, nullptr, low_key, high_key)) {
+    return DB_FAILED;
+  }
+  auto iter = container_.Begin(low_key);
+  if (iter.IsEnd()) {
+    return DB_KEY_NOT_FOUND;
+  }
+  Row entry(INVALID_ROWID);
+  (*iter).first.DeserializeToKey(entry, key_schema_);
+  key = std::move(entry);
+  return DB_SUCCESS;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::Destroy() {
   container_.Destroy();
+  if (filter_ != nullptr) {
+    filter_->Destroy();
+    filter_.reset();
+  }
   return DB_SUCCESS;
 }
 
@@ -65,6 +297,16 @@ INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() {
   return container_.End();
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetRBeginIterator() {
+  return container_.RBegin();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetRBeginIterator(const KeyType &key) {
+  return container_.RBegin(key);
+}
+
 template
 class BPlusTreeIndex<GenericKey<4>, RowId, GenericComparator<4>>;
 
@@ -78,4 +320,31 @@ template
 class BPlusTreeIndex<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTreeIndex<GenericKey<128>, RowId, GenericComparator<128>>;
+
+template
+class BPlusTreeIndex<NativeKey<int32_t, 8>, RowId, NativeComparator<int32_t, 8>>;
+
+template
+class BPlusTreeIndex<NativeKey<int32_t, 16>, RowId, NativeComparator<int32_t, 16>>;
+
+template
+class BPlusTreeIndex<NativeKey<float, 8>, RowId, NativeComparator<float, 8>>;
+
+template
+class BPlusTreeIndex<NativeKey<float, 16>, RowId, NativeComparator<float, 16>>;
+
+template
+class BPlusTreeIndex<PackedKey<32>, RowId, PackedComparator<32>>;
+
+template
+class BPlusTreeIndex<PackedKey<64>, RowId, PackedComparator<64>>;
+
+template
+class BPlusTreeIndex<PackedKey<128>, RowId, PackedComparator<128>>;
+
+template
+class BPlusTreeIndex<PackedKey<256>, RowId, PackedComparator<256>>;
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstring>
+
+#include "index/bloom_filter.h"
+#include "page/bloom_filter_page.h"
+#include "page/index_roots_page.h"
+#include "record/type_kernel.h"
+
+BloomFilter::BloomFilter(index_id_t index_id, BufferPoolManager *buffer_pool_manager)
+        : index_id_(index_id), buffer_pool_manager_(buffer_pool_manager) {}
+
+BloomFilter::~BloomFilter() {
+  if (loaded_) {
+    Flush();
+  }
+}
+
+uint64_t BloomFilter::HashKey(const Row &key, uint32_t column_count) {
+  // FNV-1a over the values, null flags keep (null, x) and (x, null) apart
+  uint64_t hash = 0xcbf29ce484222325ull;
+  auto mix = [&hash](const void *data, uint32_t len) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (uint32_t i = 0; i < len; i++) {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3ull;
+    }
+  };
+  for (uint32_t i = 0; i < column_count; i++) {
+    const Field *field = key.GetField(i);
+    uint8_t flag = field->IsNull() ? 0 : 1;
+    mix(&flag, sizeof(flag));
+    if (field->IsNull()) {
+      continue;
+    }
+    switch (field->GetTypeId()) {
+      case TypeId::kTypeInt: {
+        int32_t value = TypeKernel<TypeId::kTypeInt>::Get(*field);
+        mix(&value, sizeof(value));
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        // -0.0 equals 0.0, hash them alike
+        float value = TypeKernel<TypeId::kTypeFloat>::Get(*field);
+        if (value == 0.0f) {
+          value = 0.0f;
+        }
+        mix(&value, sizeof(value));
+        break;
+      }
+      default: {
+        uint32_t len = field->GetLength();
+        mix(&len, sizeof(len));
+        mix(TypeKernel<TypeId::kTypeChar>::Get(*field), len);
+        break;
+      }
+    }
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+bool BloomFilter::Load() {
+  loaded_ = false;
+  std::vector<page_id_t> pages;
+  GetPages(pages, false);
+  if (pages.empty()) {
+    return false;
+  }
+  std::vector<uint8_t> counters;
+  for (size_t i = 0; i < pages.size(); i++) {
+    auto *page = reinterpret_cast<BloomFilterPage *>(buffer_pool_manager_->FetchPage(pages[i])->GetData());
+    if (i == 0) {
+      if (!page->IsClean()) {
+        buffer_pool_manager_->UnpinPage(pages[i], false);
+        return false;
+      }
+      capacity_ = page->GetCapacity();
+      count_ = page->GetCount();
+    }
+    counters.insert(counters.end(), page->GetData(), page->GetData() + page->GetSize());
+    buffer_pool_manager_->UnpinPage(pages[i], false);
+  }
+  counters_ = std::move(counters);
+  mask_ = counters_.size() * 2 - 1;
+  loaded_ = true;
+  // from now on the pages lag behind the counters until the next write back
+  MarkClean(false);
+  return true;
+}
+
+void BloomFilter::Reset(uint32_t capacity) {
+  uint32_t counters = 2;
+  while (counters < capacity * COUNTERS_PER_KEY) {
+    counters *= 2;
+  }
+  counters_.assign(counters / 2, 0);
+  mask_ = counters - 1;
+  capacity_ = capacity;
+  count_ = 0;
+  loaded_ = true;
+  MarkClean(false);
+}
+
+void BloomFilter::Flush() {
+  if (!loaded_) {
+    return;
+  }
+  std::vector<page_id_t> pages;
+  GetPages(pages, true);
+  uint32_t offset = 0;
+  for (auto page_id : pages) {
+    auto *page = reinterpret_cast<BloomFilterPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    uint32_t size = std::min<uint32_t>(BloomFilterPage::DATA_SIZE, counters_.size() - offset);
+    page_id_t next_page_id = page->GetNextPageId();
+    page->Init(capacity_, count_, size);
+    page->SetNextPageId(next_page_id);
+    page->SetClean(true);
+    memcpy(page->GetData(), counters_.data() + offset, size);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    offset += size;
+  }
+}
+
+void BloomFilter::Destroy() {
+  std::vector<page_id_t> pages;
+  GetPages(pages, false);
+  for (auto page_id : pages) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  if (!pages.empty()) {
+    auto *roots_page =
+            reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    roots_page->Delete(FilterRootId(index_id_));
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  }
+  loaded_ = false;
+  counters_.clear();
+}
+
+bool BloomFilter::MayContain(uint64_t hash) const {
+  if (!loaded_) {
+    return true;
+  }
+  // double hashing, the odd step visits distinct counters
+  uint32_t h1 = static_cast<uint32_t>(hash), h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  for (uint32_t i = 0; i < HASH_COUNT; i++) {
+    if (CounterAt((h1 + i * h2) & mask_) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BloomFilter::Add(uint64_t hash) {
+  uint32_t h1 = static_cast<uint32_t>(hash), h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  for (uint32_t i = 0; i < HASH_COUNT; i++) {
+    uint32_t index = (h1 + i * h2) & mask_;
+    uint32_t counter = CounterAt(index);
+    if (counter < MAX_COUNTER) {
+      SetCounter(index, counter + 1);
+    }
+  }
+  count_++;
+}
+
+void BloomFilter::Remove(uint64_t hash) {
+  uint32_t h1 = static_cast<uint32_t>(hash), h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  for (uint32_t i = 0; i < HASH_COUNT; i++) {
+    uint32_t index = (h1 + i * h2) & mask_;
+    uint32_t counter = CounterAt(index);
+    // a saturated counter may stand for more keys than it counts
+    if (counter > 0 && counter < MAX_COUNTER) {
+      SetCounter(index, counter - 1);
+    }
+  }
+  if (count_ > 0) {
+    count_--;
+  }
+}
+
+void BloomFilter::GetPages(std::vector<page_id_t> &pages, bool allocate) {
+  auto *roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  page_id_t page_id;
+  bool found = roots_page->GetRootId(FilterRootId(index_id_), &page_id);
+  if (!found && allocate) {
+    auto *page = reinterpret_cast<BloomFilterPage *>(buffer_pool_manager_->NewPage(page_id)->GetData());
+    page->Init(capacity_, count_, 0);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    roots_page->Insert(FilterRootId(index_id_), page_id);
+  }
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, !found && allocate);
+  if (!found && !allocate) {
+    return;
+  }
+  size_t needed = allocate ? (counters_.size() + BloomFilterPage::DATA_SIZE - 1) / BloomFilterPage::DATA_SIZE : 0;
+  while (page_id != INVALID_PAGE_ID) {
+    pages.push_back(page_id);
+    auto *page = reinterpret_cast<BloomFilterPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    page_id_t next_page_id = page->GetNextPageId();
+    bool extend = next_page_id == INVALID_PAGE_ID && pages.size() < needed;
+    if (extend) {
+      auto *next_page = reinterpret_cast<BloomFilterPage *>(buffer_pool_manager_->NewPage(next_page_id)->GetData());
+      next_page->Init(capacity_, count_, 0);
+      buffer_pool_manager_->UnpinPage(next_page_id, true);
+      page->SetNextPageId(next_page_id);
+    }
+    buffer_pool_manager_->UnpinPage(page_id, extend);
+    page_id = next_page_id;
+  }
+}
+
+void BloomFilter::MarkClean(bool clean) {
+  auto *roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  page_id_t page_id;
+  bool found = roots_page->GetRootId(FilterRootId(index_id_), &page_id);
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  if (!found) {
+    return;
+  }
+  auto *page = reinterpret_cast<BloomFilterPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+  page->SetClean(clean);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
@@ -0,0 +1,82 @@
+#include "index/covering_b_plus_tree_index.h"
+
+template<size_t KeySize>
+COVERING_INDEX_TYPE::CoveringBPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema,
+                                            BufferPoolManager *buffer_pool_manager, bool unique,
+                                            uint32_t key_column_count, bool bloom_filter)
+        : BaseIndex(index_id, key_schema, buffer_pool_manager, false, bloom_filter),
+          unique_(unique) {
+  this->key_column_count_ = key_column_count;
+}
+
+template<size_t KeySize>
+bool COVERING_INDEX_TYPE::MakeBound(const Row &key, bool upper, KeyType &bound) const {
+  if (key.GetFieldCount() > this->key_column_count_ || !KeyType::Fits(key, this->key_schema_, false)) {
+    return false;
+  }
+  bound.SerializeFromKey(key, this->key_schema_);
+  if (upper) {
+    if (bound.GetLength() >= KeySize) {
+      return false;
+    }
+    bound.SetUpperBound();
+  }
+  return true;
+}
+
+template<size_t KeySize>
+bool COVERING_INDEX_TYPE::MakeBounds(const Row *low, const Row *high, KeyType &low_key, KeyType &high_key) const {
+  return (low == nullptr || MakeBound(*low, false, low_key)) && (high == nullptr || MakeBound(*high, true, high_key));
+}
+
+template<size_t KeySize>
+dberr_t COVERING_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
+  if (unique_) {
+    std::vector<Field> key_fields;
+    for (uint32_t i = 0; i < this->key_column_count_; i++) {
+      key_fields.emplace_back(*key.GetField(i));
+    }
+    Row key_row(std::move(key_fields));
+    std::vector<RowId> result;
+    if (this->ScanKey(key_row, result, txn) != DB_KEY_NOT_FOUND) {
+      return DB_FAILED;
+    }
+  }
+  return BaseIndex::InsertEntry(key, row_id, txn);
+}
+
+template<size_t KeySize>
+dberr_t COVERING_INDEX_TYPE::ScanRangeEntries(const Row *low, const Row *high, std::vector<Row *> &result,
+                                              MemHeap *heap, Transaction *txn) {
+  KeyType low_key, high_key;
+  if (!MakeBounds(low, high, low_key, high_key)) {
+    return DB_FAILED;
+  }
+  if (this->container_.IsEmpty()) {
+    return DB_SUCCESS;
+  }
+  // entries are decoded straight from the leaves, the table heap is never read
+  auto iter = low == nullptr ? this->container_.Begin() : this->container_.Begin(low_key);
+  for (; !iter.IsEnd(); ++iter) {
+    const auto &entry = *iter;
+    if (high != nullptr && this->comparator_(entry.first, high_key) > 0) {
+      break;
+    }
+    Row *row = new Row(entry.second, heap);
+    entry.first.DeserializeToKey(*row, this->key_schema_);
+    result.push_back(row);
+  }
+  return DB_SUCCESS;
+}
+
+template
+class CoveringBPlusTreeIndex<32>;
+
+template
+class CoveringBPlusTreeIndex<64>;
+
+template
+class CoveringBPlusTreeIndex<128>;
+
+template
+class CoveringBPlusTreeIndex<256>;
@@ -0,0 +1,329 @@
+#include <algorithm>
+#include <set>
+#include "index/extendible_hash_index.h"
+#include "index/packed_key.h"
+#include "page/index_roots_page.h"
+
+ExtendibleHashIndex::ExtendibleHashIndex(index_id_t index_id, IndexSchema *key_schema,
+                                         BufferPoolManager *buffer_pool_manager, bool unique, uint32_t key_size)
+        : Index(index_id, key_schema),
+          buffer_pool_manager_(buffer_pool_manager),
+          unique_(unique),
+          key_size_(key_size) {
+  ASSERT(key_size_ <= MAX_KEY_SIZE, "Hash key size exceed max key size.");
+  auto *roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  if (!roots_page->GetRootId(index_id_, &directory_page_id_)) {
+    directory_page_id_ = INVALID_PAGE_ID;
+  }
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+}
+
+bool ExtendibleHashIndex::MakeKey(const Row &key, char *buf, uint32_t &len) const {
+  if (PackedKeyCodec::EncodedSize(key, key_schema_) > key_size_) {
+    return false;
+  }
+  len = PackedKeyCodec::Encode(key, key_schema_, buf);
+  return true;
+}
+
+uint32_t ExtendibleHashIndex::Hash(const char *key, uint32_t len) {
+  // FNV-1a over the encoded key, then the murmur3 finalizer to spread the low bits
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (uint32_t i = 0; i < len; i++) {
+    hash ^= static_cast<uint8_t>(key[i]);
+    hash *= 0x100000001b3ull;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return static_cast<uint32_t>(hash);
+}
+
+void ExtendibleHashIndex::GetChain(const HashTableDirectoryPage *directory, uint32_t index,
+                                   std::vector<page_id_t> &chain) const {
+  page_id_t page_id = directory->GetBucketPageId(index);
+  while (page_id != INVALID_PAGE_ID) {
+    chain.push_back(page_id);
+    auto *bucket = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+dberr_t ExtendibleHashIndex::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
+  ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
+  char buf[MAX_KEY_SIZE];
+  uint32_t len;
+  if (!MakeKey(key, buf, len)) {
+    return DB_FAILED;
+  }
+  uint32_t hash = Hash(buf, len);
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    page_id_t bucket_page_id;
+    auto *bucket = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->NewPage(bucket_page_id)->GetData());
+    bucket->Init(key_size_);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    auto *directory =
+            reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->NewPage(directory_page_id_)->GetData());
+    directory->Init(bucket_page_id);
+    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+    auto *roots_page =
+            reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    roots_page->Insert(index_id_, directory_page_id_);
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  }
+  auto *directory =
+          reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  bool directory_dirty = false;
+  while (true) {
+    uint32_t index = directory->GetBucketIndex(hash);
+    // look for the key along the chain and for a page with room
+    page_id_t target = INVALID_PAGE_ID, last = INVALID_PAGE_ID;
+    bool chained = false, splittable = false;
+    page_id_t page_id = directory->GetBucketPageId(index);
+    while (page_id != INVALID_PAGE_ID) {
+      auto *bucket = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+      int slot = unique_ ? bucket->IndexOf(hash, buf, len) : bucket->IndexOf(hash, buf, len, row_id);
+      if (slot >= 0) {
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        buffer_pool_manager_->UnpinPage(directory_page_id_, directory_dirty);
+        return DB_FAILED;
+      }
+      if (target == INVALID_PAGE_ID && !bucket->IsFull()) {
+        target = page_id;
+      }
+      if (last == INVALID_PAGE_ID && bucket->IsFull()) {
+        // splitting only helps if the entries do not all share the hash of the key
+        for (int i = 0; i < bucket->GetSize() && !splittable; i++) {
+          splittable = bucket->HashAt(i) != hash;
+        }
+      }
+      chained = last != INVALID_PAGE_ID;
+      last = page_id;
+      page_id = bucket->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(last, false);
+    }
+    if (target == INVALID_PAGE_ID && !chained && splittable &&
+        (directory->GetLocalDepth(index) < directory->GetGlobalDepth() || directory->CanGrow())) {
+      SplitBucket(directory, index);
+      directory_dirty = true;
+      continue;
+    }
+    if (target == INVALID_PAGE_ID) {
+      auto *overflow = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->NewPage(target)->GetData());
+      overflow->Init(key_size_);
+      buffer_pool_manager_->UnpinPage(target, true);
+      auto *tail = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->FetchPage(last)->GetData());
+      tail->SetNextPageId(target);
+      buffer_pool_manager_->UnpinPage(last, true);
+    }
+    auto *bucket = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->FetchPage(target)->GetData());
+    bucket->Insert(hash, buf, len, row_id);
+    buffer_pool_manager_->UnpinPage(target, true);
+    buffer_pool_manager_->UnpinPage(directory_page_id_, directory_dirty);
+    return DB_SUCCESS;
+  }
+}
+
+void ExtendibleHashIndex::SplitBucket(HashTableDirectoryPage *directory, uint32_t index) {
+  uint32_t local_depth = directory->GetLocalDepth(index);
+  if (local_depth == directory->GetGlobalDepth()) {
+    directory->IncrGlobalDepth();
+  }
+  page_id_t page_id = directory->GetBucketPageId(index);
+  page_id_t image_page_id;
+  auto *image = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->NewPage(image_page_id)->GetData());
+  image->Init(key_size_);
+  auto *bucket = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+  uint32_t bit = 1u << local_depth;
+  bucket->SplitTo(image, bit);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  buffer_pool_manager_->UnpinPage(image_page_id, true);
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (directory->GetBucketPageId(i) == page_id) {
+      directory->SetLocalDepth(i, local_depth + 1);
+      if (i & bit) {
+        directory->SetBucketPageId(i, image_page_id);
+      }
+    }
+  }
+}
+
+bool ExtendibleHashIndex::IsEmptyBucket(page_id_t page_id) const {
+  auto *bucket = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+  bool empty = bucket->IsEmpty() && bucket->GetNextPageId() == INVALID_PAGE_ID;
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return empty;
+}
+
+void ExtendibleHashIndex::MergeBucket(HashTableDirectoryPage *directory, uint32_t index) {
+  // an empty bucket folds into its image, the merged bucket may fold further
+  while (directory->GetLocalDepth(index) > 0) {
+    uint32_t local_depth = directory->GetLocalDepth(index);
+    uint32_t image_index = directory->GetSplitImageIndex(index);
+    if (directory->GetLocalDepth(image_index) != local_depth) {
+      break;
+    }
+    page_id_t page_id = directory->GetBucketPageId(index);
+    page_id_t image_page_id = directory->GetBucketPageId(image_index);
+    if (!IsEmptyBucket(page_id)) {
+      if (!IsEmptyBucket(image_page_id)) {
+        break;
+      }
+      std::swap(page_id, image_page_id);
+    }
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      if (directory->GetBucketPageId(i) == page_id || directory->GetBucketPageId(i) == image_page_id) {
+        directory->SetBucketPageId(i, image_page_id);
+        directory->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+    buffer_pool_manager_->DeletePage(page_id);
+    while (directory->CanShrink()) {
+      directory->DecrGlobalDepth();
+    }
+    index &= directory->GetGlobalDepthMask();
+  }
+}
+
+dberr_t ExtendibleHashIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
+  char buf[MAX_KEY_SIZE];
+  uint32_t len;
+  if (!MakeKey(key, buf, len)) {
+    return DB_FAILED;
+  }
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_SUCCESS;
+  }
+  uint32_t hash = Hash(buf, len);
+  auto *directory =
+          reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  bool directory_dirty = false;
+  uint32_t index = directory->GetBucketIndex(hash);
+  std::vector<page_id_t> chain;
+  GetChain(directory, index, chain);
+  for (size_t pos = 0; pos < chain.size(); pos++) {
+    auto *bucket = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->FetchPage(chain[pos])->GetData());
+    // a unique key has a single entry, whatever row id the caller holds
+    int slot = unique_ ? bucket->IndexOf(hash, buf, len) : bucket->IndexOf(hash, buf, len, row_id);
+    if (slot < 0) {
+      buffer_pool_manager_->UnpinPage(chain[pos], false);
+      continue;
+    }
+    bucket->RemoveAt(slot);
+    if (!bucket->IsEmpty()) {
+      buffer_pool_manager_->UnpinPage(chain[pos], true);
+    } else if (pos > 0) {
+      // unlink an empty overflow page
+      auto *prev = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->FetchPage(chain[pos - 1])->GetData());
+      prev->SetNextPageId(bucket->GetNextPageId());
+      buffer_pool_manager_->UnpinPage(chain[pos - 1], true);
+      buffer_pool_manager_->UnpinPage(chain[pos], false);
+      buffer_pool_manager_->DeletePage(chain[pos]);
+    } else if (bucket->GetNextPageId() != INVALID_PAGE_ID) {
+      // the first overflow page takes the place of the empty bucket
+      page_id_t next_page_id = bucket->GetNextPageId();
+      Page *next = buffer_pool_manager_->FetchPage(next_page_id);
+      memcpy(reinterpret_cast<char *>(bucket), next->GetData(), PAGE_SIZE);
+      buffer_pool_manager_->UnpinPage(next_page_id, false);
+      buffer_pool_manager_->DeletePage(next_page_id);
+      buffer_pool_manager_->UnpinPage(chain[pos], true);
+    } else {
+      buffer_pool_manager_->UnpinPage(chain[pos], true);
+      MergeBucket(directory, index);
+      directory_dirty = true;
+    }
+    break;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, directory_dirty);
+  return DB_SUCCESS;
+}
+
+dberr_t ExtendibleHashIndex::ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) {
+  char buf[MAX_KEY_SIZE];
+  uint32_t len;
+  if (!MakeKey(key, buf, len)) {
+    return DB_FAILED;
+  }
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_KEY_NOT_FOUND;
+  }
+  uint32_t hash = Hash(buf, len);
+  auto *directory =
+          reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  page_id_t page_id = directory->GetBucketPageId(directory->GetBucketIndex(hash));
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  bool found = false;
+  while (page_id != INVALID_PAGE_ID) {
+    auto *bucket = reinterpret_cast<HashTableBucketPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    if (unique_) {
+      int slot = bucket->IndexOf(hash, buf, len);
+      if (slot >= 0) {
+        result.push_back(bucket->ValueAt(slot));
+        found = true;
+      }
+    } else {
+      found = bucket->Find(hash, buf, len, result) || found;
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    // a unique key is in one place only
+    page_id = found && unique_ ? INVALID_PAGE_ID : next_page_id;
+  }
+  return found ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+}
+
+dberr_t ExtendibleHashIndex::ScanRange(const Row *low, const Row *high, std::vector<RowId> &result,
+                                       Transaction *txn) {
+  if (low == nullptr || high == nullptr) {
+    return DB_FAILED;
+  }
+  char low_buf[MAX_KEY_SIZE], high_buf[MAX_KEY_SIZE];
+  uint32_t low_len, high_len;
+  if (!MakeKey(*low, low_buf, low_len) || !MakeKey(*high, high_buf, high_len)) {
+    return DB_FAILED;
+  }
+  if (low_len != high_len || memcmp(low_buf, high_buf, low_len) != 0) {
+    return DB_FAILED;
+  }
+  return ScanKey(*low, result, txn);
+}
+
+dberr_t ExtendibleHashIndex::Destroy() {
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_SUCCESS;
+  }
+  auto *directory =
+          reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  std::set<page_id_t> buckets;
+  std::vector<page_id_t> chain;
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (buckets.insert(directory->GetBucketPageId(i)).second) {
+      GetChain(directory, i, chain);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  for (auto page_id : chain) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  buffer_pool_manager_->DeletePage(directory_page_id_);
+  auto *roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  roots_page->Delete(index_id_);
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  directory_page_id_ = INVALID_PAGE_ID;
+  return DB_SUCCESS;
+}
+
+uint32_t ExtendibleHashIndex::GetGlobalDepth() const {
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return 0;
+  }
+  auto *directory =
+          reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  uint32_t global_depth = directory->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  return global_depth;
+}
@@ -1,8 +1,10 @@
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
+#include "index/packed_key.h"
 #include "index/index_iterator.h"
 
-INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator() {
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator() : leaf_page(nullptr), index_(0), buffer_pool_manager(nullptr) {
 
 }
 
@@ -12,13 +14,21 @@ INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(BPlusTreeLeafPage<Key
   buffer_pool_manager = bpm;
 }
 
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+        : leaf_page(other.leaf_page), index_(other.index_), buffer_pool_manager(other.buffer_pool_manager) {
+  other.leaf_page = nullptr;
+}
+
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::~IndexIterator() {
-  buffer_pool_manager->UnpinPage(leaf_page->GetPageId(), false);
+  if (leaf_page != nullptr) {
+    buffer_pool_manager->UnpinPage(leaf_page->GetPageId(), false);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS const MappingType &INDEXITERATOR_TYPE::operator*() {
   // ASSERT(false, "Not implemented yet.");
-  return leaf_page->GetItem(index_);
+  item_ = leaf_page->GetItem(index_);
+  return item_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
@@ -26,6 +36,7 @@ INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
   if (index_==leaf_page->GetSize()-1){//是这个页的最后一个
     page_id_t next_page_id = leaf_page->GetNextPageId();
     if (next_page_id!=INVALID_PAGE_ID){//还有下一个页
+      buffer_pool_manager->UnpinPage(leaf_page->GetPageId(), false);
       index_ = 0;//index归零
       //leaf_page变成下一页
       Page* page = buffer_pool_manager->FetchPage(next_page_id);
@@ -41,6 +52,54 @@ INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
   return *this;
 }
 
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator--() {
+  if (index_ > 0) {
+    index_--;
+    return *this;
+  }
+  LeafPage *prev = PrevLeaf();
+  if (prev == nullptr) {
+    index_ = -1;
+    return *this;
+  }
+  buffer_pool_manager->UnpinPage(leaf_page->GetPageId(), false);
+  leaf_page = prev;
+  index_ = leaf_page->GetSize() - 1;
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename INDEXITERATOR_TYPE::LeafPage *INDEXITERATOR_TYPE::PrevLeaf() const {
+  page_id_t child_id = leaf_page->GetPageId();
+  page_id_t parent_id = leaf_page->GetParentPageId();
+  while (parent_id != INVALID_PAGE_ID) {
+    auto *parent = reinterpret_cast<InternalPage *>(buffer_pool_manager->FetchPage(parent_id)->GetData());
+    int index = parent->ValueIndex(child_id);
+    if (index > 0) {
+      // rightmost leaf under the left sibling
+      page_id_t page_id = parent->ValueAt(index - 1);
+      buffer_pool_manager->UnpinPage(parent_id, false);
+      auto *node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager->FetchPage(page_id)->GetData());
+      while (!node->IsLeafPage()) {
+        page_id_t next_id = reinterpret_cast<InternalPage *>(node)->ValueAt(node->GetSize() - 1);
+        buffer_pool_manager->UnpinPage(page_id, false);
+        page_id = next_id;
+        node = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager->FetchPage(page_id)->GetData());
+      }
+      return reinterpret_cast<LeafPage *>(node);
+    }
+    child_id = parent_id;
+    parent_id = parent->GetParentPageId();
+    buffer_pool_manager->UnpinPage(child_id, false);
+  }
+  return nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXITERATOR_TYPE::IsEnd() const {
+  return index_ < 0 || index_ >= leaf_page->GetSize();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const {
   // return false;
@@ -80,3 +139,30 @@ class IndexIterator<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
 class IndexIterator<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class IndexIterator<GenericKey<128>, RowId, GenericComparator<128>>;
+
+template
+class IndexIterator<NativeKey<int32_t, 8>, RowId, NativeComparator<int32_t, 8>>;
+
+template
+class IndexIterator<NativeKey<int32_t, 16>, RowId, NativeComparator<int32_t, 16>>;
+
+template
+class IndexIterator<NativeKey<float, 8>, RowId, NativeComparator<float, 8>>;
+
+template
+class IndexIterator<NativeKey<float, 16>, RowId, NativeComparator<float, 16>>;
+
+template
+class IndexIterator<PackedKey<32>, RowId, PackedComparator<32>>;
+
+template
+class IndexIterator<PackedKey<64>, RowId, PackedComparator<64>>;
+
+template
+class IndexIterator<PackedKey<128>, RowId, PackedComparator<128>>;
+
+template
+class IndexIterator<PackedKey<256>, RowId, PackedComparator<256>>;
@@ -0,0 +1,80 @@
+#include <climits>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+#include "common/macros.h"
+#include "index/node_search.h"
+
+static inline bool IsBelow(const char *entry, int32_t threshold) {
+  return MACH_READ_FROM(int32_t, entry + sizeof(int32_t)) != 0 || MACH_READ_FROM(int32_t, entry) < threshold;
+}
+
+/**
+ * Count the entries of [begin, end) which are null or below threshold
+ */
+static inline int CountBelow(const char *base, size_t stride, int begin, int end, int32_t threshold) {
+  int count = 0;
+  int i = begin;
+#if defined(__AVX2__)
+  const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                             _mm256_set1_epi32(static_cast<int>(stride)));
+  const __m256i thresholds = _mm256_set1_epi32(threshold);
+  const __m256i zeros = _mm256_setzero_si256();
+  for (; i + 8 <= end; i += 8) {
+    const int *entries = reinterpret_cast<const int *>(base + i * stride);
+    __m256i values = _mm256_i32gather_epi32(entries, offsets, 1);
+    __m256i nulls = _mm256_i32gather_epi32(entries + 1, offsets, 1);
+    __m256i below = _mm256_or_si256(_mm256_cmpgt_epi32(thresholds, values),
+                                    _mm256_xor_si256(_mm256_cmpeq_epi32(nulls, zeros), _mm256_set1_epi32(-1)));
+    count += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(below)));
+  }
+#elif defined(__SSE4_2__)
+  const __m128i thresholds = _mm_set1_epi32(threshold);
+  const __m128i zeros = _mm_setzero_si128();
+  for (; i + 4 <= end; i += 4) {
+    const char *entry = base + i * stride;
+    __m128i values = _mm_setr_epi32(MACH_READ_FROM(int32_t, entry), MACH_READ_FROM(int32_t, entry + stride),
+                                    MACH_READ_FROM(int32_t, entry + 2 * stride),
+                                    MACH_READ_FROM(int32_t, entry + 3 * stride));
+    __m128i nulls = _mm_setr_epi32(MACH_READ_FROM(int32_t, entry + 4), MACH_READ_FROM(int32_t, entry + stride + 4),
+                                   MACH_READ_FROM(int32_t, entry + 2 * stride + 4),
+                                   MACH_READ_FROM(int32_t, entry + 3 * stride + 4));
+    __m128i below = _mm_or_si128(_mm_cmpgt_epi32(thresholds, values),
+                                 _mm_xor_si128(_mm_cmpeq_epi32(nulls, zeros), _mm_set1_epi32(-1)));
+    count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(below)));
+  }
+#endif
+  for (; i < end; i++) {
+    count += IsBelow(base + i * stride, threshold);
+  }
+  return count;
+}
+
+int NodeSearchKernel::Bound(const char *base, size_t stride, int begin, int end, int32_t value, bool upper) {
+  if (upper && value == INT_MAX) {
+    return end;
+  }
+  // value <= x is value < x + 1 for ints
+  int32_t threshold = upper ? value + 1 : value;
+  int first = begin;
+  int len = end - begin;
+  // the bound stays within [first, first + len], halved without branches
+  while (len > LINEAR_THRESHOLD) {
+    int half = len / 2;
+    first = IsBelow(base + (first + half) * stride, threshold) ? first + half : first;
+    len -= half;
+  }
+  return first + CountBelow(base, stride, first, first + len, threshold);
+}
+
+int NodeSearchKernel::BoundScalar(const char *base, size_t stride, int begin, int end, int32_t value, bool upper) {
+  int count = begin;
+  for (int i = begin; i < end; i++) {
+    const char *entry = base + i * stride;
+    int32_t key = MACH_READ_FROM(int32_t, entry);
+    count += MACH_READ_FROM(int32_t, entry + sizeof(int32_t)) != 0 || (upper ? key <= value : key < value);
+  }
+  return count;
+}
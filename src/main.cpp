@@ -1,8 +1,7 @@
+#include <chrono>
 #include <cstdio>
 #include "executor/execute_engine.h"
 #include "glog/logging.h"
-#include "parser/syntax_tree_printer.h"
-#include "utils/tree_file_mgr.h"
 #include <time.h>
 
 extern "C" {
@@ -39,54 +38,22 @@ int main(int argc, char **argv) {
   char cmd[buf_size];
   // execute engine
   ExecuteEngine engine;
-  // for print syntax tree
-  TreeFileManagers syntax_tree_file_mgr("syntax_tree_");
-  [[maybe_unused]] uint32_t syntax_tree_id = 0;
 
   while (1) {
     // read from buffer
     InputCommand(cmd, buf_size);
 
-    YY_BUFFER_STATE bp = yy_scan_string(cmd);
-    if (bp == nullptr) {
-      LOG(ERROR) << "Failed to create yy buffer state." << std::endl;
-      exit(1);
-    }
-    yy_switch_to_buffer(bp);
-
-    // init parser module
-    MinisqlParserInit();
-
-    // parse
-    yyparse();
-
-    // parse result handle
-    if (MinisqlParserGetError()) {
-      // error
-      printf("%s\n", MinisqlParserGetErrorMessage());
-    } else {
-//#ifdef ENABLE_PARSER_DEBUG
-      //printf("[INFO] Sql syntax parse ok!\n");
-      SyntaxTreePrinter printer(MinisqlGetParserRootNode());
-      printer.PrintTree(syntax_tree_file_mgr[syntax_tree_id++]);
-//#endif
-    }
-
     ExecuteContext context;
-    clock_t start,end;
-    start=clock();//��ʼ��ʱ
+    // wall time, EXPLAIN ANALYZE breaks it down
+    auto start = std::chrono::steady_clock::now();
 
-    engine.Execute(MinisqlGetParserRootNode(), &context);
+    // statements repeating the text of a cached one with other literals skip the parser
+    engine.ExecuteSql(cmd, &context);
 
-    end=clock();
-    std::cout<<"The SQL Statement Takes "<<double(end-start)/CLOCKS_PER_SEC<<"s to Execute."<<endl;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout<<"The SQL Statement Takes "<<elapsed.count()<<"s to Execute."<<endl;
     sleep(1);
 
-    // clean memory after parse
-    MinisqlParserFinish();
-    yy_delete_buffer(bp);
-    yylex_destroy();
-
     // quit condition
     if (context.flag_quit_) {
       printf("bye!\n");
@@ -1,5 +1,10 @@
+#include <algorithm>
+
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
+#include "index/node_search.h"
+#include "index/packed_key.h"
 #include "page/b_plus_tree_internal_page.h"
 
 /*****************************************************************************
@@ -67,17 +72,8 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
-  //二分搜索
-  int s = GetSize();//中间节点的size
-  int left = 1;//key[0]无意义，因此left从1开始
-  int right = s - 1;
-  while (left <= right) {//说明[left,right]中间还有元素
-    int mid = (left + right)/2;
-    if (comparator(key,KeyAt(mid))<0) right = mid - 1; //[left,mid-1]处继续搜
-    else left = mid + 1; //[mid+1,right]处继续搜
-    
-  }
-
+  // key[0] is invalid, the child is left of the first key above key
+  int left = NodeSearch<KeyType, KeyComparator>::UpperBound(array_, 1, GetSize(), key, comparator);
   return array_[left-1].second;//left必须要减1，才能保证key>=internal node中的键值
 }
 
@@ -126,9 +122,17 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value,
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient,
                                                 BufferPoolManager *buffer_pool_manager) {
+  MoveTailTo(recipient, 50, buffer_pool_manager);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveTailTo(BPlusTreeInternalPage *recipient, int keep_percent,
+                                                BufferPoolManager *buffer_pool_manager) {
+  // the recipient gets a key besides its first child unless the page is tiny
   int s = GetSize();
-  recipient->CopyNFrom(array_+s-int(s/2),int(s/2),buffer_pool_manager);
-  IncreaseSize(-int(s/2));
+  int moved = std::max(std::min(2, s / 2), s * (100 - keep_percent) / 100);
+  recipient->CopyNFrom(array_ + s - moved, moved, buffer_pool_manager);
+  IncreaseSize(-moved);
 }
 
 /* Copy entries into me, starting from {items} and copy {size} entries.
@@ -273,6 +277,174 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllToFrontOf(BPlusTreeInternalPage *rec
   IncreaseSize(-GetSize());
 }
 
+/*****************************************************************************
+ * PACKED KEYS
+ *****************************************************************************/
+#define PACKED_INTERNAL_TEMPLATE_ARGUMENTS template<size_t KeySize, typename ValueType>
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageId(page_id);
+  SetSize(0);
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetParentPageId(parent_id);
+  SetMaxSize(max_size);
+  // the first key is not ordered with the others, nothing to share
+  keys_.Init(PAGE_SIZE - sizeof(BPlusTreeInternalPage), sizeof(ValueType), false);
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+PackedKey<KeySize> B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::KeyAt(int index) const {
+  KeyType key;
+  key.len = keys_.CopyKey(index, key.data);
+  return key;
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  keys_.SetKey(index, key.data, key.len);
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
+  for (int i = 0; i < GetSize(); i++) {
+    if (ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
+  ValueType value;
+  keys_.GetValue(index, &value);
+  return value;
+}
+
+/*
+ * Child of the last key not greater than key, the first key is skipped
+ */
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
+  return ValueAt(keys_.UpperBound(key.data, key.len, 1) - 1);
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                            const ValueType &new_value) {
+  keys_.Insert(0, nullptr, 0, &old_value);
+  keys_.Insert(1, new_key.data, new_key.len, &new_value);
+  SetSize(keys_.GetSize());
+}
+
+/*
+ * The page always has room for one more entry, the caller splits it as soon
+ * as NeedsSplit
+ */
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
+                                                           const ValueType &new_value) {
+  keys_.Insert(ValueIndex(old_value) + 1, new_key.data, new_key.len, &new_value);
+  SetSize(keys_.GetSize());
+  return GetSize();
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::Remove(int index) {
+  keys_.Remove(index);
+  SetSize(keys_.GetSize());
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
+  ValueType val = ValueAt(0);
+  Remove(0);
+  return val;
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                      BufferPoolManager *buffer_pool_manager) {
+  SetKeyAt(0, middle_key);
+  MoveTo(recipient, 0, GetSize(), recipient->GetSize(), buffer_pool_manager);
+}
+
+/*
+ * Halves of about the same bytes rather than the same number of keys
+ */
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient,
+                                                       BufferPoolManager *buffer_pool_manager) {
+  MoveTailTo(recipient, 50, buffer_pool_manager);
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::MoveTailTo(BPlusTreeInternalPage *recipient, int keep_percent,
+                                                       BufferPoolManager *buffer_pool_manager) {
+  int split = keys_.GetSplitIndex(keep_percent);
+  MoveTo(recipient, split, GetSize() - split, recipient->GetSize(), buffer_pool_manager);
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient,
+                                                             const KeyType &middle_key,
+                                                             BufferPoolManager *buffer_pool_manager) {
+  SetKeyAt(0, middle_key);
+  MoveTo(recipient, 0, 1, recipient->GetSize(), buffer_pool_manager);
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient,
+                                                              const KeyType &middle_key,
+                                                              BufferPoolManager *buffer_pool_manager) {
+  int last = GetSize() - 1;
+  SetKeyAt(last, middle_key);
+  MoveTo(recipient, last, 1, 0, buffer_pool_manager);
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::MoveAllToFrontOf(BPlusTreeInternalPage *recipient,
+                                                             const KeyType &middle_key,
+                                                             BufferPoolManager *buffer_pool_manager) {
+  recipient->SetKeyAt(0, middle_key);
+  MoveTo(recipient, 0, GetSize(), 0, buffer_pool_manager);
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::HasRoomFor(const KeyType &key) const {
+  return keys_.GetBytesAfterInsert(key.data, key.len) <= GetMaxUsedBytes();
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::CanSetKeyAt(int index, const KeyType &key) const {
+  return keys_.GetBytesAfterSetKey(index, key.data, key.len) <= GetMaxUsedBytes();
+}
+
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::CanMergeWith(const BPlusTreeInternalPage *sibling,
+                                                         const KeyType &middle_key) const {
+  return GetSize() + sibling->GetSize() < GetMaxSize() &&
+         PackedKeyArray::GetBytesAfterMerge(keys_, sibling->keys_) + middle_key.len <= GetMaxUsedBytes();
+}
+
+/*
+ * Move entries to recipient and adopt the children moved
+ */
+PACKED_INTERNAL_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_INTERNAL_PAGE_TYPE::MoveTo(BPlusTreeInternalPage *recipient, int begin, int count, int pos,
+                                                   BufferPoolManager *buffer_pool_manager) {
+  keys_.MoveTo(&recipient->keys_, begin, count, pos);
+  SetSize(keys_.GetSize());
+  recipient->SetSize(recipient->keys_.GetSize());
+  for (int i = pos; i < pos + count; i++) {
+    page_id_t child_page_id = recipient->ValueAt(i);
+    Page *page = buffer_pool_manager->FetchPage(child_page_id);
+    reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(recipient->GetPageId());
+    buffer_pool_manager->UnpinPage(child_page_id, true);
+  }
+}
+
 template
 class BPlusTreeInternalPage<int, int, BasicComparator<int>>;
 
@@ -289,4 +461,31 @@ template
 class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 
 template
-class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+template
+class BPlusTreeInternalPage<GenericKey<128>, page_id_t, GenericComparator<128>>;
+
+template
+class BPlusTreeInternalPage<NativeKey<int32_t, 8>, page_id_t, NativeComparator<int32_t, 8>>;
+
+template
+class BPlusTreeInternalPage<NativeKey<int32_t, 16>, page_id_t, NativeComparator<int32_t, 16>>;
+
+template
+class BPlusTreeInternalPage<NativeKey<float, 8>, page_id_t, NativeComparator<float, 8>>;
+
+template
+class BPlusTreeInternalPage<NativeKey<float, 16>, page_id_t, NativeComparator<float, 16>>;
+
+template
+class BPlusTreeInternalPage<PackedKey<32>, page_id_t, PackedComparator<32>>;
+
+template
+class BPlusTreeInternalPage<PackedKey<64>, page_id_t, PackedComparator<64>>;
+
+template
+class BPlusTreeInternalPage<PackedKey<128>, page_id_t, PackedComparator<128>>;
+
+template
+class BPlusTreeInternalPage<PackedKey<256>, page_id_t, PackedComparator<256>>;
@@ -1,6 +1,9 @@
 #include <algorithm>
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
+#include "index/node_search.h"
+#include "index/packed_key.h"
 #include "page/b_plus_tree_leaf_page.h"
 
 /*****************************************************************************
@@ -41,21 +44,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-  int s = GetSize();
-  int left = 0;
-  int right = s - 1;
-  while (left <= right) {
-    int mid = (right + left) / 2;
-    if (comparator(key,KeyAt(mid))<=0) right = mid - 1;
-    else left = mid + 1;
-  }  // lower_bound
-  // int ret = right + 1;
-  return right+1;
-  
-  /*for(int i=1;i<GetSize();i++){
-    if(comparator(array_[i].first,key)>=0) return i;
-  }
-  return GetSize();*///若不存在比key大的值，返回size_
+  // lower_bound, native int keys are searched with SIMD compares
+  return NodeSearch<KeyType, KeyComparator>::LowerBound(array_, 0, GetSize(), key, comparator);
 }
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
@@ -114,9 +104,15 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
+  MoveTailTo(recipient, 50);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveTailTo(BPlusTreeLeafPage *recipient, int keep_percent) {
   int s = GetSize();
-  recipient->CopyNFrom(array_+s-int(s/2),int(s/2));
-  IncreaseSize(-int(s/2));
+  int moved = std::max(1, s * (100 - keep_percent) / 100);
+  recipient->CopyNFrom(array_ + s - moved, moved);
+  IncreaseSize(-moved);
 }
 
 /*
@@ -240,6 +236,132 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType &item) {
   IncreaseSize(1);
 }
 
+/*****************************************************************************
+ * PACKED KEYS
+ *****************************************************************************/
+#define PACKED_LEAF_TEMPLATE_ARGUMENTS template<size_t KeySize, typename ValueType>
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageId(page_id);
+  SetSize(0);
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetParentPageId(parent_id);
+  SetMaxSize(max_size);
+  SetNextPageId(INVALID_PAGE_ID);
+  keys_.Init(PAGE_SIZE - sizeof(BPlusTreeLeafPage), sizeof(ValueType), true);
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+PackedKey<KeySize> B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::KeyAt(int index) const {
+  KeyType key;
+  key.len = keys_.CopyKey(index, key.data);
+  return key;
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  return keys_.LowerBound(key.data, key.len);
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+std::pair<PackedKey<KeySize>, ValueType> B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::GetItem(int index) {
+  MappingType item;
+  item.first = KeyAt(index);
+  keys_.GetValue(index, &item.second);
+  return item;
+}
+
+/*
+ * The caller makes sure there is room for the key first, see HasRoomFor
+ */
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                                              const KeyComparator &comparator) {
+  int pos = keys_.LowerBound(key.data, key.len);
+  if (pos != GetSize() && keys_.CompareKey(pos, key.data, key.len) == 0) {
+    return GetSize();
+  }
+  keys_.Insert(pos, key.data, key.len, &value);
+  SetSize(keys_.GetSize());
+  return GetSize();
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value,
+                                               const KeyComparator &comparator) const {
+  int pos = keys_.LowerBound(key.data, key.len);
+  if (pos != GetSize() && keys_.CompareKey(pos, key.data, key.len) == 0) {
+    keys_.GetValue(pos, &value);
+    return true;
+  }
+  return false;
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
+  int pos = keys_.LowerBound(key.data, key.len);
+  if (pos == GetSize() || keys_.CompareKey(pos, key.data, key.len) != 0) {
+    return GetSize();
+  }
+  keys_.Remove(pos);
+  SetSize(keys_.GetSize());
+  return GetSize();
+}
+
+/*
+ * Halves of about the same bytes rather than the same number of keys
+ */
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
+  MoveTailTo(recipient, 50);
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::MoveTailTo(BPlusTreeLeafPage *recipient, int keep_percent) {
+  int split = keys_.GetSplitIndex(keep_percent);
+  MoveTo(recipient, split, GetSize() - split, recipient->GetSize());
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  recipient->SetNextPageId(GetNextPageId());
+  MoveTo(recipient, 0, GetSize(), recipient->GetSize());
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  MoveTo(recipient, 0, 1, recipient->GetSize());
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  MoveTo(recipient, GetSize() - 1, 1, 0);
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::MoveAllToFrontOf(BPlusTreeLeafPage *recipient) {
+  MoveTo(recipient, 0, GetSize(), 0);
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::HasRoomFor(const KeyType &key) const {
+  return keys_.GetBytesAfterInsert(key.data, key.len) <= keys_.GetCapacity();
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::CanMergeWith(const BPlusTreeLeafPage *sibling) const {
+  return GetSize() + sibling->GetSize() < GetMaxSize() &&
+         PackedKeyArray::GetBytesAfterMerge(keys_, sibling->keys_) <= keys_.GetCapacity();
+}
+
+PACKED_LEAF_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_PACKED_LEAF_PAGE_TYPE::MoveTo(BPlusTreeLeafPage *recipient, int begin, int count, int pos) {
+  keys_.MoveTo(&recipient->keys_, begin, count, pos);
+  SetSize(keys_.GetSize());
+  recipient->SetSize(recipient->keys_.GetSize());
+}
+
 template
 class BPlusTreeLeafPage<int, int, BasicComparator<int>>;
 
@@ -256,4 +378,31 @@ template
 class BPlusTreeLeafPage<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTreeLeafPage<GenericKey<128>, RowId, GenericComparator<128>>;
+
+template
+class BPlusTreeLeafPage<NativeKey<int32_t, 8>, RowId, NativeComparator<int32_t, 8>>;
+
+template
+class BPlusTreeLeafPage<NativeKey<int32_t, 16>, RowId, NativeComparator<int32_t, 16>>;
+
+template
+class BPlusTreeLeafPage<NativeKey<float, 8>, RowId, NativeComparator<float, 8>>;
+
+template
+class BPlusTreeLeafPage<NativeKey<float, 16>, RowId, NativeComparator<float, 16>>;
+
+template
+class BPlusTreeLeafPage<PackedKey<32>, RowId, PackedComparator<32>>;
+
+template
+class BPlusTreeLeafPage<PackedKey<64>, RowId, PackedComparator<64>>;
+
+template
+class BPlusTreeLeafPage<PackedKey<128>, RowId, PackedComparator<128>>;
+
+template
+class BPlusTreeLeafPage<PackedKey<256>, RowId, PackedComparator<256>>;
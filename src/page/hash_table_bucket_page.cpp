@@ -0,0 +1,84 @@
+#include "common/macros.h"
+#include "page/hash_table_bucket_page.h"
+
+void HashTableBucketPage::Init(uint32_t key_size) {
+  next_page_id_ = INVALID_PAGE_ID;
+  count_ = 0;
+  key_size_ = key_size;
+  capacity_ = (PAGE_SIZE - HEADER_SIZE) / (sizeof(uint32_t) + GetEntrySize());
+}
+
+bool HashTableBucketPage::KeyEquals(int index, uint32_t hash, const char *key, uint32_t len) const {
+  return hashes_[index] == hash && KeyBytesEqual(index, key, len);
+}
+
+bool HashTableBucketPage::Find(uint32_t hash, const char *key, uint32_t len, std::vector<RowId> &result) const {
+  bool found = false;
+  for (uint32_t i = 0; i < count_; i++) {
+    if (hashes_[i] == hash && KeyBytesEqual(i, key, len)) {
+      result.push_back(ValueAt(i));
+      found = true;
+    }
+  }
+  return found;
+}
+
+int HashTableBucketPage::IndexOf(uint32_t hash, const char *key, uint32_t len) const {
+  for (uint32_t i = 0; i < count_; i++) {
+    if (hashes_[i] == hash && KeyBytesEqual(i, key, len)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int HashTableBucketPage::IndexOf(uint32_t hash, const char *key, uint32_t len, RowId rid) const {
+  for (uint32_t i = 0; i < count_; i++) {
+    if (hashes_[i] == hash && KeyBytesEqual(i, key, len) && ValueAt(i).Get() == rid.Get()) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void HashTableBucketPage::Insert(uint32_t hash, const char *key, uint32_t len, RowId rid) {
+  ASSERT(!IsFull(), "Insert into a full bucket.");
+  ASSERT(len <= key_size_, "Hash key size exceed max key size.");
+  char *entry = EntryAt(count_);
+  int64_t value = rid.Get();
+  uint16_t key_len = len;
+  hashes_[count_] = hash;
+  memcpy(entry, &value, sizeof(int64_t));
+  memcpy(entry + sizeof(int64_t), &key_len, sizeof(uint16_t));
+  memcpy(entry + ENTRY_HEADER_SIZE, key, len);
+  count_++;
+}
+
+void HashTableBucketPage::RemoveAt(int index) {
+  ASSERT(index >= 0 && static_cast<uint32_t>(index) < count_, "Remove out of range.");
+  count_--;
+  if (static_cast<uint32_t>(index) != count_) {
+    CopyEntry(index, this, count_);
+  }
+}
+
+void HashTableBucketPage::SplitTo(HashTableBucketPage *recipient, uint32_t bit) {
+  ASSERT(recipient->IsEmpty() && recipient->key_size_ == key_size_, "Split into a used bucket.");
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < count_; i++) {
+    if (hashes_[i] & bit) {
+      recipient->CopyEntry(recipient->count_++, this, i);
+    } else {
+      if (kept != i) {
+        CopyEntry(kept, this, i);
+      }
+      kept++;
+    }
+  }
+  count_ = kept;
+}
+
+void HashTableBucketPage::CopyEntry(int index, const HashTableBucketPage *from, int from_index) {
+  hashes_[index] = from->hashes_[from_index];
+  memcpy(EntryAt(index), from->EntryAt(from_index), GetEntrySize());
+}
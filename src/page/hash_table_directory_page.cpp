@@ -0,0 +1,35 @@
+#include "common/macros.h"
+#include "page/hash_table_directory_page.h"
+
+void HashTableDirectoryPage::Init(page_id_t bucket_page_id) {
+  global_depth_ = 0;
+  local_depths_[0] = 0;
+  bucket_page_ids_[0] = bucket_page_id;
+}
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  ASSERT(CanGrow(), "Hash directory full.");
+  uint32_t size = Size();
+  for (uint32_t i = 0; i < size; i++) {
+    local_depths_[size + i] = local_depths_[i];
+    bucket_page_ids_[size + i] = bucket_page_ids_[i];
+  }
+  global_depth_++;
+}
+
+bool HashTableDirectoryPage::CanShrink() const {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < Size(); i++) {
+    if (local_depths_[i] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashTableDirectoryPage::DecrGlobalDepth() {
+  ASSERT(CanShrink(), "Hash directory cannot shrink.");
+  global_depth_--;
+}
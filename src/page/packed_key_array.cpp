@@ -0,0 +1,223 @@
+#include <algorithm>
+#include "common/config.h"
+#include "common/macros.h"
+#include "index/packed_key.h"
+#include "page/packed_key_array.h"
+
+void PackedKeyArray::Init(uint32_t capacity, uint32_t value_size, bool compress_prefix) {
+  ASSERT(capacity < PAGE_SIZE, "Packed key array larger than a page.");
+  count_ = 0;
+  prefix_len_ = 0;
+  heap_top_ = capacity;
+  garbage_ = 0;
+  capacity_ = capacity;
+  value_size_ = value_size;
+  compress_prefix_ = compress_prefix;
+}
+
+uint32_t PackedKeyArray::CopyKey(int index, char *buf) const {
+  memcpy(buf, data_, prefix_len_);
+  memcpy(buf + prefix_len_, data_ + SlotOffset(index), SlotLength(index));
+  return prefix_len_ + SlotLength(index);
+}
+
+int PackedKeyArray::CompareKey(int index, const char *key, uint32_t len) const {
+  int ret = memcmp(data_, key, std::min<uint32_t>(prefix_len_, len));
+  if (ret != 0) {
+    return ret;
+  }
+  if (len < prefix_len_) {
+    return 1;
+  }
+  return PackedKeyCodec::Compare(data_ + SlotOffset(index), SlotLength(index), key + prefix_len_,
+                                 len - prefix_len_);
+}
+
+int PackedKeyArray::LowerBound(const char *key, uint32_t len, int begin) const {
+  int left = begin;
+  int right = count_;
+  while (left < right) {
+    int mid = (left + right) / 2;
+    if (CompareKey(mid, key, len) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+int PackedKeyArray::UpperBound(const char *key, uint32_t len, int begin) const {
+  int left = begin;
+  int right = count_;
+  while (left < right) {
+    int mid = (left + right) / 2;
+    if (CompareKey(mid, key, len) <= 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+uint32_t PackedKeyArray::GetBytesAfterInsert(const char *key, uint32_t len) const {
+  if (count_ == 0) {
+    return len + GetSlotSize();
+  }
+  uint32_t prefix = compress_prefix_ ? PackedKeyCodec::CommonPrefix(data_, prefix_len_, key, len) : 0;
+  return prefix + (count_ + 1) * GetSlotSize() + GetKeyBytes() + len - (count_ + 1) * prefix;
+}
+
+uint32_t PackedKeyArray::GetBytesAfterSetKey(int index, const char *key, uint32_t len) const {
+  uint32_t prefix = compress_prefix_ ? PackedKeyCodec::CommonPrefix(data_, prefix_len_, key, len) : 0;
+  return prefix + count_ * GetSlotSize() + GetKeyBytes() - GetKeyLength(index) + len - count_ * prefix;
+}
+
+uint32_t PackedKeyArray::GetBytesAfterMerge(const PackedKeyArray &lhs, const PackedKeyArray &rhs) {
+  uint32_t count = lhs.count_ + rhs.count_;
+  uint32_t prefix = 0;
+  if (lhs.compress_prefix_ && lhs.count_ > 0 && rhs.count_ > 0) {
+    // the common prefix of the union is shared by any key of each side
+    prefix = std::min(lhs.prefix_len_, rhs.prefix_len_);
+    prefix = std::min(prefix, PackedKeyCodec::CommonPrefix(lhs.data_, lhs.prefix_len_, rhs.data_, rhs.prefix_len_));
+  } else if (lhs.compress_prefix_) {
+    prefix = lhs.count_ > 0 ? lhs.prefix_len_ : rhs.prefix_len_;
+  }
+  return prefix + count * lhs.GetSlotSize() + lhs.GetKeyBytes() + rhs.GetKeyBytes() - count * prefix;
+}
+
+int PackedKeyArray::GetSplitIndex(int lower_percent) const {
+  ASSERT(count_ >= 2, "Split an array of less than two keys.");
+  uint32_t total = GetHeapBytes() + count_ * GetSlotSize();
+  uint32_t bytes = 0;
+  int index = 0;
+  while (index < count_ - 1 && bytes * 100 < total * lower_percent) {
+    bytes += SlotLength(index) + GetSlotSize();
+    index++;
+  }
+  return std::max(index, 1);
+}
+
+void PackedKeyArray::Insert(int index, const char *key, uint32_t len, const void *value) {
+  ASSERT(index >= 0 && index <= count_, "Insert out of range.");
+  uint32_t slot_size = GetSlotSize();
+  if (count_ > 0 && SharesPrefix(key, len)) {
+    uint32_t suffix_len = len - prefix_len_;
+    uint32_t slots_end = prefix_len_ + count_ * slot_size;
+    if (slots_end + slot_size + suffix_len <= heap_top_) {
+      heap_top_ -= suffix_len;
+      memcpy(data_ + heap_top_, key + prefix_len_, suffix_len);
+      memmove(SlotAt(index + 1), SlotAt(index), (count_ - index) * slot_size);
+      SetSlot(index, heap_top_, suffix_len);
+      SetValue(index, value);
+      count_++;
+      return;
+    }
+  }
+  // the prefix shrinks or the heap needs compaction
+  std::vector<EntryRef> entries;
+  CollectEntries(0, index, &entries);
+  entries.push_back({key, len, nullptr, 0, static_cast<const char *>(value)});
+  CollectEntries(index, count_, &entries);
+  Assign(entries);
+}
+
+void PackedKeyArray::Remove(int index) {
+  ASSERT(index >= 0 && index < count_, "Remove out of range.");
+  uint32_t slot_size = GetSlotSize();
+  garbage_ += SlotLength(index);
+  memmove(SlotAt(index), SlotAt(index + 1), (count_ - index - 1) * slot_size);
+  count_--;
+  if (count_ == 0) {
+    Init(capacity_, value_size_, compress_prefix_);
+  }
+}
+
+void PackedKeyArray::SetKey(int index, const char *key, uint32_t len) {
+  ASSERT(index >= 0 && index < count_, "Set key out of range.");
+  if (SharesPrefix(key, len)) {
+    uint32_t suffix_len = len - prefix_len_;
+    uint32_t old_len = SlotLength(index);
+    uint32_t slots_end = prefix_len_ + count_ * GetSlotSize();
+    if (suffix_len <= old_len) {
+      memcpy(data_ + SlotOffset(index), key + prefix_len_, suffix_len);
+      garbage_ += old_len - suffix_len;
+      SetSlot(index, SlotOffset(index), suffix_len);
+      return;
+    }
+    if (slots_end + suffix_len <= heap_top_) {
+      heap_top_ -= suffix_len;
+      memcpy(data_ + heap_top_, key + prefix_len_, suffix_len);
+      garbage_ += old_len;
+      SetSlot(index, heap_top_, suffix_len);
+      return;
+    }
+  }
+  std::vector<EntryRef> entries;
+  CollectEntries(0, count_, &entries);
+  entries[index] = {key, len, nullptr, 0, entries[index].value};
+  Assign(entries);
+}
+
+void PackedKeyArray::MoveTo(PackedKeyArray *recipient, int begin, int count, int pos) {
+  ASSERT(recipient->value_size_ == value_size_, "Move between arrays of different values.");
+  std::vector<EntryRef> entries;
+  recipient->CollectEntries(0, pos, &entries);
+  CollectEntries(begin, begin + count, &entries);
+  recipient->CollectEntries(pos, recipient->count_, &entries);
+  recipient->Assign(entries);
+  entries.clear();
+  CollectEntries(0, begin, &entries);
+  CollectEntries(begin + count, count_, &entries);
+  Assign(entries);
+}
+
+void PackedKeyArray::CollectEntries(int begin, int end, std::vector<EntryRef> *entries) const {
+  for (int i = begin; i < end; i++) {
+    entries->push_back({data_, prefix_len_, data_ + SlotOffset(i), SlotLength(i), SlotAt(i) + SLOT_HEADER_SIZE});
+  }
+}
+
+void PackedKeyArray::Assign(const std::vector<EntryRef> &entries) {
+  char buf[PAGE_SIZE];
+  uint32_t count = entries.size();
+  uint32_t prefix = 0;
+  if (compress_prefix_ && count > 0) {
+    const EntryRef &first = entries.front();
+    const EntryRef &last = entries.back();
+    uint32_t len = std::min(first.Length(), last.Length());
+    while (prefix < len && first.At(prefix) == last.At(prefix)) {
+      prefix++;
+    }
+  }
+  uint32_t slot_size = GetSlotSize();
+  uint32_t bytes = prefix + count * slot_size;
+  for (const auto &entry : entries) {
+    bytes += entry.Length() - prefix;
+  }
+  ASSERT(bytes <= capacity_, "Packed keys overflow the page.");
+  uint32_t heap_top = capacity_;
+  for (uint32_t i = 0; i < prefix; i++) {
+    buf[i] = entries.front().At(i);
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    const EntryRef &entry = entries[i];
+    uint16_t suffix_len = entry.Length() - prefix;
+    heap_top -= suffix_len;
+    for (uint32_t j = 0; j < suffix_len; j++) {
+      buf[heap_top + j] = entry.At(prefix + j);
+    }
+    char *slot = buf + prefix + i * slot_size;
+    uint16_t offset = heap_top;
+    memcpy(slot, &offset, sizeof(uint16_t));
+    memcpy(slot + sizeof(uint16_t), &suffix_len, sizeof(uint16_t));
+    memcpy(slot + SLOT_HEADER_SIZE, entry.value, value_size_);
+  }
+  memcpy(data_, buf, prefix + count * slot_size);
+  memcpy(data_ + heap_top, buf + heap_top, capacity_ - heap_top);
+  count_ = count;
+  prefix_len_ = prefix;
+  heap_top_ = heap_top;
+  garbage_ = 0;
+}
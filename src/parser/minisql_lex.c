@@ -389,35 +389,41 @@ static void yy_fatal_error(yyconst char msg[]);
   *yy_cp = '\0'; \
   (yy_c_buf_p) = yy_cp;
 
-#define YY_NUM_RULES 56
-#define YY_END_OF_BUFFER 57
+#define YY_NUM_RULES 72
+#define YY_END_OF_BUFFER 73
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info {
   flex_int32_t yy_verify;
   flex_int32_t yy_nxt;
 };
-static yyconst flex_int16_t yy_accept[175] =
+static yyconst flex_int16_t yy_accept[227] =
         {0,
-         41, 41, 57, 55, 54, 54, 55, 49, 52, 53,
-         47, 46, 41, 55, 41, 48, 50, 42, 51, 39,
-         39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
-         39, 39, 39, 39, 39, 39, 39, 39, 0, 1,
-         0, 0, 41, 40, 44, 43, 45, 39, 39, 39,
-         39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
-         37, 39, 39, 39, 22, 35, 39, 39, 39, 39,
-         39, 39, 39, 39, 39, 39, 39, 34, 39, 39,
-         39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
-         32, 29, 36, 39, 39, 39, 39, 39, 26, 39,
-
-         39, 39, 39, 14, 39, 39, 39, 39, 31, 39,
-         39, 39, 39, 3, 39, 39, 23, 39, 39, 25,
-         38, 39, 11, 39, 39, 13, 39, 39, 39, 39,
-         39, 39, 8, 39, 39, 39, 39, 39, 33, 20,
-         39, 39, 39, 39, 18, 39, 39, 15, 39, 24,
-         9, 2, 39, 6, 39, 39, 5, 39, 39, 4,
-         19, 30, 7, 27, 39, 39, 21, 28, 39, 16,
-         12, 10, 17, 0
+         55, 55, 73, 71, 70, 70, 71, 63, 66, 67,
+         61, 60, 55, 68, 62, 64, 56, 65, 69, 53,
+         53, 53, 53, 53, 53, 53, 53, 53, 53, 53,
+         53, 53, 53, 53, 53, 53, 53, 53, 53, 53,
+         53, 0, 1, 0, 0, 55, 54, 58, 57, 59,
+         53, 53, 51, 53, 44, 53, 53, 53, 53, 53,
+         53, 53, 53, 53, 53, 53, 53, 37, 53, 53,
+         53, 53, 53, 22, 35, 53, 53, 53, 53, 53,
+         53, 53, 53, 53, 53, 53, 53, 34, 47, 53,
+         53, 53, 53, 53, 53, 53, 53, 53, 53, 53,
+
+         53, 53, 53, 53, 53, 53, 32, 53, 29, 53,
+         36, 53, 53, 53, 53, 53, 53, 53, 26, 53,
+         53, 53, 53, 14, 53, 53, 53, 53, 53, 31,
+         53, 53, 53, 53, 48, 53, 3, 53, 53, 53,
+         23, 53, 53, 53, 53, 25, 41, 53, 38, 53,
+         53, 53, 11, 53, 53, 13, 53, 53, 53, 53,
+         53, 53, 53, 8, 53, 53, 53, 53, 53, 53,
+         53, 53, 33, 43, 53, 20, 53, 46, 45, 53,
+         53, 53, 53, 18, 53, 53, 15, 53, 24, 53,
+         9, 2, 53, 6, 53, 53, 53, 53, 53, 53,
+
+         5, 53, 53, 53, 4, 19, 30, 7, 27, 40,
+         53, 53, 53, 50, 52, 39, 21, 49, 28, 53,
+         16, 42, 12, 10, 17, 0
         };
 
 static yyconst flex_int32_t yy_ec[256] =
@@ -428,14 +434,14 @@ static yyconst flex_int32_t yy_ec[256] =
          1, 2, 1, 4, 1, 1, 1, 1, 5, 6,
          7, 8, 1, 9, 10, 11, 1, 12, 12, 12,
          12, 12, 12, 12, 12, 12, 12, 1, 13, 14,
-         15, 16, 1, 1, 17, 17, 17, 17, 17, 17,
-         17, 17, 17, 17, 17, 17, 17, 17, 17, 17,
-         17, 17, 17, 17, 17, 17, 17, 17, 17, 17,
-         1, 18, 1, 1, 17, 1, 19, 20, 21, 22,
-
-         23, 24, 25, 26, 27, 17, 28, 29, 30, 31,
-         32, 33, 34, 35, 36, 37, 38, 39, 40, 41,
-         42, 17, 1, 1, 1, 1, 1, 1, 1, 1,
+         15, 16, 17, 1, 18, 18, 18, 18, 18, 18,
+         18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+         18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+         1, 19, 1, 1, 18, 1, 20, 21, 22, 23,
+
+         24, 25, 26, 27, 28, 29, 30, 31, 32, 33,
+         34, 35, 36, 37, 38, 39, 40, 41, 42, 43,
+         44, 45, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
@@ -452,127 +458,164 @@ static yyconst flex_int32_t yy_ec[256] =
          1, 1, 1, 1, 1
         };
 
-static yyconst flex_int32_t yy_meta[43] =
+static yyconst flex_int32_t yy_meta[46] =
         {0,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-         1, 2, 1, 1, 1, 1, 2, 1, 2, 2,
-         2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-         2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-         2, 2
+         1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+         1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+         1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+         1, 1, 1, 1, 1
         };
 
-static yyconst flex_int16_t yy_base[177] =
+static yyconst flex_int16_t yy_base[227] =
         {0,
-         0, 0, 188, 189, 189, 189, 39, 189, 189, 189,
-         189, 189, 33, 175, 35, 189, 33, 189, 171, 0,
-         154, 161, 24, 32, 142, 23, 29, 159, 30, 35,
-         146, 142, 147, 38, 159, 38, 158, 150, 59, 189,
-         172, 162, 42, 161, 189, 189, 189, 0, 150, 146,
-         151, 139, 145, 130, 137, 133, 141, 131, 130, 50,
-         0, 119, 123, 130, 0, 0, 131, 130, 127, 44,
-         123, 134, 126, 130, 52, 122, 127, 0, 122, 113,
-         117, 127, 126, 121, 110, 121, 122, 110, 116, 115,
-         105, 0, 0, 107, 105, 97, 104, 109, 0, 91,
-
-         101, 95, 109, 0, 96, 88, 90, 93, 0, 96,
-         85, 101, 83, 0, 95, 81, 0, 76, 81, 0,
-         0, 96, 0, 94, 92, 0, 89, 73, 73, 84,
-         85, 84, 0, 69, 82, 85, 80, 75, 0, 78,
-         63, 64, 79, 60, 60, 72, 71, 0, 57, 0,
-         0, 0, 56, 0, 62, 54, 0, 43, 63, 0,
-         0, 0, 0, 0, 60, 59, 0, 0, 52, 42,
-         0, 0, 0, 189, 87, 74
+         0, 0, 46, 303, 303, 303, 46, 303, 303, 303,
+         303, 303, 81, 82, 303, 80, 303, 82, 303, 86,
+         67, 108, 106, 114, 56, 104, 64, 106, 68, 79,
+         108, 113, 112, 100, 106, 114, 130, 130, 123, 135,
+         132, 0, 303, 159, 0, 0, 0, 303, 303, 303,
+         0, 144, 138, 139, 0, 146, 136, 145, 131, 141,
+         133, 139, 150, 141, 142, 143, 158, 0, 154, 139,
+         152, 147, 156, 0, 165, 165, 162, 160, 161, 160,
+         174, 170, 176, 177, 171, 179, 173, 0, 0, 178,
+         170, 176, 189, 190, 187, 190, 174, 179, 193, 185,
+
+         197, 186, 179, 189, 197, 198, 189, 191, 0, 197,
+         0, 195, 203, 193, 197, 191, 200, 208, 0, 191,
+         203, 199, 216, 0, 204, 198, 202, 196, 208, 0,
+         214, 204, 223, 206, 0, 218, 0, 222, 228, 210,
+         0, 215, 211, 209, 216, 0, 0, 215, 0, 218,
+         236, 237, 0, 237, 237, 0, 236, 221, 224, 238,
+         241, 242, 222, 0, 229, 245, 250, 247, 239, 245,
+         235, 247, 0, 0, 253, 253, 239, 0, 0, 242,
+         243, 261, 243, 245, 260, 261, 0, 248, 0, 263,
+         0, 0, 250, 0, 267, 259, 267, 259, 269, 256,
+
+         0, 271, 252, 275, 0, 0, 0, 0, 0, 0,
+         274, 260, 276, 0, 0, 0, 0, 0, 0, 271,
+         264, 0, 0, 0, 0, 303
         };
 
-static yyconst flex_int16_t yy_def[177] =
+static yyconst flex_int16_t yy_def[227] =
         {0,
-         174, 1, 174, 174, 174, 174, 175, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 175, 174,
-         175, 174, 174, 174, 174, 174, 174, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
-         176, 176, 176, 0, 174, 174
+         226, 1, 226, 226, 226, 226, 226, 226, 226, 226,
+         226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 7, 226, 7, 14, 13, 14, 226, 226, 226,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 0
         };
 
-static yyconst flex_int16_t yy_nxt[232] =
+static yyconst flex_int16_t yy_nxt[349] =
         {0,
          4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
-         14, 15, 16, 17, 18, 19, 20, 4, 21, 22,
-         23, 24, 25, 26, 20, 20, 27, 28, 20, 20,
-         29, 30, 31, 32, 33, 34, 35, 36, 37, 38,
-         20, 20, 40, 42, 43, 42, 43, 45, 46, 51,
-         54, 58, 42, 43, 55, 52, 41, 59, 53, 60,
-         70, 63, 40, 71, 61, 65, 56, 64, 73, 66,
-         74, 89, 98, 75, 104, 48, 41, 173, 105, 172,
-         99, 171, 170, 169, 168, 90, 91, 39, 39, 167,
-         166, 165, 164, 163, 162, 161, 160, 159, 158, 157,
-
-         156, 155, 154, 153, 152, 151, 150, 149, 148, 147,
-         146, 145, 144, 143, 142, 141, 140, 139, 138, 137,
-         136, 135, 134, 133, 132, 131, 130, 129, 128, 127,
-         126, 125, 124, 123, 122, 121, 120, 119, 118, 117,
-         116, 115, 114, 113, 112, 111, 110, 109, 108, 107,
-         106, 103, 102, 101, 100, 97, 96, 95, 94, 93,
-         92, 88, 87, 86, 85, 84, 83, 82, 81, 80,
-         79, 78, 44, 44, 174, 77, 76, 72, 69, 68,
-         67, 62, 57, 50, 49, 47, 44, 174, 3, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174
+         14, 13, 15, 16, 17, 18, 19, 20, 4, 21,
+         22, 23, 24, 25, 26, 27, 20, 28, 29, 30,
+         31, 20, 32, 33, 34, 35, 36, 37, 38, 39,
+         40, 41, 20, 20, 20, 226, 42, 42, 42, 43,
+         42, 42, 42, 42, 42, 42, 42, 42, 42, 42,
+         42, 42, 42, 42, 44, 42, 42, 42, 42, 42,
+         42, 42, 42, 42, 42, 42, 42, 42, 42, 42,
+         42, 42, 42, 42, 42, 42, 42, 42, 42, 42,
+         42, 45, 46, 47, 48, 49, 50, 51, 63, 52,
+
+         66, 69, 70, 51, 53, 51, 51, 51, 51, 51,
+         51, 51, 51, 51, 51, 51, 51, 51, 51, 51,
+         51, 51, 51, 51, 51, 51, 51, 51, 51, 51,
+         51, 54, 56, 59, 64, 71, 76, 60, 67, 57,
+         65, 61, 58, 68, 74, 77, 72, 78, 75, 81,
+         62, 55, 73, 79, 85, 82, 80, 83, 86, 89,
+         84, 226, 42, 87, 90, 91, 88, 92, 93, 94,
+         97, 95, 98, 99, 101, 102, 103, 42, 96, 104,
+         105, 108, 109, 110, 100, 111, 112, 113, 114, 116,
+         117, 118, 115, 120, 121, 106, 107, 122, 123, 119,
+
+         124, 126, 127, 128, 125, 129, 130, 131, 132, 133,
+         134, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+         144, 145, 146, 147, 148, 149, 150, 151, 152, 153,
+         154, 155, 156, 157, 158, 159, 160, 161, 162, 163,
+         164, 165, 166, 167, 168, 169, 170, 172, 173, 174,
+         175, 176, 177, 178, 179, 180, 181, 182, 183, 184,
+         185, 171, 186, 187, 188, 189, 190, 191, 192, 193,
+         194, 195, 196, 197, 198, 199, 200, 201, 202, 203,
+         204, 205, 206, 207, 208, 209, 210, 211, 212, 213,
+         214, 215, 216, 217, 218, 219, 220, 221, 222, 223,
+
+         224, 225, 3, 226, 226, 226, 226, 226, 226, 226,
+         226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+         226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+         226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+         226, 226, 226, 226, 226, 226, 226, 226
         };
 
-static yyconst flex_int16_t yy_chk[232] =
+static yyconst flex_int16_t yy_chk[349] =
         {0,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
          1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-         1, 1, 7, 13, 13, 15, 15, 17, 17, 23,
-         24, 26, 43, 43, 24, 23, 7, 26, 23, 27,
-         34, 29, 39, 34, 27, 30, 24, 29, 36, 30,
-         36, 60, 70, 36, 75, 176, 39, 170, 75, 169,
-         70, 166, 165, 159, 158, 60, 60, 175, 175, 156,
-         155, 153, 149, 147, 146, 145, 144, 143, 142, 141,
-
-         140, 138, 137, 136, 135, 134, 132, 131, 130, 129,
-         128, 127, 125, 124, 122, 119, 118, 116, 115, 113,
-         112, 111, 110, 108, 107, 106, 105, 103, 102, 101,
-         100, 98, 97, 96, 95, 94, 91, 90, 89, 88,
-         87, 86, 85, 84, 83, 82, 81, 80, 79, 77,
-         76, 74, 73, 72, 71, 69, 68, 67, 64, 63,
-         62, 59, 58, 57, 56, 55, 54, 53, 52, 51,
-         50, 49, 44, 42, 41, 38, 37, 35, 33, 32,
-         31, 28, 25, 22, 21, 19, 14, 3, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
-         174
+         1, 1, 1, 1, 1, 3, 7, 7, 7, 7,
+         7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+         7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+         7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+         7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+         7, 13, 13, 14, 16, 16, 18, 20, 25, 21,
+
+         27, 29, 30, 20, 21, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+         20, 22, 23, 24, 26, 31, 34, 24, 28, 23,
+         26, 24, 23, 28, 33, 35, 32, 36, 33, 38,
+         24, 22, 32, 37, 40, 39, 37, 39, 41, 53,
+         39, 44, 44, 52, 54, 56, 52, 57, 58, 59,
+         61, 60, 62, 63, 64, 65, 66, 44, 60, 67,
+         67, 69, 70, 71, 63, 72, 73, 75, 76, 77,
+         78, 79, 76, 80, 81, 67, 67, 82, 83, 79,
+
+         84, 85, 86, 87, 84, 90, 91, 92, 93, 94,
+         95, 96, 97, 98, 99, 100, 101, 102, 103, 104,
+         105, 106, 107, 108, 110, 112, 113, 114, 115, 116,
+         117, 118, 120, 121, 122, 123, 125, 126, 127, 128,
+         129, 131, 132, 133, 134, 136, 138, 139, 140, 142,
+         143, 144, 145, 148, 150, 151, 152, 154, 155, 157,
+         158, 138, 159, 160, 161, 162, 163, 165, 166, 167,
+         168, 169, 170, 171, 172, 175, 176, 177, 180, 181,
+         182, 183, 184, 185, 186, 188, 190, 193, 195, 196,
+         197, 198, 199, 200, 202, 203, 204, 211, 212, 213,
+
+         220, 221, 226, 226, 226, 226, 226, 226, 226, 226,
+         226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+         226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+         226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+         226, 226, 226, 226, 226, 226, 226, 226
         };
 
 /* Table of booleans, true if rule could match eol. */
-static yyconst flex_int32_t yy_rule_can_match_eol[57] =
+static yyconst flex_int32_t yy_rule_can_match_eol[73] =
         {0,
          1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,};
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,};
 
 static yy_state_type yy_last_accepting_state;
 static char *yy_last_accepting_cpos;
@@ -598,7 +641,7 @@ char *yytext;
 int yywrap();
 
 extern YYSTYPE yylval;
-#line 585 "../../parser/minisql_lex.c"
+#line 645 "../../parser/minisql_lex.c"
 
 #define INITIAL 0
 
@@ -787,7 +830,7 @@ YY_DECL {
 #line 15 "minisql.l"
 
 
-#line 770 "../../parser/minisql_lex.c"
+#line 834 "../../parser/minisql_lex.c"
 
   if (!(yy_init)) {
     (yy_init) = 1;
@@ -836,12 +879,12 @@ YY_DECL {
       }
       while (yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
         yy_current_state = (int) yy_def[yy_current_state];
-        if (yy_current_state >= 175)
+        if (yy_current_state >= 227)
           yy_c = yy_meta[(unsigned int) yy_c];
       }
       yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
       ++yy_cp;
-    } while (yy_base[yy_current_state] != 189);
+    } while (yy_base[yy_current_state] != 303);
 
     yy_find_action:
     yy_act = yy_accept[yy_current_state];
@@ -1180,149 +1223,277 @@ YY_DECL {
       case 39:
         YY_RULE_SETUP
 #line 208 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return INCLUDE;
+      }
+        YY_BREAK
+      case 40:
+        YY_RULE_SETUP
+#line 213 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return ANALYZE;
+      }
+        YY_BREAK
+      case 41:
+        YY_RULE_SETUP
+#line 218 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return JOIN;
+      }
+        YY_BREAK
+      case 42:
+        YY_RULE_SETUP
+#line 223 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return DISTINCT;
+      }
+        YY_BREAK
+      case 43:
+        YY_RULE_SETUP
+#line 228 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return GROUP;
+      }
+        YY_BREAK
+      case 44:
+        YY_RULE_SETUP
+#line 233 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return BY;
+      }
+        YY_BREAK
+      case 45:
+        YY_RULE_SETUP
+#line 238 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return ORDER;
+      }
+        YY_BREAK
+      case 46:
+        YY_RULE_SETUP
+#line 243 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return LIMIT;
+      }
+        YY_BREAK
+      case 47:
+        YY_RULE_SETUP
+#line 248 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return ASC;
+      }
+        YY_BREAK
+      case 48:
+        YY_RULE_SETUP
+#line 253 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return DESC;
+      }
+        YY_BREAK
+      case 49:
+        YY_RULE_SETUP
+#line 258 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return PREPARE;
+      }
+        YY_BREAK
+      case 50:
+        YY_RULE_SETUP
+#line 263 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return EXECUTE;
+      }
+        YY_BREAK
+      case 51:
+        YY_RULE_SETUP
+#line 268 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return AS;
+      }
+        YY_BREAK
+      case 52:
+        YY_RULE_SETUP
+#line 273 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return EXPLAIN;
+      }
+        YY_BREAK
+      case 53:
+        YY_RULE_SETUP
+#line 278 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
         return IDENTIFIER;
       }
         YY_BREAK
-      case 40:
+      case 54:
         YY_RULE_SETUP
-#line 214 "minisql.l"
+#line 284 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
         return NUMBER;
       }
         YY_BREAK
-      case 41:
+      case 55:
         YY_RULE_SETUP
-#line 220 "minisql.l"
+#line 290 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
         return NUMBER;
       }
         YY_BREAK
-      case 42:
+      case 56:
         YY_RULE_SETUP
-#line 226 "minisql.l"
+#line 296 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return EQ;
       }
         YY_BREAK
-      case 43:
+      case 57:
         YY_RULE_SETUP
-#line 231 "minisql.l"
+#line 301 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return NE;
       }
         YY_BREAK
-      case 44:
+      case 58:
         YY_RULE_SETUP
-#line 236 "minisql.l"
+#line 306 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return LE;
       }
         YY_BREAK
-      case 45:
+      case 59:
         YY_RULE_SETUP
-#line 241 "minisql.l"
+#line 311 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return GE;
       }
         YY_BREAK
-      case 46:
+      case 60:
         YY_RULE_SETUP
-#line 246 "minisql.l"
+#line 316 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return (',');
       }
         YY_BREAK
-      case 47:
+      case 61:
         YY_RULE_SETUP
-#line 251 "minisql.l"
+#line 321 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('*');
       }
         YY_BREAK
-      case 48:
+      case 62:
         YY_RULE_SETUP
-#line 256 "minisql.l"
+#line 326 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return (';');
       }
         YY_BREAK
-      case 49:
+      case 63:
         YY_RULE_SETUP
-#line 261 "minisql.l"
+#line 331 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('\'');
       }
         YY_BREAK
-      case 50:
+      case 64:
         YY_RULE_SETUP
-#line 266 "minisql.l"
+#line 336 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('<');
       }
         YY_BREAK
-      case 51:
+      case 65:
         YY_RULE_SETUP
-#line 271 "minisql.l"
+#line 341 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('>');
       }
         YY_BREAK
-      case 52:
+      case 66:
         YY_RULE_SETUP
-#line 276 "minisql.l"
+#line 346 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('(');
       }
         YY_BREAK
-      case 53:
+      case 67:
         YY_RULE_SETUP
-#line 281 "minisql.l"
+#line 351 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return (')');
       }
         YY_BREAK
-      case 54:
-/* rule 54 can match eol */
+      case 68:
         YY_RULE_SETUP
-#line 286 "minisql.l"
+#line 356 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
+        return ('.');
       }
         YY_BREAK
-      case 55:
+      case 69:
         YY_RULE_SETUP
-#line 290 "minisql.l"
+#line 361 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+        return ('?');
+      }
+        YY_BREAK
+      case 70:
+/* rule 70 can match eol */
+        YY_RULE_SETUP
+#line 366 "minisql.l"
+      {
+        MinisqlParserMovePos(yylineno, yytext);
+      }
+        YY_BREAK
+      case 71:
+        YY_RULE_SETUP
+#line 370 "minisql.l"
       {
         char str[128] = {0};
         sprintf(str, "Unrecognized token [%s] in input sql.", yytext);
         MinisqlParserSetError(str);
       }
         YY_BREAK
-      case 56:
+      case 72:
         YY_RULE_SETUP
-#line 296 "minisql.l"
+#line 376 "minisql.l"
         ECHO;
         YY_BREAK
-#line 1314 "../../parser/minisql_lex.c"
+#line 1497 "../../parser/minisql_lex.c"
       case YY_STATE_EOF(INITIAL):
         yyterminate();
 
@@ -1579,7 +1750,7 @@ static yy_state_type yy_get_previous_state(void) {
     }
     while (yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
       yy_current_state = (int) yy_def[yy_current_state];
-      if (yy_current_state >= 175)
+      if (yy_current_state >= 227)
         yy_c = yy_meta[(unsigned int) yy_c];
     }
     yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
@@ -1604,11 +1775,11 @@ static yy_state_type yy_try_NUL_trans(yy_state_type yy_current_state) {
   }
   while (yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
     yy_current_state = (int) yy_def[yy_current_state];
-    if (yy_current_state >= 175)
+    if (yy_current_state >= 227)
       yy_c = yy_meta[(unsigned int) yy_c];
   }
   yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-  yy_is_jam = (yy_current_state == 174);
+  yy_is_jam = (yy_current_state == 226);
 
   return yy_is_jam ? 0 : yy_current_state;
 }
@@ -2258,7 +2429,7 @@ void yyfree(void *ptr) {
 
 #define YYTABLES_NAME "yytables"
 
-#line 296 "minisql.l"
+#line 376 "minisql.l"
 
 
 int yywrap() {
@@ -169,6 +169,30 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeAnalyze:
+      return "kNodeAnalyze";
+    case kNodeJoin:
+      return "kNodeJoin";
+    case kNodeAggregate:
+      return "kNodeAggregate";
+    case kNodeGroupBy:
+      return "kNodeGroupBy";
+    case kNodeDistinct:
+      return "kNodeDistinct";
+    case kNodeOrderBy:
+      return "kNodeOrderBy";
+    case kNodeOrderItem:
+      return "kNodeOrderItem";
+    case kNodeLimit:
+      return "kNodeLimit";
+    case kNodeParameter:
+      return "kNodeParameter";
+    case kNodePrepare:
+      return "kNodePrepare";
+    case kNodeExecute:
+      return "kNodeExecute";
+    case kNodeExplain:
+      return "kNodeExplain";
     default:
       return "error type";
   }
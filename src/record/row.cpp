@@ -1,6 +1,33 @@
 #include "record/row.h"
 
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
+    if (UseCompactFormat(schema)) {
+        uint32_t count = fields_.size();
+        char *bitmap = buf + sizeof(uint32_t) + sizeof(uint16_t);
+        char *fixed = bitmap + (count + 7) / 8;
+        char *var_offsets = fixed + schema->GetFixedRegionSize();
+        char *temp = buf + GetCompactHeaderSize(schema);
+        MACH_WRITE_UINT32(buf, ROW_COMPACT_MAGIC_NUM);
+        MACH_WRITE_TO(uint16_t, buf + sizeof(uint32_t), count);
+        memset(bitmap, 0, var_offsets - bitmap);
+        for (uint32_t i = 0; i < count; i++) {
+            const Field *field = fields_[i];
+            uint32_t slot = schema->GetLayoutOffset(i);
+            ASSERT(field->type_id_ == schema->GetColumn(i)->GetType(), "Field type not match schema.");
+            if (field->IsNull()) {
+                bitmap[i / 8] |= static_cast<char>(1 << (i % 8));
+            } else if (field->type_id_ == TypeId::kTypeChar) {
+                memcpy(temp, field->GetCharData(), field->len_);
+                temp += field->len_;
+            } else {
+                memcpy(fixed + slot, &field->value_, Type::GetTypeSize(field->type_id_));
+            }
+            if (field->type_id_ == TypeId::kTypeChar) {
+                MACH_WRITE_TO(uint16_t, var_offsets + sizeof(uint16_t) * slot, temp - buf);
+            }
+        }
+        return temp - buf;
+    }
     // magic_num
     char *temp = buf;
     MACH_WRITE_UINT32(temp, ROW_MAGIC_NUM);
@@ -24,6 +51,39 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
 }
 
 uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
+    if (MACH_READ_UINT32(buf) != ROW_COMPACT_MAGIC_NUM) {
+        return DeserializeLegacy(buf, schema);
+    }
+    uint32_t count = MACH_READ_FROM(uint16_t, buf + sizeof(uint32_t));
+    ASSERT(count == schema->GetColumnCount(), "Row does not match schema.");
+    const char *bitmap = buf + sizeof(uint32_t) + sizeof(uint16_t);
+    const char *fixed = bitmap + (count + 7) / 8;
+    const char *var_offsets = fixed + schema->GetFixedRegionSize();
+    uint32_t end = GetCompactHeaderSize(schema);
+    for (uint32_t i = 0; i < count; i++) {
+        TypeId type = schema->GetColumn(i)->GetType();
+        uint32_t slot = schema->GetLayoutOffset(i);
+        if (type == TypeId::kTypeChar) {
+            uint32_t begin = slot == 0 ? GetCompactHeaderSize(schema)
+                                       : MACH_READ_FROM(uint16_t, var_offsets + sizeof(uint16_t) * (slot - 1));
+            end = MACH_READ_FROM(uint16_t, var_offsets + sizeof(uint16_t) * slot);
+            if (bitmap[i / 8] & (1 << (i % 8))) {
+                fields_.push_back(ALLOC_P(heap_, Field)(type));
+            } else {
+                fields_.push_back(NewCharField(buf + begin, end - begin));
+            }
+        } else if (bitmap[i / 8] & (1 << (i % 8))) {
+            fields_.push_back(ALLOC_P(heap_, Field)(type));
+        } else if (type == TypeId::kTypeInt) {
+            fields_.push_back(ALLOC_P(heap_, Field)(type, MACH_READ_FROM(int32_t, fixed + slot)));
+        } else {
+            fields_.push_back(ALLOC_P(heap_, Field)(type, MACH_READ_FROM(float, fixed + slot)));
+        }
+    }
+    return end;
+}
+
+uint32_t Row::DeserializeLegacy(char *buf, Schema *schema) {
     // replace with your code here
     char *temp = buf;
     if (MACH_READ_UINT32(temp) == ROW_MAGIC_NUM) {
@@ -37,10 +97,8 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
         }
         for (size_t i = 0; i < size; i++) {
             fields_.push_back(nullptr);
-            if (!null_bitMap[i]) {
-                fields_[i]->DeserializeFrom(temp, schema->GetColumn(i)->GetType(), &(fields_[i]), false, heap_);
-                temp += fields_[i]->GetSerializedSize();
-            }
+            // null fields still get a Field object, they just carry no payload
+            temp += Field::DeserializeFrom(temp, schema->GetColumn(i)->GetType(), &(fields_[i]), null_bitMap[i], heap_);
             /*
             if (null_map[i] == false) {
                 fields_.push_back(nullptr);
@@ -62,6 +120,12 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
 uint32_t Row::GetSerializedSize(Schema *schema) const {
     // replace with your code here
     uint32_t serialize_size = 0;
+    if (UseCompactFormat(schema)) {
+        serialize_size = GetCompactHeaderSize(schema);
+        for (auto field : fields_)
+            if (field->type_id_ == TypeId::kTypeChar && !field->IsNull()) serialize_size += field->len_;
+        return serialize_size;
+    }
     // sizeof(uint32_t)*2 is sizeof(magic_num) and sizeof(size)
     serialize_size += sizeof(uint32_t) * 2 + sizeof(bool) * fields_.size();
     size_t i;
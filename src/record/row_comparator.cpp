@@ -0,0 +1,103 @@
+#include "record/row_comparator.h"
+
+RowComparator::RowComparator(const Schema *schema)
+        : schema_(schema),
+          column_count_(schema->GetColumnCount()),
+          bitmap_begin_(sizeof(uint32_t) + sizeof(uint16_t)),
+          fixed_begin_(bitmap_begin_ + (column_count_ + 7) / 8),
+          var_begin_(fixed_begin_ + schema->GetFixedRegionSize()),
+          header_size_(Row::GetCompactHeaderSize(schema)),
+          compare_serialized_(&RowComparator::CompareMulti) {
+  for (uint32_t i = 0; i < column_count_; i++) {
+    layout_.push_back(schema->GetLayoutOffset(i));
+    switch (schema->GetColumn(i)->GetType()) {
+      case TypeId::kTypeInt:
+        field_compare_.push_back(&TypeKernel<TypeId::kTypeInt>::Compare);
+        column_compare_.push_back(&RowComparator::CompareColumn<TypeId::kTypeInt>);
+        break;
+      case TypeId::kTypeFloat:
+        field_compare_.push_back(&TypeKernel<TypeId::kTypeFloat>::Compare);
+        column_compare_.push_back(&RowComparator::CompareColumn<TypeId::kTypeFloat>);
+        break;
+      case TypeId::kTypeChar:
+        field_compare_.push_back(&TypeKernel<TypeId::kTypeChar>::Compare);
+        column_compare_.push_back(&RowComparator::CompareColumn<TypeId::kTypeChar>);
+        break;
+      default:
+        ASSERT(false, "Unknown column type.");
+    }
+  }
+  if (column_count_ == 1) {
+    switch (schema->GetColumn(0)->GetType()) {
+      case TypeId::kTypeInt:
+        compare_serialized_ = &RowComparator::CompareSingle<TypeId::kTypeInt>;
+        break;
+      case TypeId::kTypeFloat:
+        compare_serialized_ = &RowComparator::CompareSingle<TypeId::kTypeFloat>;
+        break;
+      default:
+        compare_serialized_ = &RowComparator::CompareSingle<TypeId::kTypeChar>;
+        break;
+    }
+  }
+}
+
+int RowComparator::Compare(const Row &lhs, const Row &rhs) const {
+  ASSERT(lhs.GetFieldCount() == column_count_ && rhs.GetFieldCount() == column_count_, "Row does not match schema.");
+  for (uint32_t i = 0; i < column_count_; i++) {
+    const Field *lhs_value = lhs.GetField(i);
+    const Field *rhs_value = rhs.GetField(i);
+    if (lhs_value->IsNull() || rhs_value->IsNull()) {
+      if (lhs_value->IsNull() == rhs_value->IsNull()) {
+        continue;
+      }
+      return lhs_value->IsNull() ? -1 : 1;
+    }
+    int ret = field_compare_[i](*lhs_value, *rhs_value);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return 0;
+}
+
+template<TypeId type>
+int RowComparator::CompareColumn(const RowComparator &cmp, uint32_t idx, const char *lhs, const char *rhs) {
+  if constexpr (type == TypeId::kTypeChar) {
+    uint32_t lhs_len, rhs_len;
+    const char *lhs_chars = cmp.GetChars(lhs, idx, &lhs_len);
+    const char *rhs_chars = cmp.GetChars(rhs, idx, &rhs_len);
+    return TypeKernel<type>::Compare(lhs_chars, lhs_len, rhs_chars, rhs_len);
+  } else {
+    uint32_t offset = cmp.fixed_begin_ + cmp.layout_[idx];
+    return TypeKernel<type>::Compare(TypeKernel<type>::Read(lhs + offset), TypeKernel<type>::Read(rhs + offset));
+  }
+}
+
+template<TypeId type>
+int RowComparator::CompareSingle(const RowComparator &cmp, const char *lhs, const char *rhs) {
+  int lhs_null = lhs[cmp.bitmap_begin_] & 1;
+  int rhs_null = rhs[cmp.bitmap_begin_] & 1;
+  if (lhs_null | rhs_null) {
+    return rhs_null - lhs_null;
+  }
+  return CompareColumn<type>(cmp, 0, lhs, rhs);
+}
+
+int RowComparator::CompareMulti(const RowComparator &cmp, const char *lhs, const char *rhs) {
+  for (uint32_t i = 0; i < cmp.column_count_; i++) {
+    bool lhs_null = cmp.IsNull(lhs, i);
+    bool rhs_null = cmp.IsNull(rhs, i);
+    if (lhs_null || rhs_null) {
+      if (lhs_null == rhs_null) {
+        continue;
+      }
+      return lhs_null ? -1 : 1;
+    }
+    int ret = cmp.column_compare_[i](cmp, i, lhs, rhs);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include "record/row_view.h"
+
+void RowView::DecodeHeader() const {
+  ASSERT(data_ != nullptr, "Decode an empty row view.");
+  nulls_.clear();
+  offsets_.clear();
+  const char *temp = data_;
+  compact_ = MACH_READ_UINT32(temp) == Row::ROW_COMPACT_MAGIC_NUM;
+  if (compact_) {
+    count_ = MACH_READ_FROM(uint16_t, temp + sizeof(uint32_t));
+    bitmap_ = temp + sizeof(uint32_t) + sizeof(uint16_t);
+    fixed_ = bitmap_ + (count_ + 7) / 8;
+    var_offsets_ = fixed_ + schema_->GetFixedRegionSize();
+    decoded_ = true;
+    return;
+  }
+  count_ = 0;
+  if (MACH_READ_UINT32(temp) != Row::ROW_MAGIC_NUM) {
+    decoded_ = true;
+    return;
+  }
+  temp += sizeof(uint32_t);
+  uint32_t size = MACH_READ_UINT32(temp);
+  temp += sizeof(uint32_t);
+  for (uint32_t i = 0; i < size; i++) {
+    nulls_.push_back(MACH_READ_FROM(bool, temp));
+    temp += sizeof(bool);
+  }
+  // walk the payloads once, every later access is a table lookup
+  for (uint32_t i = 0; i < size; i++) {
+    offsets_.push_back(temp - data_);
+    if (nulls_[i]) {
+      continue;
+    }
+    TypeId type = schema_->GetColumn(i)->GetType();
+    if (type == TypeId::kTypeChar) {
+      temp += sizeof(uint32_t) + MACH_READ_UINT32(temp);
+    } else {
+      temp += Type::GetTypeSize(type);
+    }
+  }
+  count_ = size;
+  decoded_ = true;
+}
+
+uint32_t RowView::GetFieldCount() const {
+  if (!decoded_) DecodeHeader();
+  return count_;
+}
+
+bool RowView::IsNull(uint32_t idx) const {
+  if (!decoded_) DecodeHeader();
+  ASSERT(idx < count_, "Failed to access field");
+  if (compact_) {
+    return bitmap_[idx / 8] & (1 << (idx % 8));
+  }
+  return nulls_[idx];
+}
+
+int32_t RowView::GetInt(uint32_t idx) const {
+  ASSERT(!IsNull(idx), "Failed to access field");
+  if (compact_) {
+    return MACH_READ_FROM(int32_t, fixed_ + schema_->GetLayoutOffset(idx));
+  }
+  return MACH_READ_FROM(int32_t, data_ + offsets_[idx]);
+}
+
+float RowView::GetFloat(uint32_t idx) const {
+  ASSERT(!IsNull(idx), "Failed to access field");
+  if (compact_) {
+    return MACH_READ_FROM(float, fixed_ + schema_->GetLayoutOffset(idx));
+  }
+  return MACH_READ_FROM(float, data_ + offsets_[idx]);
+}
+
+const char *RowView::GetChars(uint32_t idx, uint32_t *len) const {
+  ASSERT(!IsNull(idx), "Failed to access field");
+  if (compact_) {
+    uint32_t begin;
+    GetVarRange(idx, &begin, len);
+    return data_ + begin;
+  }
+  *len = MACH_READ_UINT32(data_ + offsets_[idx]);
+  return data_ + offsets_[idx] + sizeof(uint32_t);
+}
+
+Field RowView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (IsNull(idx)) {
+    return Field(type);
+  }
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, GetInt(idx));
+    case TypeId::kTypeFloat:
+      return Field(type, GetFloat(idx));
+    default: {
+      uint32_t len;
+      const char *chars = GetChars(idx, &len);
+      return Field(type, const_cast<char *>(chars), len, false);
+    }
+  }
+}
+
+void RowView::ToRow(Row *row) const {
+  ASSERT(row != nullptr && row->GetFieldCount() == 0, "Materialize into a non-empty row.");
+  row->SetRowId(rid_);
+  row->DeserializeFrom(const_cast<char *>(data_), schema_);
+}
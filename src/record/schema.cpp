@@ -1,5 +1,20 @@
 #include "record/schema.h"
 #include <iostream>
+
+void Schema::InitRowLayout() {
+    layout_.clear();
+    fixed_size_ = 0;
+    var_count_ = 0;
+    for (auto column : columns_) {
+        if (column->GetType() == TypeId::kTypeChar) {
+            layout_.push_back(var_count_++);
+        } else {
+            layout_.push_back(fixed_size_);
+            fixed_size_ += Type::GetTypeSize(column->GetType());
+        }
+    }
+}
+
 uint32_t Schema::SerializeTo(char *buf) const {
     // replace with your code here
     char *temp = buf;
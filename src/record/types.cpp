@@ -233,7 +233,7 @@ uint32_t TypeChar::SerializeTo(const Field &field, char *buf) const {
   if (!field.IsNull()) {
     uint32_t len = GetLength(field);
     memcpy(buf, &len, sizeof(uint32_t));
-    memcpy(buf + sizeof(uint32_t), field.value_.chars_, len);
+    memcpy(buf + sizeof(uint32_t), field.GetCharData(), len);
     return len + sizeof(uint32_t);
   }
   return 0;
@@ -258,7 +258,7 @@ uint32_t TypeChar::GetSerializedSize(const Field &field, bool is_null) const {
 }
 
 const char *TypeChar::GetData(const Field &val) const {
-  return val.value_.chars_;
+  return val.GetCharData();
 }
 
 uint32_t TypeChar::GetLength(const Field &val) const {
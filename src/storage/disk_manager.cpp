@@ -124,6 +124,7 @@ int DiskManager::GetFileSize(const std::string &file_name) {
 }
 
 void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
+  read_count_++;
   int offset = physical_page_id * PAGE_SIZE;
   // check if read beyond file length
   if (offset >= GetFileSize(file_name_)) {
@@ -147,6 +148,7 @@ void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data)
 }
 
 void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
+  write_count_++;
   size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
   // set write cursor to offset
   db_io_.seekp(offset);
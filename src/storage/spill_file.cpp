@@ -0,0 +1,104 @@
+#include "storage/spill_file.h"
+
+SpillFile::SpillFile(SpillFile &&other) noexcept
+    : buffer_pool_manager_(other.buffer_pool_manager_),
+      first_page_id_(other.first_page_id_),
+      last_page_id_(other.last_page_id_),
+      last_used_(other.last_used_),
+      page_count_(other.page_count_),
+      row_count_(other.row_count_) {
+  other.first_page_id_ = other.last_page_id_ = INVALID_PAGE_ID;
+  other.last_used_ = CAPACITY;
+  other.page_count_ = 0;
+  other.row_count_ = 0;
+}
+
+bool SpillFile::Append(const Row &row, Schema *schema) {
+  uint32_t size = row.GetSerializedSize(schema);
+  buf_.resize(size);
+  row.SerializeTo(buf_.data(), schema);
+  if (!Write(reinterpret_cast<const char *>(&size), sizeof(uint32_t)) || !Write(buf_.data(), size)) {
+    return false;
+  }
+  row_count_++;
+  return true;
+}
+
+bool SpillFile::Write(const char *data, uint32_t len) {
+  while (len > 0) {
+    Page *page;
+    if (last_used_ == CAPACITY) {
+      // chain a new page behind the last one
+      page_id_t page_id;
+      page = buffer_pool_manager_->NewPage(page_id);
+      if (page == nullptr) return false;
+      MACH_WRITE_INT32(page->GetData() + OFFSET_NEXT_PAGE_ID, INVALID_PAGE_ID);
+      if (last_page_id_ == INVALID_PAGE_ID) {
+        first_page_id_ = page_id;
+      } else {
+        Page *last = buffer_pool_manager_->FetchPage(last_page_id_);
+        MACH_WRITE_INT32(last->GetData() + OFFSET_NEXT_PAGE_ID, page_id);
+        buffer_pool_manager_->UnpinPage(last_page_id_, true);
+      }
+      last_page_id_ = page_id;
+      last_used_ = 0;
+      page_count_++;
+    } else {
+      page = buffer_pool_manager_->FetchPage(last_page_id_);
+    }
+    uint32_t size = std::min(len, CAPACITY - last_used_);
+    memcpy(page->GetData() + SIZE_HEADER + last_used_, data, size);
+    last_used_ += size;
+    MACH_WRITE_UINT32(page->GetData() + OFFSET_USED, last_used_);
+    buffer_pool_manager_->UnpinPage(last_page_id_, true);
+    data += size;
+    len -= size;
+  }
+  return true;
+}
+
+bool SpillFile::Reader::Next(Row *row, Schema *schema) {
+  uint32_t size;
+  if (!Read(reinterpret_cast<char *>(&size), sizeof(uint32_t))) return false;
+  buf_.resize(size);
+  if (!Read(buf_.data(), size)) return false;
+  row->DeserializeFrom(buf_.data(), schema);
+  return true;
+}
+
+bool SpillFile::Reader::Read(char *buf, uint32_t len) {
+  while (len > 0) {
+    if (page_id_ == INVALID_PAGE_ID) return false;
+    Page *page = file_->buffer_pool_manager_->FetchPage(page_id_);
+    uint32_t used = MACH_READ_UINT32(page->GetData() + OFFSET_USED);
+    if (offset_ == used) {
+      page_id_t next_page_id = MACH_READ_INT32(page->GetData() + OFFSET_NEXT_PAGE_ID);
+      file_->buffer_pool_manager_->UnpinPage(page_id_, false);
+      page_id_ = next_page_id;
+      offset_ = 0;
+      continue;
+    }
+    uint32_t size = std::min(len, used - offset_);
+    memcpy(buf, page->GetData() + SIZE_HEADER + offset_, size);
+    file_->buffer_pool_manager_->UnpinPage(page_id_, false);
+    offset_ += size;
+    buf += size;
+    len -= size;
+  }
+  return true;
+}
+
+void SpillFile::Clear() {
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    page_id_t next_page_id = MACH_READ_INT32(page->GetData() + OFFSET_NEXT_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+  first_page_id_ = last_page_id_ = INVALID_PAGE_ID;
+  last_used_ = CAPACITY;
+  page_count_ = 0;
+  row_count_ = 0;
+}
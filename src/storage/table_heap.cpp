@@ -21,6 +21,7 @@ bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
       buffer_pool_manager_->UnpinPage(new_page->GetTablePageId(), false);
       page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, page->GetTablePageId(), log_manager_, txn);
+      if (page_ids_loaded_) page_ids_.push_back(next_page_id);
       buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
       page = new_page;
     }
@@ -100,6 +101,8 @@ void TableHeap::FreeHeap() {
     buffer_pool_manager_->DeletePage(pageId);
     pageId = nextPageId;
   }
+  page_ids_.clear();
+  page_ids_loaded_ = false;
 }
 
 bool TableHeap::GetTuple(Row *row, Transaction *txn) {
@@ -111,6 +114,110 @@ bool TableHeap::GetTuple(Row *row, Transaction *txn) {
   return if_get;
 }
 
+uint32_t TableHeap::SamplePages(uint32_t max_pages, const std::function<void(const RowView &)> &visit,
+                                uint32_t &page_count) {
+  page_count = LoadPageIds() ? page_ids_.size() : 0;
+  uint32_t sampled = std::min(max_pages, page_count);
+  for (uint32_t i = 0; i < sampled; i++) {
+    page_id_t pageId = page_ids_[static_cast<uint64_t>(i) * page_count / sampled];
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(pageId));
+    if (page == nullptr) continue;
+    RowId rid;
+    RowView view;
+    for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(RowId(rid), &rid)) {
+      if (page->GetTupleView(rid, schema_, &view)) {
+        visit(view);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(pageId, false);
+  }
+  return sampled;
+}
+
+bool TableHeap::LoadPageIds() {
+  if (page_ids_loaded_) return true;
+  // the whole of every page is read to find the next one
+  std::vector<page_id_t> page_ids;
+  page_id_t pageId = first_page_id_;
+  while (pageId != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(pageId));
+    if (page == nullptr) return false;
+    page_ids.push_back(pageId);
+    pageId = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_ids.back(), false);
+  }
+  page_ids_.swap(page_ids);
+  page_ids_loaded_ = true;
+  return true;
+}
+
+bool TableHeap::ScanBatches(uint32_t batch_size, uint32_t max_pages,
+                            const std::function<bool(const RowView *views, uint32_t count)> &visit) {
+  return ScanBatchesFrom(first_page_id_, [](TablePage *page) { return page->GetNextPageId(); }, batch_size, max_pages,
+                  visit);
+}
+
+bool TableHeap::ScanPageBatches(const std::vector<page_id_t> &page_ids, uint32_t batch_size, uint32_t max_pages,
+                                const std::function<bool(const RowView *views, uint32_t count)> &visit) {
+  if (page_ids.empty()) return true;
+  size_t next = 1;
+  auto next_page = [&](TablePage *) { return next < page_ids.size() ? page_ids[next++] : INVALID_PAGE_ID; };
+  return ScanBatchesFrom(page_ids[0], next_page, batch_size, max_pages, visit);
+}
+
+bool TableHeap::GetPageIds(std::vector<page_id_t> &page_ids) {
+  if (!LoadPageIds()) return false;
+  page_ids = page_ids_;
+  return true;
+}
+
+bool TableHeap::ScanBatchesFrom(page_id_t page_id, const std::function<page_id_t(TablePage *page)> &next,
+                                uint32_t batch_size, uint32_t max_pages,
+                                const std::function<bool(const RowView *views, uint32_t count)> &visit) {
+  std::vector<RowView> views(batch_size);
+  std::vector<TablePage *> pinned;
+  uint32_t count = 0;
+  bool more = true;
+  // visit the batch, then release its pages except the last keep ones
+  auto flush = [&](uint32_t keep) {
+    if (more && count > 0) more = visit(views.data(), count);
+    count = 0;
+    for (uint32_t i = 0; i + keep < pinned.size(); i++) {
+      pinned[i]->RUnlatch();
+      buffer_pool_manager_->UnpinPage(pinned[i]->GetTablePageId(), false);
+    }
+    pinned.erase(pinned.begin(), pinned.end() - keep);
+  };
+  while (more && page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      // every frame is pinned, release the pages of the batch unvisited
+      more = false;
+      flush(0);
+      return false;
+    }
+    page->RLatch();
+    pinned.push_back(page);
+    RowId rid;
+    for (bool found = page->GetFirstTupleRid(&rid); more && found; found = page->GetNextTupleRid(RowId(rid), &rid)) {
+      if (count == batch_size) {
+        // the rest of this page goes into the next batch
+        flush(1);
+        if (!more) break;
+      }
+      if (page->GetTupleView(rid, schema_, &views[count])) {
+        count++;
+      }
+    }
+    page_id = next(page);
+    if (pinned.size() >= max_pages || page_id == INVALID_PAGE_ID) {
+      flush(0);
+    }
+  }
+  flush(0);
+  return true;
+}
+
 TableIterator TableHeap::Begin(Transaction *txn) {
   RowId first_row_id;
   page_id_t pageId=first_page_id_;
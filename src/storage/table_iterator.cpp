@@ -3,50 +3,88 @@
 
 TableIterator::TableIterator() {}
 
-TableIterator::TableIterator(TableHeap *tableHeap, RowId rowId) : tableHeap_(tableHeap), row_(new Row(rowId)) {
-  if (row_->GetRowId().GetPageId() != INVALID_PAGE_ID) {
-    tableHeap_->GetTuple(row_, nullptr);
+TableIterator::TableIterator(TableHeap *tableHeap, RowId rowId) : tableHeap_(tableHeap), rid_(rowId) {
+  if (rid_.GetPageId() != INVALID_PAGE_ID) {
+    PinPage(rid_.GetPageId());
+    if (page_ == nullptr || !page_->GetTupleView(rid_, tableHeap_->schema_, &view_)) {
+      ReleasePage();
+    }
   }
 }
 
-TableIterator::TableIterator(const TableIterator &other) : tableHeap_(other.tableHeap_), row_(new Row(*other.row_)) {}
+TableIterator::TableIterator(const TableIterator &other) : tableHeap_(other.tableHeap_), rid_(other.rid_) {
+  if (other.page_ != nullptr) {
+    PinPage(other.page_->GetTablePageId());
+    view_.Reset(other.view_.GetData(), other.view_.GetSchema(), rid_);
+  }
+}
 
-TableIterator::~TableIterator() {}
+TableIterator::~TableIterator() {
+  delete row_;
+  ReleasePage();
+}
 
-bool TableIterator::operator==(const TableIterator &itr) const { return row_->GetRowId() == itr.row_->GetRowId(); }
+bool TableIterator::operator==(const TableIterator &itr) const { return rid_ == itr.rid_; }
 
 bool TableIterator::operator!=(const TableIterator &itr) const { return !(*this == itr); }
 
-Row &TableIterator::operator*() { return *(this->row_); }
+Row &TableIterator::operator*() { return *(this->operator->()); }
 
 Row *TableIterator::operator->() {
   // ASSERT(*this != tableHeap_->End(), "itr is at end");
+  if (row_ == nullptr) {
+    row_ = new Row(rid_, &heap_);
+  }
+  if (!row_valid_) {
+    heap_.Reset();
+    row_->Reset(rid_);
+    if (view_.IsValid()) {
+      view_.ToRow(row_);
+    }
+    row_valid_ = true;
+  }
   return row_;
 }
+
 TableIterator &TableIterator::operator=(const TableIterator &other) {
+  if (this == &other) {
+    return *this;
+  }
+  ReleaseRow();
+  ReleasePage();
   tableHeap_ = other.tableHeap_;
-  row_ = other.row_;
+  rid_ = other.rid_;
+  view_.Reset(nullptr, nullptr);
+  if (other.page_ != nullptr) {
+    PinPage(other.page_->GetTablePageId());
+    view_.Reset(other.view_.GetData(), other.view_.GetSchema(), rid_);
+  }
   return *this;
 }
+
 TableIterator &TableIterator::operator++() {
-  BufferPoolManager *bufferPoolManager = tableHeap_->buffer_pool_manager_;
-  auto page = reinterpret_cast<TablePage *>(bufferPoolManager->FetchPage(row_->GetRowId().GetPageId()));
+  ReleaseRow();
+  if (page_ == nullptr) {
+    rid_ = INVALID_ROWID;
+    return *this;
+  }
   RowId next_row_id;
-  bool if_get = page->GetNextTupleRid(row_->GetRowId(), &next_row_id);
-  while (!if_get && (page->GetNextPageId() != INVALID_PAGE_ID)) {
-    auto next_page = reinterpret_cast<TablePage *>(bufferPoolManager->FetchPage(page->GetNextPageId()));
-    // auto next_page=static_cast<TablePage *>(buffer_pool_manager->FetchPage(page->GetNextPageId()));
-    bufferPoolManager->UnpinPage(page->GetTablePageId(), false);
-    page = next_page;
-    if_get = page->GetFirstTupleRid(&next_row_id);
+  bool if_get = page_->GetNextTupleRid(rid_, &next_row_id);
+  while (!if_get && (page_->GetNextPageId() != INVALID_PAGE_ID)) {
+    page_id_t next_page_id = page_->GetNextPageId();
+    ReleasePage();
+    PinPage(next_page_id);
+    if (page_ == nullptr) break;
+    if_get = page_->GetFirstTupleRid(&next_row_id);
   }
-  delete row_;
-  row_ = new Row(next_row_id);
-  if (*this != tableHeap_->End()) {
-    Transaction *txn = nullptr;
-    tableHeap_->GetTuple(row_, txn);
+  if (if_get) {
+    rid_ = next_row_id;
+    page_->GetTupleView(rid_, tableHeap_->schema_, &view_);
+  } else {
+    rid_ = INVALID_ROWID;
+    view_.Reset(nullptr, nullptr);
+    ReleasePage();
   }
-  bufferPoolManager->UnpinPage(page->GetTablePageId(), false);
   return *this;
 }
 
@@ -54,4 +92,15 @@ TableIterator TableIterator::operator++(int) {
   TableIterator tableIterator = *this;
   ++(*this);
   return tableIterator;
-}
\ No newline at end of file
+}
+
+void TableIterator::PinPage(page_id_t page_id) {
+  page_ = reinterpret_cast<TablePage *>(tableHeap_->buffer_pool_manager_->FetchPage(page_id));
+}
+
+void TableIterator::ReleasePage() {
+  if (page_ != nullptr) {
+    tableHeap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+    page_ = nullptr;
+  }
+}
@@ -1,6 +1,7 @@
 #include "catalog/catalog.h"
 #include "common/instance.h"
 #include "gtest/gtest.h"
+#include "record/type_kernel.h"
 #include "utils/utils.h"
 #include "glog/logging.h"
 
@@ -138,4 +139,161 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, IndexKeyTypeTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  IndexKeyType key_type;
+  uint32_t key_size;
+  IndexMetadata::SelectKeyType(schema.get(), {0}, true, key_type, key_size);
+  ASSERT_EQ(kKeyInt, key_type);
+  ASSERT_EQ(8u, key_size);
+  IndexMetadata::SelectKeyType(schema.get(), {2}, false, key_type, key_size);
+  ASSERT_EQ(kKeyFloat, key_type);
+  ASSERT_EQ(16u, key_size);
+  IndexMetadata::SelectKeyType(schema.get(), {0, 1}, true, key_type, key_size);
+  ASSERT_EQ(kKeyPacked, key_type);
+  ASSERT_EQ(128u, key_size);
+  // metadata keeps the layout across serialization
+  char *buf = reinterpret_cast<char *>(heap.Allocate(PAGE_SIZE));
+  IndexMetadata::SelectKeyType(schema.get(), {2}, false, key_type, key_size);
+  auto *meta = IndexMetadata::Create(1, "index-float", 0, {2}, &heap, false, key_type, key_size);
+  ASSERT_EQ(meta->GetSerializedSize(), meta->SerializeTo(buf));
+  IndexMetadata *other = nullptr;
+  ASSERT_EQ(meta->GetSerializedSize(), IndexMetadata::DeserializeFrom(buf, other, &heap));
+  ASSERT_FALSE(other->IsUnique());
+  ASSERT_EQ(kKeyFloat, other->GetKeyType());
+  ASSERT_EQ(16u, other->GetKeySize());
+  // a native index stores and finds its keys after reloading the catalog
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-id", {"id"}, &txn, index_info, false));
+  for (int i = 0; i < 100; i++) {
+    Row row(std::vector<Field>{Field(TypeId::kTypeInt, i % 10)});
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(row, RowId(1000, i), nullptr));
+  }
+  // so does a hash index, whose directory is found through the index roots
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-name", {"name"}, &txn, index_info, true,
+                                                         kIndexHash));
+  ASSERT_EQ(kKeyPacked, index_info->GetIndexMeta()->GetKeyType());
+  ASSERT_EQ(1u + 64u + 2u, index_info->GetIndexMeta()->GetKeySize());
+  for (int i = 0; i < 100; i++) {
+    std::string name = "name-" + std::to_string(i);
+    Row row(std::vector<Field>{Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)});
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(row, RowId(1000, i), nullptr));
+  }
+  // a covering index keeps its included columns, hash indexes cannot include any
+  ASSERT_EQ(DB_FAILED, db_01->catalog_mgr_->CreateIndex("table-1", "index-bad", {"name"}, &txn, index_info, true,
+                                                        kIndexHash, {"id"}));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-account", {"account"}, &txn, index_info,
+                                                         false, kIndexBPlusTree, {"id"}));
+  ASSERT_EQ(kKeyPacked, index_info->GetIndexMeta()->GetKeyType());
+  ASSERT_EQ(32u, index_info->GetIndexMeta()->GetKeySize());
+  ASSERT_EQ(2u, index_info->GetIndexKeySchema()->GetColumnCount());
+  for (int i = 0; i < 100; i++) {
+    Row row(std::vector<Field>{Field(TypeId::kTypeFloat, float(i % 10)), Field(TypeId::kTypeInt, i)});
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(row, RowId(1000, i), nullptr));
+  }
+  delete db_01;
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-id", index_info));
+  std::vector<RowId> ret;
+  Row key(std::vector<Field>{Field(TypeId::kTypeInt, 3)});
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, ret, &txn));
+  ASSERT_EQ(10u, ret.size());
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-name", index_info));
+  ASSERT_EQ(kIndexHash, index_info->GetIndexMethod());
+  ret.clear();
+  Row name_key(std::vector<Field>{Field(TypeId::kTypeChar, const_cast<char *>("name-42"), 7, true)});
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(name_key, ret, &txn));
+  ASSERT_EQ(1u, ret.size());
+  ASSERT_EQ(RowId(1000, 42).Get(), ret[0].Get());
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-account", index_info));
+  ASSERT_TRUE(index_info->GetIndexMeta()->IsCovering());
+  ASSERT_EQ(1u, index_info->GetKeyColumnCount());
+  Row account_key(std::vector<Field>{Field(TypeId::kTypeFloat, 7.0f)});
+  std::vector<Row *> entries;
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanRangeEntries(&account_key, &account_key, entries, &heap, &txn));
+  ASSERT_EQ(10u, entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    ASSERT_EQ(static_cast<int>(10 * i + 7), TypeKernel<TypeId::kTypeInt>::Get(*entries[i]->GetField(1)));
+    delete entries[i];
+  }
+  delete db_02;
+}
+
+TEST(CatalogTest, TableStatisticsTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("grp", TypeId::kTypeInt, 1, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 8, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), &txn, table_info));
+  auto insert = [&](int from, int to) {
+    for (int i = from; i < to; i++) {
+      std::string name = "n-" + std::to_string(i % 100);
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeInt, i % 20),
+                                i % 10 == 0 ? Field(TypeId::kTypeChar)
+                                            : Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(),
+                                                    true)};
+      Row row(fields);
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+    }
+  };
+  insert(0, 5000);
+  ASSERT_EQ(nullptr, table_info->GetStatistics());
+  TableStatistics *stats = nullptr;
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, db_01->catalog_mgr_->AnalyzeTable("table-2", &txn, stats));
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->AnalyzeTable("table-1", &txn, stats));
+  ASSERT_EQ(stats, table_info->GetStatistics());
+  // a table smaller than the sample is counted exactly
+  ASSERT_LE(stats->GetPageCount(), TableStatistics::SAMPLE_PAGES);
+  ASSERT_EQ(5000u, stats->GetRowCount());
+  ASSERT_EQ(5000u, stats->GetColumn(0).distinct_count_);
+  ASSERT_EQ(20u, stats->GetColumn(1).distinct_count_);
+  ASSERT_EQ(90u, stats->GetColumn(2).distinct_count_);
+  ASSERT_EQ(500u, stats->GetColumn(2).null_count_);
+  Field low(TypeId::kTypeInt, 1000), high(TypeId::kTypeInt, 1999), missing(TypeId::kTypeInt, 5000);
+  ASSERT_NEAR(0.2, stats->RangeSelectivity(0, &low, true, &high, true), 0.02);
+  ASSERT_NEAR(0.8, stats->RangeSelectivity(0, &low, true, nullptr, false), 0.02);
+  ASSERT_NEAR(0.05, stats->EqualSelectivity(1, Field(TypeId::kTypeInt, 7)), 0.01);
+  ASSERT_EQ(0, stats->EqualSelectivity(0, missing));
+  ASSERT_NEAR(0.1, stats->NullSelectivity(2), 1e-6);
+  // larger tables are sampled, estimates stay close
+  insert(5000, 40000);
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->AnalyzeTable("table-1", &txn, stats));
+  ASSERT_EQ(stats, table_info->GetStatistics());
+  ASSERT_GT(stats->GetPageCount(), TableStatistics::SAMPLE_PAGES);
+  ASSERT_NEAR(40000, stats->GetRowCount(), 2000);
+  ASSERT_EQ(20u, stats->GetColumn(1).distinct_count_);
+  ASSERT_GE(stats->GetColumn(0).distinct_count_, stats->GetSampleRowCount());
+  ASSERT_LE(stats->GetColumn(0).distinct_count_, stats->GetRowCount());
+  ASSERT_EQ(90u, stats->GetColumn(2).distinct_count_);
+  ASSERT_NEAR(0.1, stats->RangeSelectivity(0, &low, false, &missing, false), 0.02);
+  uint32_t rows = stats->GetRowCount(), pages = stats->GetPageCount();
+  std::vector<double> bounds = stats->GetColumn(0).bounds_;
+  delete db_01;
+  // statistics are reloaded with the catalog
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info));
+  stats = table_info->GetStatistics();
+  ASSERT_NE(nullptr, stats);
+  ASSERT_EQ(rows, stats->GetRowCount());
+  ASSERT_EQ(pages, stats->GetPageCount());
+  ASSERT_EQ(bounds, stats->GetColumn(0).bounds_);
+  ASSERT_NEAR(0.1, stats->NullSelectivity(2), 0.01);
+  delete db_02;
+}
@@ -0,0 +1,146 @@
+#include <sstream>
+#include <string>
+
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+
+/**
+ * Execute sql in a context of its own
+ */
+static dberr_t Sql(ExecuteEngine &engine, const char *sql) {
+  ExecuteContext context;
+  return engine.ExecuteSql(sql, &context);
+}
+
+/**
+ * Execute sql, returning what it prints
+ */
+static std::string Output(ExecuteEngine &engine, const char *sql) {
+  std::ostringstream os;
+  std::streambuf *console = std::cout.rdbuf(os.rdbuf());
+  Sql(engine, sql);
+  std::cout.rdbuf(console);
+  return os.str();
+}
+
+/**
+ * Pages operator fetched, from the plan EXPLAIN ANALYZE printed
+ */
+static uint64_t Fetches(const std::string &plan, const std::string &name) {
+  size_t line = plan.find("-> " + name + "  (");
+  if (line == std::string::npos) line = plan.find(name + "  (");
+  EXPECT_NE(std::string::npos, line) << plan;
+  return std::stoull(plan.substr(plan.find("hits=", line) + 5)) +
+         std::stoull(plan.substr(plan.find("misses=", line) + 7));
+}
+
+TEST(ExecuteEngineTest, UpdateUniqueTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create database execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "use execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create table t(id int, name char(16) unique, primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "insert into t values(1, \"a\");"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "insert into t values(2, \"b\");"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "insert into t values(3, \"c\");"));
+  // a key of another row fails and leaves the row and its keys as they were
+  ASSERT_EQ(DB_FAILED, Sql(engine, "update t set name = \"b\" where id = 1;"));
+  ASSERT_EQ(DB_FAILED, Sql(engine, "update t set id = 2 where id = 1;"));
+  ASSERT_EQ(DB_FAILED, Sql(engine, "insert into t values(4, \"a\");"));
+  ASSERT_EQ(DB_FAILED, Sql(engine, "insert into t values(1, \"d\");"));
+  // so does the same key given to several rows
+  ASSERT_EQ(DB_FAILED, Sql(engine, "update t set name = \"z\";"));
+  ASSERT_EQ(DB_FAILED, Sql(engine, "insert into t values(4, \"b\");"));
+  ASSERT_EQ(DB_FAILED, Sql(engine, "insert into t values(4, \"c\");"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "insert into t values(4, \"z\");"));
+  // a free key is taken and the old one given up
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "update t set name = \"y\" where id = 1;"));
+  ASSERT_EQ(DB_FAILED, Sql(engine, "insert into t values(5, \"y\");"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "insert into t values(5, \"a\");"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "drop database execute_engine_test;"));
+}
+
+TEST(ExecuteEngineTest, IndexLimitTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create database execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "use execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create table t(id int, name char(16), primary key(id));"));
+  for (int i = 0; i < 1000; i++) {
+    std::string insert = "insert into t values(" + std::to_string(i) + ", \"name\");";
+    ASSERT_EQ(DB_SUCCESS, Sql(engine, insert.c_str()));
+  }
+  // rows of an index scan are fetched one at a time, a limit stops the fetches
+  std::string plan = Output(engine, "explain analyze select * from t where id >= 0 limit 3;");
+  ASSERT_NE(std::string::npos, plan.find("Limit 3  (")) << plan;
+  ASSERT_LT(Fetches(plan, "Index Scan on t using t_pk"), 50u);
+  // so does one ordered on the index, instead of a sort
+  plan = Output(engine, "explain analyze select * from t order by id desc limit 3;");
+  ASSERT_EQ(std::string::npos, plan.find("Sort")) << plan;
+  ASSERT_LT(Fetches(plan, "Index Scan Backward on t using t_pk"), 50u);
+  std::string rows = Output(engine, "select id from t order by id desc limit 3;");
+  ASSERT_NE(std::string::npos, rows.find("\n999  \n998  \n997  \nSelect Success, Affects 3 Record!")) << rows;
+  rows = Output(engine, "select id from t where id > 500 and id <= 900 order by id limit 2;");
+  ASSERT_NE(std::string::npos, rows.find("\n501  \n502  \nSelect Success, Affects 2 Record!")) << rows;
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "drop database execute_engine_test;"));
+}
+
+TEST(ExecuteEngineTest, IndexMinMaxTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create database execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "use execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create table t(id int, score int, primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create index t_score on t(score);"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "insert into t values(-1, null);"));
+  for (int i = 0; i < 1000; i++) {
+    std::string insert = "insert into t values(" + std::to_string(i) + ", " + std::to_string(i % 7 + 10) + ");";
+    ASSERT_EQ(DB_SUCCESS, Sql(engine, insert.c_str()));
+  }
+  // one probe of each index instead of a scan, the null score left out
+  std::string plan = Output(engine, "explain analyze select min(id), max(id), min(score), max(score) from t;");
+  ASSERT_EQ(std::string::npos, plan.find("Scan")) << plan;
+  ASSERT_LT(Fetches(plan, "Index Min/Max on t using t_pk, t_score"), 20u);
+  std::string rows = Output(engine, "select min(id), max(id), min(score), max(score) from t;");
+  ASSERT_NE(std::string::npos, rows.find("\n-1  999  10  16  \nSelect Success, Affects 1 Record!")) << rows;
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "drop database execute_engine_test;"));
+}
+
+TEST(ExecuteEngineTest, ExplainBoundsTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create database execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "use execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create table t(id int, name char(64), score int, primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create index t_name on t(name) include (score);"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "insert into t values(1, \"a\", 3);"));
+  // a bound too long for the keys of the covering index leaves it out of both plans
+  std::string where = " from t where name = \"" + std::string(300, 'a') + "\";";
+  std::string plan = Output(engine, ("explain select name, score" + where).c_str());
+  ASSERT_NE(std::string::npos, plan.find("\nIndex Scan on t using t_name\n")) << plan;
+  plan = Output(engine, ("explain analyze select name, score" + where).c_str());
+  ASSERT_EQ(std::string::npos, plan.find("Covering")) << plan;
+  ASSERT_NE(std::string::npos, plan.find("\nIndex Scan on t using t_name  (")) << plan;
+  plan = Output(engine, "explain select name, score from t where name = \"a\";");
+  ASSERT_NE(std::string::npos, plan.find("\nCovering Index Scan on t using t_name\n")) << plan;
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "drop database execute_engine_test;"));
+}
+
+TEST(ExecuteEngineTest, CompareNumberTest) {
+  ExecuteEngine engine;
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create database execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "use execute_engine_test;"));
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "create table t(id int, score int, primary key(id));"));
+  for (int i = 0; i < 5; i++) {
+    std::string insert = "insert into t values(" + std::to_string(i) + ", " + std::to_string(i) + ");";
+    ASSERT_EQ(DB_SUCCESS, Sql(engine, insert.c_str()));
+  }
+  // fractions compare exactly, with the index on id as without one on score
+  for (std::string column : {"id", "score"}) {
+    std::string rows = Output(engine, ("select id from t where " + column + " < 2.5;").c_str());
+    ASSERT_NE(std::string::npos, rows.find("Select Success, Affects 3 Record!")) << rows;
+    rows = Output(engine, ("select id from t where " + column + " > 1.5 and " + column + " <= 3;").c_str());
+    ASSERT_NE(std::string::npos, rows.find("\n2  \n3  \nSelect Success, Affects 2 Record!")) << rows;
+    rows = Output(engine, ("select id from t where " + column + " = 2.5;").c_str());
+    ASSERT_NE(std::string::npos, rows.find("Affects 0 Record!")) << rows;
+    rows = Output(engine, ("select id from t where " + column + " > -0.5 and " + column + " < 3000000000;").c_str());
+    ASSERT_NE(std::string::npos, rows.find("Select Success, Affects 5 Record!")) << rows;
+  }
+  ASSERT_EQ(DB_SUCCESS, Sql(engine, "drop database execute_engine_test;"));
+}
@@ -0,0 +1,61 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/explain.h"
+#include "gtest/gtest.h"
+
+static string db_file_name = "explain_test.db";
+
+TEST(ExplainTest, PlanTest) {
+  DBStorageEngine engine(db_file_name, true, 16);
+  Explain explain(false, engine.bpm_, engine.disk_mgr_);
+  uint32_t join = explain.Add(Explain::NO_OPERATOR, "Hash Join u");
+  explain.Add(join, "Seq Scan on u");
+  uint32_t scan = explain.Add(join, "Seq Scan");
+  explain.SetName(scan, "Index Scan on t using t_pk");
+  explain.AddDetail(join, "spilled 2 pages");
+  std::ostringstream os;
+  explain.Print(os, Explain::Clock::duration(0));
+  ASSERT_EQ("Hash Join u, spilled 2 pages\n  -> Seq Scan on u\n  -> Index Scan on t using t_pk\n", os.str());
+}
+
+TEST(ExplainTest, AnalyzeTest) {
+  // more pages than frames, the first ones are read back from disk
+  DBStorageEngine engine(db_file_name, true, 16);
+  BufferPoolManager *bpm = engine.bpm_;
+  std::vector<page_id_t> page_ids(32);
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  Explain explain(true, bpm, engine.disk_mgr_);
+  uint32_t sort = explain.Add(Explain::NO_OPERATOR, "Sort");
+  uint32_t scan = explain.Add(sort, "Seq Scan on t");
+  Row row(std::vector<Field>{Field(TypeId::kTypeInt, 1)});
+  uint64_t hits = bpm->GetHitCount(), misses = bpm->GetMissCount();
+  {
+    // the scan reads the first page back, the sort fetches it again while taking a row
+    Explain::Running running(&explain, scan);
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+    bpm->UnpinPage(page_ids[0], false);
+    explain.Count(scan, 2, 0);
+    Explain::Visit output = explain.Output(scan, [&](const Row &) {
+      bpm->FetchPage(page_ids[0]);
+      bpm->UnpinPage(page_ids[0], false);
+      return true;
+    });
+    ASSERT_TRUE(output(row));
+  }
+  ASSERT_EQ(hits + 1, bpm->GetHitCount());
+  ASSERT_EQ(misses + 1, bpm->GetMissCount());
+  std::ostringstream os;
+  explain.Print(os, Explain::Clock::duration(0));
+  std::string plan = os.str();
+  ASSERT_EQ(0u, plan.find("Sort  (time="));
+  ASSERT_NE(std::string::npos, plan.find(", rows in=1 out=0, hits=1 misses=0, read=0 "));
+  ASSERT_NE(std::string::npos, plan.find("\n  -> Seq Scan on t  (time="));
+  ASSERT_NE(std::string::npos, plan.find(", rows in=2 out=1, hits=0 misses=1, read=1 "));
+  ASSERT_NE(std::string::npos, plan.find("\nParse: 0.000 ms, Plan: "));
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/external_sort.h"
+#include "gtest/gtest.h"
+#include "record/type_kernel.h"
+
+static string db_file_name = "external_sort_test.db";
+
+TEST(ExternalSortTest, SortTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   ALLOC_COLUMN(heap)("val", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  // few names, some null, a zero byte and prefixes of each other; vals of
+  // both signs with many ties, -0 among them
+  const int row_nums = 30000;
+  const char names[][4] = {"a", "ab", "b", "a\0b", "", "ba"};
+  const uint32_t name_lens[] = {1, 2, 1, 3, 0, 2};
+  std::vector<Row> rows;
+  for (int i = 0; i < row_nums; i++) {
+    uint32_t name = i % 7;
+    float val = static_cast<float>((i * 13) % 41 - 20) / 4;
+    if (val == 0 && i % 2 == 1) val = -0.0f;
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              name == 6 ? Field(TypeId::kTypeChar)
+                                        : Field(TypeId::kTypeChar, const_cast<char *>(names[name]), name_lens[name], true),
+                              Field(TypeId::kTypeFloat, val)};
+    rows.emplace_back(fields);
+  }
+  // name ascending with nulls first, val descending, then input order
+  std::vector<int> expected(row_nums);
+  for (int i = 0; i < row_nums; i++) expected[i] = i;
+  auto compare = [](const Field &lhs, const Field &rhs) {
+    if (lhs.IsNull() || rhs.IsNull()) return int(rhs.IsNull()) - int(lhs.IsNull());
+    return CompareFields(lhs, rhs);
+  };
+  std::stable_sort(expected.begin(), expected.end(), [&](int lhs, int rhs) {
+    int ret = compare(*rows[lhs].GetField(1), *rows[rhs].GetField(1));
+    if (ret == 0) ret = -compare(*rows[lhs].GetField(2), *rows[rhs].GetField(2));
+    return ret < 0;
+  });
+  struct Case {
+    uint64_t limit;
+    size_t budget;
+    bool top_n;
+    bool spilled;
+  };
+  std::vector<Case> cases{{ExternalSort::NO_LIMIT, size_t(64) << 20, false, false},
+                          {ExternalSort::NO_LIMIT, size_t(64) << 10, false, true},
+                          {10, size_t(64) << 10, true, false},
+                          {0, size_t(64) << 10, true, false},
+                          {5000, size_t(64) << 10, false, true},
+                          {5000, size_t(64) << 20, true, false}};
+  for (const auto &c : cases) {
+    ExternalSort sort(engine.bpm_, &schema, {{1, false}, {2, true}}, c.limit, c.budget);
+    for (const auto &row : rows) {
+      ASSERT_TRUE(sort.Add(row));
+    }
+    ASSERT_EQ(c.top_n, sort.IsTopN());
+    ASSERT_EQ(c.spilled, sort.GetRunCount() > 1);
+    std::vector<int> actual;
+    sort.Finish([&](const Row &row) { actual.push_back(TypeKernel<kTypeInt>::Get(*row.GetField(0))); });
+    uint64_t count = std::min<uint64_t>(c.limit, row_nums);
+    ASSERT_EQ(std::vector<int>(expected.begin(), expected.begin() + count), actual);
+  }
+}
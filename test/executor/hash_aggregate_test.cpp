@@ -0,0 +1,80 @@
+#include <map>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/hash_aggregate.h"
+#include "gtest/gtest.h"
+#include "record/type_kernel.h"
+
+static string db_file_name = "hash_aggregate_test.db";
+
+TEST(HashAggregateTest, SpillTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("grp", TypeId::kTypeChar, 16, 1, true, false),
+                                   ALLOC_COLUMN(heap)("val", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  // count, sum and max of each group, null groups are one group
+  struct Expected {
+    int count{0};
+    int64_t sum{0};
+    int max{0};
+  };
+  const int row_nums = 100000, group_nums = 20000;
+  std::map<int, Expected> expected;
+  std::vector<Row> rows;
+  for (int i = 0; i < row_nums; i++) {
+    int group = (i * 7) % group_nums;
+    std::string key = "g" + std::to_string(group);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              group == 0 ? Field(TypeId::kTypeChar)
+                                         : Field(TypeId::kTypeChar, const_cast<char *>(key.c_str()), key.size(), true),
+                              Field(TypeId::kTypeFloat, 1.5f)};
+    rows.emplace_back(fields);
+    Expected &e = expected[group == 0 ? -1 : group];
+    e.count++;
+    e.sum += i;
+    e.max = std::max(e.max, i);
+  }
+  std::vector<Aggregate> aggregates{{kAggregateCount, Aggregate::COUNT_ALL},
+                                    {kAggregateSum, 0},
+                                    {kAggregateMax, 0},
+                                    {kAggregateAvg, 2}};
+  for (size_t budget : {size_t(64) << 20, size_t(64) << 10}) {
+    HashAggregate aggregate(engine.bpm_, &schema, {1}, aggregates, budget);
+    for (const auto &row : rows) {
+      ASSERT_TRUE(aggregate.Add(row));
+    }
+    std::map<int, Expected> actual;
+    ASSERT_TRUE(aggregate.Finish([&](const Row &row) {
+      ASSERT_EQ(5u, row.GetFieldCount());
+      const Field *key = row.GetField(0);
+      int group = key->IsNull() ? -1 : std::stoi(std::string(key->GetData() + 1, key->GetLength() - 1));
+      ASSERT_EQ(0u, actual.count(group));
+      Expected &e = actual[group];
+      e.count = TypeKernel<kTypeInt>::Get(*row.GetField(1));
+      e.sum = TypeKernel<kTypeInt>::Get(*row.GetField(2));
+      e.max = TypeKernel<kTypeInt>::Get(*row.GetField(3));
+      ASSERT_FLOAT_EQ(1.5f, TypeKernel<kTypeFloat>::Get(*row.GetField(4)));
+    }));
+    ASSERT_EQ(budget < (1u << 20), aggregate.IsSpilled());
+    ASSERT_EQ(expected.size(), actual.size());
+    for (auto &entry : expected) {
+      ASSERT_EQ(entry.second.count, actual[entry.first].count);
+      ASSERT_EQ(entry.second.sum, actual[entry.first].sum);
+      ASSERT_EQ(entry.second.max, actual[entry.first].max);
+    }
+    ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  }
+  // without group keys there is one row even for no input
+  HashAggregate empty(engine.bpm_, &schema, {}, aggregates);
+  uint32_t count = 0;
+  ASSERT_TRUE(empty.Finish([&](const Row &row) {
+    count++;
+    ASSERT_EQ(0, TypeKernel<kTypeInt>::Get(*row.GetField(0)));
+    ASSERT_TRUE(row.GetField(1)->IsNull());
+    ASSERT_TRUE(row.GetField(3)->IsNull());
+  }));
+  ASSERT_EQ(1u, count);
+}
@@ -0,0 +1,110 @@
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/hash_join.h"
+#include "gtest/gtest.h"
+#include "record/schema.h"
+#include "record/type_kernel.h"
+
+static string db_file_name = "hash_join_test.db";
+
+/**
+ * Number of matches and an order independent checksum of them
+ */
+struct JoinResult {
+  uint64_t count{0};
+  uint64_t checksum{0};
+
+  void Add(int32_t build_id, int32_t probe_id) {
+    count++;
+    checksum += (static_cast<uint64_t>(build_id) * 1000003 + probe_id) * 0x9e3779b97f4a7c15ULL;
+  }
+};
+
+static JoinResult RunJoin(BufferPoolManager *bpm, Schema *build_schema, const std::vector<Row> &build_rows,
+                          Schema *probe_schema, const std::vector<Row> &probe_rows, size_t budget, bool &spilled) {
+  HashJoin join(bpm, build_schema, {1}, probe_schema, {1}, budget);
+  JoinResult result;
+  auto emit = [&](const Row &build, const Row &probe) {
+    EXPECT_EQ(CmpBool::kTrue, build.GetField(1)->CompareEquals(*probe.GetField(1)));
+    result.Add(TypeKernel<kTypeInt>::Get(*build.GetField(0)), TypeKernel<kTypeInt>::Get(*probe.GetField(0)));
+  };
+  for (const auto &row : build_rows) {
+    EXPECT_TRUE(join.Build(row));
+  }
+  for (const auto &row : probe_rows) {
+    EXPECT_TRUE(join.Probe(row, emit));
+  }
+  EXPECT_TRUE(join.Finish(emit));
+  spilled = join.IsSpilled();
+  if (spilled) {
+    EXPECT_LT(0u, join.GetSpilledPageCount());
+  }
+  return result;
+}
+
+TEST(HashJoinTest, SpillTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> build_columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                         ALLOC_COLUMN(heap)("key", TypeId::kTypeChar, 16, 1, true, false)};
+  std::vector<Column *> probe_columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                         ALLOC_COLUMN(heap)("key", TypeId::kTypeChar, 16, 1, true, false),
+                                         ALLOC_COLUMN(heap)("pad", TypeId::kTypeChar, 64, 2, true, false)};
+  Schema build_schema(build_columns), probe_schema(probe_columns);
+  char pad[64] = {0};
+  auto key_field = [](int key) {
+    if (key < 0) return Field(TypeId::kTypeChar);
+    std::string key_str = "k" + std::to_string(key);
+    return Field(TypeId::kTypeChar, const_cast<char *>(key_str.c_str()), key_str.size(), true);
+  };
+  // duplicate keys on both sides, null keys never match
+  const int build_nums = 20000, probe_nums = 12000;
+  std::vector<Row> build_rows, probe_rows;
+  std::vector<int> build_keys(build_nums), probe_keys(probe_nums);
+  for (int i = 0; i < build_nums; i++) {
+    build_keys[i] = i % 97 == 0 ? -1 : i % 5000;
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), key_field(build_keys[i])};
+    build_rows.emplace_back(fields);
+  }
+  for (int i = 0; i < probe_nums; i++) {
+    probe_keys[i] = i % 89 == 0 ? -1 : i % 7000;
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), key_field(probe_keys[i]),
+                              Field(TypeId::kTypeChar, pad, sizeof(pad), false)};
+    probe_rows.emplace_back(fields);
+  }
+  JoinResult expected;
+  std::vector<std::vector<int>> by_key(7000);
+  for (int i = 0; i < build_nums; i++) {
+    if (build_keys[i] >= 0) by_key[build_keys[i]].push_back(i);
+  }
+  for (int i = 0; i < probe_nums; i++) {
+    if (probe_keys[i] < 0) continue;
+    for (int id : by_key[probe_keys[i]]) expected.Add(id, i);
+  }
+  bool spilled;
+  JoinResult in_memory =
+      RunJoin(engine.bpm_, &build_schema, build_rows, &probe_schema, probe_rows, 16 << 20, spilled);
+  ASSERT_FALSE(spilled);
+  ASSERT_EQ(expected.count, in_memory.count);
+  ASSERT_EQ(expected.checksum, in_memory.checksum);
+  JoinResult grace = RunJoin(engine.bpm_, &build_schema, build_rows, &probe_schema, probe_rows, 64 << 10, spilled);
+  ASSERT_TRUE(spilled);
+  ASSERT_EQ(expected.count, grace.count);
+  ASSERT_EQ(expected.checksum, grace.checksum);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  // a single key cannot be partitioned, its build rows are joined a budget at a time
+  std::vector<Row> skewed_rows, skewed_probe;
+  for (int i = 0; i < 3000; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), key_field(1)};
+    skewed_rows.emplace_back(fields);
+  }
+  for (int i = 0; i < 3; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), key_field(1), Field(TypeId::kTypeChar, pad, 1, false)};
+    skewed_probe.emplace_back(fields);
+  }
+  JoinResult skewed = RunJoin(engine.bpm_, &build_schema, skewed_rows, &probe_schema, skewed_probe, 16 << 10, spilled);
+  ASSERT_TRUE(spilled);
+  ASSERT_EQ(9000u, skewed.count);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
@@ -0,0 +1,92 @@
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/index_join.h"
+#include "gtest/gtest.h"
+#include "record/type_kernel.h"
+
+static string db_file_name = "index_join_test.db";
+
+TEST(IndexJoinTest, ProbeTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("grp", TypeId::kTypeInt, 1, true, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 8, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("inner", schema.get(), &txn, table_info));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("inner", "index-grp", {"grp"}, &txn, index_info, false));
+  const int row_nums = 5000, group_nums = 700;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "n" + std::to_string(i % 3);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeInt, i % group_nums),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    Row key(std::vector<Field>{Field(TypeId::kTypeInt, i % group_nums)});
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, row.GetRowId(), nullptr));
+  }
+  // outer rows in no particular key order, with duplicates, misses and nulls
+  std::vector<Row> outer_rows;
+  for (int i = 0; i < 300; i++) {
+    int group = (i * 7919) % 1000;
+    std::string name = "n" + std::to_string(i % 4);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              i % 50 == 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, group),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    outer_rows.emplace_back(fields);
+  }
+  auto run = [&](const std::vector<uint32_t> &keys, uint64_t &count, uint64_t &checksum) {
+    IndexJoin join(table_info->GetTableHeap(), schema.get(), keys, index_info->GetIndex(), keys, 64);
+    int64_t last_rid = -1;
+    uint32_t last_batch = 0;
+    auto emit = [&](const Row &outer, const Row &inner) {
+      for (auto key : keys) {
+        ASSERT_EQ(0, CompareFields(*outer.GetField(key), *inner.GetField(key)));
+      }
+      // a batch fetches its tuples in row id order
+      if (join.GetBatchCount() != last_batch) {
+        last_batch = join.GetBatchCount();
+        last_rid = -1;
+      }
+      ASSERT_LE(last_rid, inner.GetRowId().Get());
+      last_rid = inner.GetRowId().Get();
+      count++;
+      checksum += TypeKernel<kTypeInt>::Get(*outer.GetField(0)) * 10007 + TypeKernel<kTypeInt>::Get(*inner.GetField(0));
+    };
+    for (const auto &row : outer_rows) {
+      ASSERT_TRUE(join.Probe(row, emit));
+    }
+    ASSERT_TRUE(join.Finish(emit));
+    // null keys are never buffered
+    ASSERT_EQ((outer_rows.size() - 6 + 63) / 64, join.GetBatchCount());
+  };
+  auto expect = [&](bool with_name, uint64_t &count, uint64_t &checksum) {
+    for (int i = 0; i < 300; i++) {
+      int group = (i * 7919) % 1000;
+      if (i % 50 == 0 || group >= group_nums) continue;
+      for (int j = group; j < row_nums; j += group_nums) {
+        if (with_name && i % 4 != j % 3) continue;
+        count++;
+        checksum += static_cast<uint64_t>(i) * 10007 + j;
+      }
+    }
+  };
+  uint64_t count = 0, checksum = 0, expected_count = 0, expected_checksum = 0;
+  run({1}, count, checksum);
+  expect(false, expected_count, expected_checksum);
+  ASSERT_LT(0u, count);
+  ASSERT_EQ(expected_count, count);
+  ASSERT_EQ(expected_checksum, checksum);
+  // further key columns are compared on the fetched tuples
+  count = checksum = expected_count = expected_checksum = 0;
+  run({1, 2}, count, checksum);
+  expect(true, expected_count, expected_checksum);
+  ASSERT_LT(0u, count);
+  ASSERT_EQ(expected_count, count);
+  ASSERT_EQ(expected_checksum, checksum);
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
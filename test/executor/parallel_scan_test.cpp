@@ -0,0 +1,79 @@
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/parallel_scan.h"
+#include "executor/vector_filter.h"
+#include "gtest/gtest.h"
+#include "record/type_kernel.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "parallel_scan_test.db";
+
+TEST(ParallelScanTest, ScanTest) {
+  // a small pool makes the workers evict each other's pages
+  DBStorageEngine engine(db_file_name, true, 128);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, &heap);
+  const int row_nums = 20000;
+  std::string name(40, 'x');
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  std::vector<page_id_t> page_ids;
+  ASSERT_TRUE(table_heap->GetPageIds(page_ids));
+  ASSERT_GT(page_ids.size(), 128u);
+  // every third id below 15000, in the order of a sequential scan
+  Predicate predicate({TypeId::kTypeInt, TypeId::kTypeChar});
+  predicate.AddConjunct(predicate.AddCompare(0, kCompareLess, Field(TypeId::kTypeInt, 15000)));
+  std::vector<int32_t> expected;
+  for (int i = 0; i < 15000; i += 3) expected.push_back(i);
+  for (uint32_t workers : {1u, 4u}) {
+    for (uint32_t morsel_pages : {1u, 16u}) {
+      ParallelScan scan(table_heap, predicate, workers, morsel_pages);
+      std::vector<int32_t> actual;
+      ASSERT_TRUE(scan.Run([&](const Row &row) {
+        int32_t id = TypeKernel<kTypeInt>::Get(*row.GetField(0));
+        if (id % 3 == 0) actual.push_back(id);
+        EXPECT_EQ(name.size(), row.GetField(1)->GetLength());
+        return true;
+      }));
+      ASSERT_EQ(expected, actual);
+      ASSERT_EQ((page_ids.size() + morsel_pages - 1) / morsel_pages, scan.GetMorselCount());
+      ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+    }
+  }
+  // stopping leaves most morsels unclaimed and no page pinned
+  ParallelScan scan(table_heap, predicate, 4, 1);
+  int visited = 0;
+  scan.Run([&](const Row &) { return ++visited < 10; });
+  ASSERT_EQ(10, visited);
+  ASSERT_LT(scan.GetMorselCount(), page_ids.size());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  // a predicate which never holds selects nothing
+  Predicate never({TypeId::kTypeInt, TypeId::kTypeChar});
+  never.AddConjunct(never.AddConstant(false));
+  ParallelScan empty(table_heap, never, 4);
+  empty.Run([&](const Row &) {
+    ADD_FAILURE();
+    return true;
+  });
+  // with every frame pinned the pages cannot be fetched, scans fail instead of ending early
+  std::vector<page_id_t> pinned(128);
+  for (auto &page_id : pinned) {
+    ASSERT_NE(nullptr, engine.bpm_->NewPage(page_id));
+  }
+  ParallelScan failed(table_heap, predicate, 4);
+  ASSERT_FALSE(failed.Run([](const Row &) { return true; }));
+  ASSERT_FALSE(table_heap->ScanBatches(VectorFilter::BATCH_SIZE, 16, [](const RowView *, uint32_t) { return true; }));
+  for (auto page_id : pinned) {
+    engine.bpm_->UnpinPage(page_id, false);
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
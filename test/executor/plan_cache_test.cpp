@@ -0,0 +1,152 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "executor/execute_engine.h"
+#include "executor/plan_cache.h"
+#include "gtest/gtest.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+/**
+ * Parse sql and copy its syntax tree
+ */
+static std::unique_ptr<PreparedStatement> Prepare(const char *sql, bool literal_parameters) {
+  YY_BUFFER_STATE bp = yy_scan_string(sql);
+  yy_switch_to_buffer(bp);
+  MinisqlParserInit();
+  yyparse();
+  EXPECT_EQ(0, MinisqlParserGetError());
+  std::unique_ptr<PreparedStatement> statement(new PreparedStatement(MinisqlGetParserRootNode(), literal_parameters));
+  MinisqlParserFinish();
+  yy_delete_buffer(bp);
+  yylex_destroy();
+  return statement;
+}
+
+TEST(PlanCacheTest, NormalizeTest) {
+  std::string key, other;
+  std::vector<Literal> literals;
+  ASSERT_TRUE(PlanCache::Normalize("  insert into t1 values(1,  \"a b\", -2.5, null) ;", key, literals));
+  ASSERT_EQ("insert into t1 values(?, ?, ?, null) ;", key);
+  ASSERT_EQ(3u, literals.size());
+  ASSERT_EQ(kNodeNumber, literals[0].type_);
+  ASSERT_EQ("1", literals[0].val_);
+  ASSERT_EQ(kNodeString, literals[1].type_);
+  ASSERT_EQ("a b", literals[1].val_);
+  ASSERT_EQ("-2.5", literals[2].val_);
+  // statements differing in their literals share the key
+  ASSERT_TRUE(PlanCache::Normalize("insert into t1 values(20, \"x\", .5, null) ;", other, literals));
+  ASSERT_EQ(key, other);
+  ASSERT_TRUE(PlanCache::Normalize("select * from t where t.a = 3 and b <> \"c\\\"d\" limit 10;", key, literals));
+  ASSERT_EQ("select * from t where t.a = ? and b <> ? limit ?;", key);
+  ASSERT_EQ("c\\\"d", literals[1].val_);
+  // other statements, user parameters and open strings are not cached
+  ASSERT_FALSE(PlanCache::Normalize("create table t(a char(16));", key, literals));
+  ASSERT_FALSE(PlanCache::Normalize("selection;", key, literals));
+  ASSERT_FALSE(PlanCache::Normalize("select * from t where a = ?;", key, literals));
+  ASSERT_FALSE(PlanCache::Normalize("select * from t where a = \"b;", key, literals));
+}
+
+TEST(PlanCacheTest, BindTest) {
+  // parameters bind in text order, whatever the order of the tree
+  auto statement = Prepare("select * from t join u on t.a = ? where b < ? and c = ? limit ?;", false);
+  ASSERT_EQ(4u, statement->GetParameterCount());
+  ASSERT_FALSE(statement->Bind({{kNodeNumber, "1"}}));
+  ASSERT_TRUE(statement->Bind({{kNodeNumber, "1"}, {kNodeString, "s"}, {kNodeNull, ""}, {kNodeNumber, "5"}}));
+  pSyntaxNode tree = statement->GetTree();
+  pSyntaxNode limit = tree->child_;
+  while (limit->type_ != kNodeLimit) limit = limit->next_;
+  ASSERT_EQ(kNodeNumber, limit->child_->type_);
+  ASSERT_STREQ("5", limit->child_->val_);
+  // a longer value than the last one bound
+  ASSERT_TRUE(statement->Bind({{kNodeNumber, "1"}, {kNodeString, "s"}, {kNodeNull, ""}, {kNodeNumber, "123456789"}}));
+  ASSERT_STREQ("123456789", limit->child_->val_);
+
+  // copies for the plan cache take the literals as parameters
+  auto insert = Prepare("insert into t values(1, \"a\", null, 2.5);", true);
+  ASSERT_EQ(3u, insert->GetParameterCount());
+  ASSERT_TRUE(insert->Bind({{kNodeNumber, "7"}, {kNodeString, "bb"}, {kNodeNumber, "0.5"}}));
+  pSyntaxNode value = insert->GetTree()->child_->next_->child_;
+  ASSERT_STREQ("7", value->val_);
+  ASSERT_STREQ("bb", value->next_->val_);
+  ASSERT_EQ(nullptr, value->next_->next_->val_);
+  ASSERT_STREQ("0.5", value->next_->next_->next_->val_);
+}
+
+TEST(PlanCacheTest, EvictTest) {
+  PlanCache cache(2);
+  cache.Insert("a", Prepare("delete from t;", true));
+  cache.Insert("b", Prepare("delete from u;", true));
+  ASSERT_NE(nullptr, cache.Find("a"));
+  // b is the least recently used
+  cache.Insert("c", Prepare("delete from v;", true));
+  ASSERT_EQ(2u, cache.GetSize());
+  ASSERT_EQ(nullptr, cache.Find("b"));
+  ASSERT_STREQ("t", cache.Find("a")->GetTree()->child_->val_);
+  ASSERT_STREQ("v", cache.Find("c")->GetTree()->child_->val_);
+}
+
+/**
+ * Execute sql, returning what it prints
+ */
+static std::string Output(ExecuteEngine &engine, const std::string &sql) {
+  ExecuteContext context;
+  std::ostringstream os;
+  std::streambuf *console = std::cout.rdbuf(os.rdbuf());
+  engine.ExecuteSql(sql.c_str(), &context);
+  std::cout.rdbuf(console);
+  return os.str();
+}
+
+/**
+ * Statement the engine cached for sql
+ */
+static PreparedStatement *Cached(ExecuteEngine &engine, const std::string &sql) {
+  std::string key;
+  std::vector<Literal> literals;
+  EXPECT_TRUE(PlanCache::Normalize(sql.c_str(), key, literals));
+  PreparedStatement *statement = engine.GetPlanCache().Find(key);
+  EXPECT_NE(nullptr, statement) << sql;
+  return statement;
+}
+
+TEST(PlanCacheTest, ResolveOnceTest) {
+  ExecuteEngine engine;
+  Output(engine, "create database plan_cache_test;");
+  Output(engine, "use plan_cache_test;");
+  Output(engine, "create table t(id int, name char(16), score int, primary key(id));");
+  Output(engine, "create index t_score on t(score);");
+  for (int i = 0; i < 10; i++) {
+    Output(engine, "insert into t values(" + std::to_string(i) + ", \"a\", " + std::to_string(i) + ");");
+  }
+  // the second of each pair runs the table, indexes and condition of the first, bound to other literals
+  std::vector<std::pair<std::string, std::string>> runs = {
+      {"select id from t where score >= 2 and id < 5;", "Select Success, Affects 3 Record!"},
+      {"select id from t where score >= 7 and id < 9;", "Select Success, Affects 2 Record!"},
+      {"update t set name = \"b\" where score < 2;", "Update Success, Affects 2 Record!"},
+      {"update t set name = \"c\" where score < 5;", "Update Success, Affects 5 Record!"},
+      {"delete from t where name = \"c\";", "Delete Success, Affects 5 Record!"},
+      {"delete from t where name = \"a\";", "Delete Success, Affects 5 Record!"}};
+  for (auto &run : runs) {
+    std::string rows = Output(engine, run.first);
+    ASSERT_NE(std::string::npos, rows.find(run.second)) << rows;
+  }
+  for (uint32_t i = 0; i < runs.size(); i += 2) {
+    PreparedStatement *statement = Cached(engine, runs[i].first);
+    ASSERT_EQ(1u, statement->resolve_count_) << runs[i].first;
+    ASSERT_EQ(1u, statement->compile_count_) << runs[i].first;
+  }
+  ASSERT_EQ(Cached(engine, runs[4].first), Cached(engine, runs[5].first));
+
+  // any DDL makes them resolve and compile again
+  Output(engine, "create index t_name on t(name);");
+  Output(engine, runs[0].first);
+  ASSERT_EQ(2u, Cached(engine, runs[0].first)->resolve_count_);
+  ASSERT_EQ(2u, Cached(engine, runs[0].first)->compile_count_);
+  Output(engine, "drop database plan_cache_test;");
+}
@@ -0,0 +1,187 @@
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/vector_filter.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "vector_filter_test.db";
+
+TEST(VectorFilterTest, SelectTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   ALLOC_COLUMN(heap)("val", TypeId::kTypeFloat, 2, true, false),
+                                   ALLOC_COLUMN(heap)("grp", TypeId::kTypeInt, 3, true, false)};
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, &heap);
+  // every tenth name and every seventh grp null
+  const int row_nums = 5000;
+  const char *names[] = {"a", "ab", "b", "abc"};
+  auto name_of = [&](int i) { return i % 10 == 3 ? nullptr : names[i % 4]; };
+  auto val_of = [](int i) { return static_cast<float>(i % 97) / 2 - 10; };
+  auto grp_of = [](int i) { return i % 7 == 0 ? -1 : i % 31; };
+  for (int i = 0; i < row_nums; i++) {
+    const char *name = name_of(i);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              name == nullptr ? Field(TypeId::kTypeChar)
+                                              : Field(TypeId::kTypeChar, const_cast<char *>(name), strlen(name), true),
+                              Field(TypeId::kTypeFloat, val_of(i)),
+                              grp_of(i) < 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, grp_of(i))};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  // (id < 4000 and name >= "ab") or grp is null, val > grp, val <> 3
+  Predicate predicate({TypeId::kTypeInt, TypeId::kTypeChar, TypeId::kTypeFloat, TypeId::kTypeInt});
+  char ab[] = "ab";
+  uint32_t id = predicate.AddCompare(0, kCompareLess, Field(TypeId::kTypeInt, 4000));
+  uint32_t name = predicate.AddCompare(1, kCompareGreaterEqual, Field(TypeId::kTypeChar, ab, 2, false));
+  uint32_t both = predicate.AddConnector(true, id, name);
+  predicate.AddConjunct(predicate.AddConnector(false, both, predicate.AddNullTest(3, true)));
+  predicate.AddConjunct(predicate.AddCompareColumns(2, kCompareGreater, 3));
+  predicate.AddConjunct(predicate.AddCompare(2, kCompareNotEqual, Field(TypeId::kTypeFloat, 3.0f)));
+  // conditions known to hold drop out, those known to fail empty the result
+  predicate.AddConjunct(predicate.AddConnector(false, predicate.AddCompareColumns(0, kCompareEqual, 0),
+                                               predicate.AddConstant(true)));
+  ASSERT_FALSE(predicate.IsFalse());
+  VectorFilter filter(predicate);
+  std::vector<int> expected;
+  for (int i = 0; i < row_nums; i++) {
+    const char *n = name_of(i);
+    bool first = (i < 4000 && n != nullptr && strcmp(n, "ab") >= 0) || grp_of(i) < 0;
+    bool second = grp_of(i) >= 0 && val_of(i) > grp_of(i);
+    if (first && second && val_of(i) != 3.0f) expected.push_back(i);
+  }
+  // small batches over few pages cross page boundaries mid-page
+  for (uint32_t batch_size : {VectorFilter::BATCH_SIZE, 100u}) {
+    for (uint32_t max_pages : {16u, 1u}) {
+      std::vector<int> actual;
+      uint16_t selection[VectorFilter::BATCH_SIZE];
+      table_heap->ScanBatches(batch_size, max_pages, [&](const RowView *views, uint32_t count) {
+        EXPECT_LE(count, batch_size);
+        uint32_t selected = filter.Select(views, count, selection);
+        for (uint32_t i = 0, j = 0; i < count; i++) {
+          // evaluated a row at a time the predicate selects the same rows
+          bool chosen = j < selected && selection[j] == i;
+          EXPECT_EQ(chosen, predicate.Match(views[i]));
+          j += chosen;
+        }
+        for (uint32_t i = 0; i < selected; i++) {
+          actual.push_back(views[selection[i]].GetInt(0));
+        }
+        return true;
+      });
+      ASSERT_EQ(expected, actual);
+    }
+  }
+  Predicate never = predicate;
+  never.AddConjunct(never.AddCompare(1, kCompareEqual, Field(TypeId::kTypeChar)));
+  ASSERT_TRUE(never.IsFalse());
+  VectorFilter empty(never);
+  table_heap->ScanBatches(VectorFilter::BATCH_SIZE, 16, [&](const RowView *views, uint32_t count) {
+    uint16_t selection[VectorFilter::BATCH_SIZE];
+    EXPECT_EQ(0u, empty.Select(views, count, selection));
+    EXPECT_FALSE(never.Match(views[0]));
+    return true;
+  });
+  // names far below "x" in the collation
+  Predicate below({TypeId::kTypeInt, TypeId::kTypeChar, TypeId::kTypeFloat, TypeId::kTypeInt});
+  char x[] = "x";
+  below.AddConjunct(below.AddCompare(1, kCompareLess, Field(TypeId::kTypeChar, x, 1, false)));
+  VectorFilter lower(below);
+  table_heap->ScanBatches(VectorFilter::BATCH_SIZE, 16, [&](const RowView *views, uint32_t count) {
+    uint16_t selection[VectorFilter::BATCH_SIZE];
+    uint32_t selected = lower.Select(views, count, selection);
+    for (uint32_t i = 0, j = 0; i < count; i++) {
+      bool chosen = j < selected && selection[j] == i;
+      EXPECT_EQ(!views[i].IsNull(1), chosen);
+      EXPECT_EQ(chosen, below.Match(views[i]));
+      j += chosen;
+    }
+    return true;
+  });
+  // the scan stops as soon as visit says so
+  uint32_t batches = 0;
+  table_heap->ScanBatches(100, 16, [&](const RowView *, uint32_t) { return ++batches < 3; });
+  ASSERT_EQ(3u, batches);
+}
+
+TEST(VectorFilterTest, CompareNumberTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false),
+                                   ALLOC_COLUMN(heap)("val", TypeId::kTypeFloat, 1, true, false)};
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, &heap);
+  // ids -50..49, every ninth one null
+  const int row_nums = 100;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{i % 9 == 0 ? Field(TypeId::kTypeInt) : Field(TypeId::kTypeInt, i - 50),
+                              Field(TypeId::kTypeFloat, static_cast<float>(i) / 4)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  auto select = [&](const Predicate &predicate) {
+    VectorFilter filter(predicate);
+    std::vector<int> actual;
+    table_heap->ScanBatches(VectorFilter::BATCH_SIZE, 16, [&](const RowView *views, uint32_t count) {
+      uint16_t selection[VectorFilter::BATCH_SIZE];
+      uint32_t selected = filter.Select(views, count, selection);
+      for (uint32_t i = 0, j = 0; i < count; i++) {
+        bool chosen = j < selected && selection[j] == i;
+        EXPECT_EQ(chosen, predicate.Match(views[i]));
+        j += chosen;
+      }
+      for (uint32_t i = 0; i < selected; i++) {
+        actual.push_back(static_cast<int>(views[selection[i]].GetFloat(1) * 4));
+      }
+      return true;
+    });
+    return actual;
+  };
+  auto expect = [&](const std::function<bool(int)> &holds) {
+    std::vector<int> expected;
+    for (int i = 0; i < row_nums; i++) {
+      if (i % 9 != 0 && holds(i - 50)) expected.push_back(i);
+    }
+    return expected;
+  };
+  std::vector<TypeId> types{TypeId::kTypeInt, TypeId::kTypeFloat};
+  // an int column against a fraction compares as doubles, not truncated
+  Predicate less(types);
+  less.AddConjunct(less.AddCompareNumber(0, kCompareLess, 2.5));
+  less.AddConjunct(less.AddCompareNumber(0, kCompareGreaterEqual, -2.5));
+  ASSERT_EQ(expect([](int id) { return id < 2.5 && id >= -2.5; }), select(less));
+  // comparisons no value can change fold into constants and null tests
+  Predicate equal(types);
+  equal.AddConjunct(equal.AddCompareNumber(0, kCompareEqual, 2.5));
+  ASSERT_TRUE(equal.IsFalse());
+  Predicate above(types);
+  above.AddConjunct(above.AddCompareNumber(0, kCompareGreater, 1e10));
+  ASSERT_TRUE(above.IsFalse());
+  Predicate not_equal(types);
+  not_equal.AddConjunct(not_equal.AddCompareNumber(0, kCompareNotEqual, 2.5));
+  not_equal.AddConjunct(not_equal.AddCompareNumber(0, kCompareLess, 1e10));
+  ASSERT_FALSE(not_equal.IsFalse());
+  ASSERT_EQ(expect([](int) { return true; }), select(not_equal));
+  // a whole number compares in the column type, a float column widens too
+  Predicate whole(types);
+  whole.AddConjunct(whole.AddCompareNumber(0, kCompareLessEqual, 2.0));
+  whole.AddConjunct(whole.AddCompareNumber(1, kCompareGreater, 0.1));
+  ASSERT_EQ(expect([](int id) { return id <= 2 && (id + 50) / 4.0 > 0.1; }), select(whole));
+  // a parameter never holds until bound, the comparison with each value bound takes its place
+  Predicate bound(types);
+  bound.AddConjunct(bound.AddParameter(0, kCompareLess, 0));
+  bound.AddConjunct(bound.AddCompareNumber(1, kCompareGreater, 2.0));
+  ASSERT_TRUE(select(bound).empty());
+  bound.BindParameter(0, bound.AddCompareNumber(0, kCompareLess, 2.5));
+  ASSERT_EQ(expect([](int id) { return id < 2.5 && (id + 50) / 4.0 > 2; }), select(bound));
+  bound.BindParameter(0, bound.AddCompareNumber(0, kCompareLess, -1e10));
+  ASSERT_TRUE(bound.IsFalse());
+  bound.BindParameter(0, bound.AddCompareNumber(0, kCompareLess, -40.0));
+  ASSERT_FALSE(bound.IsFalse());
+  ASSERT_EQ(expect([](int id) { return id < -40 && (id + 50) / 4.0 > 2; }), select(bound));
+}
@@ -1,9 +1,18 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
 #include <string>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/b_plus_tree_index.h"
+#include "index/covering_b_plus_tree_index.h"
 #include "index/generic_key.h"
+#include "index/native_key.h"
+#include "index/packed_key.h"
+#include "page/disk_file_meta_page.h"
+#include "page/index_roots_page.h"
+#include "record/row_comparator.h"
 
 static const std::string db_name = "bp_tree_index_test.db";
 
@@ -78,4 +87,486 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     ASSERT_EQ(i, (*iter).second.GetSlotNum());
     i++;
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, BPlusTreeIndexNonUniqueTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("status", TypeId::kTypeInt, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  // duplicates of a key span several leaves
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_, false);
+  const int row_nums = 1000, status_nums = 7;
+  auto make_key = [](int status) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, status)};
+    return Row(std::move(fields));
+  };
+  auto count = [&](int status) { return static_cast<size_t>((row_nums - status + status_nums - 1) / status_nums); };
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_key(i % status_nums), RowId(1000 + i / 100, i % 100), nullptr));
+  }
+  // every duplicate is found, in row id order
+  for (int status = 0; status < status_nums; status++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(make_key(status), ret, nullptr));
+    ASSERT_EQ(count(status), ret.size());
+    for (size_t j = 0; j < ret.size(); j++) {
+      int i = (ret[j].GetPageId() - 1000) * 100 + ret[j].GetSlotNum();
+      ASSERT_EQ(status, i % status_nums);
+      if (j > 0) {
+        ASSERT_LT(ret[j - 1].Get(), ret[j].Get());
+      }
+    }
+  }
+  // remove a single entry of a duplicate key
+  ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(make_key(3), RowId(1000, 3), nullptr));
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(make_key(3), ret, nullptr));
+  ASSERT_EQ(count(3) - 1, ret.size());
+  for (auto rid : ret) {
+    ASSERT_FALSE(rid == RowId(1000, 3));
+  }
+  // inclusive range over several keys
+  ret.clear();
+  Row low = make_key(2), high = make_key(4);
+  ASSERT_EQ(DB_SUCCESS, index->ScanRange(&low, &high, ret, nullptr));
+  ASSERT_EQ(count(2) + count(3) - 1 + count(4), ret.size());
+  ret.clear();
+  Row missing = make_key(status_nums);
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(missing, ret, nullptr));
+  ASSERT_TRUE(ret.empty());
+}
+
+/**
+ * Keys of (int, char(64)) sharing a long prefix, as a naming scheme would
+ */
+static Row MakeNameKey(int i) {
+  char name[64];
+  int len = snprintf(name, sizeof(name), "warehouse/district-%02d/customer-%06d", i % 10, i);
+  std::vector<Field> fields{
+          Field(TypeId::kTypeInt, i % 10),
+          Field(TypeId::kTypeChar, name, len, true)
+  };
+  return Row(std::move(fields));
+}
+
+template<typename KeyType, typename KeyComparator>
+static uint32_t FillNameIndex(const std::string &file_name, const std::vector<int> &ids) {
+  using BP_TREE_INDEX = BPlusTreeIndex<KeyType, RowId, KeyComparator>;
+  remove(file_name.c_str());
+  DBStorageEngine engine(file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("district", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0, 1}, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  for (int i : ids) {
+    EXPECT_EQ(DB_SUCCESS, index->InsertEntry(MakeNameKey(i), RowId(i), nullptr));
+  }
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(engine.disk_mgr_->GetMetaData());
+  return meta_page->GetAllocatedPages();
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexPackedKeyTest) {
+  using INDEX_KEY_TYPE = PackedKey<128>;
+  using INDEX_COMPARATOR_TYPE = PackedComparator<128>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("district", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0, 1}, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  const int row_nums = 20000;
+  std::vector<int> ids(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  for (int i : ids) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(MakeNameKey(i), RowId(i), nullptr));
+  }
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(MakeNameKey(ids[0]), RowId(ids[0]), nullptr));
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeNameKey(i), ret, nullptr));
+    ASSERT_EQ(1u, ret.size());
+    ASSERT_EQ(i, ret[0].Get());
+  }
+  // remove two thirds in random order, leaves merge and borrow
+  for (int j = 0; j < row_nums; j++) {
+    if (ids[j] % 3 != 0) {
+      ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(MakeNameKey(ids[j]), RowId(ids[j]), nullptr));
+    }
+  }
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(i % 3 == 0 ? DB_SUCCESS : DB_KEY_NOT_FOUND, index->ScanKey(MakeNameKey(i), ret, nullptr));
+  }
+  // leaves that could neither merge nor borrow were left underfull, the lookups above still found every key
+  using LeafPage = BPlusTreeLeafPage<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  using InternalPage = BPlusTreeInternalPage<INDEX_KEY_TYPE, page_id_t, INDEX_COMPARATOR_TYPE>;
+  auto *roots = reinterpret_cast<IndexRootsPage *>(engine.bpm_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  page_id_t page_id;
+  ASSERT_TRUE(roots->GetRootId(0, &page_id));
+  engine.bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  auto *node = reinterpret_cast<BPlusTreePage *>(engine.bpm_->FetchPage(page_id)->GetData());
+  while (!node->IsLeafPage()) {
+    page_id_t child_id = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    engine.bpm_->UnpinPage(page_id, false);
+    page_id = child_id;
+    node = reinterpret_cast<BPlusTreePage *>(engine.bpm_->FetchPage(page_id)->GetData());
+  }
+  int underfull = 0;
+  while (true) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    underfull += leaf->IsUnderflow() ? 1 : 0;
+    page_id_t next_page_id = leaf->GetNextPageId();
+    engine.bpm_->UnpinPage(page_id, false);
+    if (next_page_id == INVALID_PAGE_ID) break;
+    page_id = next_page_id;
+    node = reinterpret_cast<BPlusTreePage *>(engine.bpm_->FetchPage(page_id)->GetData());
+  }
+  ASSERT_GT(underfull, 0);
+  // the leaves stay in key order, decoded keys match the inserted ones
+  RowComparator row_comparator(index_schema);
+  Row prev(INVALID_ROWID);
+  int count = 0;
+  for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter) {
+    Row key(INVALID_ROWID);
+    (*iter).first.DeserializeToKey(key, index_schema);
+    Row expected = MakeNameKey((*iter).second.Get());
+    ASSERT_EQ(0, row_comparator.Compare(expected, key));
+    if (count > 0) {
+      ASSERT_LT(row_comparator.Compare(prev, key), 0);
+    }
+    prev = std::move(key);
+    count++;
+  }
+  ASSERT_EQ((row_nums + 2) / 3, count);
+  std::vector<RowId> ret;
+  Row low = MakeNameKey(3), high = MakeNameKey(93);
+  ASSERT_EQ(DB_SUCCESS, index->ScanRange(&low, &high, ret, nullptr));
+  ASSERT_EQ(4u, ret.size());
+  // prefix compression and short separators take far fewer pages than fixed slots
+  uint32_t packed_pages = FillNameIndex<INDEX_KEY_TYPE, INDEX_COMPARATOR_TYPE>("bp_tree_packed_test.db", ids);
+  uint32_t generic_pages = FillNameIndex<GenericKey<128>, GenericComparator<128>>("bp_tree_generic_test.db", ids);
+  ASSERT_LT(packed_pages * 2, generic_pages);
+}
+
+static Row MakeIntKey(int value) {
+  std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+  return Row(std::move(fields));
+}
+
+TEST(BPlusTreeTests, CoveringIndexTest) {
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false),
+          ALLOC_COLUMN(heap)("district", TypeId::kTypeInt, 1, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 2, true, false)
+  };
+  const TableSchema table_schema(columns);
+  // unique on id, district and name included
+  auto *entry_schema = Schema::ShallowCopySchema(&table_schema, {0, 1, 2}, &heap);
+  auto *index = ALLOC(heap, CoveringBPlusTreeIndex<128>)(0, entry_schema, engine.bpm_, true, 1);
+  auto make_entry = [](int i) {
+    Row name_key = MakeNameKey(i);
+    std::vector<Field> fields;
+    fields.emplace_back(TypeId::kTypeInt, i);
+    fields.emplace_back(*name_key.GetField(0));
+    fields.emplace_back(*name_key.GetField(1));
+    return Row(std::move(fields));
+  };
+  const int row_nums = 5000;
+  std::vector<int> ids(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  for (int i : ids) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_entry(i), RowId(i), nullptr));
+  }
+  // uniqueness holds on the key alone, whatever the included values
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(make_entry(ids[0]), RowId(row_nums), nullptr));
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(42), ret, nullptr));
+  ASSERT_EQ(1u, ret.size());
+  ASSERT_EQ(42, ret[0].Get());
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(MakeIntKey(row_nums), ret, nullptr));
+  // entries come back decoded in key order, included values and row id intact
+  RowComparator row_comparator(entry_schema);
+  Row low = MakeIntKey(100), high = MakeIntKey(199);
+  std::vector<Row *> entries;
+  ASSERT_EQ(DB_SUCCESS, index->ScanRangeEntries(&low, &high, entries, &heap, nullptr));
+  ASSERT_EQ(100u, entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    ASSERT_EQ(100 + static_cast<int64_t>(i), entries[i]->GetRowId().Get());
+    ASSERT_EQ(0, row_comparator.Compare(make_entry(100 + i), *entries[i]));
+    delete entries[i];
+  }
+  entries.clear();
+  for (int i : ids) {
+    if (i % 2 == 1) {
+      ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(make_entry(i), RowId(i), nullptr));
+    }
+  }
+  ASSERT_EQ(DB_SUCCESS, index->ScanRangeEntries(nullptr, &high, entries, &heap, nullptr));
+  ASSERT_EQ(100u, entries.size());
+  for (auto entry : entries) {
+    delete entry;
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  // a non-unique key prefix selects every entry of the key, ordered by the included name
+  auto *district_schema = Schema::ShallowCopySchema(&table_schema, {1, 2}, &heap);
+  auto *district_index = ALLOC(heap, CoveringBPlusTreeIndex<128>)(1, district_schema, engine.bpm_, false, 1);
+  for (int i : ids) {
+    ASSERT_EQ(DB_SUCCESS, district_index->InsertEntry(MakeNameKey(i), RowId(i), nullptr));
+  }
+  RowComparator district_comparator(district_schema);
+  Row district = MakeIntKey(3);
+  entries.clear();
+  ASSERT_EQ(DB_SUCCESS, district_index->ScanRangeEntries(&district, &district, entries, &heap, nullptr));
+  ASSERT_EQ(static_cast<size_t>(row_nums / 10), entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    ASSERT_EQ(0, district_comparator.Compare(MakeNameKey(entries[i]->GetRowId().Get()), *entries[i]));
+    if (i > 0) {
+      ASSERT_LT(entries[i - 1]->GetRowId().Get(), entries[i]->GetRowId().Get());
+    }
+  }
+  for (auto entry : entries) {
+    delete entry;
+  }
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, district_index->ScanKey(district, ret, nullptr));
+  ASSERT_EQ(static_cast<size_t>(row_nums / 10), ret.size());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(BPlusTreeTests, ReverseIteratorTest) {
+  using BP_TREE_INDEX = BPlusTreeIndex<PackedKey<32>, RowId, PackedComparator<32>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  // even keys only, odd keys probe the gaps
+  const int row_nums = 20000;
+  std::vector<int> keys(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    keys[i] = i * 2;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (int key : keys) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(MakeIntKey(key), RowId(key), nullptr));
+  }
+  auto make_key = [&](int value) {
+    PackedKey<32> key;
+    key.SerializeFromKey(MakeIntKey(value), index_schema);
+    return key;
+  };
+  // a whole backward walk crosses every leaf
+  {
+    int expected = (row_nums - 1) * 2;
+    for (auto iter = index->GetRBeginIterator(); !iter.IsEnd(); --iter) {
+      ASSERT_EQ(expected, (*iter).second.Get());
+      expected -= 2;
+    }
+    ASSERT_EQ(-2, expected);
+  }
+  {
+    auto iter = index->GetRBeginIterator(make_key(1001));
+    ASSERT_EQ(1000, (*iter).second.Get());
+    --iter;
+    ASSERT_EQ(998, (*iter).second.Get());
+    ++iter;
+    ASSERT_EQ(1000, (*iter).second.Get());
+  }
+  ASSERT_EQ(1000, (*index->GetRBeginIterator(make_key(1000))).second.Get());
+  ASSERT_TRUE(index->GetRBeginIterator(make_key(-1)).IsEnd());
+  ASSERT_EQ((row_nums - 1) * 2, (*index->GetRBeginIterator(make_key(row_nums * 2))).second.Get());
+  // descending range scans stop at the low bound or the limit
+  std::vector<RowId> ret;
+  Row low = MakeIntKey(101), high = MakeIntKey(300);
+  ASSERT_EQ(DB_SUCCESS, index->ScanRangeReverse(&low, &high, ret, UINT32_MAX, nullptr));
+  ASSERT_EQ(100u, ret.size());
+  for (size_t i = 0; i < ret.size(); i++) {
+    ASSERT_EQ(300 - 2 * static_cast<int>(i), ret[i].Get());
+  }
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index->ScanRangeReverse(nullptr, nullptr, ret, 1, nullptr));
+  ASSERT_EQ(1u, ret.size());
+  ASSERT_EQ((row_nums - 1) * 2, ret[0].Get());
+  ret.clear();
+  Row gap = MakeIntKey(501);
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanRangeReverse(&gap, &gap, ret, UINT32_MAX, nullptr));
+  // ascending ones the same from the low bound up
+  ASSERT_EQ(DB_SUCCESS, index->ScanRangeForward(&low, &high, ret, UINT32_MAX, nullptr));
+  ASSERT_EQ(100u, ret.size());
+  for (size_t i = 0; i < ret.size(); i++) {
+    ASSERT_EQ(102 + 2 * static_cast<int>(i), ret[i].Get());
+  }
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index->ScanRangeForward(nullptr, nullptr, ret, 3, nullptr));
+  ASSERT_EQ(3u, ret.size());
+  ASSERT_EQ(4, ret[2].Get());
+  ret.clear();
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanRangeForward(&gap, &gap, ret, UINT32_MAX, nullptr));
+  // the first keys skip the null one, which sorts first
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(std::vector<Field>{Field(TypeId::kTypeInt)}), RowId(1), nullptr));
+  Row first(INVALID_ROWID), last(INVALID_ROWID);
+  ASSERT_EQ(DB_SUCCESS, index->ScanFirstKey(false, first, nullptr));
+  ASSERT_EQ(DB_SUCCESS, index->ScanFirstKey(true, last, nullptr));
+  ASSERT_EQ(CmpBool::kTrue, first.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 0)));
+  ASSERT_EQ(CmpBool::kTrue, last.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, (row_nums - 1) * 2)));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  // duplicates of a non-unique covering index come back newest entry first
+  std::vector<Column *> entry_columns = {
+          ALLOC_COLUMN(heap)("district", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 1, false, false)
+  };
+  const TableSchema entry_table_schema(entry_columns);
+  auto *entry_schema = Schema::ShallowCopySchema(&entry_table_schema, {0, 1}, &heap);
+  auto *district_index = ALLOC(heap, CoveringBPlusTreeIndex<32>)(1, entry_schema, engine.bpm_, false, 1);
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields;
+    fields.emplace_back(TypeId::kTypeInt, i % 10);
+    fields.emplace_back(TypeId::kTypeInt, i);
+    ASSERT_EQ(DB_SUCCESS, district_index->InsertEntry(Row(std::move(fields)), RowId(i), nullptr));
+  }
+  ret.clear();
+  Row district = MakeIntKey(3);
+  ASSERT_EQ(DB_SUCCESS, district_index->ScanRangeReverse(&district, &district, ret, 5, nullptr));
+  ASSERT_EQ(5u, ret.size());
+  for (size_t i = 0; i < ret.size(); i++) {
+    ASSERT_EQ(row_nums - 7 - 10 * static_cast<int>(i), ret[i].Get());
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(BPlusTreeTests, ScanKeysTest) {
+  using UNIQUE_INDEX = BPlusTreeIndex<NativeKey<int32_t, 8>, RowId, NativeComparator<int32_t, 8>>;
+  using NON_UNIQUE_INDEX = BPlusTreeIndex<NativeKey<int32_t, 16>, RowId, NativeComparator<int32_t, 16>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  auto *unique_index = ALLOC(heap, UNIQUE_INDEX)(0, index_schema, engine.bpm_, true);
+  auto *non_unique_index = ALLOC(heap, NON_UNIQUE_INDEX)(1, index_schema, engine.bpm_, false);
+  // even keys only; 100 distinct keys with 300 entries each cross leaves
+  const int row_nums = 30000;
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(DB_SUCCESS, unique_index->InsertEntry(MakeIntKey(i * 2), RowId(i), nullptr));
+    ASSERT_EQ(DB_SUCCESS, non_unique_index->InsertEntry(MakeIntKey(i % 100 * 2), RowId(i), nullptr));
+  }
+  // unsorted probes with repeats and absent keys, grouped like one ScanKey each
+  std::vector<Row> keys;
+  for (int i = 0; i < 5000; i++) {
+    keys.push_back(MakeIntKey((i * 7919) % (row_nums * 2 + 10) - 5));
+  }
+  keys.push_back(MakeIntKey(42));
+  keys.push_back(MakeIntKey(42));
+  for (Index *index : std::vector<Index *>{unique_index, non_unique_index}) {
+    std::vector<std::vector<RowId>> result;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKeys(keys, result, nullptr));
+    ASSERT_EQ(keys.size(), result.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      std::vector<RowId> expected;
+      if (index->ScanKey(keys[i], expected, nullptr) != DB_SUCCESS) {
+        expected.clear();
+      }
+      ASSERT_EQ(expected.size(), result[i].size());
+      for (size_t j = 0; j < expected.size(); j++) {
+        ASSERT_EQ(expected[j].Get(), result[i][j].Get());
+      }
+    }
+    ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  }
+  std::vector<std::vector<RowId>> result;
+  std::vector<Row> missing{MakeIntKey(-1), MakeIntKey(3)};
+  ASSERT_EQ(DB_KEY_NOT_FOUND, unique_index->ScanKeys(missing, result, nullptr));
+  ASSERT_TRUE(result[0].empty() && result[1].empty());
+  // a batch of every other key fetches fewer pages than one descent per key
+  keys.clear();
+  for (int i = row_nums - 1; i >= 0; i -= 2) {
+    keys.push_back(MakeIntKey(i * 2));
+  }
+  auto fetches = [&]() { return engine.bpm_->GetHitCount() + engine.bpm_->GetMissCount(); };
+  uint64_t start = fetches();
+  std::vector<RowId> single;
+  for (auto &key : keys) {
+    unique_index->ScanKey(key, single, nullptr);
+  }
+  uint64_t single_fetches = fetches() - start;
+  start = fetches();
+  ASSERT_EQ(DB_SUCCESS, unique_index->ScanKeys(keys, result, nullptr));
+  ASSERT_LT((fetches() - start) * 2, single_fetches);
+  ASSERT_EQ(keys.size(), single.size());
+}
+
+TEST(BPlusTreeTests, FirstKeyNullsTest) {
+  using INT_INDEX = BPlusTreeIndex<NativeKey<int32_t, 16>, RowId, NativeComparator<int32_t, 16>>;
+  using NAME_INDEX = BPlusTreeIndex<PackedKey<32>, RowId, PackedComparator<32>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *int_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  auto *name_schema = Schema::ShallowCopySchema(&table_schema, {1}, &heap);
+  auto *int_index = ALLOC(heap, INT_INDEX)(0, int_schema, engine.bpm_, false);
+  auto *name_index = ALLOC(heap, NAME_INDEX)(1, name_schema, engine.bpm_, false);
+  // many leaves of nulls ahead of the first value
+  const int null_nums = 30000;
+  for (int i = 0; i < null_nums; i++) {
+    ASSERT_EQ(DB_SUCCESS, int_index->InsertEntry(Row(std::vector<Field>{Field(TypeId::kTypeInt)}), RowId(i), nullptr));
+    ASSERT_EQ(DB_SUCCESS, name_index->InsertEntry(Row(std::vector<Field>{Field(TypeId::kTypeChar)}), RowId(i), nullptr));
+  }
+  Row first(INVALID_ROWID);
+  ASSERT_EQ(DB_KEY_NOT_FOUND, int_index->ScanFirstKey(false, first, nullptr));
+  ASSERT_EQ(DB_KEY_NOT_FOUND, int_index->ScanFirstKey(true, first, nullptr));
+  ASSERT_EQ(DB_KEY_NOT_FOUND, name_index->ScanFirstKey(false, first, nullptr));
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(DB_SUCCESS, int_index->InsertEntry(MakeIntKey(i - 5), RowId(null_nums + i), nullptr));
+    std::string name(1, static_cast<char>('k' - i));
+    std::vector<Field> fields;
+    fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true);
+    ASSERT_EQ(DB_SUCCESS, name_index->InsertEntry(Row(std::move(fields)), RowId(null_nums + i), nullptr));
+  }
+  // one descent past the nulls, not a walk over them
+  auto fetches = [&]() { return engine.bpm_->GetHitCount() + engine.bpm_->GetMissCount(); };
+  uint64_t start = fetches();
+  ASSERT_EQ(DB_SUCCESS, int_index->ScanFirstKey(false, first, nullptr));
+  ASSERT_LT(fetches() - start, 10u);
+  ASSERT_EQ(CmpBool::kTrue, first.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, -5)));
+  start = fetches();
+  ASSERT_EQ(DB_SUCCESS, name_index->ScanFirstKey(false, first, nullptr));
+  ASSERT_LT(fetches() - start, 10u);
+  ASSERT_EQ(CmpBool::kTrue, first.GetField(0)->CompareEquals(Field(TypeId::kTypeChar, const_cast<char *>("b"), 1, false)));
+  Row last(INVALID_ROWID);
+  ASSERT_EQ(DB_SUCCESS, int_index->ScanFirstKey(true, last, nullptr));
+  ASSERT_EQ(CmpBool::kTrue, last.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 4)));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
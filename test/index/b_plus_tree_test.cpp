@@ -60,4 +60,68 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_TRUE(tree.GetValue(delete_seq[i], ans));
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
-}
\ No newline at end of file
+}
+/**
+ * Average percent of the leaf capacity in use, walking the leaf chain
+ */
+static int LeafFillPercent(BPlusTree<int, int, BasicComparator<int>> &tree, BufferPoolManager *bpm) {
+  using LeafPage = BPlusTreeLeafPage<int, int, BasicComparator<int>>;
+  page_id_t page_id = tree.FindLeafPage(0, true)->GetPageId();
+  long long used = 0, capacity = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    auto *leaf = reinterpret_cast<LeafPage *>(bpm->FetchPage(page_id)->GetData());
+    used += leaf->GetSize();
+    capacity += leaf->GetMaxSize();
+    page_id_t next_page_id = leaf->GetNextPageId();
+    bpm->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return static_cast<int>(used * 100 / capacity);
+}
+
+TEST(BPlusTreeTests, AppendTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> append_tree(0, engine.bpm_, comparator);
+  BPlusTree<int, int, BasicComparator<int>> random_tree(1, engine.bpm_, comparator);
+  const int n = 200000;
+  vector<int> keys;
+  for (int i = 0; i < n; i++) {
+    keys.push_back(i);
+  }
+  for (int i = 0; i < n; i++) {
+    ASSERT_TRUE(append_tree.Insert(i, i));
+  }
+  ShuffleArray(keys);
+  for (int i = 0; i < n; i++) {
+    ASSERT_TRUE(random_tree.Insert(keys[i], keys[i]));
+  }
+  int append_fill = LeafFillPercent(append_tree, engine.bpm_);
+  int random_fill = LeafFillPercent(random_tree, engine.bpm_);
+  // splits at the right edge leave leaves nearly full
+  ASSERT_GE(append_fill, 85);
+  ASSERT_LT(random_fill, 85);
+  ASSERT_TRUE(append_tree.Check());
+  // inserts in the middle, removes and duplicates around the cached leaf
+  ASSERT_FALSE(append_tree.Insert(n - 1, 0));
+  for (int i = 0; i < n; i += 3) {
+    ASSERT_TRUE(append_tree.Remove(i));
+  }
+  for (int i = n; i < n + 1000; i++) {
+    ASSERT_TRUE(append_tree.Insert(i, i));
+  }
+  for (int i = 0; i < n; i += 3) {
+    ASSERT_TRUE(append_tree.Insert(i, i));
+  }
+  vector<int> ans;
+  for (int i = 0; i < n + 1000; i++) {
+    ASSERT_TRUE(append_tree.GetValue(i, ans));
+    ASSERT_EQ(i, ans.back());
+  }
+  int expected = 0;
+  for (auto iter = append_tree.Begin(); !iter.IsEnd(); ++iter) {
+    ASSERT_EQ(expected++, (*iter).first);
+  }
+  ASSERT_EQ(n + 1000, expected);
+  ASSERT_TRUE(append_tree.Check());
+}
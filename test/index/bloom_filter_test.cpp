@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree_index.h"
+#include "index/native_key.h"
+
+static const std::string db_name = "bloom_filter_test.db";
+
+using BP_TREE_INDEX = BPlusTreeIndex<NativeKey<int32_t, 8>, RowId, NativeComparator<int32_t, 8>>;
+
+static Row MakeIntKey(int value) {
+  std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+  return Row(std::move(fields));
+}
+
+TEST(BloomFilterTest, IndexFilterTest) {
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  auto *index = new BP_TREE_INDEX(0, index_schema, engine.bpm_, true, true);
+  // even keys are present, odd keys never are
+  const int row_nums = 20000;
+  std::vector<int> keys(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    keys[i] = i * 2;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (int key : keys) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(MakeIntKey(key), RowId(key), nullptr));
+  }
+  BloomFilter *filter = index->GetBloomFilter();
+  ASSERT_GE(filter->GetCapacity(), static_cast<uint32_t>(row_nums));
+  auto count_excluded = [&](int from, int step) {
+    int excluded = 0;
+    for (int key = from; key < row_nums * 2; key += step) {
+      if (!filter->MayContain(BloomFilter::HashKey(MakeIntKey(key), 1))) {
+        excluded++;
+      }
+    }
+    return excluded;
+  };
+  // no false negatives, few false positives
+  ASSERT_EQ(0, count_excluded(0, 2));
+  ASSERT_GT(count_excluded(1, 2), row_nums * 95 / 100);
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(MakeIntKey(1), ret, nullptr));
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(42), ret, nullptr));
+  // removed keys leave the filter, absent ones do not disturb it
+  for (int key = 0; key < row_nums * 2; key += 4) {
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(MakeIntKey(key), RowId(key), nullptr));
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(MakeIntKey(key + 1), RowId(key + 1), nullptr));
+  }
+  ASSERT_EQ(static_cast<uint32_t>(row_nums / 2), filter->GetCount());
+  ASSERT_EQ(0, count_excluded(2, 4));
+  ASSERT_GT(count_excluded(0, 4), row_nums / 2 * 90 / 100);
+  // the counters are written back with the index and read again
+  delete index;
+  index = new BP_TREE_INDEX(0, index_schema, engine.bpm_, true, true);
+  filter = index->GetBloomFilter();
+  ASSERT_EQ(static_cast<uint32_t>(row_nums / 2), filter->GetCount());
+  ASSERT_EQ(0, count_excluded(2, 4));
+  ASSERT_GT(count_excluded(0, 4), row_nums / 2 * 90 / 100);
+  // an index gone without writing back leaves a stale filter, which is rebuilt
+  index->InsertEntry(MakeIntKey(0), RowId(0), nullptr);
+  auto *lost = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_, true, true);
+  ASSERT_EQ(static_cast<uint32_t>(row_nums / 2 + 1), lost->GetBloomFilter()->GetCount());
+  delete index;
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(BloomFilterTest, MissingKeyTest) {
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  auto *plain_index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  auto *filtered_index = new BP_TREE_INDEX(1, index_schema, engine.bpm_, true, true);
+  const int row_nums = 50000;
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(DB_SUCCESS, plain_index->InsertEntry(MakeIntKey(i * 2), RowId(i), nullptr));
+    ASSERT_EQ(DB_SUCCESS, filtered_index->InsertEntry(MakeIntKey(i * 2), RowId(i), nullptr));
+  }
+  // the filter turns most missing keys away before the tree is walked
+  auto lookup = [&](Index *index) {
+    std::vector<RowId> ret;
+    int missing = 0;
+    uint64_t fetches = engine.bpm_->GetHitCount() + engine.bpm_->GetMissCount();
+    for (int i = 0; i < row_nums; i++) {
+      missing += index->ScanKey(MakeIntKey(i * 2 + 1), ret, nullptr) == DB_KEY_NOT_FOUND ? 1 : 0;
+    }
+    EXPECT_EQ(row_nums, missing);
+    return engine.bpm_->GetHitCount() + engine.bpm_->GetMissCount() - fetches;
+  };
+  uint64_t plain_fetches = lookup(plain_index);
+  ASSERT_LT(lookup(filtered_index) * 10, plain_fetches);
+  delete filtered_index;
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree_index.h"
+#include "index/extendible_hash_index.h"
+#include "index/native_key.h"
+
+static const std::string db_name = "extendible_hash_index_test.db";
+
+static Row MakeIntKey(int value) {
+  std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+  return Row(std::move(fields));
+}
+
+TEST(ExtendibleHashIndexTest, UniqueKeyTest) {
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  auto *index = ALLOC(heap, ExtendibleHashIndex)(0, index_schema, engine.bpm_, true, 5);
+  const int row_nums = 20000;
+  std::vector<int> keys(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    keys[i] = i * 7 - row_nums;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(MakeIntKey(keys[i]), RowId(i), nullptr));
+  }
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(MakeIntKey(keys[0]), RowId(row_nums), nullptr));
+  ASSERT_GT(index->GetGlobalDepth(), 0u);
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(keys[i]), ret, nullptr));
+    ASSERT_EQ(1u, ret.size());
+    ASSERT_EQ(i, ret[0].Get());
+  }
+  std::vector<RowId> ret;
+  Row missing = MakeIntKey(1), low = MakeIntKey(keys[0]), high = MakeIntKey(keys[0] + 7);
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(missing, ret, nullptr));
+  // only single key ranges are answered
+  ASSERT_EQ(DB_SUCCESS, index->ScanRange(&low, &low, ret, nullptr));
+  ASSERT_EQ(1u, ret.size());
+  ASSERT_EQ(DB_FAILED, index->ScanRange(&low, &high, ret, nullptr));
+  ASSERT_EQ(DB_FAILED, index->ScanRange(&low, nullptr, ret, nullptr));
+  // a second instance finds the directory through the index roots page
+  ExtendibleHashIndex reopened(0, index_schema, engine.bpm_, true, 5);
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, reopened.ScanKey(MakeIntKey(keys[100]), ret, nullptr));
+  ASSERT_EQ(100, ret[0].Get());
+  // empty buckets merge and the directory shrinks back
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(MakeIntKey(keys[i]), RowId(i), nullptr));
+    if (i % 1000 == 0) {
+      ret.clear();
+      ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(MakeIntKey(keys[i]), ret, nullptr));
+      ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeIntKey(keys[i + 1]), ret, nullptr));
+    }
+  }
+  ASSERT_EQ(0u, index->GetGlobalDepth());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  ASSERT_EQ(DB_SUCCESS, index->Destroy());
+}
+
+TEST(ExtendibleHashIndexTest, DuplicateKeyTest) {
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 0, false, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  auto *index = ALLOC(heap, ExtendibleHashIndex)(0, index_schema, engine.bpm_, false, 19);
+  auto make_key = [](int status) {
+    std::string name = "status-" + std::to_string(status);
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    return Row(std::move(fields));
+  };
+  // one key with more entries than a bucket holds chains overflow pages
+  const int row_nums = 5000, status_nums = 3;
+  for (int i = 0; i < row_nums; i++) {
+    int status = i % 10 == 0 ? i % status_nums + 1 : 0;
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(make_key(status), RowId(i), nullptr));
+  }
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(make_key(0), RowId(1), nullptr));
+  auto count = [&](int status) {
+    std::vector<RowId> ret;
+    index->ScanKey(make_key(status), ret, nullptr);
+    return ret.size();
+  };
+  ASSERT_EQ(static_cast<size_t>(row_nums - row_nums / 10), count(0));
+  ASSERT_EQ(static_cast<size_t>(row_nums / 10), count(1) + count(2) + count(3));
+  for (int i = 0; i < row_nums; i += 2) {
+    int status = i % 10 == 0 ? i % status_nums + 1 : 0;
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(make_key(status), RowId(i), nullptr));
+  }
+  ASSERT_EQ(static_cast<size_t>(row_nums / 2), count(0));
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(make_key(0), ret, nullptr));
+  for (auto rid : ret) {
+    ASSERT_EQ(1, rid.Get() % 2);
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(ExtendibleHashIndexTest, PointLookupTest) {
+  using BP_TREE_INDEX = BPlusTreeIndex<NativeKey<int32_t, 8>, RowId, NativeComparator<int32_t, 8>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  auto *hash_index = ALLOC(heap, ExtendibleHashIndex)(0, index_schema, engine.bpm_, true, 5);
+  auto *tree_index = ALLOC(heap, BP_TREE_INDEX)(1, index_schema, engine.bpm_);
+  const int row_nums = 50000;
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(DB_SUCCESS, hash_index->InsertEntry(MakeIntKey(i), RowId(i), nullptr));
+    ASSERT_EQ(DB_SUCCESS, tree_index->InsertEntry(MakeIntKey(i), RowId(i), nullptr));
+  }
+  // a hash lookup fetches the directory and one bucket, never more pages than a walk down the tree
+  auto lookup = [&](Index *index) {
+    std::vector<RowId> ret;
+    uint64_t fetches = engine.bpm_->GetHitCount() + engine.bpm_->GetMissCount();
+    for (int i = 0; i < row_nums; i++) {
+      int key = (i * 7919) % row_nums;
+      index->ScanKey(MakeIntKey(key), ret, nullptr);
+      EXPECT_EQ(key, ret.back().Get());
+    }
+    EXPECT_EQ(static_cast<size_t>(row_nums), ret.size());
+    return engine.bpm_->GetHitCount() + engine.bpm_->GetMissCount() - fetches;
+  };
+  uint64_t hash_fetches = lookup(hash_index);
+  ASSERT_EQ(2u * row_nums, hash_fetches);
+  ASSERT_LE(hash_fetches, lookup(tree_index));
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree_index.h"
+#include "index/native_key.h"
+#include "index/node_search.h"
+
+static const std::string db_name = "node_search_test.db";
+
+static Row MakeIntKey(int value) {
+  std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+  return Row(std::move(fields));
+}
+
+/**
+ * Node entries of the given stride, value and null flag first, n values
+ * below a null prefix of nulls entries
+ */
+static std::vector<char> MakeEntries(size_t stride, int nulls, const std::vector<int32_t> &values) {
+  std::vector<char> entries(stride * (nulls + values.size()), 0);
+  for (int i = 0; i < nulls; i++) {
+    MACH_WRITE_TO(int32_t, entries.data() + i * stride + sizeof(int32_t), 1);
+  }
+  for (size_t i = 0; i < values.size(); i++) {
+    MACH_WRITE_TO(int32_t, entries.data() + (nulls + i) * stride, values[i]);
+  }
+  return entries;
+}
+
+TEST(NodeSearchTest, KernelTest) {
+  std::mt19937 rng(7);
+  // strides of unique and non-unique leaf and internal entries
+  for (size_t stride : {12, 16, 20, 24}) {
+    for (int n : {0, 1, 7, 8, 9, 31, 33, 100, 255}) {
+      for (int nulls : {0, 3}) {
+        std::vector<int32_t> values(n);
+        for (auto &value : values) {
+          value = static_cast<int32_t>(rng() % 200) - 100;
+        }
+        values.push_back(INT_MIN);
+        values.push_back(INT_MAX);
+        std::sort(values.begin(), values.end());
+        auto entries = MakeEntries(stride, nulls, values);
+        int size = nulls + values.size();
+        for (int32_t probe : {INT_MIN, -101, -50, 0, 1, 99, 100, INT_MAX}) {
+          for (bool upper : {false, true}) {
+            int expected = nulls + (upper ? std::upper_bound(values.begin(), values.end(), probe)
+                                          : std::lower_bound(values.begin(), values.end(), probe)) - values.begin();
+            ASSERT_EQ(expected, NodeSearchKernel::Bound(entries.data(), stride, 0, size, probe, upper));
+            ASSERT_EQ(expected, NodeSearchKernel::BoundScalar(entries.data(), stride, 0, size, probe, upper));
+            int begin = std::min(size, nulls + 1);
+            ASSERT_EQ(std::max(expected, begin),
+                      NodeSearchKernel::Bound(entries.data(), stride, begin, size, probe, upper));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(NodeSearchTest, NodeTest) {
+  using KeyType = NativeKey<int32_t, 8>;
+  using KeyComparator = NativeComparator<int32_t, 8>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  KeyComparator comparator(index_schema);
+  // a full leaf of unique int keys
+  const int size = 250;
+  std::vector<std::pair<KeyType, RowId>> entries(size);
+  for (int i = 0; i < size; i++) {
+    entries[i].first.SerializeFromKey(MakeIntKey(i * 4), index_schema);
+    entries[i].second = RowId(i);
+  }
+  // the simd search finds the bound the comparator's binary search does
+  for (int i = 0; i < size * 4; i++) {
+    KeyType key;
+    key.SerializeFromKey(MakeIntKey(i), index_schema);
+    ASSERT_EQ((BinaryNodeSearch<KeyType, KeyComparator>::LowerBound(entries.data(), 0, size, key, comparator)),
+              (NodeSearch<KeyType, KeyComparator>::LowerBound(entries.data(), 0, size, key, comparator)));
+  }
+}
+
+template<size_t KeySize>
+static void RunTreeTest(bool unique) {
+  using BP_TREE_INDEX = BPlusTreeIndex<NativeKey<int32_t, KeySize>, RowId, NativeComparator<int32_t, KeySize>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_, unique);
+  const int row_nums = 100000;
+  std::vector<int> keys(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(row_nums));
+  for (int key : keys) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(MakeIntKey(key), RowId(key), nullptr));
+  }
+  std::vector<RowId> ret;
+  for (int key : keys) {
+    index->ScanKey(MakeIntKey(key), ret, nullptr);
+  }
+  ASSERT_EQ(static_cast<size_t>(row_nums), ret.size());
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(keys[i], ret[i].Get());
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(NodeSearchTest, TreeTest) {
+  RunTreeTest<8>(true);
+  RunTreeTest<16>(false);
+}
@@ -5,6 +5,8 @@
 #include "page/table_page.h"
 #include "record/field.h"
 #include "record/row.h"
+#include "record/row_comparator.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 char *chars[] = {
@@ -117,4 +119,208 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+
+TEST(TupleTest, RowViewTest) {
+  SimpleMemHeap heap;
+  TablePage table_page;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("nick", TypeId::kTypeChar, 16, 2, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 3, true, false)
+  };
+  std::vector<Field> fields = {
+          Field(TypeId::kTypeInt, 188),
+          Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+          Field(TypeId::kTypeChar),
+          Field(TypeId::kTypeFloat, 19.99f)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  ASSERT_TRUE(table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr));
+  RowView view;
+  ASSERT_TRUE(table_page.GetTupleView(row.GetRowId(), schema.get(), &view));
+  ASSERT_EQ(row.GetRowId(), view.GetRowId());
+  ASSERT_EQ(4, view.GetFieldCount());
+  // fields are decoded in place, out of order access is fine
+  EXPECT_EQ(19.99f, view.GetFloat(3));
+  EXPECT_TRUE(view.IsNull(2));
+  EXPECT_EQ(188, view.GetInt(0));
+  uint32_t len;
+  const char *name = view.GetChars(1, &len);
+  ASSERT_EQ(strlen("minisql"), len);
+  EXPECT_EQ(0, memcmp(name, "minisql", len));
+  EXPECT_TRUE(name >= table_page.GetData() && name < table_page.GetData() + PAGE_SIZE);
+  for (uint32_t i = 0; i < view.GetFieldCount(); i++) {
+    if (i == 2) continue;
+    ASSERT_EQ(CmpBool::kTrue, view.GetField(i).CompareEquals(fields[i]));
+  }
+  Row row2(INVALID_ROWID);
+  view.ToRow(&row2);
+  ASSERT_EQ(row.GetRowId(), row2.GetRowId());
+  ASSERT_EQ(4, row2.GetFieldCount());
+  ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
+  ASSERT_FALSE(table_page.GetTupleView(row.GetRowId(), schema.get(), &view));
+}
+
+TEST(TupleTest, CompactRowFormatTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false),
+          ALLOC_COLUMN(heap)("nick", TypeId::kTypeChar, 16, 3, true, false),
+          ALLOC_COLUMN(heap)("age", TypeId::kTypeInt, 4, true, false),
+          ALLOC_COLUMN(heap)("city", TypeId::kTypeChar, 16, 5, true, false)
+  };
+  std::vector<Field> fields = {
+          Field(TypeId::kTypeInt, 188),
+          Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+          Field(TypeId::kTypeFloat),
+          Field(TypeId::kTypeChar),
+          Field(TypeId::kTypeInt, -7),
+          Field(TypeId::kTypeChar, const_cast<char *>("hangzhou"), strlen("hangzhou"), false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  char compact[PAGE_SIZE];
+  char legacy[PAGE_SIZE];
+  uint32_t compact_size = row.SerializeTo(compact, schema.get());
+  ASSERT_EQ(row.GetSerializedSize(schema.get()), compact_size);
+  // rows written without a schema keep the old format
+  uint32_t legacy_size = row.SerializeTo(legacy, nullptr);
+  ASSERT_EQ(row.GetSerializedSize(nullptr), legacy_size);
+  ASSERT_LT(compact_size, legacy_size);
+  for (char *buf : {compact, legacy}) {
+    Row row2(INVALID_ROWID);
+    ASSERT_EQ(buf == compact ? compact_size : legacy_size, row2.DeserializeFrom(buf, schema.get()));
+    RowView view(buf, schema.get());
+    ASSERT_EQ(6, row2.GetFieldCount());
+    ASSERT_EQ(6, view.GetFieldCount());
+    for (uint32_t i = 0; i < fields.size(); i++) {
+      ASSERT_EQ(fields[i].IsNull(), row2.GetField(i)->IsNull());
+      ASSERT_EQ(fields[i].IsNull(), view.IsNull(i));
+      if (!fields[i].IsNull()) {
+        ASSERT_EQ(CmpBool::kTrue, row2.GetField(i)->CompareEquals(fields[i]));
+        ASSERT_EQ(CmpBool::kTrue, view.GetField(i).CompareEquals(fields[i]));
+      }
+    }
+    EXPECT_EQ(-7, view.GetInt(4));
+    uint32_t len;
+    const char *city = view.GetChars(5, &len);
+    ASSERT_EQ(strlen("hangzhou"), len);
+    EXPECT_EQ(0, memcmp(city, "hangzhou", len));
+  }
+}
+
+TEST(TupleTest, MoveAndInlineFieldTest) {
+  // short chars are kept inside the field, long ones are allocated
+  Field small(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), true);
+  const char *small_data = small.GetData();
+  EXPECT_TRUE(small_data >= reinterpret_cast<const char *>(&small) &&
+              small_data < reinterpret_cast<const char *>(&small + 1));
+  char long_chars[64];
+  memset(long_chars, 'x', sizeof(long_chars));
+  Field large(TypeId::kTypeChar, long_chars, sizeof(long_chars), true);
+  const char *large_data = large.GetData();
+  EXPECT_NE(long_chars, large_data);
+  // a move steals the payload instead of copying it
+  Field moved(std::move(large));
+  EXPECT_EQ(large_data, moved.GetData());
+  EXPECT_EQ(sizeof(long_chars), moved.GetLength());
+  Field small_copy(small);
+  EXPECT_EQ(CmpBool::kTrue, small_copy.CompareEquals(small));
+  EXPECT_NE(small_data, small_copy.GetData());
+
+  std::vector<Field> fields;
+  fields.emplace_back(TypeId::kTypeInt, 188);
+  fields.emplace_back(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), true);
+  fields.emplace_back(TypeId::kTypeChar, long_chars, sizeof(long_chars), true);
+  const char *row_large_data = fields[2].GetData();
+  Row row(std::move(fields));
+  ASSERT_EQ(3, row.GetFieldCount());
+  EXPECT_EQ(row_large_data, row.GetField(2)->GetData());
+  Field *first = row.GetField(0);
+  Row moved_row(std::move(row));
+  EXPECT_EQ(0, row.GetFieldCount());
+  ASSERT_EQ(3, moved_row.GetFieldCount());
+  EXPECT_EQ(first, moved_row.GetField(0));
+  EXPECT_EQ(CmpBool::kTrue, moved_row.GetField(1)->CompareEquals(small));
+
+  // in place construction and per row updates on an arena
+  ArenaMemHeap arena;
+  Row arena_row(INVALID_ROWID, &arena);
+  arena_row.EmplaceField(TypeId::kTypeInt, 7);
+  arena_row.EmplaceField(TypeId::kTypeChar, long_chars, sizeof(long_chars), true);
+  EXPECT_EQ(sizeof(long_chars), arena_row.GetField(1)->GetLength());
+  arena_row.SetField(0, Field(TypeId::kTypeInt, 8));
+  arena_row.SetField(1, small);
+  EXPECT_EQ(CmpBool::kTrue, arena_row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 8)));
+  EXPECT_EQ(CmpBool::kTrue, arena_row.GetField(1)->CompareEquals(small));
+}
+
+TEST(TupleTest, RowComparatorTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 0, true, false),
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 1, true, false),
+          ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  RowComparator comparator(schema.get());
+  const char *names[] = {"", "a", "ab", "b", "abcdefghijklmnopq"};
+  std::vector<Row *> rows;
+  for (auto name : names) {
+    for (int32_t id : {-3, 0, 7}) {
+      for (float score : {-1.5f, 2.25f}) {
+        std::vector<Field> fields;
+        fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(name), strlen(name), true);
+        fields.emplace_back(TypeId::kTypeInt, id);
+        fields.emplace_back(TypeId::kTypeFloat, score);
+        rows.push_back(new Row(std::move(fields)));
+      }
+    }
+  }
+  std::vector<std::vector<char>> bufs;
+  for (auto row : rows) {
+    bufs.emplace_back(row->GetSerializedSize(schema.get()));
+    row->SerializeTo(bufs.back().data(), schema.get());
+    ASSERT_TRUE(RowComparator::IsCompact(bufs.back().data()));
+  }
+  // kernels agree with the virtual Field compares, materialized or serialized
+  for (size_t i = 0; i < rows.size(); i++) {
+    for (size_t j = 0; j < rows.size(); j++) {
+      int expect = 0;
+      for (uint32_t k = 0; k < 3 && expect == 0; k++) {
+        if (rows[i]->GetField(k)->CompareLessThan(*rows[j]->GetField(k)) == CmpBool::kTrue) {
+          expect = -1;
+        } else if (rows[i]->GetField(k)->CompareGreaterThan(*rows[j]->GetField(k)) == CmpBool::kTrue) {
+          expect = 1;
+        }
+      }
+      ASSERT_EQ(expect, comparator.Compare(*rows[i], *rows[j]));
+      int ret = comparator.CompareSerialized(bufs[i].data(), bufs[j].data());
+      ASSERT_EQ(expect, (ret > 0) - (ret < 0));
+    }
+  }
+  // single column schemas take the specialized path, nulls sort first
+  std::vector<Column *> key_columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false)};
+  auto key_schema = std::make_shared<Schema>(key_columns);
+  RowComparator key_comparator(key_schema.get());
+  std::vector<Field> lhs{Field(TypeId::kTypeInt, 5)}, rhs{Field(TypeId::kTypeInt, 9)}, null{Field(TypeId::kTypeInt)};
+  char lhs_buf[PAGE_SIZE], rhs_buf[PAGE_SIZE], null_buf[PAGE_SIZE];
+  Row(lhs).SerializeTo(lhs_buf, key_schema.get());
+  Row(rhs).SerializeTo(rhs_buf, key_schema.get());
+  Row(null).SerializeTo(null_buf, key_schema.get());
+  EXPECT_GT(0, key_comparator.CompareSerialized(lhs_buf, rhs_buf));
+  EXPECT_LT(0, key_comparator.CompareSerialized(rhs_buf, lhs_buf));
+  EXPECT_EQ(0, key_comparator.CompareSerialized(lhs_buf, lhs_buf));
+  EXPECT_GT(0, key_comparator.CompareSerialized(null_buf, rhs_buf));
+  EXPECT_LT(0, key_comparator.CompareSerialized(rhs_buf, null_buf));
+  EXPECT_EQ(0, key_comparator.CompareSerialized(null_buf, null_buf));
+  for (auto row : rows) {
+    delete row;
+  }
+}
@@ -54,3 +54,45 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
 }
 
+TEST(TableHeapTest, SamplePagesTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  char characters[64];
+  memset(characters, 'x', sizeof(characters));
+  auto insert = [&](int from, int to) {
+    for (int i = from; i < to; i++) {
+      Row row(Fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, characters, 64, true)});
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+  };
+  insert(0, 2000);
+  // a heap loaded from its first page reads the page list once
+  TableHeap *loaded = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), schema.get(), nullptr, nullptr,
+                                        &heap);
+  uint32_t page_count;
+  ASSERT_EQ(1u, loaded->SamplePages(1, [](const RowView &) {}, page_count));
+  ASSERT_GT(page_count, 10u);
+  uint64_t fetches = engine.bpm_->GetHitCount() + engine.bpm_->GetMissCount();
+  uint32_t again;
+  ASSERT_EQ(1u, loaded->SamplePages(1, [](const RowView &) {}, again));
+  ASSERT_EQ(page_count, again);
+  ASSERT_EQ(fetches + 1, engine.bpm_->GetHitCount() + engine.bpm_->GetMissCount());
+  // pages added later are counted without reading the list again
+  uint32_t created;
+  table_heap->SamplePages(0, [](const RowView &) {}, created);
+  ASSERT_EQ(page_count, created);
+  insert(2000, 4000);
+  table_heap->SamplePages(0, [](const RowView &) {}, created);
+  uint32_t sampled = 0;
+  loaded = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), schema.get(), nullptr, nullptr, &heap);
+  ASSERT_EQ(created, loaded->SamplePages(created, [&](const RowView &) { sampled++; }, again));
+  ASSERT_EQ(created, again);
+  ASSERT_EQ(4000u, sampled);
+  ASSERT_GT(created, page_count);
+}
@@ -0,0 +1,96 @@
+#include <cstring>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+#include "utils/utils.h"
+
+/**
+ * Count the allocations made through a heap
+ */
+class CountingMemHeap : public MemHeap {
+public:
+  explicit CountingMemHeap(MemHeap *heap) : heap_(heap) {}
+
+  void *Allocate(size_t size) {
+    count_++;
+    return heap_->Allocate(size);
+  }
+
+  void Free(void *ptr) { heap_->Free(ptr); }
+
+  inline uint64_t GetCount() const { return count_; }
+
+private:
+  MemHeap *heap_;
+  uint64_t count_{0};
+};
+
+static string db_file_name = "table_iterator_test.db";
+
+TEST(TableIteratorTest, ScanAllocationTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 10000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  char characters[64];
+  int64_t total_len = 0;
+  for (int i = 0; i < row_nums; i++) {
+    int32_t len = RandomUtils::RandomInt(1, 64);
+    RandomUtils::RandomString(characters, len);
+    total_len += len;
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, i),
+            Field(TypeId::kTypeChar, characters, len, false),
+            Field(TypeId::kTypeFloat, RandomUtils::RandomFloat(-999.f, 999.f))
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  auto scan = [&](auto &&visit) {
+    int64_t sum = 0;
+    for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+      sum += visit(it);
+    }
+    EXPECT_EQ(total_len, sum);
+  };
+  // a copied row allocates every field from its heap
+  SimpleMemHeap copy_heap;
+  CountingMemHeap copy_counter(&copy_heap);
+  scan([&](TableIterator &it) {
+    Row row(*it, &copy_counter);
+    return row.GetField(1)->GetLength();
+  });
+  EXPECT_GE(copy_counter.GetCount(), static_cast<uint64_t>(3 * row_nums));
+  // an arena reset on every row keeps reusing its first block
+  ArenaMemHeap arena;
+  CountingMemHeap arena_counter(&arena);
+  scan([&](TableIterator &it) {
+    arena.Reset();
+    Row row(*it, &arena_counter);
+    return row.GetField(1)->GetLength();
+  });
+  EXPECT_GE(arena_counter.GetCount(), static_cast<uint64_t>(3 * row_nums));
+  EXPECT_EQ(1u, arena.GetBlockCount());
+  // the iterator materializes every tuple into the same row
+  const Row *iterator_row = nullptr;
+  scan([&](TableIterator &it) {
+    if (iterator_row == nullptr) iterator_row = &*it;
+    EXPECT_EQ(iterator_row, &*it);
+    return it->GetField(1)->GetLength();
+  });
+  scan([](TableIterator &it) {
+    uint32_t len;
+    it.GetRowView().GetChars(1, &len);
+    return len;
+  });
+}